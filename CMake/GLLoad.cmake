@@ -0,0 +1,45 @@
+# Generates the glload implementation for builds that cannot link the shipped Win32 glload library.
+# Every header gl_4_3.hpp includes is scanned for function pointer and extension variable declarations,
+# those declarations become definitions and each pointer gets loaded by its GL name, __gleX is glX.
+#
+# Usage: cmake -DGLLOAD_INCLUDE_DIR=<dir> -DGLLOAD_TEMPLATE=<GLLoad.cpp.in> -DGLLOAD_OUTPUT=<GLLoad.cpp> -P GLLoad.cmake
+
+file(STRINGS "${GLLOAD_INCLUDE_DIR}/gl_4_3.hpp" GLLOAD_HEADER_INCLUDES REGEX "^#include \"_int_gl_[0-9a-z_]+\\.hpp\"")
+
+set(GLLOAD_DEFINITIONS "")
+set(GLLOAD_CORE_LOADS "")
+set(GLLOAD_EXTENSION_LOADS "")
+set(GLLOAD_DEFINED_NAMES "")
+
+foreach(INCLUDE_LINE ${GLLOAD_HEADER_INCLUDES})
+	string(REGEX REPLACE "^#include \"([^\"]+)\".*$" "\\1" HEADER_NAME "${INCLUDE_LINE}")
+	file(STRINGS "${GLLOAD_INCLUDE_DIR}/${HEADER_NAME}" DECLARATIONS REGEX "^extern (.+\\(GLE_FUNCPTR \\*[A-Za-z0-9_]+\\)|int glext_[A-Za-z0-9_]+)")
+	foreach(DECLARATION ${DECLARATIONS})
+		string(REGEX REPLACE "[ ;]+$" "" DECLARATION "${DECLARATION}")
+		if(DECLARATION MATCHES "^extern int (glext_[A-Za-z0-9_]+)")
+			set(NAME "${CMAKE_MATCH_1}")
+		elseif(DECLARATION MATCHES "\\(GLE_FUNCPTR \\*([A-Za-z0-9_]+)\\)")
+			set(NAME "${CMAKE_MATCH_1}")
+		else()
+			continue()
+		endif()
+		list(FIND GLLOAD_DEFINED_NAMES "${NAME}" DEFINED_INDEX)
+		if(NOT DEFINED_INDEX EQUAL -1)
+			continue()
+		endif()
+		list(APPEND GLLOAD_DEFINED_NAMES "${NAME}")
+
+		string(REGEX REPLACE "^extern " "" DEFINITION "${DECLARATION}")
+		string(APPEND GLLOAD_DEFINITIONS "${DEFINITION};\n")
+		if(NAME MATCHES "^glext_")
+			continue()
+		endif()
+		if(NAME MATCHES "^__gle(.+)$")
+			string(APPEND GLLOAD_CORE_LOADS "\t\tmissingCount += Load(${NAME}, \"gl${CMAKE_MATCH_1}\") ? 0 : 1;\n")
+		else()
+			string(APPEND GLLOAD_EXTENSION_LOADS "\t\tLoad(${NAME}, \"${NAME}\");\n")
+		endif()
+	endforeach()
+endforeach()
+
+configure_file("${GLLOAD_TEMPLATE}" "${GLLOAD_OUTPUT}" @ONLY)
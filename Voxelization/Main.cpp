@@ -475,7 +475,9 @@ int main()
 	return 0;
 }
 
+#ifdef _MSC_VER
 #define MEMORY_LEAK_CHECK
+#endif
 #ifdef MEMORY_LEAK_CHECK
 #define _CRTDBG_MAP_ALLOC
 #include <stdlib.h>
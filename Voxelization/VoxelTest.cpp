@@ -127,9 +127,9 @@ namespace
 			technique->AddInclude(XREXContext::GetInstance().GetRenderingEngine().GetSystemTechniqueFactory("Transformation")->GetTechniqueInformationToInclude());
 			technique->AddInclude(XREXContext::GetInstance().GetRenderingEngine().GetSystemTechniqueFactory("Camera")->GetTechniqueInformationToInclude());
 
-			technique->AddUniformBufferInformation(BufferInformation("PerObject", "", BufferView::BufferType::Uniform, std::vector<VariableInformation const>()));
-			technique->AddUniformBufferInformation(BufferInformation("PerAxis", "", BufferView::BufferType::Uniform, std::vector<VariableInformation const>()));
-			technique->AddUniformBufferInformation(BufferInformation("NeverChanged", "", BufferView::BufferType::Uniform, std::vector<VariableInformation const>()));
+			technique->AddUniformBufferInformation(BufferInformation("PerObject", "", BufferView::BufferType::Uniform, std::vector<VariableInformation>()));
+			technique->AddUniformBufferInformation(BufferInformation("PerAxis", "", BufferView::BufferType::Uniform, std::vector<VariableInformation>()));
+			technique->AddUniformBufferInformation(BufferInformation("NeverChanged", "", BufferView::BufferType::Uniform, std::vector<VariableInformation>()));
 
 			technique->AddImageInformation(ImageInformation("heads", TextureImage::ImageType::Image2D, TexelFormat::R32UI, AccessType::ReadWrite));
 			technique->AddImageInformation(ImageInformation("nodePool", TextureImage::ImageType::ImageBuffer, TexelFormat::RGBA32UI, AccessType::WriteOnly));
@@ -144,7 +144,7 @@ namespace
 			ss.magFilterMode = SamplerState::TextureFilterMode::Anisotropic;
 			technique->AddSamplerState("DefaultSampler", ss);
 
-			technique->AddAtomicCounterBufferInformation(BufferInformation("AtomicBuffer0", "", BufferView::BufferType::AtomicCounter, std::vector<VariableInformation const>()));
+			technique->AddAtomicCounterBufferInformation(BufferInformation("AtomicBuffer0", "", BufferView::BufferType::AtomicCounter, std::vector<VariableInformation>()));
 
 			technique->AddAttributeInputInformation(AttributeInputInformation("position", ElementType::FloatV3));
 			technique->AddAttributeInputInformation(AttributeInputInformation("textureCoordinate0", ElementType::FloatV3));
@@ -186,7 +186,7 @@ namespace
 			technique->AddStageCode(ShaderObject::ShaderType::VertexShader, MakeSP<string>());
 			technique->AddStageCode(ShaderObject::ShaderType::FragmentShader, MakeSP<string>());
 
-			technique->AddUniformBufferInformation(BufferInformation("PerAxis", "", BufferView::BufferType::Uniform, std::vector<VariableInformation const>()));
+			technique->AddUniformBufferInformation(BufferInformation("PerAxis", "", BufferView::BufferType::Uniform, std::vector<VariableInformation>()));
 
 			technique->AddImageInformation(ImageInformation("heads", TextureImage::ImageType::Image2D, TexelFormat::R32UI, AccessType::ReadOnly));
 			technique->AddImageInformation(ImageInformation("nodePool", TextureImage::ImageType::ImageBuffer, TexelFormat::RGBA32UI, AccessType::ReadOnly));
@@ -359,6 +359,11 @@ namespace
 		uint32 frame;
 
 		bool anisotropic;
+
+		/*
+		 *	Required by RenderablePackCollector, only small packs are collected, which do not use it.
+		 */
+		FrameArena collectorArena;
 		
 
 		RenderToTextureProcess(floatV3 const& sceneCenter, float sceneHalfSize, uint32 voxelVolumeResolution, float cameraSpeedScaler)
@@ -499,7 +504,7 @@ namespace
 		{
 			std::vector<SceneObjectSP> sceneObjects = scene->GetRenderableQueue(nullptr);
 
-			RenderablePackCollector collector;
+			RenderablePackCollector collector(collectorArena);
 			for (SceneObjectSP sceneObject : sceneObjects)
 			{
 				TransformationSP transformation = sceneObject->GetComponent<Transformation>();
@@ -695,21 +700,19 @@ namespace
 			coneTracingTechniqueCameraSetter->SetParameter(camera);
 			coneTracingTechniqueTransformationSetter->Connect(camera);
 
-			RenderablePackCollector collector;
-			coneTracingProxyCube->GetComponent<Renderable>()->GetRenderablePack(collector, nullptr);
-			std::vector<Renderable::RenderablePack> allRenderableNeedToRender = collector.ExtractRenderablePacks();
+			// packs only have raw pointers, draw the sub meshes of the proxy cube, which hold them.
+			MeshSP cube = CheckedSPCast<Mesh>(coneTracingProxyCube->GetComponent<Renderable>());
 
 			gl::MemoryBarrier(gl::GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 
 			IndexedDrawer drawer;
-			for (auto& renderable : allRenderableNeedToRender)
+			for (auto& subMesh : cube->GetAllSubMeshes())
 			{
-				Renderable& ownerRenderable = *renderable.renderable;
-				RenderingTechniqueSP const& technique = renderable.technique;
-				RenderingLayoutSP const& layout = renderable.layout;
-				MaterialSP const& material = renderable.material;
+				RenderingTechniqueSP const& technique = subMesh->GetTechnique();
+				RenderingLayoutSP const& layout = subMesh->GetLayout();
+				MaterialSP const& material = subMesh->GetMaterial();
 
-				coneTracingTechniqueTransformationSetter->SetParameter(ownerRenderable.GetOwnerSceneObject()->GetComponent<Transformation>());
+				coneTracingTechniqueTransformationSetter->SetParameter(coneTracingProxyCube->GetComponent<Transformation>());
 
 				material->SetParameter("voxels", voxelVolumeToTrace);
 				material->BindToTechnique(technique);
@@ -726,7 +729,7 @@ namespace
 
 		void Logic(double currentTime, double deltaTime)
 		{
-			auto& transformation = viewCameraObject->GetComponent<Transformation>();
+			auto transformation = viewCameraObject->GetComponent<Transformation>();
 			floatV3 const& position = transformation->GetWorldPosition();
 			floatV3 to = TransformDirection(transformation->GetWorldMatrix(), transformation->GetModelFrontDirection());
 			floatV3 up = TransformDirection(transformation->GetWorldMatrix(), transformation->GetModelUpDirection());
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Base/BasicType.hpp"
+
+#include <filesystem>
+
+namespace XREX
+{
+
+	/*
+	 *	The file system library is std::tr2::sys in Visual Studio and std::filesystem elsewhere.
+	 *	Use it through this namespace, with the few functions named differently wrapped.
+	 */
+	namespace FileSystem
+	{
+#ifdef _MSC_VER
+		using namespace std::tr2::sys;
+
+		inline bool IsRegularFile(path const& filePath)
+		{
+			return is_regular(filePath);
+		}
+		inline path Complete(path const& filePath)
+		{
+			return complete(filePath);
+		}
+		inline uint64 LastWriteTime(path const& filePath)
+		{
+			return static_cast<uint64>(last_write_time(filePath));
+		}
+#else
+		using namespace std::filesystem;
+
+		inline bool IsRegularFile(path const& filePath)
+		{
+			return is_regular_file(filePath);
+		}
+		inline path Complete(path const& filePath)
+		{
+			return absolute(filePath);
+		}
+		inline uint64 LastWriteTime(path const& filePath)
+		{
+			return static_cast<uint64>(last_write_time(filePath).time_since_epoch().count());
+		}
+#endif
+	}
+
+}
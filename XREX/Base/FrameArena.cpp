@@ -0,0 +1,74 @@
+#include "XREX.hpp"
+
+#include "FrameArena.hpp"
+
+#include <algorithm>
+
+namespace XREX
+{
+	namespace
+	{
+		/*
+		 *	Alignment new guarantees on all platforms, enough for types allocated from arena.
+		 */
+		uint32 const MaxAlignment = 8;
+	}
+
+
+
+	FrameArena::FrameArena(uint32 chunkSizeInBytes)
+		: chunkSize_(chunkSizeInBytes), offset_(0), usedSize_(0), heapAllocationCount_(0)
+	{
+		assert(chunkSizeInBytes != 0);
+	}
+
+	FrameArena::~FrameArena()
+	{
+	}
+
+	void* FrameArena::Allocate(uint32 sizeInBytes, uint32 alignment)
+	{
+		assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && alignment <= MaxAlignment);
+		uint32 alignedOffset = (offset_ + alignment - 1) & ~(alignment - 1);
+		if (chunks_.empty() || alignedOffset + sizeInBytes > chunkSizes_.back())
+		{
+			AddChunk(std::max(chunkSize_, sizeInBytes)); // the rest of the last chunk is wasted until Reset
+			alignedOffset = 0;
+		}
+		usedSize_ += alignedOffset + sizeInBytes - offset_;
+		offset_ = alignedOffset + sizeInBytes;
+		return chunks_.back().get() + alignedOffset;
+	}
+
+	void FrameArena::Reset()
+	{
+		if (chunks_.size() > 1)
+		{
+			uint32 capacity = GetCapacity();
+			chunks_.clear();
+			chunkSizes_.clear();
+			AddChunk(capacity);
+		}
+		offset_ = 0;
+		usedSize_ = 0;
+	}
+
+	uint32 FrameArena::GetCapacity() const
+	{
+		uint32 capacity = 0;
+		for (uint32 size : chunkSizes_)
+		{
+			capacity += size;
+		}
+		return capacity;
+	}
+
+	void FrameArena::AddChunk(uint32 sizeInBytes)
+	{
+		chunks_.push_back(std::unique_ptr<uint8[]>(new uint8[sizeInBytes]));
+		chunkSizes_.push_back(sizeInBytes);
+		offset_ = 0;
+		++heapAllocationCount_;
+	}
+
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include <vector>
+#include <cstring>
+
+namespace XREX
+{
+
+	/*
+	 *	Linear allocator for data of one frame. Allocation only moves an offset, Reset releases everything at once.
+	 *	Chunks are kept by Reset. If a frame needed more than one chunk, they are replaced by one chunk of the total size,
+	 *	so frames of similar size do not touch the heap after the first one.
+	 *	Memory is not initialized and no destructor is called, only for trivially copyable and destructible types.
+	 *	Not thread safe.
+	 */
+	class XREX_API FrameArena
+		: Noncopyable
+	{
+	public:
+		static uint32 const DefaultChunkSizeInBytes = 64 * 1024;
+
+	public:
+		explicit FrameArena(uint32 chunkSizeInBytes = DefaultChunkSizeInBytes);
+		~FrameArena();
+
+		/*
+		 *	@alignment: power of 2, at most 8.
+		 */
+		void* Allocate(uint32 sizeInBytes, uint32 alignment);
+		template <typename T>
+		T* AllocateArray(uint32 count)
+		{
+			return static_cast<T*>(Allocate(sizeof(T) * count, std::alignment_of<T>::value));
+		}
+
+		/*
+		 *	Invalidate all allocations.
+		 */
+		void Reset();
+
+		/*
+		 *	Bytes allocated since last Reset, including alignment.
+		 */
+		uint32 GetUsedSize() const
+		{
+			return usedSize_;
+		}
+		uint32 GetCapacity() const;
+		/*
+		 *	Chunks allocated from heap since construction.
+		 */
+		uint32 GetHeapAllocationCount() const
+		{
+			return heapAllocationCount_;
+		}
+
+	private:
+		void AddChunk(uint32 sizeInBytes);
+
+	private:
+		uint32 chunkSize_;
+		std::vector<std::unique_ptr<uint8[]>> chunks_;
+		std::vector<uint32> chunkSizes_;
+		/*
+		 *	Offset in the last chunk.
+		 */
+		uint32 offset_;
+		uint32 usedSize_;
+		uint32 heapAllocationCount_;
+	};
+
+
+
+	/*
+	 *	Growable array in a FrameArena, a handle that can be copied freely.
+	 *	Growing allocates a larger array from the arena and copies elements, the old array is wasted until the arena is reset.
+	 *	Elements are copied by memcpy, so T must be trivially copyable.
+	 */
+	template <typename T>
+	class FrameArray
+	{
+	public:
+		FrameArray()
+			: arena_(nullptr), data_(nullptr), size_(0), capacity_(0)
+		{
+		}
+		explicit FrameArray(FrameArena& arena)
+			: arena_(&arena), data_(nullptr), size_(0), capacity_(0)
+		{
+		}
+
+		FrameArena* GetArena() const
+		{
+			return arena_;
+		}
+
+		void Reserve(uint32 capacity)
+		{
+			if (capacity > capacity_)
+			{
+				assert(arena_ != nullptr);
+				T* data = arena_->AllocateArray<T>(capacity);
+				if (size_ != 0)
+				{
+					memcpy(data, data_, sizeof(T) * size_);
+				}
+				data_ = data;
+				capacity_ = capacity;
+			}
+		}
+		void PushBack(T const& value)
+		{
+			if (size_ == capacity_)
+			{
+				Reserve(capacity_ == 0 ? 16 : capacity_ * 2);
+			}
+			data_[size_] = value;
+			++size_;
+		}
+		/*
+		 *	Remove all elements, capacity is kept.
+		 */
+		void Clear()
+		{
+			size_ = 0;
+		}
+
+		uint32 GetSize() const
+		{
+			return size_;
+		}
+		bool IsEmpty() const
+		{
+			return size_ == 0;
+		}
+		T* GetData()
+		{
+			return data_;
+		}
+		T const* GetData() const
+		{
+			return data_;
+		}
+		T& operator [](uint32 index)
+		{
+			assert(index < size_);
+			return data_[index];
+		}
+		T const& operator [](uint32 index) const
+		{
+			assert(index < size_);
+			return data_[index];
+		}
+
+		/*
+		 *	For range-based for.
+		 */
+		T* begin()
+		{
+			return data_;
+		}
+		T* end()
+		{
+			return data_ + size_;
+		}
+		T const* begin() const
+		{
+			return data_;
+		}
+		T const* end() const
+		{
+			return data_ + size_;
+		}
+
+	private:
+		FrameArena* arena_;
+		T* data_;
+		uint32 size_;
+		uint32 capacity_;
+	};
+
+}
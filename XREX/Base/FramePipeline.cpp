@@ -0,0 +1,137 @@
+#include "XREX.hpp"
+
+#include "FramePipeline.hpp"
+
+#include "Rendering/FrameSnapshot.hpp"
+
+#include <chrono>
+
+namespace XREX
+{
+
+	FramePipeline::Statistics::Statistics()
+		: logicFrameCount(0), renderedFrameCount(0), totalLogicTime(0), totalRenderTime(0), totalLogicWaitTime(0), totalRenderWaitTime(0),
+		totalLatency(0), maxLatency(0), elapsedTime(0)
+	{
+	}
+
+
+
+	FramePipeline::FramePipeline(uint32 framesInFlight)
+		: stopped_(false), nextFrameIndex_(0), renderBeginTime_(0), statisticsBeginTime_(0)
+	{
+		assert(framesInFlight > 0);
+		for (uint32 i = 0; i < framesInFlight + 1; ++i)
+		{
+			snapshots_.push_back(MakeUP<FrameSnapshot>());
+			freeSnapshots_.push_back(snapshots_.back().get());
+		}
+	}
+
+
+	FramePipeline::~FramePipeline()
+	{
+	}
+
+	FrameSnapshot* FramePipeline::BeginLogicFrame()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		double waitBeginTime = timer_.Elapsed();
+		while (!stopped_ && freeSnapshots_.empty())
+		{
+			snapshotFreed_.wait(lock);
+		}
+		if (stopped_)
+		{
+			return nullptr;
+		}
+		FrameSnapshot* snapshot = freeSnapshots_.back();
+		freeSnapshots_.pop_back();
+		snapshot->frameIndex = nextFrameIndex_++;
+		snapshot->logicBeginTime = timer_.Elapsed();
+		statistics_.totalLogicWaitTime += snapshot->logicBeginTime - waitBeginTime;
+		lock.unlock();
+		// scene objects of the rendered frame are released here on logic thread, outside the lock.
+		snapshot->ReleaseSceneObjects();
+		return snapshot;
+	}
+
+	void FramePipeline::EndLogicFrame(FrameSnapshot* snapshot)
+	{
+		assert(snapshot != nullptr);
+		std::lock_guard<std::mutex> lock(mutex_);
+		snapshot->logicEndTime = timer_.Elapsed();
+		++statistics_.logicFrameCount;
+		statistics_.totalLogicTime += snapshot->logicEndTime - snapshot->logicBeginTime;
+		capturedSnapshots_.push_back(snapshot);
+		snapshotCaptured_.notify_one();
+	}
+
+	FrameSnapshot* FramePipeline::BeginRenderFrame(double maxWaitTime)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		double waitBeginTime = timer_.Elapsed();
+		if (!stopped_ && capturedSnapshots_.empty())
+		{
+			snapshotCaptured_.wait_for(lock, std::chrono::microseconds(static_cast<int64>(maxWaitTime * 1000000)), [this] ()
+			{
+				return stopped_ || !capturedSnapshots_.empty();
+			});
+		}
+		renderBeginTime_ = timer_.Elapsed();
+		statistics_.totalRenderWaitTime += renderBeginTime_ - waitBeginTime;
+		if (stopped_ || capturedSnapshots_.empty())
+		{
+			return nullptr;
+		}
+		FrameSnapshot* snapshot = capturedSnapshots_.front();
+		capturedSnapshots_.pop_front();
+		return snapshot;
+	}
+
+	void FramePipeline::EndRenderFrame(FrameSnapshot* snapshot)
+	{
+		assert(snapshot != nullptr);
+		// GPU resources are released here on render thread with the context current, outside the lock.
+		snapshot->Clear();
+		std::lock_guard<std::mutex> lock(mutex_);
+		double currentTime = timer_.Elapsed();
+		double latency = currentTime - snapshot->logicBeginTime;
+		++statistics_.renderedFrameCount;
+		statistics_.totalRenderTime += currentTime - renderBeginTime_;
+		statistics_.totalLatency += latency;
+		statistics_.maxLatency = std::max(statistics_.maxLatency, latency);
+		freeSnapshots_.push_back(snapshot);
+		snapshotFreed_.notify_one();
+	}
+
+	void FramePipeline::Stop()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopped_ = true;
+		snapshotFreed_.notify_all();
+		snapshotCaptured_.notify_all();
+	}
+
+	bool FramePipeline::IsStopped() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return stopped_;
+	}
+
+	FramePipeline::Statistics FramePipeline::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		Statistics result = statistics_;
+		result.elapsedTime = timer_.Elapsed() - statisticsBeginTime_;
+		return result;
+	}
+
+	void FramePipeline::ResetStatistics()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		statistics_ = Statistics();
+		statisticsBeginTime_ = timer_.Elapsed();
+	}
+
+}
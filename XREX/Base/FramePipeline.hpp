@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Base/Timer.hpp"
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace XREX
+{
+
+	/*
+	 *	Passes FrameSnapshots from logic thread to render thread.
+	 *	Holds framesInFlight + 1 snapshots: one being written by logic thread, the others captured and waiting for or being rendered,
+	 *	so logic thread runs at most framesInFlight frames ahead of the frame on screen.
+	 */
+	class XREX_API FramePipeline
+		: Noncopyable
+	{
+	public:
+		/*
+		 *	All times are in seconds.
+		 */
+		struct XREX_API Statistics
+		{
+			uint32 logicFrameCount;
+			uint32 renderedFrameCount;
+			/*
+			 *	Time spent in logic frames and render frames, excluding time waiting for each other.
+			 */
+			double totalLogicTime;
+			double totalRenderTime;
+			/*
+			 *	Logic thread waiting for a free snapshot, means rendering is the bottleneck.
+			 */
+			double totalLogicWaitTime;
+			/*
+			 *	Render thread waiting for a captured snapshot, means logic is the bottleneck.
+			 */
+			double totalRenderWaitTime;
+			/*
+			 *	From beginning of a logic frame to the end of rendering its snapshot.
+			 */
+			double totalLatency;
+			double maxLatency;
+			/*
+			 *	Since creation or last ResetStatistics.
+			 */
+			double elapsedTime;
+
+			Statistics();
+
+			double GetAverageLatency() const
+			{
+				return renderedFrameCount == 0 ? 0 : totalLatency / renderedFrameCount;
+			}
+			double GetAverageLogicTime() const
+			{
+				return logicFrameCount == 0 ? 0 : totalLogicTime / logicFrameCount;
+			}
+			double GetAverageRenderTime() const
+			{
+				return renderedFrameCount == 0 ? 0 : totalRenderTime / renderedFrameCount;
+			}
+			double GetLogicFramesPerSecond() const
+			{
+				return elapsedTime == 0 ? 0 : logicFrameCount / elapsedTime;
+			}
+			double GetRenderedFramesPerSecond() const
+			{
+				return elapsedTime == 0 ? 0 : renderedFrameCount / elapsedTime;
+			}
+		};
+
+	public:
+		explicit FramePipeline(uint32 framesInFlight);
+		~FramePipeline();
+
+		uint32 GetFramesInFlight() const
+		{
+			return snapshots_.size() - 1;
+		}
+
+		/*
+		 *	Called by logic thread, block until a snapshot is free.
+		 *	@return: cleared snapshot to capture into, nullptr if the pipeline is stopped.
+		 *	Scene objects referenced by the frame last rendered from the snapshot are released here.
+		 */
+		FrameSnapshot* BeginLogicFrame();
+		void EndLogicFrame(FrameSnapshot* snapshot);
+
+		/*
+		 *	Called by render thread, block at most maxWaitTime until a snapshot is captured.
+		 *	@return: oldest captured snapshot, nullptr if none is captured in time or the pipeline is stopped.
+		 */
+		FrameSnapshot* BeginRenderFrame(double maxWaitTime);
+		/*
+		 *	Clear the rendered snapshot and hand it back, scene objects it referenced are released by BeginLogicFrame on logic thread.
+		 */
+		void EndRenderFrame(FrameSnapshot* snapshot);
+
+		/*
+		 *	Wake up and release both threads. Can be called from any thread.
+		 */
+		void Stop();
+		bool IsStopped() const;
+
+		Statistics GetStatistics() const;
+		void ResetStatistics();
+
+	private:
+		std::vector<std::unique_ptr<FrameSnapshot>> snapshots_;
+		std::vector<FrameSnapshot*> freeSnapshots_;
+		std::deque<FrameSnapshot*> capturedSnapshots_;
+
+		std::mutex mutable mutex_;
+		std::condition_variable snapshotFreed_;
+		std::condition_variable snapshotCaptured_;
+		bool stopped_;
+
+		uint32 nextFrameIndex_;
+		double renderBeginTime_;
+
+		Timer timer_;
+		Statistics statistics_;
+		double statisticsBeginTime_;
+	};
+
+}
@@ -0,0 +1,293 @@
+#include "XREX.hpp"
+
+#include "FrustumCulling.hpp"
+
+#include "Base/TaskScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace XREX
+{
+	namespace
+	{
+		/*
+		 *	Frustum planes in structure of arrays layout, absolute normals are for box radii.
+		 */
+		struct CullingPlanes
+		{
+			float normalX[Frustum::PlaneCount];
+			float normalY[Frustum::PlaneCount];
+			float normalZ[Frustum::PlaneCount];
+			float absoluteNormalX[Frustum::PlaneCount];
+			float absoluteNormalY[Frustum::PlaneCount];
+			float absoluteNormalZ[Frustum::PlaneCount];
+			float distance[Frustum::PlaneCount];
+
+			explicit CullingPlanes(Frustum const& frustum)
+			{
+				for (uint32 i = 0; i < Frustum::PlaneCount; ++i)
+				{
+					Plane const& plane = frustum.GetPlanes()[i];
+					normalX[i] = plane.GetNormal().X();
+					normalY[i] = plane.GetNormal().Y();
+					normalZ[i] = plane.GetNormal().Z();
+					absoluteNormalX[i] = std::abs(normalX[i]);
+					absoluteNormalY[i] = std::abs(normalY[i]);
+					absoluteNormalZ[i] = std::abs(normalZ[i]);
+					distance[i] = plane.GetDistance();
+				}
+			}
+		};
+
+		/*
+		 *	Operation order follows Intersect(frustum, box): Dot of 3 components is x + (y + z), radius is (x + y) + z.
+		 */
+		bool IsBoxVisible(CullingPlanes const& planes, BoundingBoxArrays const& boxes, uint32 index)
+		{
+			for (uint32 i = 0; i < Frustum::PlaneCount; ++i)
+			{
+				float distance = planes.normalX[i] * boxes.centerX[index] + (planes.normalY[i] * boxes.centerY[index] + planes.normalZ[i] * boxes.centerZ[index]) + planes.distance[i];
+				float radius = boxes.extentX[index] * planes.absoluteNormalX[i] + boxes.extentY[index] * planes.absoluteNormalY[i] + boxes.extentZ[index] * planes.absoluteNormalZ[i];
+				if (distance + radius < 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool IsSphereVisible(CullingPlanes const& planes, BoundingSphereArrays const& spheres, uint32 index)
+		{
+			for (uint32 i = 0; i < Frustum::PlaneCount; ++i)
+			{
+				float distance = planes.normalX[i] * spheres.centerX[index] + (planes.normalY[i] * spheres.centerY[index] + planes.normalZ[i] * spheres.centerZ[index]) + planes.distance[i];
+				if (distance + spheres.radius[index] < 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+#if defined(XREX_SIMD_AVX)
+		uint32 const BatchSize = 8;
+
+		/*
+		 *	@return: bit i set if box index + i is visible.
+		 */
+		uint32 CullBoxBatch(CullingPlanes const& planes, BoundingBoxArrays const& boxes, uint32 index)
+		{
+			__m256 centerX = _mm256_loadu_ps(&boxes.centerX[index]);
+			__m256 centerY = _mm256_loadu_ps(&boxes.centerY[index]);
+			__m256 centerZ = _mm256_loadu_ps(&boxes.centerZ[index]);
+			__m256 extentX = _mm256_loadu_ps(&boxes.extentX[index]);
+			__m256 extentY = _mm256_loadu_ps(&boxes.extentY[index]);
+			__m256 extentZ = _mm256_loadu_ps(&boxes.extentZ[index]);
+			__m256 outside = _mm256_setzero_ps();
+			for (uint32 i = 0; i < Frustum::PlaneCount; ++i)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.normalY[i]), centerY), _mm256_mul_ps(_mm256_set1_ps(planes.normalZ[i]), centerZ));
+				distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.normalX[i]), centerX), distance), _mm256_set1_ps(planes.distance[i]));
+				__m256 radius = _mm256_add_ps(_mm256_mul_ps(extentX, _mm256_set1_ps(planes.absoluteNormalX[i])), _mm256_mul_ps(extentY, _mm256_set1_ps(planes.absoluteNormalY[i])));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(extentZ, _mm256_set1_ps(planes.absoluteNormalZ[i])));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+			}
+			return ~static_cast<uint32>(_mm256_movemask_ps(outside)) & 0xFF;
+		}
+
+		uint32 CullSphereBatch(CullingPlanes const& planes, BoundingSphereArrays const& spheres, uint32 index)
+		{
+			__m256 centerX = _mm256_loadu_ps(&spheres.centerX[index]);
+			__m256 centerY = _mm256_loadu_ps(&spheres.centerY[index]);
+			__m256 centerZ = _mm256_loadu_ps(&spheres.centerZ[index]);
+			__m256 radius = _mm256_loadu_ps(&spheres.radius[index]);
+			__m256 outside = _mm256_setzero_ps();
+			for (uint32 i = 0; i < Frustum::PlaneCount; ++i)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.normalY[i]), centerY), _mm256_mul_ps(_mm256_set1_ps(planes.normalZ[i]), centerZ));
+				distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.normalX[i]), centerX), distance), _mm256_set1_ps(planes.distance[i]));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+			}
+			return ~static_cast<uint32>(_mm256_movemask_ps(outside)) & 0xFF;
+		}
+#elif defined(XREX_SIMD_SSE)
+		uint32 const BatchSize = 4;
+
+		uint32 CullBoxBatch(CullingPlanes const& planes, BoundingBoxArrays const& boxes, uint32 index)
+		{
+			__m128 centerX = _mm_loadu_ps(&boxes.centerX[index]);
+			__m128 centerY = _mm_loadu_ps(&boxes.centerY[index]);
+			__m128 centerZ = _mm_loadu_ps(&boxes.centerZ[index]);
+			__m128 extentX = _mm_loadu_ps(&boxes.extentX[index]);
+			__m128 extentY = _mm_loadu_ps(&boxes.extentY[index]);
+			__m128 extentZ = _mm_loadu_ps(&boxes.extentZ[index]);
+			__m128 outside = _mm_setzero_ps();
+			for (uint32 i = 0; i < Frustum::PlaneCount; ++i)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.normalY[i]), centerY), _mm_mul_ps(_mm_set1_ps(planes.normalZ[i]), centerZ));
+				distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.normalX[i]), centerX), distance), _mm_set1_ps(planes.distance[i]));
+				__m128 radius = _mm_add_ps(_mm_mul_ps(extentX, _mm_set1_ps(planes.absoluteNormalX[i])), _mm_mul_ps(extentY, _mm_set1_ps(planes.absoluteNormalY[i])));
+				radius = _mm_add_ps(radius, _mm_mul_ps(extentZ, _mm_set1_ps(planes.absoluteNormalZ[i])));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+			return ~static_cast<uint32>(_mm_movemask_ps(outside)) & 0xF;
+		}
+
+		uint32 CullSphereBatch(CullingPlanes const& planes, BoundingSphereArrays const& spheres, uint32 index)
+		{
+			__m128 centerX = _mm_loadu_ps(&spheres.centerX[index]);
+			__m128 centerY = _mm_loadu_ps(&spheres.centerY[index]);
+			__m128 centerZ = _mm_loadu_ps(&spheres.centerZ[index]);
+			__m128 radius = _mm_loadu_ps(&spheres.radius[index]);
+			__m128 outside = _mm_setzero_ps();
+			for (uint32 i = 0; i < Frustum::PlaneCount; ++i)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.normalY[i]), centerY), _mm_mul_ps(_mm_set1_ps(planes.normalZ[i]), centerZ));
+				distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.normalX[i]), centerX), distance), _mm_set1_ps(planes.distance[i]));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+			return ~static_cast<uint32>(_mm_movemask_ps(outside)) & 0xF;
+		}
+#else
+		uint32 const BatchSize = 1;
+
+		uint32 CullBoxBatch(CullingPlanes const& planes, BoundingBoxArrays const& boxes, uint32 index)
+		{
+			return IsBoxVisible(planes, boxes, index) ? 1 : 0;
+		}
+
+		uint32 CullSphereBatch(CullingPlanes const& planes, BoundingSphereArrays const& spheres, uint32 index)
+		{
+			return IsSphereVisible(planes, spheres, index) ? 1 : 0;
+		}
+#endif
+
+		/*
+		 *	Fill mask elements [beginMask, endMask). Full batches use the kernel, the rest are tested one by one.
+		 */
+		template <typename Bounds, typename BatchFunction, typename SingleFunction>
+		void CullMaskRange(CullingPlanes const& planes, Bounds const& bounds, uint32* visibilityMask, uint32 beginMask, uint32 endMask,
+			BatchFunction batchFunction, SingleFunction singleFunction)
+		{
+			uint32 count = bounds.GetCount();
+			for (uint32 maskIndex = beginMask; maskIndex < endMask; ++maskIndex)
+			{
+				uint32 begin = maskIndex * 32;
+				uint32 end = std::min(begin + 32, count);
+				uint32 bits = 0;
+				uint32 index = begin;
+				for (; index + BatchSize <= end; index += BatchSize)
+				{
+					bits |= batchFunction(planes, bounds, index) << (index - begin);
+				}
+				for (; index < end; ++index)
+				{
+					bits |= (singleFunction(planes, bounds, index) ? 1u : 0u) << (index - begin);
+				}
+				visibilityMask[maskIndex] = bits;
+			}
+		}
+
+		void CullBoxRange(CullingPlanes const& planes, BoundingBoxArrays const& boxes, uint32* visibilityMask, uint32 beginMask, uint32 endMask)
+		{
+			CullMaskRange(planes, boxes, visibilityMask, beginMask, endMask, CullBoxBatch, IsBoxVisible);
+		}
+
+		void CullSphereRange(CullingPlanes const& planes, BoundingSphereArrays const& spheres, uint32* visibilityMask, uint32 beginMask, uint32 endMask)
+		{
+			CullMaskRange(planes, spheres, visibilityMask, beginMask, endMask, CullSphereBatch, IsSphereVisible);
+		}
+	}
+
+
+
+	void BoundingBoxArrays::Reserve(uint32 count)
+	{
+		centerX.reserve(count);
+		centerY.reserve(count);
+		centerZ.reserve(count);
+		extentX.reserve(count);
+		extentY.reserve(count);
+		extentZ.reserve(count);
+	}
+
+	void BoundingBoxArrays::Add(AxisAlignedBox const& box)
+	{
+		floatV3 center = box.GetCenter();
+		floatV3 extent = box.GetExtent();
+		centerX.push_back(center.X());
+		centerY.push_back(center.Y());
+		centerZ.push_back(center.Z());
+		extentX.push_back(extent.X());
+		extentY.push_back(extent.Y());
+		extentZ.push_back(extent.Z());
+	}
+
+	void BoundingBoxArrays::Clear()
+	{
+		centerX.clear();
+		centerY.clear();
+		centerZ.clear();
+		extentX.clear();
+		extentY.clear();
+		extentZ.clear();
+	}
+
+
+
+	void BoundingSphereArrays::Reserve(uint32 count)
+	{
+		centerX.reserve(count);
+		centerY.reserve(count);
+		centerZ.reserve(count);
+		radius.reserve(count);
+	}
+
+	void BoundingSphereArrays::Add(Sphere const& sphere)
+	{
+		centerX.push_back(sphere.GetCenter().X());
+		centerY.push_back(sphere.GetCenter().Y());
+		centerZ.push_back(sphere.GetCenter().Z());
+		radius.push_back(sphere.GetRadius());
+	}
+
+	void BoundingSphereArrays::Clear()
+	{
+		centerX.clear();
+		centerY.clear();
+		centerZ.clear();
+		radius.clear();
+	}
+
+
+
+	void CullBoxes(Frustum const& frustum, BoundingBoxArrays const& boxes, uint32* visibilityMask)
+	{
+		CullBoxRange(CullingPlanes(frustum), boxes, visibilityMask, 0, GetVisibilityMaskSize(boxes.GetCount()));
+	}
+
+	void CullSpheres(Frustum const& frustum, BoundingSphereArrays const& spheres, uint32* visibilityMask)
+	{
+		CullSphereRange(CullingPlanes(frustum), spheres, visibilityMask, 0, GetVisibilityMaskSize(spheres.GetCount()));
+	}
+
+	void ParallelCullBoxes(TaskScheduler& scheduler, Frustum const& frustum, BoundingBoxArrays const& boxes, uint32* visibilityMask, uint32 chunkSize)
+	{
+		CullingPlanes planes(frustum);
+		scheduler.ParallelFor(0, GetVisibilityMaskSize(boxes.GetCount()), GetVisibilityMaskSize(std::max(chunkSize, 1u)), [&planes, &boxes, visibilityMask] (uint32 beginMask, uint32 endMask)
+		{
+			CullBoxRange(planes, boxes, visibilityMask, beginMask, endMask);
+		});
+	}
+
+	void ParallelCullSpheres(TaskScheduler& scheduler, Frustum const& frustum, BoundingSphereArrays const& spheres, uint32* visibilityMask, uint32 chunkSize)
+	{
+		CullingPlanes planes(frustum);
+		scheduler.ParallelFor(0, GetVisibilityMaskSize(spheres.GetCount()), GetVisibilityMaskSize(std::max(chunkSize, 1u)), [&planes, &spheres, visibilityMask] (uint32 beginMask, uint32 endMask)
+		{
+			CullSphereRange(planes, spheres, visibilityMask, beginMask, endMask);
+		});
+	}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Base/GeometricalMath.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Axis aligned boxes in structure of arrays layout, as centers and extents, for culling many of them at once.
+	 */
+	struct XREX_API BoundingBoxArrays
+	{
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+		std::vector<float> extentX;
+		std::vector<float> extentY;
+		std::vector<float> extentZ;
+
+		uint32 GetCount() const
+		{
+			return centerX.size();
+		}
+		void Reserve(uint32 count);
+		void Add(AxisAlignedBox const& box);
+		void Clear();
+	};
+
+	/*
+	 *	Spheres in structure of arrays layout.
+	 */
+	struct XREX_API BoundingSphereArrays
+	{
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+		std::vector<float> radius;
+
+		uint32 GetCount() const
+		{
+			return centerX.size();
+		}
+		void Reserve(uint32 count);
+		void Add(Sphere const& sphere);
+		void Clear();
+	};
+
+	/*
+	 *	Frustum culling kernels, testing 8 bounds per iteration with AVX, 4 with SSE, one by one otherwise.
+	 *	Results are exactly Intersect(frustum, bound) != IntersectionResult::Outside of each bound, the same float operations are done.
+	 *	Visibility is output as a bit mask, bit i % 32 of visibilityMask[i / 32] is set if bound i is not outside.
+	 */
+
+	inline uint32 GetVisibilityMaskSize(uint32 boundCount)
+	{
+		return (boundCount + 31) / 32;
+	}
+	inline bool IsVisible(uint32 const* visibilityMask, uint32 index)
+	{
+		return (visibilityMask[index / 32] & (1u << (index % 32))) != 0;
+	}
+
+	/*
+	 *	@visibilityMask: GetVisibilityMaskSize(boxes.GetCount()) elements.
+	 */
+	XREX_API void CullBoxes(Frustum const& frustum, BoundingBoxArrays const& boxes, uint32* visibilityMask);
+	XREX_API void CullSpheres(Frustum const& frustum, BoundingSphereArrays const& spheres, uint32* visibilityMask);
+
+	/*
+	 *	Cull chunks of bounds in parallel with TaskScheduler::ParallelFor.
+	 *	@chunkSize: bounds culled by a task, rounded up to a multiple of 32 so tasks never write the same mask element.
+	 */
+	XREX_API void ParallelCullBoxes(TaskScheduler& scheduler, Frustum const& frustum, BoundingBoxArrays const& boxes, uint32* visibilityMask, uint32 chunkSize = 16384);
+	XREX_API void ParallelCullSpheres(TaskScheduler& scheduler, Frustum const& frustum, BoundingSphereArrays const& spheres, uint32* visibilityMask, uint32 chunkSize = 16384);
+
+}
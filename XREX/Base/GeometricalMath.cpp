@@ -29,5 +29,85 @@ namespace XREX
 		return false;
 	}
 	template XREX_API bool Intersect(Ray const& ray, Plane const& plane, float* outDistance, floatV3* outPoint);
+
+	template <typename T>
+	IntersectionResult Intersect(FrustumT<T> const& frustum, AxisAlignedBoxT<T> const& box)
+	{
+		VectorT<T, 3> center = box.GetCenter();
+		VectorT<T, 3> extent = box.GetExtent();
+		IntersectionResult result = IntersectionResult::Inside;
+		for (auto& plane : frustum.GetPlanes())
+		{
+			VectorT<T, 3> const& normal = plane.GetNormal();
+			T distance = Dot(normal, center) + plane.GetDistance();
+			T radius = extent.X() * std::abs(normal.X()) + extent.Y() * std::abs(normal.Y()) + extent.Z() * std::abs(normal.Z());
+			if (distance + radius < 0)
+			{
+				return IntersectionResult::Outside;
+			}
+			if (distance - radius < 0)
+			{
+				result = IntersectionResult::Intersecting;
+			}
+		}
+		return result;
+	}
+	template XREX_API IntersectionResult Intersect(Frustum const& frustum, AxisAlignedBox const& box);
+
+	template <typename T>
+	IntersectionResult Intersect(FrustumT<T> const& frustum, SphereT<T> const& sphere)
+	{
+		IntersectionResult result = IntersectionResult::Inside;
+		for (auto& plane : frustum.GetPlanes())
+		{
+			T distance = Dot(plane.GetNormal(), sphere.GetCenter()) + plane.GetDistance();
+			if (distance + sphere.GetRadius() < 0)
+			{
+				return IntersectionResult::Outside;
+			}
+			if (distance - sphere.GetRadius() < 0)
+			{
+				result = IntersectionResult::Intersecting;
+			}
+		}
+		return result;
+	}
+	template XREX_API IntersectionResult Intersect(Frustum const& frustum, Sphere const& sphere);
+
+	template <typename T>
+	AxisAlignedBoxT<T> Transform(Matrix4T<T> const& matrix, AxisAlignedBoxT<T> const& box)
+	{
+		if (box.IsEmpty())
+		{
+			return box;
+		}
+		// see 'Transforming Axis-Aligned Bounding Boxes', James Arvo, Graphics Gems.
+		VectorT<T, 3> center = Transform(matrix, box.GetCenter());
+		VectorT<T, 3> extent = box.GetExtent();
+		T newExtent[3];
+		for (uint32 i = 0; i < 3; ++i)
+		{
+			newExtent[i] = std::abs(matrix(i, 0)) * extent.X() + std::abs(matrix(i, 1)) * extent.Y() + std::abs(matrix(i, 2)) * extent.Z();
+		}
+		VectorT<T, 3> halfSize(newExtent);
+		return AxisAlignedBoxT<T>(center - halfSize, center + halfSize);
+	}
+	template XREX_API AxisAlignedBox Transform(floatM44 const& matrix, AxisAlignedBox const& box);
+
+	template <typename T>
+	SphereT<T> Transform(Matrix4T<T> const& matrix, SphereT<T> const& sphere)
+	{
+		if (sphere.IsEmpty())
+		{
+			return sphere;
+		}
+		T maxScalingSquared = 0;
+		for (uint32 i = 0; i < 3; ++i)
+		{
+			maxScalingSquared = std::max(maxScalingSquared, Square(matrix(0, i)) + Square(matrix(1, i)) + Square(matrix(2, i)));
+		}
+		return SphereT<T>(Transform(matrix, sphere.GetCenter()), sphere.GetRadius() * std::sqrt(maxScalingSquared));
+	}
+	template XREX_API Sphere Transform(floatM44 const& matrix, Sphere const& sphere);
 }
 
@@ -11,6 +11,32 @@ namespace XREX
 	 */
 	template <typename T>
 	bool Intersect(RayT<T> const& ray, PlaneT<T> const& plane, typename RayT<T>::Pointer outDistance, VectorT<typename RayT<T>::ValueType, 3>* outPoint);
+
+	enum class IntersectionResult
+	{
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+	/*
+	 *	Conservative test, boxes near frustum corners may be reported as Intersecting while actually outside.
+	 */
+	template <typename T>
+	IntersectionResult Intersect(FrustumT<T> const& frustum, AxisAlignedBoxT<T> const& box);
+	template <typename T>
+	IntersectionResult Intersect(FrustumT<T> const& frustum, SphereT<T> const& sphere);
+
+	/*
+	 *	@return: the axis aligned box bounding the transformed box.
+	 */
+	template <typename T>
+	AxisAlignedBoxT<T> Transform(Matrix4T<T> const& matrix, AxisAlignedBoxT<T> const& box);
+	/*
+	 *	Radius is scaled by the largest scaling of the matrix.
+	 */
+	template <typename T>
+	SphereT<T> Transform(Matrix4T<T> const& matrix, SphereT<T> const& sphere);
 }
 
 
@@ -2,6 +2,10 @@
 
 #include "Base/BasicType.hpp"
 #include "Vector.hpp"
+#include "Matrix.hpp"
+
+#include <array>
+#include <algorithm>
 
 // TODO
 namespace XREX
@@ -46,6 +50,7 @@ namespace XREX
 				origin_ = right.origin_;
 				direction_ = right.direction_;
 			}
+			return *this;
 		}
 		template <typename U>
 		RayT& operator =(RayT<U> const& right)
@@ -55,6 +60,7 @@ namespace XREX
 				origin_ = right.origin_;
 				direction_ = right.direction_;
 			}
+			return *this;
 		}
 
 		VectorT<T, 3> const& GetOrigin() const
@@ -105,6 +111,12 @@ namespace XREX
 		typedef ValueType const& ConstReference;
 
 	public:
+		/*
+		 *	Create an uninitialized PlaneT.
+		 */
+		PlaneT()
+		{
+		}
 		PlaneT(VectorT<T, 3> const& normal, T const& distance)
 			: normal_(normal), distance_(distance)
 		{
@@ -127,6 +139,7 @@ namespace XREX
 				normal_ = right.normal_;
 				distance_ = right.distance_;
 			}
+			return *this;
 		}
 		template <typename U>
 		PlaneT& operator =(PlaneT<U> const& right)
@@ -136,6 +149,7 @@ namespace XREX
 				normal_ = right.normal_;
 				distance_ = right.distance_;
 			}
+			return *this;
 		}
 
 		VectorT<T, 3> const& GetNormal() const
@@ -153,14 +167,308 @@ namespace XREX
 	};
 	typedef PlaneT<float> Plane;
 
+	/*
+	 *	Axis aligned box, represented by min and max corner.
+	 *	A default constructed box is empty, merging anything into it results the merged one.
+	 */
+	template <typename T>
+	class AxisAlignedBoxT
+	{
+		template <typename U>
+		friend class AxisAlignedBoxT;
+
+	public:
+		typedef T ValueType;
+
+		typedef ValueType* Pointer;
+		typedef ValueType const* ConstPointer;
+
+		typedef ValueType& Reference;
+		typedef ValueType const& ConstReference;
+
+	public:
+		AxisAlignedBoxT()
+			: min_(std::numeric_limits<T>::max()), max_(-std::numeric_limits<T>::max())
+		{
+		}
+		AxisAlignedBoxT(VectorT<T, 3> const& minCorner, VectorT<T, 3> const& maxCorner)
+			: min_(minCorner), max_(maxCorner)
+		{
+			assert(minCorner.X() <= maxCorner.X() && minCorner.Y() <= maxCorner.Y() && minCorner.Z() <= maxCorner.Z());
+		}
+
+		AxisAlignedBoxT(AxisAlignedBoxT const& right)
+			: min_(right.min_), max_(right.max_)
+		{
+		}
+		template <typename U>
+		AxisAlignedBoxT(AxisAlignedBoxT<U> const& right)
+			: min_(right.min_), max_(right.max_)
+		{
+		}
+
+		AxisAlignedBoxT& operator =(AxisAlignedBoxT const& right)
+		{
+			if (this != &right)
+			{
+				min_ = right.min_;
+				max_ = right.max_;
+			}
+			return *this;
+		}
+		template <typename U>
+		AxisAlignedBoxT& operator =(AxisAlignedBoxT<U> const& right)
+		{
+			min_ = right.min_;
+			max_ = right.max_;
+			return *this;
+		}
+
+		friend bool operator ==(AxisAlignedBoxT const& left, AxisAlignedBoxT const& right)
+		{
+			return left.min_ == right.min_ && left.max_ == right.max_;
+		}
+		friend bool operator !=(AxisAlignedBoxT const& left, AxisAlignedBoxT const& right)
+		{
+			return !(left == right);
+		}
+
+		VectorT<T, 3> const& GetMin() const
+		{
+			return min_;
+		}
+		VectorT<T, 3> const& GetMax() const
+		{
+			return max_;
+		}
+
+		bool IsEmpty() const
+		{
+			return min_.X() > max_.X() || min_.Y() > max_.Y() || min_.Z() > max_.Z();
+		}
+
+		VectorT<T, 3> GetCenter() const
+		{
+			return (min_ + max_) * T(0.5);
+		}
+		/*
+		 *	@return: half size of the box.
+		 */
+		VectorT<T, 3> GetExtent() const
+		{
+			return (max_ - min_) * T(0.5);
+		}
+
+		T GetSurfaceArea() const
+		{
+			VectorT<T, 3> size = max_ - min_;
+			return (size.X() * size.Y() + size.Y() * size.Z() + size.Z() * size.X()) * T(2);
+		}
+
+		bool Contains(VectorT<T, 3> const& point) const
+		{
+			return min_.X() <= point.X() && min_.Y() <= point.Y() && min_.Z() <= point.Z()
+				&& point.X() <= max_.X() && point.Y() <= max_.Y() && point.Z() <= max_.Z();
+		}
+		bool Contains(AxisAlignedBoxT const& box) const
+		{
+			return min_.X() <= box.min_.X() && min_.Y() <= box.min_.Y() && min_.Z() <= box.min_.Z()
+				&& box.max_.X() <= max_.X() && box.max_.Y() <= max_.Y() && box.max_.Z() <= max_.Z();
+		}
+
+		/*
+		 *	@return: a box with each side moved outward by margin.
+		 */
+		AxisAlignedBoxT Enlarge(T const& margin) const
+		{
+			VectorT<T, 3> delta(margin);
+			return AxisAlignedBoxT(min_ - delta, max_ + delta);
+		}
+
+		AxisAlignedBoxT Merge(VectorT<T, 3> const& point) const
+		{
+			AxisAlignedBoxT result;
+			result.min_ = VectorT<T, 3>(std::min(min_.X(), point.X()), std::min(min_.Y(), point.Y()), std::min(min_.Z(), point.Z()));
+			result.max_ = VectorT<T, 3>(std::max(max_.X(), point.X()), std::max(max_.Y(), point.Y()), std::max(max_.Z(), point.Z()));
+			return result;
+		}
+		AxisAlignedBoxT Merge(AxisAlignedBoxT const& box) const
+		{
+			AxisAlignedBoxT result;
+			result.min_ = VectorT<T, 3>(std::min(min_.X(), box.min_.X()), std::min(min_.Y(), box.min_.Y()), std::min(min_.Z(), box.min_.Z()));
+			result.max_ = VectorT<T, 3>(std::max(max_.X(), box.max_.X()), std::max(max_.Y(), box.max_.Y()), std::max(max_.Z(), box.max_.Z()));
+			return result;
+		}
+
+	private:
+		VectorT<T, 3> min_;
+		VectorT<T, 3> max_;
+	};
+	typedef AxisAlignedBoxT<float> AxisAlignedBox;
+
+	/*
+	 *	A sphere with negative radius is empty.
+	 */
+	template <typename T>
+	class SphereT
+	{
+		template <typename U>
+		friend class SphereT;
+
+	public:
+		typedef T ValueType;
+
+		typedef ValueType* Pointer;
+		typedef ValueType const* ConstPointer;
+
+		typedef ValueType& Reference;
+		typedef ValueType const& ConstReference;
+
+	public:
+		SphereT()
+			: center_(T(0)), radius_(T(-1))
+		{
+		}
+		SphereT(VectorT<T, 3> const& center, T const& radius)
+			: center_(center), radius_(radius)
+		{
+		}
+
+		SphereT(SphereT const& right)
+			: center_(right.center_), radius_(right.radius_)
+		{
+		}
+		template <typename U>
+		SphereT(SphereT<U> const& right)
+			: center_(right.center_), radius_(right.radius_)
+		{
+		}
+
+		SphereT& operator =(SphereT const& right)
+		{
+			if (this != &right)
+			{
+				center_ = right.center_;
+				radius_ = right.radius_;
+			}
+			return *this;
+		}
+		template <typename U>
+		SphereT& operator =(SphereT<U> const& right)
+		{
+			center_ = right.center_;
+			radius_ = right.radius_;
+			return *this;
+		}
+
+		VectorT<T, 3> const& GetCenter() const
+		{
+			return center_;
+		}
+		T const& GetRadius() const
+		{
+			return radius_;
+		}
+
+		bool IsEmpty() const
+		{
+			return radius_ < T(0);
+		}
+
+		/*
+		 *	@return: the smallest sphere containing both.
+		 */
+		SphereT Merge(SphereT const& sphere) const
+		{
+			if (sphere.IsEmpty())
+			{
+				return *this;
+			}
+			if (IsEmpty())
+			{
+				return sphere;
+			}
+			VectorT<T, 3> offset = sphere.center_ - center_;
+			T distance = offset.Length();
+			if (distance + sphere.radius_ <= radius_)
+			{
+				return *this;
+			}
+			if (distance + radius_ <= sphere.radius_)
+			{
+				return sphere;
+			}
+			T radius = (distance + radius_ + sphere.radius_) * T(0.5);
+			return SphereT(center_ + offset * ((radius - radius_) / distance), radius);
+		}
+
+	private:
+		VectorT<T, 3> center_;
+		T radius_;
+	};
+	typedef SphereT<float> Sphere;
+
+	/*
+	 *	Six planes with normals pointing inside.
+	 */
 	template <typename T>
 	class FrustumT
 	{
 	public:
-		FrustumT();
+		enum class PlaneIndex
+		{
+			Left,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+
+			PlaneCount
+		};
+
+		static uint32 const PlaneCount = static_cast<uint32>(PlaneIndex::PlaneCount);
+
+	public:
+		/*
+		 *	Extract planes from a clip matrix, use projection * view to get a frustum in world space.
+		 *	Clip space is in OpenGL convention, z in [-w, w].
+		 */
+		explicit FrustumT(Matrix4T<T> const& clipMatrix)
+		{
+			// see 'Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix', Gil Gribb & Klaus Hartmann.
+			VectorT<T, 4> row0(clipMatrix(0, 0), clipMatrix(0, 1), clipMatrix(0, 2), clipMatrix(0, 3));
+			VectorT<T, 4> row1(clipMatrix(1, 0), clipMatrix(1, 1), clipMatrix(1, 2), clipMatrix(1, 3));
+			VectorT<T, 4> row2(clipMatrix(2, 0), clipMatrix(2, 1), clipMatrix(2, 2), clipMatrix(2, 3));
+			VectorT<T, 4> row3(clipMatrix(3, 0), clipMatrix(3, 1), clipMatrix(3, 2), clipMatrix(3, 3));
+			planes_[static_cast<uint32>(PlaneIndex::Left)] = MakePlane(row3 + row0);
+			planes_[static_cast<uint32>(PlaneIndex::Right)] = MakePlane(row3 - row0);
+			planes_[static_cast<uint32>(PlaneIndex::Bottom)] = MakePlane(row3 + row1);
+			planes_[static_cast<uint32>(PlaneIndex::Top)] = MakePlane(row3 - row1);
+			planes_[static_cast<uint32>(PlaneIndex::Near)] = MakePlane(row3 + row2);
+			planes_[static_cast<uint32>(PlaneIndex::Far)] = MakePlane(row3 - row2);
+		}
+
+		PlaneT<T> const& GetPlane(PlaneIndex index) const
+		{
+			return planes_[static_cast<uint32>(index)];
+		}
+		std::array<PlaneT<T>, PlaneCount> const& GetPlanes() const
+		{
+			return planes_;
+		}
 
 	private:
+		static PlaneT<T> MakePlane(VectorT<T, 4> const& coefficients)
+		{
+			VectorT<T, 3> normal(coefficients);
+			T inverseLength = T(1) / normal.Length();
+			return PlaneT<T>(normal * inverseLength, coefficients.W() * inverseLength);
+		}
 
+	private:
+		std::array<PlaneT<T>, PlaneCount> planes_;
 	};
+	typedef FrustumT<float> Frustum;
 
 }
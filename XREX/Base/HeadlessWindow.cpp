@@ -0,0 +1,92 @@
+#include "XREX.hpp"
+
+#ifdef XREX_HEADLESS
+
+#include "Window.hpp"
+#include "Base/XREXContext.hpp"
+#include "Base/Settings.hpp"
+
+
+namespace XREX
+{
+
+	/*
+	 *	No native window, nothing to hide.
+	 */
+	struct Window::HideWindows_
+	{
+	};
+
+
+
+	void Window::SetRawWindowsMessageHook(void const* hook)
+	{
+		// there are no windows messages.
+	}
+
+
+	void* Window::GetHWND() const
+	{
+		return nullptr;
+	}
+
+
+
+	Window::Window(Settings const& settings)
+		: leftShift_(false), rightShift_(false), leftCtrl_(false), rightCtrl_(false), leftAlt_(false), rightAlt_(false),
+		active_(false), running_(false), rendering_(false), fullScreen_(false), name_(settings.windowTitle)
+	{
+		hideWindows_ = MakeUP<HideWindows_>();
+
+		// the size of offscreen default frame buffer.
+		left_ = 0;
+		top_ = 0;
+		windowLeft_ = 0;
+		windowTop_ = 0;
+		width_ = settings.renderingSettings.width;
+		height_ = settings.renderingSettings.height;
+	}
+
+
+	Window::~Window()
+	{
+	}
+
+
+	void Window::OnMessageIdle()
+	{
+		if (messageIdle_ != nullptr)
+		{
+			messageIdle_();
+		}
+	}
+
+	void Window::Recreate()
+	{
+	}
+
+
+	void Window::StartHandlingMessages()
+	{
+		// no messages to handle, render frames until stopped by the logic function or the frame pipeline.
+		running_ = true;
+		rendering_ = true;
+		while (running_)
+		{
+			OnMessageIdle();
+		}
+	}
+
+	std::wstring Window::GetTitleText() const
+	{
+		return name_;
+	}
+
+	void Window::SetTitleText(std::wstring const& text)
+	{
+		name_ = text;
+	}
+
+}
+
+#endif // XREX_HEADLESS
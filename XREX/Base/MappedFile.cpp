@@ -0,0 +1,99 @@
+#include "XREX.hpp"
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+#endif
+#include <windows.h>
+
+namespace XREX
+{
+
+	MappedFile::MappedFile(std::string const& fileName)
+		: data_(nullptr), size_(0), file_(INVALID_HANDLE_VALUE), mapping_(nullptr)
+	{
+		file_ = ::CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+		LARGE_INTEGER size;
+		if (!::GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+		{
+			return;
+		}
+		mapping_ = ::CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_ == nullptr)
+		{
+			return;
+		}
+		data_ = static_cast<uint8 const*>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+		if (data_ != nullptr)
+		{
+			size_ = static_cast<uint64>(size.QuadPart);
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data_ != nullptr)
+		{
+			::UnmapViewOfFile(data_);
+		}
+		if (mapping_ != nullptr)
+		{
+			::CloseHandle(mapping_);
+		}
+		if (file_ != INVALID_HANDLE_VALUE)
+		{
+			::CloseHandle(file_);
+		}
+	}
+
+}
+
+#else // _WIN32
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace XREX
+{
+
+	MappedFile::MappedFile(std::string const& fileName)
+		: data_(nullptr), size_(0), file_(nullptr), mapping_(nullptr)
+	{
+		int file = ::open(fileName.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return;
+		}
+		struct stat status;
+		if (::fstat(file, &status) == 0 && status.st_size > 0)
+		{
+			void* data = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			if (data != MAP_FAILED)
+			{
+				data_ = static_cast<uint8 const*>(data);
+				size_ = static_cast<uint64>(status.st_size);
+			}
+		}
+		::close(file); // the mapping stays valid
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data_ != nullptr)
+		{
+			::munmap(const_cast<uint8*>(data_), static_cast<size_t>(size_));
+		}
+	}
+
+}
+
+#endif // _WIN32
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include <string>
+
+namespace XREX
+{
+
+	/*
+	 *	Read only view of a whole file mapped into memory, pages are read from disk when first accessed.
+	 */
+	class XREX_API MappedFile
+		: Noncopyable
+	{
+	public:
+		explicit MappedFile(std::string const& fileName);
+		~MappedFile();
+
+		/*
+		 *	False if file not found, empty or not mappable.
+		 */
+		bool IsMapped() const
+		{
+			return data_ != nullptr;
+		}
+		uint8 const* GetData() const
+		{
+			return data_;
+		}
+		uint64 GetSize() const
+		{
+			return size_;
+		}
+
+	private:
+		uint8 const* data_;
+		uint64 size_;
+		/*
+		 *	File and file mapping handle on Windows.
+		 */
+		void* file_;
+		void* mapping_;
+	};
+
+}
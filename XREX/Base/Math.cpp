@@ -98,32 +98,21 @@ namespace XREX
 	template <typename T>
 	Matrix4T<T> MatrixFromQuaternion(QuaternionT<T> const& quaternion)
 	{
-		// see Real-Time Rendering, 3rd. 4.3.2 Quaternion Transforms
-		// or Mathematics for 3D Game Programming and Computer Graphics, 3rd. 4.6.2 Rotations with Quaternions
-
-		T const x2(quaternion.X() + quaternion.X());
-		T const y2(quaternion.Y() + quaternion.Y());
-		T const z2(quaternion.Z() + quaternion.Z());
-
-		T const xx2(quaternion.X() * x2);
-		T const xy2(quaternion.X() * y2);
-		T const xz2(quaternion.X() * z2);
-		T const yy2(quaternion.Y() * y2);
-		T const yz2(quaternion.Y() * z2);
-		T const zz2(quaternion.Z() * z2);
-
-		T const wx2(quaternion.W() * x2);
-		T const wy2(quaternion.W() * y2);
-		T const wz2(quaternion.W() * z2);
-
-		return Matrix4T<T>(
-			1 - yy2 - zz2, xy2 + wz2, xz2 - wy2, 0,
-			xy2 - wz2, 1 - xx2 - zz2, yz2 + wx2, 0,
-			xz2 + wy2, yz2 - wx2, 1 - xx2 - yy2, 0,
-			0, 0, 0, 1);
+		Matrix4T<T> temp;
+		MathHelper::QuaternionHelper<T>::DoToMatrix(const_cast<T*>(&temp[0]), &quaternion[0]);
+		return temp;
 	}
 	template XREX_API floatM44 MatrixFromQuaternion(floatQ const& quaternion);
 
+	template <typename T>
+	Matrix4T<T> TransformationMatrix(VectorT<T, 3> const& translation, QuaternionT<T> const& orientation, VectorT<T, 3> const& scaling)
+	{
+		Matrix4T<T> temp;
+		MathHelper::QuaternionHelper<T>::DoComposeTransformation(const_cast<T*>(&temp[0]), &translation[0], &orientation[0], &scaling[0]);
+		return temp;
+	}
+	template XREX_API floatM44 TransformationMatrix(floatV3 const& translation, floatQ const& orientation, floatV3 const& scaling);
+
 	template <typename T, uint32 N>
 	VectorT<T, N> Transform(Matrix4T<T> const& matrix, VectorT<T, N> const& vector, T const& lastComponent)
 	{
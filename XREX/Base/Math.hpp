@@ -79,6 +79,11 @@ namespace XREX
 	QuaternionT<T> QuaternionFromMatrix(Matrix4T<T> const& rotationMatrix);
 	template <typename T>
 	Matrix4T<T> MatrixFromQuaternion(QuaternionT<T> const& quaternion);
+	/*
+	 *	Same as TranslationMatrix(translation) * MatrixFromQuaternion(orientation) * ScalingMatrix(scaling), without matrix multiplications.
+	 */
+	template <typename T>
+	Matrix4T<T> TransformationMatrix(VectorT<T, 3> const& translation, QuaternionT<T> const& orientation, VectorT<T, 3> const& scaling);
 
 	/*
 	 *	for 3 dimension vector, affine division will be done on the result vector.
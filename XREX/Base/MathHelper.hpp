@@ -5,17 +5,23 @@
 
 namespace XREX
 {
+	/*
+	 *	Defined in Math.hpp, which includes this file through Matrix.hpp.
+	 */
+	template <typename T>
+	bool Equal(T const& left, T const& right);
+
 	namespace MathHelper
 	{
 		template <typename T, uint32 N> // is a class due to template function cannot be partially specialized.
-		struct TransformHelper
+		struct ScalarTransformHelper
 		{
 			static void DoTransform(T out[N], T const m[16], T const v[N], T lastComponent);
 			static void DoTransformDirection(T out[N], T const m[16], T const v[N]);
 		};
 
 		template <typename T>
-		struct TransformHelper<T, 4>
+		struct ScalarTransformHelper<T, 4>
 		{
 			static void DoTransform(T out[4], T const m[16], T const v[4], T lastComponent)
 			{
@@ -33,7 +39,7 @@ namespace XREX
 			}
 		};
 		template <typename T>
-		struct TransformHelper<T, 3>
+		struct ScalarTransformHelper<T, 3>
 		{
 			static void DoTransform(T out[3], T const m[16], T const v[3], T lastComponent)
 			{
@@ -52,90 +58,90 @@ namespace XREX
 
 
 		template <typename T, uint32 N>
-		struct VectorHelper
+		struct ScalarVectorHelper
 		{
 			static_assert(N <= 4, "Vector larger than 4 are not support.");
 			template <typename U>
 			static void DoCopy(T out[N], U const right[N])
 			{
 				out[0] = static_cast<T>(right[0]);
-				VectorHelper<T, N - 1>::DoCopy(out + 1, right + 1);
+				ScalarVectorHelper<T, N - 1>::DoCopy(out + 1, right + 1);
 			}
 
 			static void DoAssign(T out[N], T const& right)
 			{
 				out[0] = right;
-				VectorHelper<T, N - 1>::DoAssign(out + 1, right);
+				ScalarVectorHelper<T, N - 1>::DoAssign(out + 1, right);
 			}
 
 			static void DoAdd(T out[N], T const left[N], T const right[N])
 			{
 				out[0] = left[0] + right[0];
-				VectorHelper<T, N - 1>::DoAdd(out + 1, left + 1, right + 1);
+				ScalarVectorHelper<T, N - 1>::DoAdd(out + 1, left + 1, right + 1);
 			}
 
 			static void DoAdd(T out[N], T const left[N], T const& right)
 			{
 				out[0] = left[0] + right;
-				VectorHelper<T, N - 1>::DoAdd(out + 1, left + 1, right);
+				ScalarVectorHelper<T, N - 1>::DoAdd(out + 1, left + 1, right);
 			}
 
 			static void DoSubtract(T out[N], T const left[N], T const right[N])
 			{
 				out[0] = left[0] - right[0];
-				VectorHelper<T, N - 1>::DoSubtract(out + 1, left + 1, right + 1);
+				ScalarVectorHelper<T, N - 1>::DoSubtract(out + 1, left + 1, right + 1);
 			}
 
 			static void DoSubtract(T out[N], T const left[N], T const& right)
 			{
 				out[0] = left[0] - right;
-				VectorHelper<T, N - 1>::DoSubtract(out + 1, left + 1, right);
+				ScalarVectorHelper<T, N - 1>::DoSubtract(out + 1, left + 1, right);
 			}
 
 			static void DoMultiply(T out[N], T const left[N], T const right[N])
 			{
 				out[0] = left[0] * right[0];
-				VectorHelper<T, N - 1>::DoMultiply(out + 1, left + 1, right + 1);
+				ScalarVectorHelper<T, N - 1>::DoMultiply(out + 1, left + 1, right + 1);
 			}
 
 			static void DoScale(T out[N], T const left[N], T const& right)
 			{
 				out[0] = left[0] * right;
-				VectorHelper<T, N - 1>::DoScale(out + 1, left + 1, right);
+				ScalarVectorHelper<T, N - 1>::DoScale(out + 1, left + 1, right);
 			}
 
 			static void DoDivide(T out[N], T const left[N], T const right[N])
 			{
 				out[0] = left[0] / right[0];
-				VectorHelper<T, N - 1>::DoDivide(out + 1, left + 1, right + 1);
+				ScalarVectorHelper<T, N - 1>::DoDivide(out + 1, left + 1, right + 1);
 			}
 
 			static void DoNegate(T out[N], T const right[N])
 			{
 				out[0] = -right[0];
-				VectorHelper<T, N - 1>::DoNegate(out + 1, right + 1);
+				ScalarVectorHelper<T, N - 1>::DoNegate(out + 1, right + 1);
 			}
 
 			static bool DoEqual(T const left[N], T const right[N])
 			{
-				return VectorHelper<T, 1>::DoEqual(left, right) && VectorHelper<T, N - 1>::DoEqual(left + 1, right + 1);
+				return ScalarVectorHelper<T, 1>::DoEqual(left, right) && ScalarVectorHelper<T, N - 1>::DoEqual(left + 1, right + 1);
 			}
 
 			static void DoSwap(T left[N], T right[N])
 			{
 				std::swap(left[0], right[0]);
-				VectorHelper<T, N - 1>::DoSwap(left + 1, right + 1);
+				ScalarVectorHelper<T, N - 1>::DoSwap(left + 1, right + 1);
 			}
 
 
 			static T DoDot(T const left[1], T const right[1])
 			{
-				return left[0] * right[0] + VectorHelper<T, N - 1>::DoDot(left + 1, right + 1);
+				return left[0] * right[0] + ScalarVectorHelper<T, N - 1>::DoDot(left + 1, right + 1);
 			}
 		};
 
 		template <typename T>
-		struct VectorHelper<T, 1>
+		struct ScalarVectorHelper<T, 1>
 		{
 			template <typename U>
 			static void DoCopy(T out[1], U const right[1])
@@ -200,7 +206,7 @@ namespace XREX
 		};
 
 		template <typename T>
-		struct MatrixHepler
+		struct ScalarMatrixHepler
 		{
 			static void DoMultiply(T out[16], T const left[16], T const right[16])
 			{
@@ -222,7 +228,18 @@ namespace XREX
 				out[15] = right[12] * left[3] + right[13] * left[7] + right[14] * left[11] + right[15] * left[15];
 			}
 
-			static void CalculateDeterminant(T vectors_[16]) 
+			static void DoTranspose(T out[16], T const in[16])
+			{
+				for (uint32 column = 0; column < 4; ++column)
+				{
+					for (uint32 row = 0; row < 4; ++row)
+					{
+						out[row * 4 + column] = in[column * 4 + row];
+					}
+				}
+			}
+
+			static T CalculateDeterminant(T const in[16])
 			{
 				// subscript: row, column
 				T m11 = in[0], m21 = in[1], m31 = in[2], m41 = in[3],
@@ -300,5 +317,100 @@ namespace XREX
 
 		};
 
+		template <typename T>
+		struct ScalarQuaternionHelper
+		{
+			/*
+			 *	@quaternion: x, y, z, w.
+			 *	@out: column major rotation matrix.
+			 */
+			static void DoToMatrix(T out[16], T const quaternion[4])
+			{
+				// see Real-Time Rendering, 3rd. 4.3.2 Quaternion Transforms
+				// or Mathematics for 3D Game Programming and Computer Graphics, 3rd. 4.6.2 Rotations with Quaternions
+
+				T const x2(quaternion[0] + quaternion[0]);
+				T const y2(quaternion[1] + quaternion[1]);
+				T const z2(quaternion[2] + quaternion[2]);
+
+				T const xx2(quaternion[0] * x2);
+				T const xy2(quaternion[0] * y2);
+				T const xz2(quaternion[0] * z2);
+				T const yy2(quaternion[1] * y2);
+				T const yz2(quaternion[1] * z2);
+				T const zz2(quaternion[2] * z2);
+
+				T const wx2(quaternion[3] * x2);
+				T const wy2(quaternion[3] * y2);
+				T const wz2(quaternion[3] * z2);
+
+				out[0] = 1 - yy2 - zz2;
+				out[1] = xy2 + wz2;
+				out[2] = xz2 - wy2;
+				out[3] = 0;
+				out[4] = xy2 - wz2;
+				out[5] = 1 - xx2 - zz2;
+				out[6] = yz2 + wx2;
+				out[7] = 0;
+				out[8] = xz2 + wy2;
+				out[9] = yz2 - wx2;
+				out[10] = 1 - xx2 - yy2;
+				out[11] = 0;
+				out[12] = 0;
+				out[13] = 0;
+				out[14] = 0;
+				out[15] = 1;
+			}
+
+			/*
+			 *	Translation * rotation * scaling, without the 2 matrix multiplications.
+			 */
+			static void DoComposeTransformation(T out[16], T const translation[3], T const quaternion[4], T const scaling[3])
+			{
+				DoToMatrix(out, quaternion);
+				for (uint32 column = 0; column < 3; ++column)
+				{
+					out[column * 4 + 0] *= scaling[column];
+					out[column * 4 + 1] *= scaling[column];
+					out[column * 4 + 2] *= scaling[column];
+				}
+				out[12] = translation[0];
+				out[13] = translation[1];
+				out[14] = translation[2];
+			}
+		};
+
+
+		/*
+		 *	Helpers used by math types. They are the scalar ones, unless specialized in MathHelperSIMD.hpp.
+		 *	Scalar helpers are kept usable directly, as reference of specialized ones.
+		 */
+		template <typename T, uint32 N>
+		struct TransformHelper
+			: ScalarTransformHelper<T, N>
+		{
+		};
+
+		template <typename T, uint32 N>
+		struct VectorHelper
+			: ScalarVectorHelper<T, N>
+		{
+		};
+
+		template <typename T>
+		struct MatrixHepler
+			: ScalarMatrixHepler<T>
+		{
+		};
+
+		template <typename T>
+		struct QuaternionHelper
+			: ScalarQuaternionHelper<T>
+		{
+		};
+
 	}
 }
+
+#include "MathHelperSIMD.hpp"
+
@@ -0,0 +1,346 @@
+#pragma once
+
+/*
+ *	SSE specializations of float math helpers, selected at compile time. Define XREX_NO_SIMD to use scalar helpers only.
+ *	Each one does the same float operations in the same order as its scalar helper, so results are bit identical
+ *	(a - b is done as a + (-b), which is the same in IEEE 754). This holds as long as the compiler does not contract
+ *	multiplications and additions into FMA, which is not done with /fp:precise.
+ *	Data is loaded unaligned, math types are not aligned.
+ */
+#if !defined(XREX_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define XREX_SIMD_SSE
+#if defined(__AVX__)
+#define XREX_SIMD_AVX
+#endif
+#endif
+
+#ifdef XREX_SIMD_SSE
+
+#ifdef XREX_SIMD_AVX
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#include <cmath>
+#include <limits>
+
+namespace XREX
+{
+	namespace MathHelper
+	{
+		namespace SIMD
+		{
+			/*
+			 *	@return: (x, x, x, x) of lane x.
+			 */
+			template <int Lane>
+			inline __m128 Broadcast(__m128 value)
+			{
+				return _mm_shuffle_ps(value, value, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+			}
+
+			/*
+			 *	Flips sign of lanes whose mask lane is -0.f.
+			 */
+			inline __m128 FlipSign(__m128 value, __m128 signMask)
+			{
+				return _mm_xor_ps(value, signMask);
+			}
+
+			/*
+			 *	@return: column * v[0] + ... in the order of scalar helpers.
+			 */
+			inline __m128 CombineColumns(float const m[16], __m128 v0, __m128 v1, __m128 v2)
+			{
+				__m128 result = _mm_mul_ps(_mm_loadu_ps(m), v0);
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 4), v1));
+				return _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 8), v2));
+			}
+			inline __m128 CombineColumns(float const m[16], __m128 v0, __m128 v1, __m128 v2, __m128 v3)
+			{
+				return _mm_add_ps(CombineColumns(m, v0, v1, v2), _mm_mul_ps(_mm_loadu_ps(m + 12), v3));
+			}
+		}
+
+
+
+		template <>
+		struct TransformHelper<float, 4>
+			: ScalarTransformHelper<float, 4>
+		{
+			static void DoTransform(float out[4], float const m[16], float const v[4], float lastComponent)
+			{
+				_mm_storeu_ps(out, SIMD::CombineColumns(m, _mm_set1_ps(v[0]), _mm_set1_ps(v[1]), _mm_set1_ps(v[2]), _mm_set1_ps(v[3])));
+			}
+			static void DoTransformDirection(float out[4], float const m[16], float const v[4])
+			{
+				__m128 result = SIMD::CombineColumns(m, _mm_set1_ps(v[0]), _mm_set1_ps(v[1]), _mm_set1_ps(v[2]));
+				__m128 xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+				_mm_storeu_ps(out, _mm_and_ps(result, xyzMask));
+			}
+		};
+
+		template <>
+		struct TransformHelper<float, 3>
+			: ScalarTransformHelper<float, 3>
+		{
+			static void DoTransform(float out[3], float const m[16], float const v[3], float lastComponent)
+			{
+				// lane 3 is w.
+				__m128 result = SIMD::CombineColumns(m, _mm_set1_ps(v[0]), _mm_set1_ps(v[1]), _mm_set1_ps(v[2]), _mm_set1_ps(lastComponent));
+				float inverseW = 1.f / _mm_cvtss_f32(SIMD::Broadcast<3>(result));
+				float temp[4];
+				_mm_storeu_ps(temp, _mm_mul_ps(result, _mm_set1_ps(inverseW)));
+				out[0] = temp[0];
+				out[1] = temp[1];
+				out[2] = temp[2];
+			}
+			static void DoTransformDirection(float out[3], float const m[16], float const v[3])
+			{
+				float temp[4];
+				_mm_storeu_ps(temp, SIMD::CombineColumns(m, _mm_set1_ps(v[0]), _mm_set1_ps(v[1]), _mm_set1_ps(v[2])));
+				out[0] = temp[0];
+				out[1] = temp[1];
+				out[2] = temp[2];
+			}
+		};
+
+
+		template <>
+		struct VectorHelper<float, 4>
+			: ScalarVectorHelper<float, 4>
+		{
+			static void DoAdd(float out[4], float const left[4], float const right[4])
+			{
+				_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(left), _mm_loadu_ps(right)));
+			}
+			static void DoAdd(float out[4], float const left[4], float const& right)
+			{
+				_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(left), _mm_set1_ps(right)));
+			}
+
+			static void DoSubtract(float out[4], float const left[4], float const right[4])
+			{
+				_mm_storeu_ps(out, _mm_sub_ps(_mm_loadu_ps(left), _mm_loadu_ps(right)));
+			}
+			static void DoSubtract(float out[4], float const left[4], float const& right)
+			{
+				_mm_storeu_ps(out, _mm_sub_ps(_mm_loadu_ps(left), _mm_set1_ps(right)));
+			}
+
+			static void DoMultiply(float out[4], float const left[4], float const right[4])
+			{
+				_mm_storeu_ps(out, _mm_mul_ps(_mm_loadu_ps(left), _mm_loadu_ps(right)));
+			}
+
+			static void DoScale(float out[4], float const left[4], float const& right)
+			{
+				_mm_storeu_ps(out, _mm_mul_ps(_mm_loadu_ps(left), _mm_set1_ps(right)));
+			}
+
+			static void DoDivide(float out[4], float const left[4], float const right[4])
+			{
+				_mm_storeu_ps(out, _mm_div_ps(_mm_loadu_ps(left), _mm_loadu_ps(right)));
+			}
+
+			static void DoNegate(float out[4], float const right[4])
+			{
+				_mm_storeu_ps(out, SIMD::FlipSign(_mm_loadu_ps(right), _mm_set1_ps(-0.f)));
+			}
+		};
+
+
+		template <>
+		struct MatrixHepler<float>
+			: ScalarMatrixHepler<float>
+		{
+			static void DoMultiply(float out[16], float const left[16], float const right[16])
+			{
+#ifdef XREX_SIMD_AVX
+				// 2 result columns at a time. right is loaded first, out may be right.
+				__m256 columns[2] = { _mm256_loadu_ps(right), _mm256_loadu_ps(right + 8) };
+				__m256 left0 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(left));
+				__m256 left1 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(left + 4));
+				__m256 left2 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(left + 8));
+				__m256 left3 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(left + 12));
+				for (uint32 i = 0; i < 2; ++i)
+				{
+					__m256 result = _mm256_mul_ps(left0, _mm256_permute_ps(columns[i], _MM_SHUFFLE(0, 0, 0, 0)));
+					result = _mm256_add_ps(result, _mm256_mul_ps(left1, _mm256_permute_ps(columns[i], _MM_SHUFFLE(1, 1, 1, 1))));
+					result = _mm256_add_ps(result, _mm256_mul_ps(left2, _mm256_permute_ps(columns[i], _MM_SHUFFLE(2, 2, 2, 2))));
+					result = _mm256_add_ps(result, _mm256_mul_ps(left3, _mm256_permute_ps(columns[i], _MM_SHUFFLE(3, 3, 3, 3))));
+					_mm256_storeu_ps(out + i * 8, result);
+				}
+#else
+				// out may be left or right, compute all columns before storing.
+				__m128 result[4];
+				for (uint32 i = 0; i < 4; ++i)
+				{
+					__m128 column = _mm_loadu_ps(right + i * 4);
+					result[i] = SIMD::CombineColumns(left, SIMD::Broadcast<0>(column), SIMD::Broadcast<1>(column), SIMD::Broadcast<2>(column), SIMD::Broadcast<3>(column));
+				}
+				for (uint32 i = 0; i < 4; ++i)
+				{
+					_mm_storeu_ps(out + i * 4, result[i]);
+				}
+#endif
+			}
+
+			static void DoTranspose(float out[16], float const in[16])
+			{
+				__m128 column0 = _mm_loadu_ps(in);
+				__m128 column1 = _mm_loadu_ps(in + 4);
+				__m128 column2 = _mm_loadu_ps(in + 8);
+				__m128 column3 = _mm_loadu_ps(in + 12);
+				_MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+				_mm_storeu_ps(out, column0);
+				_mm_storeu_ps(out + 4, column1);
+				_mm_storeu_ps(out + 8, column2);
+				_mm_storeu_ps(out + 12, column3);
+			}
+
+			/*
+			 *	Same cofactors as the scalar one, each output column is P * X + Q * Y + R * Z, with signs folded into P, Q, R.
+			 */
+			static bool DoInverse(float out[16], float const in[16])
+			{
+				__m128 column0 = _mm_loadu_ps(in); // m11, m21, m31, m41
+				__m128 column1 = _mm_loadu_ps(in + 4);
+				__m128 column2 = _mm_loadu_ps(in + 8);
+				__m128 column3 = _mm_loadu_ps(in + 12);
+
+				// 2x2 determinants of columns 0, 1 and columns 2, 3, of rows 12, 13, 14, 23 and 24, 34.
+				// low01: _1122_2112, _1132_3112, _1142_4112, _2132_3122. high01: _2142_4122, _3142_4132.
+				// low23: _1324_2314, _1334_3314, _1344_4314, _2334_3324. high23: _2344_4324, _3344_4334.
+				__m128 low01 = _mm_sub_ps(
+					_mm_mul_ps(_mm_shuffle_ps(column0, column0, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shuffle_ps(column1, column1, _MM_SHUFFLE(2, 3, 2, 1))),
+					_mm_mul_ps(_mm_shuffle_ps(column0, column0, _MM_SHUFFLE(2, 3, 2, 1)), _mm_shuffle_ps(column1, column1, _MM_SHUFFLE(1, 0, 0, 0))));
+				__m128 high01 = _mm_sub_ps(
+					_mm_mul_ps(_mm_shuffle_ps(column0, column0, _MM_SHUFFLE(2, 1, 2, 1)), _mm_shuffle_ps(column1, column1, _MM_SHUFFLE(3, 3, 3, 3))),
+					_mm_mul_ps(_mm_shuffle_ps(column0, column0, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_ps(column1, column1, _MM_SHUFFLE(2, 1, 2, 1))));
+				__m128 low23 = _mm_sub_ps(
+					_mm_mul_ps(_mm_shuffle_ps(column2, column2, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shuffle_ps(column3, column3, _MM_SHUFFLE(2, 3, 2, 1))),
+					_mm_mul_ps(_mm_shuffle_ps(column2, column2, _MM_SHUFFLE(2, 3, 2, 1)), _mm_shuffle_ps(column3, column3, _MM_SHUFFLE(1, 0, 0, 0))));
+				__m128 high23 = _mm_sub_ps(
+					_mm_mul_ps(_mm_shuffle_ps(column2, column2, _MM_SHUFFLE(2, 1, 2, 1)), _mm_shuffle_ps(column3, column3, _MM_SHUFFLE(3, 3, 3, 3))),
+					_mm_mul_ps(_mm_shuffle_ps(column2, column2, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_ps(column3, column3, _MM_SHUFFLE(2, 1, 2, 1))));
+
+				float d01[8];
+				float d23[8];
+				_mm_storeu_ps(d01, low01);
+				_mm_storeu_ps(d01 + 4, high01);
+				_mm_storeu_ps(d23, low23);
+				_mm_storeu_ps(d23 + 4, high23);
+				float determinant = (d01[0] * d23[5] - d01[1] * d23[4] + d01[2] * d23[3] + d01[3] * d23[2] - d01[4] * d23[1] + d01[5] * d23[0]);
+
+				// non-invertible, same as Equal<float>(determinant, 0), which is not declared yet
+				if (std::abs(determinant) <= std::numeric_limits<float>::epsilon())
+				{
+					return false;
+				}
+				__m128 inverseDeterminant = _mm_set1_ps(1.f / determinant);
+
+				// X, Y, Z of output columns are pairs of 2x2 determinants, (s23, s23, s01, s01).
+				__m128 s3344_3142 = _mm_shuffle_ps(high23, high01, _MM_SHUFFLE(1, 1, 1, 1));
+				__m128 s2344_2142 = _mm_shuffle_ps(high23, high01, _MM_SHUFFLE(0, 0, 0, 0));
+				__m128 s2334_2132 = _mm_shuffle_ps(low23, low01, _MM_SHUFFLE(3, 3, 3, 3));
+				__m128 s1344_1142 = _mm_shuffle_ps(low23, low01, _MM_SHUFFLE(2, 2, 2, 2));
+				__m128 s1334_1132 = _mm_shuffle_ps(low23, low01, _MM_SHUFFLE(1, 1, 1, 1));
+				__m128 s1324_1122 = _mm_shuffle_ps(low23, low01, _MM_SHUFFLE(0, 0, 0, 0));
+
+				// rows with element pairs swapped, row2 is (m22, m21, m24, m23).
+				_MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+				__m128 row1 = _mm_shuffle_ps(column0, column0, _MM_SHUFFLE(2, 3, 0, 1));
+				__m128 row2 = _mm_shuffle_ps(column1, column1, _MM_SHUFFLE(2, 3, 0, 1));
+				__m128 row3 = _mm_shuffle_ps(column2, column2, _MM_SHUFFLE(2, 3, 0, 1));
+				__m128 row4 = _mm_shuffle_ps(column3, column3, _MM_SHUFFLE(2, 3, 0, 1));
+
+				__m128 const plusMinus = _mm_setr_ps(0.f, -0.f, 0.f, -0.f);
+				__m128 const minusPlus = _mm_setr_ps(-0.f, 0.f, -0.f, 0.f);
+
+				__m128 result[4];
+				result[0] = CombineCofactors(SIMD::FlipSign(row2, plusMinus), s3344_3142, SIMD::FlipSign(row3, minusPlus), s2344_2142, SIMD::FlipSign(row4, plusMinus), s2334_2132);
+				result[1] = CombineCofactors(SIMD::FlipSign(row1, minusPlus), s3344_3142, SIMD::FlipSign(row3, plusMinus), s1344_1142, SIMD::FlipSign(row4, minusPlus), s1334_1132);
+				result[2] = CombineCofactors(SIMD::FlipSign(row1, plusMinus), s2344_2142, SIMD::FlipSign(row2, minusPlus), s1344_1142, SIMD::FlipSign(row4, plusMinus), s1324_1122);
+				result[3] = CombineCofactors(SIMD::FlipSign(row1, minusPlus), s2334_2132, SIMD::FlipSign(row2, plusMinus), s1334_1132, SIMD::FlipSign(row3, minusPlus), s1324_1122);
+				for (uint32 i = 0; i < 4; ++i)
+				{
+					_mm_storeu_ps(out + i * 4, _mm_mul_ps(result[i], inverseDeterminant));
+				}
+				return true;
+			}
+
+		private:
+			static __m128 CombineCofactors(__m128 p, __m128 x, __m128 q, __m128 y, __m128 r, __m128 z)
+			{
+				return _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, x), _mm_mul_ps(q, y)), _mm_mul_ps(r, z));
+			}
+		};
+
+
+		template <>
+		struct QuaternionHelper<float>
+			: ScalarQuaternionHelper<float>
+		{
+			static void DoToMatrix(float out[16], float const quaternion[4])
+			{
+				__m128 column[3];
+				ToRotationColumns(column, quaternion);
+				_mm_storeu_ps(out, column[0]);
+				_mm_storeu_ps(out + 4, column[1]);
+				_mm_storeu_ps(out + 8, column[2]);
+				_mm_storeu_ps(out + 12, _mm_setr_ps(0, 0, 0, 1));
+			}
+
+			static void DoComposeTransformation(float out[16], float const translation[3], float const quaternion[4], float const scaling[3])
+			{
+				__m128 column[3];
+				ToRotationColumns(column, quaternion);
+				// w of columns are multiplied by 1 to stay 0 whatever the sign of scaling.
+				_mm_storeu_ps(out, _mm_mul_ps(column[0], _mm_setr_ps(scaling[0], scaling[0], scaling[0], 1)));
+				_mm_storeu_ps(out + 4, _mm_mul_ps(column[1], _mm_setr_ps(scaling[1], scaling[1], scaling[1], 1)));
+				_mm_storeu_ps(out + 8, _mm_mul_ps(column[2], _mm_setr_ps(scaling[2], scaling[2], scaling[2], 1)));
+				_mm_storeu_ps(out + 12, _mm_setr_ps(translation[0], translation[1], translation[2], 1));
+			}
+
+		private:
+			/*
+			 *	Products are done in vectors, the 3 columns are assembled from diagonal, sum and difference vectors.
+			 */
+			static void ToRotationColumns(__m128 column[3], float const quaternion[4])
+			{
+				__m128 q = _mm_loadu_ps(quaternion);
+				__m128 q2 = _mm_add_ps(q, q);
+
+				__m128 a = _mm_mul_ps(SIMD::Broadcast<0>(q), q2); // xx2, xy2, xz2
+				__m128 b = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 2, 1, 1)), _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 2, 2, 1))); // yy2, yz2, zz2
+				__m128 c = _mm_mul_ps(SIMD::Broadcast<3>(q), q2); // wx2, wy2, wz2
+
+				__m128 xyYzXz = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 1)); // xy2, xz2, yz2
+				xyYzXz = _mm_shuffle_ps(xyYzXz, xyYzXz, _MM_SHUFFLE(3, 1, 2, 0)); // xy2, yz2, xz2
+				__m128 wzWxWy = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 1, 0, 2)); // wz2, wx2, wy2
+				__m128 sum = _mm_add_ps(xyYzXz, wzWxWy); // m21, m32, m13
+				__m128 difference = _mm_sub_ps(xyYzXz, wzWxWy); // m12, m23, m31
+
+				__m128 yyXxXx = _mm_shuffle_ps(b, a, _MM_SHUFFLE(0, 0, 0, 0)); // yy2, yy2, xx2
+				yyXxXx = _mm_shuffle_ps(yyXxXx, yyXxXx, _MM_SHUFFLE(3, 2, 2, 0)); // yy2, xx2, xx2
+				__m128 zzZzYy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 2)); // zz2, zz2, yy2
+				__m128 diagonal = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1), yyXxXx), zzZzYy); // m11, m22, m33
+
+				float d[4];
+				float s[4];
+				float t[4];
+				_mm_storeu_ps(d, diagonal);
+				_mm_storeu_ps(s, sum);
+				_mm_storeu_ps(t, difference);
+				column[0] = _mm_setr_ps(d[0], s[0], t[2], 0);
+				column[1] = _mm_setr_ps(t[0], d[1], s[1], 0);
+				column[2] = _mm_setr_ps(s[2], t[1], d[2], 0);
+			}
+		};
+
+	}
+}
+
+#endif // XREX_SIMD_SSE
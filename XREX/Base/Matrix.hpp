@@ -237,10 +237,9 @@ namespace XREX
 
 		Matrix4T Transpose() const
 		{
-			return Matrix4T(operator [](0), operator [](4), operator [](8), operator [](12),
-				operator [](1), operator [](5), operator [](9),operator [](13),
-				operator [](2), operator [](6), operator [](10), operator [](14),
-				operator [](3), operator [](7), operator [](11), operator [](15));
+			Matrix4T temp;
+			MathHelper::MatrixHepler<T>::DoTranspose(GetFirstElementNonConstPointer(temp), GetFirstElementNonConstPointer(*this));
+			return temp;
 		}
 
 		Matrix4T Inverse() const
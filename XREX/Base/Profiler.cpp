@@ -0,0 +1,221 @@
+#include "XREX.hpp"
+
+#include "Profiler.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#ifdef _MSC_VER
+#define XREX_THREAD_LOCAL __declspec(thread)
+#else
+#define XREX_THREAD_LOCAL __thread
+#endif
+
+namespace XREX
+{
+	namespace
+	{
+		std::atomic<uint32> NextProfilerID(1);
+
+		/*
+		 *	Track of the current thread and the profiler it belongs to.
+		 */
+		XREX_THREAD_LOCAL uint32 CurrentProfilerID = 0;
+		XREX_THREAD_LOCAL void* CurrentTrack = nullptr;
+
+		void WriteJSONString(std::ostream& stream, char const* text)
+		{
+			stream << '"';
+			for (char const* c = text; *c != 0; ++c)
+			{
+				if (*c == '"' || *c == '\\')
+				{
+					stream << '\\' << *c;
+				}
+				else if (static_cast<uint8>(*c) < 0x20)
+				{
+					stream << ' ';
+				}
+				else
+				{
+					stream << *c;
+				}
+			}
+			stream << '"';
+		}
+	}
+
+
+
+	struct Profiler::Track
+		: Noncopyable
+	{
+		std::string name;
+		/*
+		 *	Ring buffer, event i is at i % size.
+		 */
+		std::vector<Event> events;
+		/*
+		 *	Events written since StartCapture, only increased by the writing thread.
+		 */
+		std::atomic<uint32> writtenCount;
+		/*
+		 *	Open scopes of the thread.
+		 */
+		uint32 depth;
+
+		Track(std::string const& theName, uint32 eventCount)
+			: name(theName), events(eventCount), writtenCount(0), depth(0)
+		{
+		}
+
+		void Write(Event const& event)
+		{
+			uint32 index = writtenCount.load(std::memory_order_relaxed);
+			events[index % events.size()] = event;
+			writtenCount.store(index + 1, std::memory_order_release);
+		}
+	};
+
+
+
+	Profiler::Profiler(uint32 eventCountPerTrack)
+		: id_(NextProfilerID++), eventCountPerTrack_(eventCountPerTrack), capturing_(false), captureBeginTime_(0)
+	{
+		assert(eventCountPerTrack != 0);
+	}
+
+	Profiler::~Profiler()
+	{
+	}
+
+	void Profiler::StartCapture()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto& track : tracks_)
+			{
+				track->writtenCount.store(0, std::memory_order_relaxed);
+			}
+		}
+		captureBeginTime_ = GetCurrentTime();
+		capturing_.store(true, std::memory_order_release);
+	}
+
+	void Profiler::StopCapture()
+	{
+		capturing_.store(false, std::memory_order_release);
+	}
+
+	double Profiler::BeginScope()
+	{
+		++GetCurrentThreadTrack().depth;
+		return GetCurrentTime();
+	}
+
+	void Profiler::EndScope(char const* name, double beginTime, int32 argument, bool hasArgument)
+	{
+		double endTime = GetCurrentTime();
+		Track& track = GetCurrentThreadTrack();
+		assert(track.depth > 0);
+		--track.depth;
+		if (IsCapturing())
+		{
+			Event event;
+			event.name = name;
+			event.beginTime = beginTime;
+			event.endTime = endTime;
+			event.depth = track.depth;
+			event.argument = argument;
+			event.hasArgument = hasArgument;
+			track.Write(event);
+		}
+	}
+
+	uint32 Profiler::CreateTrack(std::string const& name)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		tracks_.push_back(MakeUP<Track>(name, eventCountPerTrack_));
+		return tracks_.size() - 1;
+	}
+
+	void Profiler::AddEvent(uint32 track, Event const& event)
+	{
+		if (IsCapturing())
+		{
+			Track* theTrack;
+			{
+				std::lock_guard<std::mutex> lock(mutex_); // tracks_ may grow meanwhile
+				theTrack = tracks_[track].get();
+			}
+			theTrack->Write(event);
+		}
+	}
+
+	char const* Profiler::InternName(std::string const& name)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return names_.insert(name).first->c_str();
+	}
+
+	Profiler::Track& Profiler::GetCurrentThreadTrack()
+	{
+		if (CurrentProfilerID != id_)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			tracks_.push_back(MakeUP<Track>("thread " + std::to_string(static_cast<uint64>(tracks_.size())), eventCountPerTrack_));
+			CurrentTrack = tracks_.back().get();
+			CurrentProfilerID = id_;
+		}
+		return *static_cast<Track*>(CurrentTrack);
+	}
+
+	std::string Profiler::ExportChromeTrace() const
+	{
+		std::ostringstream stream;
+		stream.setf(std::ios::fixed);
+		stream.precision(3);
+		stream << "{\"traceEvents\":[";
+		bool first = true;
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (uint32 trackIndex = 0; trackIndex < tracks_.size(); ++trackIndex)
+		{
+			Track const& track = *tracks_[trackIndex];
+			stream << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << trackIndex << ",\"args\":{\"name\":";
+			WriteJSONString(stream, track.name.c_str());
+			stream << "}}";
+			first = false;
+
+			uint32 writtenCount = track.writtenCount.load(std::memory_order_acquire);
+			uint32 eventCount = track.events.size();
+			for (uint32 i = writtenCount > eventCount ? writtenCount - eventCount : 0; i < writtenCount; ++i)
+			{
+				Event const& event = track.events[i % eventCount];
+				stream << ",\n{\"name\":";
+				WriteJSONString(stream, event.name);
+				stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << trackIndex
+					<< ",\"ts\":" << (event.beginTime - captureBeginTime_) * 1e6 << ",\"dur\":" << (event.endTime - event.beginTime) * 1e6
+					<< ",\"args\":{\"depth\":" << event.depth;
+				if (event.hasArgument)
+				{
+					stream << ",\"value\":" << event.argument;
+				}
+				stream << "}}";
+			}
+		}
+		stream << "\n]}\n";
+		return stream.str();
+	}
+
+	bool Profiler::SaveChromeTrace(std::string const& fileName) const
+	{
+		std::ofstream file(fileName, std::ios::out | std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		file << ExportChromeTrace();
+		return file.good();
+	}
+
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Base/Timer.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <unordered_set>
+
+namespace XREX
+{
+
+	/*
+	 *	Records nested time ranges of all threads while capturing, exported as Chrome trace_event JSON (load it in chrome://tracing).
+	 *	Events are grouped by tracks, each thread gets its own track on its first event, other tracks hold events measured elsewhere, e.g. on GPU.
+	 *	Each track is a ring buffer written by one thread without locks, the oldest events are overwritten when it is full.
+	 *	Capture is started and stopped on the rendering thread, events ending meanwhile on other threads may be lost.
+	 */
+	class XREX_API Profiler
+		: Noncopyable
+	{
+	public:
+		struct Event
+		{
+			/*
+			 *	Must stay alive until the capture is exported, a literal or a string from InternName.
+			 */
+			char const* name;
+			/*
+			 *	Seconds, of GetCurrentTime.
+			 */
+			double beginTime;
+			double endTime;
+			/*
+			 *	Count of enclosing ranges.
+			 */
+			uint32 depth;
+			/*
+			 *	Shown in args of the event if hasArgument, e.g. a rendering group.
+			 */
+			int32 argument;
+			bool hasArgument;
+		};
+
+		static uint32 const DefaultEventCountPerTrack = 64 * 1024;
+
+	public:
+		explicit Profiler(uint32 eventCountPerTrack = DefaultEventCountPerTrack);
+		~Profiler();
+
+		double GetCurrentTime() const
+		{
+			return timer_.Elapsed();
+		}
+
+		/*
+		 *	Events recorded by last capture are dropped.
+		 */
+		void StartCapture();
+		void StopCapture();
+		bool IsCapturing() const
+		{
+			return capturing_.load(std::memory_order_relaxed);
+		}
+
+		/*
+		 *	Used by ProfileScope, a range of the calling thread.
+		 *	@return: begin time.
+		 */
+		double BeginScope();
+		void EndScope(char const* name, double beginTime, int32 argument, bool hasArgument);
+
+		/*
+		 *	A track for events not measured by ProfileScope. Events of the track must be added by one thread at a time.
+		 *	@return: id of the track.
+		 */
+		uint32 CreateTrack(std::string const& name);
+		/*
+		 *	Ignored when not capturing.
+		 */
+		void AddEvent(uint32 track, Event const& event);
+
+		/*
+		 *	@return: a copy of name living as long as the profiler, the same pointer for the same name.
+		 */
+		char const* InternName(std::string const& name);
+
+		/*
+		 *	Events of last capture, times are in microseconds from start of the capture.
+		 */
+		std::string ExportChromeTrace() const;
+		bool SaveChromeTrace(std::string const& fileName) const;
+
+	private:
+		struct Track;
+
+		Track& GetCurrentThreadTrack();
+
+	private:
+		/*
+		 *	Unique over profilers, to tell whether the track cached by a thread belongs to this profiler.
+		 */
+		uint32 id_;
+		uint32 eventCountPerTrack_;
+		Timer timer_;
+		std::atomic<bool> capturing_;
+		double captureBeginTime_;
+		/*
+		 *	Guards tracks_ and names_.
+		 */
+		mutable std::mutex mutex_;
+		std::vector<std::unique_ptr<Track>> tracks_;
+		std::unordered_set<std::string> names_;
+	};
+
+
+
+	/*
+	 *	Records a range from construction to destruction into the track of the current thread, does nothing if the profiler is not capturing.
+	 *	@name: must stay alive until the capture is exported, see Profiler::Event.
+	 */
+	class XREX_API ProfileScope
+		: Noncopyable
+	{
+	public:
+		ProfileScope(Profiler& profiler, char const* name)
+			: profiler_(profiler.IsCapturing() ? &profiler : nullptr), name_(name), argument_(0), hasArgument_(false)
+		{
+			if (profiler_ != nullptr)
+			{
+				beginTime_ = profiler_->BeginScope();
+			}
+		}
+		ProfileScope(Profiler& profiler, char const* name, int32 argument)
+			: profiler_(profiler.IsCapturing() ? &profiler : nullptr), name_(name), argument_(argument), hasArgument_(true)
+		{
+			if (profiler_ != nullptr)
+			{
+				beginTime_ = profiler_->BeginScope();
+			}
+		}
+		~ProfileScope()
+		{
+			if (profiler_ != nullptr)
+			{
+				profiler_->EndScope(name_, beginTime_, argument_, hasArgument_);
+			}
+		}
+
+	private:
+		Profiler* profiler_;
+		char const* name_;
+		int32 argument_;
+		bool hasArgument_;
+		double beginTime_;
+	};
+
+}
@@ -31,8 +31,29 @@ namespace XREX
 		RenderingSettings renderingSettings;
 		std::wstring windowTitle;
 		std::string rootPath;
+		/*
+		 *	Number of threads executing tasks of TaskScheduler, including the logic thread. 0 to use all hardware threads.
+		 */
+		uint32 threadCount;
+		/*
+		 *	0 to run logic and rendering one after another on window thread.
+		 *	Otherwise logic runs on its own thread, at most framesInFlight frames ahead of the frame being rendered.
+		 *	Requires a RenderingProcess supporting snapshots.
+		 */
+		uint32 framesInFlight;
+		/*
+		 *	Threads reading and decoding resources loaded by ResourceManager::LoadTexture2DAsync and LoadModelAsync.
+		 */
+		uint32 resourceLoadingThreadCount;
+		/*
+		 *	Time in seconds and bytes of data spent creating asynchronously loaded resources on context thread each frame.
+		 *	At least one resource is created each frame if any is ready.
+		 */
+		double resourceUploadTimeBudget;
+		uint64 resourceUploadByteBudget;
 		Settings(std::string const& theRootPath)
-			: rootPath(theRootPath)
+			: rootPath(theRootPath), threadCount(0), framesInFlight(0),
+			resourceLoadingThreadCount(2), resourceUploadTimeBudget(0.002), resourceUploadByteBudget(8 * 1024 * 1024)
 		{
 		}
 	};
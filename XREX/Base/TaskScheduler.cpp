@@ -0,0 +1,262 @@
+#include "XREX.hpp"
+
+#include "TaskScheduler.hpp"
+
+#ifdef _MSC_VER
+#define XREX_THREAD_LOCAL __declspec(thread)
+#else
+#define XREX_THREAD_LOCAL __thread
+#endif
+
+using std::vector;
+
+namespace XREX
+{
+
+	namespace
+	{
+		/*
+		 *	Which scheduler the current thread is a worker of, and the queue it owns.
+		 */
+		XREX_THREAD_LOCAL TaskScheduler const* CurrentScheduler = nullptr;
+		XREX_THREAD_LOCAL uint32 CurrentQueueIndex = 0;
+
+		/*
+		 *	Times a thread polls for tasks before going to sleep.
+		 */
+		uint32 const SpinCount = 64;
+	}
+
+
+
+	TaskGroup::TaskGroup()
+		: pendingCount_(0)
+	{
+	}
+
+
+	TaskGroup::~TaskGroup()
+	{
+		assert(pendingCount_ == 0);
+	}
+
+
+
+	TaskScheduler::TaskScheduler(uint32 threadCount)
+		: queuedCount_(0), sleepingCount_(0), running_(true)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		for (uint32 i = 0; i < threadCount; ++i)
+		{
+			queues_.push_back(MakeUP<TaskQueue>());
+		}
+		for (uint32 i = 0; i < threadCount - 1; ++i)
+		{
+			workers_.push_back(std::thread([this, i] ()
+			{
+				WorkerMain(i);
+			}));
+		}
+	}
+
+
+	TaskScheduler::~TaskScheduler()
+	{
+		running_ = false;
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex_);
+			wakeUp_.notify_all();
+		}
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+		assert(queuedCount_ == 0);
+	}
+
+	void TaskScheduler::Run(TaskGroup& group, std::function<void()> task)
+	{
+		++group.pendingCount_;
+		Push(Task(std::move(task), &group));
+	}
+
+	void TaskScheduler::RunAfter(TaskGroup& dependency, TaskGroup& group, std::function<void()> task)
+	{
+		++group.pendingCount_;
+		{
+			std::lock_guard<std::mutex> lock(dependency.mutex_);
+			if (dependency.pendingCount_ != 0)
+			{
+				dependency.continuations_.push_back(std::make_pair(&group, std::move(task)));
+				return;
+			}
+		}
+		Push(Task(std::move(task), &group));
+	}
+
+	void TaskScheduler::Wait(TaskGroup& group)
+	{
+		uint32 queueIndex = GetCurrentQueueIndex();
+		uint32 idleCount = 0;
+		while (group.pendingCount_ != 0)
+		{
+			Task task;
+			if (Pop(queueIndex, task))
+			{
+				Execute(task);
+				idleCount = 0;
+			}
+			else if (++idleCount > SpinCount)
+			{
+				std::this_thread::yield();
+			}
+		}
+		// the thread finishing the last task may still hold the lock, wait for it to leave the group.
+		std::lock_guard<std::mutex> lock(group.mutex_);
+	}
+
+	void TaskScheduler::ParallelFor(uint32 begin, uint32 end, uint32 grainSize, std::function<void(uint32 rangeBegin, uint32 rangeEnd)> const& function)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+		grainSize = std::max(grainSize, 1u);
+		if (end - begin <= grainSize)
+		{
+			function(begin, end);
+			return;
+		}
+		TaskGroup group;
+		for (uint32 rangeBegin = begin; rangeBegin < end; )
+		{
+			uint32 rangeEnd = end - rangeBegin > grainSize ? rangeBegin + grainSize : end;
+			Run(group, [&function, rangeBegin, rangeEnd] ()
+			{
+				function(rangeBegin, rangeEnd);
+			});
+			rangeBegin = rangeEnd;
+		}
+		Wait(group);
+	}
+
+	uint32 TaskScheduler::GetCurrentQueueIndex() const
+	{
+		return CurrentScheduler == this ? CurrentQueueIndex : queues_.size() - 1;
+	}
+
+	void TaskScheduler::Push(Task&& task)
+	{
+		TaskQueue& queue = *queues_[GetCurrentQueueIndex()];
+		++queuedCount_; // increase before pushing so that it never goes negative
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		if (sleepingCount_ != 0)
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex_);
+			wakeUp_.notify_one();
+		}
+	}
+
+	bool TaskScheduler::Pop(uint32 queueIndex, Task& task)
+	{
+		if (queuedCount_ == 0)
+		{
+			return false;
+		}
+		{
+			TaskQueue& queue = *queues_[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.tasks.empty())
+			{
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+				--queuedCount_;
+				return true;
+			}
+		}
+		uint32 queueCount = queues_.size();
+		for (uint32 i = 1; i < queueCount; ++i)
+		{
+			TaskQueue& victim = *queues_[(queueIndex + i) % queueCount];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				--queuedCount_;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void TaskScheduler::Execute(Task& task)
+	{
+		task.function();
+		FinishTask(*task.group);
+	}
+
+	void TaskScheduler::FinishTask(TaskGroup& group)
+	{
+		int32 count = group.pendingCount_;
+		while (count > 1)
+		{
+			if (group.pendingCount_.compare_exchange_weak(count, count - 1))
+			{
+				return;
+			}
+		}
+		// may be the last one, continuations must be taken before anyone can see the group finished.
+		vector<std::pair<TaskGroup*, std::function<void()>>> continuations;
+		{
+			std::lock_guard<std::mutex> lock(group.mutex_);
+			if (--group.pendingCount_ == 0)
+			{
+				continuations.swap(group.continuations_);
+			}
+		}
+		for (auto& continuation : continuations)
+		{
+			Push(Task(std::move(continuation.second), continuation.first));
+		}
+	}
+
+	void TaskScheduler::WorkerMain(uint32 queueIndex)
+	{
+		CurrentScheduler = this;
+		CurrentQueueIndex = queueIndex;
+		uint32 idleCount = 0;
+		while (running_)
+		{
+			Task task;
+			if (Pop(queueIndex, task))
+			{
+				Execute(task);
+				idleCount = 0;
+			}
+			else if (++idleCount <= SpinCount)
+			{
+				std::this_thread::yield();
+			}
+			else
+			{
+				std::unique_lock<std::mutex> lock(sleepMutex_);
+				++sleepingCount_;
+				while (running_ && queuedCount_ == 0)
+				{
+					wakeUp_.wait(lock);
+				}
+				--sleepingCount_;
+				idleCount = 0;
+			}
+		}
+		CurrentScheduler = nullptr;
+	}
+
+}
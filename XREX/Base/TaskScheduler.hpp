@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+
+namespace XREX
+{
+
+	/*
+	 *	Tracks a set of tasks, used to wait for them or to start continuations after them.
+	 *	A group can be reused after all its tasks finished.
+	 */
+	class XREX_API TaskGroup
+		: Noncopyable
+	{
+		friend class TaskScheduler;
+
+	public:
+		TaskGroup();
+		~TaskGroup();
+
+		bool IsFinished() const
+		{
+			return pendingCount_ == 0;
+		}
+
+	private:
+		std::atomic<int32> pendingCount_;
+		/*
+		 *	Guards the last decrease of pendingCount_ and continuations_.
+		 */
+		std::mutex mutex_;
+		std::vector<std::pair<TaskGroup*, std::function<void()>>> continuations_;
+	};
+
+
+
+	/*
+	 *	Work stealing task scheduler. Each worker thread owns a deque, takes tasks from back of its own deque,
+	 *	steals from front of other deques when its own one is empty.
+	 *	Tasks submitted by threads outside the scheduler go to a shared deque.
+	 *	Threads waiting for a group execute tasks meanwhile, so it is fine to wait inside a task.
+	 */
+	class XREX_API TaskScheduler
+		: Noncopyable
+	{
+	public:
+		/*
+		 *	@threadCount: number of threads executing tasks, including the thread waiting for tasks.
+		 *		threadCount - 1 worker threads will be created. 0 to use all hardware threads.
+		 */
+		explicit TaskScheduler(uint32 threadCount = 0);
+		~TaskScheduler();
+
+		uint32 GetThreadCount() const
+		{
+			return queues_.size();
+		}
+
+		void Run(TaskGroup& group, std::function<void()> task);
+		/*
+		 *	Run task in group after all tasks in dependency finished.
+		 *	group is not finished before task finishes.
+		 */
+		void RunAfter(TaskGroup& dependency, TaskGroup& group, std::function<void()> task);
+		/*
+		 *	Block until all tasks in group finished, executing tasks meanwhile.
+		 */
+		void Wait(TaskGroup& group);
+
+		/*
+		 *	Call function with sub ranges of [begin, end), each range is no larger than grainSize.
+		 *	Return after all ranges finished.
+		 */
+		void ParallelFor(uint32 begin, uint32 end, uint32 grainSize, std::function<void(uint32 rangeBegin, uint32 rangeEnd)> const& function);
+
+	private:
+		struct Task
+		{
+			std::function<void()> function;
+			TaskGroup* group;
+
+			Task()
+				: group(nullptr)
+			{
+			}
+			Task(std::function<void()>&& function, TaskGroup* group)
+				: function(std::move(function)), group(group)
+			{
+			}
+		};
+		struct TaskQueue
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+	private:
+		uint32 GetCurrentQueueIndex() const;
+		void Push(Task&& task);
+		/*
+		 *	Take from back of own queue, or steal from front of others.
+		 */
+		bool Pop(uint32 queueIndex, Task& task);
+		void Execute(Task& task);
+		void FinishTask(TaskGroup& group);
+
+		void WorkerMain(uint32 queueIndex);
+
+	private:
+		/*
+		 *	One for each worker thread, the last one for threads outside the scheduler.
+		 */
+		std::vector<std::unique_ptr<TaskQueue>> queues_;
+		std::vector<std::thread> workers_;
+
+		std::atomic<int32> queuedCount_;
+		std::atomic<int32> sleepingCount_;
+		std::atomic<bool> running_;
+		std::mutex sleepMutex_;
+		std::condition_variable wakeUp_;
+	};
+
+}
@@ -3,6 +3,8 @@
 
 #include "Timer.hpp"
 
+#ifdef _WIN32
+
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 #endif
@@ -67,4 +69,54 @@ namespace XREX
 
 }
 
-#endif
\ No newline at end of file
+#endif
+
+#else // _WIN32
+
+#include <chrono>
+
+namespace XREX
+{
+
+	namespace
+	{
+		typedef std::chrono::steady_clock Clock;
+	}
+
+
+	Timer::Timer()
+	{
+		this->Restart();
+	}
+	Timer::~Timer()
+	{
+	}
+
+	void Timer::Restart()
+	{
+		startTime_ = CurrentTime();
+	}
+
+	double Timer::Elapsed() const
+	{
+		return CurrentTime() - startTime_;
+	}
+
+	double Timer::MaxElapseTime() const
+	{
+		return std::chrono::duration<double>(Clock::duration::max()).count() - startTime_;
+	}
+
+	double Timer::MinElapseTimeSpan() const
+	{
+		return std::chrono::duration<double>(Clock::duration(1)).count();
+	}
+
+	double Timer::CurrentTime() const
+	{
+		return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+	}
+
+}
+
+#endif // _WIN32
\ No newline at end of file
@@ -6,6 +6,24 @@
 #include <utility>
 #include <memory>
 #include <vector>
+#include <cstring>
+#include <cerrno>
+
+#ifndef _MSC_VER
+/*
+ *	Bounds checked copy of the Visual Studio C runtime, other C libraries do not have it.
+ */
+inline int memcpy_s(void* destination, size_t destinationSize, void const* source, size_t count)
+{
+	if (count > destinationSize)
+	{
+		std::memset(destination, 0, destinationSize);
+		return ERANGE;
+	}
+	std::memcpy(destination, source, count);
+	return 0;
+}
+#endif
 
 namespace XREX
 {
@@ -111,7 +129,7 @@ namespace XREX
  *	Usage: XREX_ON_SCOPE_EXIT([&obj] { obj.DoSomethingCleanUp(); });
  *	Notice, this macro generate two statements.
  */
-#define XREX_ON_SCOPE_EXIT(callback) auto& _XREX_SCOPE_GUARD_NAME(_XREX_CallBackObject, __LINE__) = (callback);\
+#define XREX_ON_SCOPE_EXIT(callback) auto&& _XREX_SCOPE_GUARD_NAME(_XREX_CallBackObject, __LINE__) = (callback);\
 	::XREX::ScopeGuard<decltype(_XREX_SCOPE_GUARD_NAME(_XREX_CallBackObject, __LINE__))> _XREX_SCOPE_GUARD_NAME(_XREX_OnScopeExitObject, __LINE__)(_XREX_SCOPE_GUARD_NAME(_XREX_CallBackObject, __LINE__))
 
 	/*
@@ -137,7 +155,7 @@ namespace XREX
 	template <typename First, typename Second>
 	struct STLPairHasher // std::pair do not have a hash specialization...
 	{
-		size_t operator ()(std::pair<First, Second> const& value)
+		size_t operator ()(std::pair<First, Second> const& value) const
 		{
 			return std::hash<First>()(value.first) * 31 + std::hash<Second>()(value.second);
 		}
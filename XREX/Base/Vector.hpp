@@ -13,6 +13,12 @@
 namespace XREX
 {
 
+	/*
+	 *	Declared in Math.hpp, which may include this file before the declaration.
+	 */
+	template <typename T>
+	T ReciprocalSqrt(T number);
+
 	/*
 	 *	Immutable type.
 	 */
@@ -25,7 +31,7 @@ namespace XREX
 		friend class VectorT;
 
 		// Matrix knows the storage details
-		template <typename T>
+		template <typename U>
 		friend class Matrix4;
 
 	public:
@@ -79,7 +85,7 @@ namespace XREX
 		template <typename U, uint32 M>
 		explicit VectorT(VectorT<U, M> const& right)
 		{
-			DoConstructFromOtherSizedVector(right, std::conditional<M >= N, LargerSizeTag, SmallerSizeTag>::type());
+			DoConstructFromOtherSizedVector(right, typename std::conditional<M >= N, LargerSizeTag, SmallerSizeTag>::type());
 		}
 		explicit VectorT(T const& right)
 		{
@@ -120,7 +126,7 @@ namespace XREX
 		template <typename U, uint32 M>
 		VectorT& operator =(VectorT<U, M> const& right)
 		{
-			DoConstructFromOtherSizedVector(right, std::conditional<M >= N, LargerSizeTag, SmallerSizeTag>::type());
+			DoConstructFromOtherSizedVector(right, typename std::conditional<M >= N, LargerSizeTag, SmallerSizeTag>::type());
 			return *this;
 		}
 
@@ -1,5 +1,7 @@
 #include "XREX.hpp"
 
+#ifndef XREX_HEADLESS
+
 #include "Window.hpp"
 #include "Base/XREXContext.hpp"
 
@@ -735,3 +737,5 @@ namespace XREX
 	}
 
 }
+
+#endif // XREX_HEADLESS
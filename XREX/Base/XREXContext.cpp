@@ -3,14 +3,19 @@
 #include "XREXContext.hpp"
 
 #include "Base/Logger.hpp"
+#include "Base/TaskScheduler.hpp"
+#include "Base/FramePipeline.hpp"
 #include "Base/Window.hpp"
 #include "Rendering/GraphicsContext.hpp"
 
 #include "Rendering/RenderingFactory.hpp"
 #include "Rendering/RenderingEngine.hpp"
+#include "Rendering/RenderingProcess.hpp"
+#include "Rendering/FrameSnapshot.hpp"
 #include "Input/InputCenter.hpp"
 #include "Resource/ResourceManager.hpp"
 #include "Resource/LocalResourceLoader.hpp"
+#include "Scene/TransformationHierarchy.hpp"
 
 #include "HelperFacility/NaiveManagedScene.hpp"
 #include "HelperFacility/DefaultRenderingProcess.hpp"
@@ -20,7 +25,7 @@ namespace XREX
 {
 
 	XREXContext::XREXContext()
-		: settings_("") // temp root path
+		: transformationHierarchy_(MakeUP<TransformationHierarchy>()), settings_("") // temp root path
 	{
 	}
 
@@ -28,9 +33,14 @@ namespace XREX
 	XREXContext::~XREXContext()
 	{
 		mainWindow_->SetRunning(false);
+		StopLogicThread();
+		// snapshots not rendered yet still reference GPU resources, release them while the context exists.
+		framePipeline_.reset();
 
+		taskScheduler_.reset();
+
+		resourceManager_.reset(); // stops loading threads using resourceLoader_
 		resourceLoader_.reset();
-		resourceManager_.reset();
 		inputCenter_.reset();
 
 		scene_.reset();
@@ -46,8 +56,9 @@ namespace XREX
 	{
 		settings_ = settings;
 		logger_ = MakeUP<Logger>();
+		taskScheduler_ = MakeUP<TaskScheduler>(settings_.threadCount);
 		scene_ = MakeSP<NaiveManagedScene>();
-		resourceManager_ = MakeUP<ResourceManager>(settings_.rootPath);
+		resourceManager_ = MakeUP<ResourceManager>(settings_.rootPath, settings_.resourceLoadingThreadCount);
 		inputCenter_ = MakeUP<InputCenter>();
 		resourceLoader_ = MakeUP<LocalResourceLoader>();
 
@@ -88,8 +99,48 @@ namespace XREX
 		timer_.Restart();
 		mainWindow_->SetActive(true);
 		renderingEngine_->Start();
+		if (settings_.framesInFlight > 0)
+		{
+			StartLogicThread();
+		}
 		mainWindow_->StartHandlingMessages();
 		// when runs to here, the whole program will stop running.
+		StopLogicThread();
+	}
+
+	void XREXContext::StartLogicThread()
+	{
+		RenderingProcessSP const& process = renderingEngine_->GetRenderingProcess();
+		if (!process || !process->IsSnapshotSupported())
+		{
+			logger_->LogLine("current RenderingProcess does not support snapshot, logic and rendering will not be separated.");
+			return;
+		}
+		framePipeline_ = MakeUP<FramePipeline>(settings_.framesInFlight);
+		logicThread_ = std::thread([this] ()
+		{
+			LogicThreadMain();
+		});
+	}
+
+	void XREXContext::StopLogicThread()
+	{
+		if (logicThread_.joinable())
+		{
+			framePipeline_->Stop();
+			logicThread_.join();
+		}
+	}
+
+	void XREXContext::LogicThreadMain()
+	{
+		while (FrameSnapshot* snapshot = framePipeline_->BeginLogicFrame())
+		{
+			ExecuteALogicFrame();
+			transformationHierarchy_->Update();
+			renderingEngine_->GetRenderingProcess()->CaptureSnapshot(scene_, *snapshot);
+			framePipeline_->EndLogicFrame(snapshot);
+		}
 	}
 
 	void XREXContext::ExecuteALogicFrame()
@@ -101,7 +152,14 @@ namespace XREX
 		{
 			if (!logicFunction_(currentTime, delta))
 			{
-				mainWindow_->SetRunning(false);
+				if (framePipeline_)
+				{
+					framePipeline_->Stop(); // window is stopped by window thread in RenderAFrame
+				}
+				else
+				{
+					mainWindow_->SetRunning(false);
+				}
 			}
 		}
 		lastTime_ = currentTime;
@@ -109,7 +167,26 @@ namespace XREX
 
 	void XREXContext::RenderAFrame()
 	{
-		ExecuteALogicFrame(); // temp, move to somewhere else when using separate thread to do logic.
+		// context thread, create resources loaded asynchronously.
+		resourceManager_->UploadLoadedResources(settings_.resourceUploadTimeBudget, settings_.resourceUploadByteBudget);
+		if (framePipeline_)
+		{
+			// wait a little only, window messages need to be handled meanwhile.
+			FrameSnapshot* snapshot = framePipeline_->BeginRenderFrame(0.005);
+			if (snapshot != nullptr)
+			{
+				renderingEngine_->RenderAFrame(*snapshot);
+				renderingEngine_->SwapBuffers();
+				framePipeline_->EndRenderFrame(snapshot);
+			}
+			else if (framePipeline_->IsStopped())
+			{
+				mainWindow_->SetRunning(false);
+			}
+			return;
+		}
+		ExecuteALogicFrame(); // logic and rendering are not separated, see Settings::framesInFlight.
+		transformationHierarchy_->Update();
 		renderingEngine_->RenderAFrame();
 		renderingEngine_->SwapBuffers();
 		
@@ -6,6 +6,7 @@
 #include "Base/Timer.hpp"
 
 #include <string>
+#include <thread>
 
 namespace XREX
 {
@@ -47,6 +48,24 @@ namespace XREX
 		{
 			return *resourceLoader_;
 		}
+		TransformationHierarchy& GetTransformationHierarchy() const
+		{
+			return *transformationHierarchy_;
+		}
+		/*
+		 *	For engine subsystems and logic function to execute tasks in parallel.
+		 */
+		TaskScheduler& GetTaskScheduler() const
+		{
+			return *taskScheduler_;
+		}
+		/*
+		 *	@return: nullptr when logic and rendering are not separated, see Settings::framesInFlight.
+		 */
+		FramePipeline* GetFramePipeline() const
+		{
+			return framePipeline_.get();
+		}
 
 		Settings const& GetSettings() const
 		{
@@ -92,11 +111,20 @@ namespace XREX
 		void InitializeMainWindow();
 		void InitializeGraphicsContext();
 
+		void StartLogicThread();
+		void StopLogicThread();
+		void LogicThreadMain();
+
 	private:
 		XREXContext();
 		~XREXContext();
 
 	private:
+		/*
+		 *	Declared first to be released last, Transformations may be released in destructor of any other member.
+		 */
+		std::unique_ptr<TransformationHierarchy> transformationHierarchy_;
+
 		std::function<bool(double currentTime, double deltaTime)> logicFunction_;
 		std::unique_ptr<Window> mainWindow_;
 		std::unique_ptr<RenderingFactory> renderingFactory_;
@@ -106,6 +134,11 @@ namespace XREX
 
 		std::unique_ptr<Logger> logger_;
 
+		std::unique_ptr<TaskScheduler> taskScheduler_;
+
+		std::unique_ptr<FramePipeline> framePipeline_;
+		std::thread logicThread_;
+
 		RenderingEngine* renderingEngine_;
 
 		SceneSP scene_;
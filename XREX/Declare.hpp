@@ -21,6 +21,14 @@ namespace XREX
 	struct RenderingSettings;
 
 	class Logger;
+	class TaskScheduler;
+	class TaskGroup;
+	class FrameArena;
+	class Profiler;
+	class ProfileScope;
+	class FramePipeline;
+	class MappedFile;
+	struct FrameSnapshot;
 
 	class XREXContext;
 	class LocalResourceLoader;
@@ -28,11 +36,20 @@ namespace XREX
 	class TextureLoader;
 	class TechniqueLoader;
 	class ResourceManager;
+	class AsyncResourceLoader;
 	class RenderingFactory;
 	class RenderingEngine;
 	class InputCenter;
 	class Window;
 	class GraphicsContext;
+	class GLStateCache;
+	class UniformRingBuffer;
+	class BufferArena;
+	class CommandBuffer;
+	class GLCommandExecutor;
+	class GPUProfiler;
+	struct FrameStatistics;
+	class FrameStatisticsHistory;
 
 	class RenderingProcess;
 	typedef std::shared_ptr<RenderingProcess> RenderingProcessSP;
@@ -50,6 +67,8 @@ namespace XREX
 	typedef std::shared_ptr<Scene> SceneSP;
 	class NaiveManagedScene;
 	typedef std::shared_ptr<NaiveManagedScene> NaiveManagedSceneSP;
+	class BVHManagedScene;
+	typedef std::shared_ptr<BVHManagedScene> BVHManagedSceneSP;
 
 	class SceneObject;
 	typedef std::shared_ptr<SceneObject> SceneObjectSP;
@@ -58,6 +77,7 @@ namespace XREX
 
 	class Transformation;
 	typedef std::shared_ptr<Transformation> TransformationSP;
+	class TransformationHierarchy;
 
 	class Renderable;
 	typedef std::shared_ptr<Renderable> RenderableSP;
@@ -0,0 +1,505 @@
+#include "XREX.hpp"
+
+#include "BVHManagedScene.hpp"
+
+#include "Rendering/Renderable.hpp"
+#include "Rendering/Camera.hpp"
+
+using std::vector;
+
+namespace XREX
+{
+
+	BVHManagedScene::BVHManagedScene(float leafMargin)
+		: leafMargin_(leafMargin), root_(NullNode)
+	{
+		assert(leafMargin >= 0);
+	}
+
+
+	BVHManagedScene::~BVHManagedScene()
+	{
+	}
+
+	SceneObjectSP const& BVHManagedScene::GetObject(std::string const& sceneObjectName)
+	{
+		auto found = nameToIndex_.find(sceneObjectName);
+		if (found == nameToIndex_.end())
+		{
+			return SceneObject::NullSceneObject;
+		}
+		return entries_[found->second].object;
+	}
+
+	bool BVHManagedScene::RemoveObject(std::string const& sceneObjectName)
+	{
+		auto found = nameToIndex_.find(sceneObjectName);
+		if (found == nameToIndex_.end())
+		{
+			return false;
+		}
+		RemoveEntry(found->second);
+		return true;
+	}
+
+	bool BVHManagedScene::HasObject(SceneObjectSP const& sceneObject)
+	{
+		auto found = nameToIndex_.find(sceneObject->GetName());
+		return found != nameToIndex_.end() && entries_[found->second].object == sceneObject;
+	}
+
+	bool BVHManagedScene::AddObject(SceneObjectSP const& sceneObject)
+	{
+		assert(sceneObject != nullptr);
+		if (HasObject(sceneObject->GetName()))
+		{
+			return false;
+		}
+		Entry entry;
+		entry.object = sceneObject;
+		entry.leaf = NullNode;
+		nameToIndex_[sceneObject->GetName()] = entries_.size();
+		entries_.push_back(std::move(entry));
+		if (sceneObject->HasComponent<Camera>())
+		{
+			cameras_.push_back(sceneObject);
+		}
+		return true;
+	}
+
+	bool BVHManagedScene::RemoveObject(SceneObjectSP const& sceneObject)
+	{
+		assert(sceneObject != nullptr);
+		auto found = nameToIndex_.find(sceneObject->GetName());
+		if (found == nameToIndex_.end() || entries_[found->second].object != sceneObject)
+		{
+			return false;
+		}
+		RemoveEntry(found->second);
+		return true;
+	}
+
+	void BVHManagedScene::ClearAllObject()
+	{
+		entries_ = vector<Entry>();
+		nameToIndex_ = std::unordered_map<std::string, uint32>();
+		cameras_ = vector<SceneObjectSP>();
+		nodes_ = vector<Node>();
+		freeNodes_ = vector<int32>();
+		root_ = NullNode;
+		unboundedEntries_.clear();
+	}
+
+	void BVHManagedScene::GetRenderableQueue(SceneObjectSP const& camera, vector<SceneObjectSP>& queue)
+	{
+		UpdateTree();
+
+		queue.clear();
+		auto addIfVisible = [this, &queue] (uint32 entryIndex)
+		{
+			SceneObjectSP const& sceneObject = entries_[entryIndex].object;
+			Renderable* renderable = static_cast<Renderable*>(sceneObject->GetComponent(Component::ComponentType::RenderableType).get());
+			if (renderable->IsVisible())
+			{
+				queue.push_back(sceneObject);
+			}
+		};
+
+		if (camera == nullptr)
+		{
+			for (uint32 entryIndex = 0; entryIndex < entries_.size(); ++entryIndex)
+			{
+				if (entries_[entryIndex].object->HasComponent<Renderable>())
+				{
+					addIfVisible(entryIndex);
+				}
+			}
+			return;
+		}
+
+		CameraSP cameraComponent = camera->GetComponent<Camera>();
+		Frustum frustum(cameraComponent->GetProjectionMatrix() * cameraComponent->GetViewMatrix());
+		if (root_ != NullNode)
+		{
+			traversalStack_.clear();
+			traversalStack_.push_back(std::make_pair(root_, false));
+			while (!traversalStack_.empty())
+			{
+				int32 nodeIndex = traversalStack_.back().first;
+				bool inside = traversalStack_.back().second;
+				traversalStack_.pop_back();
+
+				Node const& node = nodes_[nodeIndex];
+				if (!inside)
+				{
+					IntersectionResult result = Intersect(frustum, node.box);
+					if (result == IntersectionResult::Outside)
+					{
+						continue;
+					}
+					inside = result == IntersectionResult::Inside;
+				}
+				if (node.IsLeaf())
+				{
+					// the leaf box is enlarged, the object itself may still be outside
+					if (inside || Intersect(frustum, entries_[node.entry].object->GetWorldBoundingBox()) != IntersectionResult::Outside)
+					{
+						addIfVisible(node.entry);
+					}
+				}
+				else
+				{
+					traversalStack_.push_back(std::make_pair(node.left, inside));
+					traversalStack_.push_back(std::make_pair(node.right, inside));
+				}
+			}
+		}
+		for (uint32 entryIndex : unboundedEntries_)
+		{
+			addIfVisible(entryIndex);
+		}
+	}
+
+	void BVHManagedScene::GetCameras(vector<SceneObjectSP>& cameras)
+	{
+		cameras.clear();
+		for (auto& camera : cameras_)
+		{
+			if (camera->HasComponent<Camera>() && camera->GetComponent<Camera>()->IsActive())
+			{
+				cameras.push_back(camera);
+			}
+		}
+	}
+
+	void BVHManagedScene::UpdateTree()
+	{
+		unboundedEntries_.clear();
+		for (uint32 i = 0; i < entries_.size(); ++i)
+		{
+			Entry& entry = entries_[i];
+			AxisAlignedBox const& worldBox = entry.object->GetWorldBoundingBox();
+			if (worldBox.IsEmpty())
+			{
+				if (entry.leaf != NullNode)
+				{
+					RemoveLeaf(entry.leaf);
+					FreeNode(entry.leaf);
+					entry.leaf = NullNode;
+				}
+				if (entry.object->HasComponent<Renderable>())
+				{
+					unboundedEntries_.push_back(i);
+				}
+				continue;
+			}
+
+			if (entry.leaf != NullNode)
+			{
+				if (nodes_[entry.leaf].box.Contains(worldBox))
+				{
+					continue; // still inside the enlarged box
+				}
+				RemoveLeaf(entry.leaf);
+			}
+			else
+			{
+				entry.leaf = AllocateNode();
+				nodes_[entry.leaf].entry = i;
+			}
+			nodes_[entry.leaf].box = worldBox.Enlarge(leafMargin_);
+			InsertLeaf(entry.leaf);
+		}
+	}
+
+	void BVHManagedScene::RemoveEntry(uint32 index)
+	{
+		Entry& entry = entries_[index];
+		if (entry.object->HasComponent<Camera>())
+		{
+			auto cameraFound = std::find(cameras_.begin(), cameras_.end(), entry.object);
+			if (cameraFound != cameras_.end())
+			{
+				SwapBackRemove(cameras_, cameraFound);
+			}
+		}
+		if (entry.leaf != NullNode)
+		{
+			RemoveLeaf(entry.leaf);
+			FreeNode(entry.leaf);
+		}
+		nameToIndex_.erase(entry.object->GetName());
+
+		SwapBackRemove(entries_, entries_.begin() + index);
+		if (index < entries_.size()) // fix the moved one
+		{
+			Entry& moved = entries_[index];
+			nameToIndex_[moved.object->GetName()] = index;
+			if (moved.leaf != NullNode)
+			{
+				nodes_[moved.leaf].entry = index;
+			}
+		}
+		unboundedEntries_.clear(); // indices may be invalid, will be rebuilt by UpdateTree
+	}
+
+	int32 BVHManagedScene::AllocateNode()
+	{
+		int32 nodeIndex;
+		if (freeNodes_.empty())
+		{
+			nodeIndex = nodes_.size();
+			nodes_.push_back(Node());
+		}
+		else
+		{
+			nodeIndex = freeNodes_.back();
+			freeNodes_.pop_back();
+		}
+		Node& node = nodes_[nodeIndex];
+		node.box = AxisAlignedBox();
+		node.parent = NullNode;
+		node.left = NullNode;
+		node.right = NullNode;
+		node.height = 0;
+		node.entry = NullNode;
+		return nodeIndex;
+	}
+
+	void BVHManagedScene::FreeNode(int32 node)
+	{
+		assert(node != NullNode && nodes_[node].height != -1);
+		nodes_[node].height = -1;
+		freeNodes_.push_back(node);
+	}
+
+	void BVHManagedScene::InsertLeaf(int32 leaf)
+	{
+		// modified from Box2D b2DynamicTree, with surface area instead of perimeter.
+		if (root_ == NullNode)
+		{
+			root_ = leaf;
+			nodes_[leaf].parent = NullNode;
+			return;
+		}
+
+		// find the best sibling
+		AxisAlignedBox leafBox = nodes_[leaf].box;
+		int32 index = root_;
+		while (!nodes_[index].IsLeaf())
+		{
+			Node const& node = nodes_[index];
+			float area = node.box.GetSurfaceArea();
+			float combinedArea = node.box.Merge(leafBox).GetSurfaceArea();
+
+			// cost of creating a new parent for this node and the new leaf
+			float cost = 2 * combinedArea;
+			// minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2 * (combinedArea - area);
+
+			auto descendingCost = [this, &leafBox, inheritanceCost] (int32 child)
+			{
+				Node const& childNode = nodes_[child];
+				float mergedArea = childNode.box.Merge(leafBox).GetSurfaceArea();
+				return childNode.IsLeaf() ? mergedArea + inheritanceCost : mergedArea - childNode.box.GetSurfaceArea() + inheritanceCost;
+			};
+			float leftCost = descendingCost(node.left);
+			float rightCost = descendingCost(node.right);
+
+			if (cost < leftCost && cost < rightCost)
+			{
+				break;
+			}
+			index = leftCost < rightCost ? node.left : node.right;
+		}
+
+		int32 sibling = index;
+		int32 oldParent = nodes_[sibling].parent;
+		int32 newParent = AllocateNode(); // may reallocate nodes_, no node reference before here is valid
+		nodes_[newParent].parent = oldParent;
+		nodes_[newParent].box = nodes_[sibling].box.Merge(leafBox);
+		nodes_[newParent].height = nodes_[sibling].height + 1;
+		nodes_[newParent].left = sibling;
+		nodes_[newParent].right = leaf;
+		nodes_[sibling].parent = newParent;
+		nodes_[leaf].parent = newParent;
+
+		if (oldParent != NullNode)
+		{
+			if (nodes_[oldParent].left == sibling)
+			{
+				nodes_[oldParent].left = newParent;
+			}
+			else
+			{
+				nodes_[oldParent].right = newParent;
+			}
+		}
+		else
+		{
+			root_ = newParent;
+		}
+
+		// walk back up to fix heights and boxes
+		index = nodes_[leaf].parent;
+		while (index != NullNode)
+		{
+			index = Balance(index);
+			Node& node = nodes_[index];
+			node.height = 1 + std::max(nodes_[node.left].height, nodes_[node.right].height);
+			node.box = nodes_[node.left].box.Merge(nodes_[node.right].box);
+			index = node.parent;
+		}
+	}
+
+	void BVHManagedScene::RemoveLeaf(int32 leaf)
+	{
+		if (leaf == root_)
+		{
+			root_ = NullNode;
+			return;
+		}
+
+		int32 parent = nodes_[leaf].parent;
+		int32 grandParent = nodes_[parent].parent;
+		int32 sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+		nodes_[leaf].parent = NullNode;
+
+		if (grandParent != NullNode)
+		{
+			// destroy parent and connect sibling to grand parent
+			if (nodes_[grandParent].left == parent)
+			{
+				nodes_[grandParent].left = sibling;
+			}
+			else
+			{
+				nodes_[grandParent].right = sibling;
+			}
+			nodes_[sibling].parent = grandParent;
+			FreeNode(parent);
+
+			int32 index = grandParent;
+			while (index != NullNode)
+			{
+				index = Balance(index);
+				Node& node = nodes_[index];
+				node.height = 1 + std::max(nodes_[node.left].height, nodes_[node.right].height);
+				node.box = nodes_[node.left].box.Merge(nodes_[node.right].box);
+				index = node.parent;
+			}
+		}
+		else
+		{
+			root_ = sibling;
+			nodes_[sibling].parent = NullNode;
+			FreeNode(parent);
+		}
+	}
+
+	int32 BVHManagedScene::Balance(int32 indexA)
+	{
+		// modified from Box2D b2DynamicTree::Balance.
+		Node& a = nodes_[indexA];
+		if (a.IsLeaf() || a.height < 2)
+		{
+			return indexA;
+		}
+
+		int32 indexB = a.left;
+		int32 indexC = a.right;
+		Node& b = nodes_[indexB];
+		Node& c = nodes_[indexC];
+
+		int32 balance = c.height - b.height;
+
+		auto replaceChild = [this] (int32 parent, int32 oldChild, int32 newChild)
+		{
+			if (parent == NullNode)
+			{
+				root_ = newChild;
+			}
+			else if (nodes_[parent].left == oldChild)
+			{
+				nodes_[parent].left = newChild;
+			}
+			else
+			{
+				nodes_[parent].right = newChild;
+			}
+		};
+
+		if (balance > 1) // rotate c up
+		{
+			int32 indexF = c.left;
+			int32 indexG = c.right;
+			Node& f = nodes_[indexF];
+			Node& g = nodes_[indexG];
+
+			c.left = indexA;
+			c.parent = a.parent;
+			a.parent = indexC;
+			replaceChild(c.parent, indexA, indexC);
+
+			if (f.height > g.height)
+			{
+				c.right = indexF;
+				a.right = indexG;
+				g.parent = indexA;
+				a.box = b.box.Merge(g.box);
+				c.box = a.box.Merge(f.box);
+				a.height = 1 + std::max(b.height, g.height);
+				c.height = 1 + std::max(a.height, f.height);
+			}
+			else
+			{
+				c.right = indexG;
+				a.right = indexF;
+				f.parent = indexA;
+				a.box = b.box.Merge(f.box);
+				c.box = a.box.Merge(g.box);
+				a.height = 1 + std::max(b.height, f.height);
+				c.height = 1 + std::max(a.height, g.height);
+			}
+			return indexC;
+		}
+
+		if (balance < -1) // rotate b up
+		{
+			int32 indexD = b.left;
+			int32 indexE = b.right;
+			Node& d = nodes_[indexD];
+			Node& e = nodes_[indexE];
+
+			b.left = indexA;
+			b.parent = a.parent;
+			a.parent = indexB;
+			replaceChild(b.parent, indexA, indexB);
+
+			if (d.height > e.height)
+			{
+				b.right = indexD;
+				a.left = indexE;
+				e.parent = indexA;
+				a.box = c.box.Merge(e.box);
+				b.box = a.box.Merge(d.box);
+				a.height = 1 + std::max(c.height, e.height);
+				b.height = 1 + std::max(a.height, d.height);
+			}
+			else
+			{
+				b.right = indexE;
+				a.left = indexD;
+				d.parent = indexA;
+				a.box = c.box.Merge(d.box);
+				b.box = a.box.Merge(e.box);
+				a.height = 1 + std::max(c.height, d.height);
+				b.height = 1 + std::max(a.height, e.height);
+			}
+			return indexB;
+		}
+
+		return indexA;
+	}
+
+}
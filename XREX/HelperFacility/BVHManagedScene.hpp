@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Scene/Scene.hpp"
+#include "Scene/SceneObject.hpp"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+namespace XREX
+{
+
+	/*
+	 *	Scene managed by a dynamic bounding volume hierarchy of world space bounding boxes.
+	 *	Leaves hold enlarged boxes, an object is reinserted only when it moves out of its enlarged box,
+	 *	so objects moving a little every frame cost nothing but a box check.
+	 *	Culling tests the box of the object at leaves, visible objects are the same as of NaiveManagedScene.
+	 *	Objects without a bounding box (SceneObject::GetWorldBoundingBox() is empty) are never culled.
+	 */
+	class XREX_API BVHManagedScene
+		: public Scene
+	{
+	public:
+		/*
+		 *	@leafMargin: world space distance that leaf boxes are enlarged by.
+		 */
+		explicit BVHManagedScene(float leafMargin = 0.1f);
+		virtual ~BVHManagedScene() override;
+
+
+		virtual bool HasObject(std::string const& sceneObjectName) override
+		{
+			return nameToIndex_.find(sceneObjectName) != nameToIndex_.end();
+		}
+
+		virtual SceneObjectSP const& GetObject(std::string const& sceneObjectName) override;
+
+		virtual bool RemoveObject(std::string const& sceneObjectName) override;
+
+
+		virtual bool HasObject(SceneObjectSP const& sceneObject) override;
+
+		virtual bool AddObject(SceneObjectSP const& sceneObject) override;
+
+		virtual bool RemoveObject(SceneObjectSP const& sceneObject) override;
+
+		virtual int32 GetObjectCount() override
+		{
+			return entries_.size();
+		}
+
+		virtual void ClearAllObject() override;
+
+		/*
+		 *	Refit the tree with latest transformations, then collect visible objects intersecting with the camera frustum.
+		 *	Without camera, all visible objects are collected.
+		 */
+		virtual void GetRenderableQueue(SceneObjectSP const& camera, std::vector<SceneObjectSP>& queue) override;
+		using Scene::GetRenderableQueue;
+
+		virtual void GetCameras(std::vector<SceneObjectSP>& cameras) override;
+		using Scene::GetCameras;
+
+		/*
+		 *	Synchronize the tree with transformations and renderables of all objects.
+		 *	Called by GetRenderableQueue, no need to call it manually.
+		 */
+		void UpdateTree();
+
+		/*
+		 *	@return: height of the tree, 0 for a tree with one leaf, -1 for empty tree.
+		 */
+		int32 GetTreeHeight() const
+		{
+			return root_ == NullNode ? -1 : nodes_[root_].height;
+		}
+
+	private:
+		static int32 const NullNode = -1;
+
+		struct Node
+		{
+			AxisAlignedBox box;
+			int32 parent;
+			int32 left;
+			int32 right;
+			/*
+			 *	0 for leaf, -1 for free node.
+			 */
+			int32 height;
+			/*
+			 *	Index into entries_, valid for leaf only.
+			 */
+			int32 entry;
+
+			bool IsLeaf() const
+			{
+				return left == NullNode;
+			}
+		};
+
+		struct Entry
+		{
+			SceneObjectSP object;
+			int32 leaf;
+		};
+
+	private:
+		void RemoveEntry(uint32 index);
+
+		int32 AllocateNode();
+		void FreeNode(int32 node);
+
+		void InsertLeaf(int32 leaf);
+		void RemoveLeaf(int32 leaf);
+		/*
+		 *	Rotate the subtree if it is imbalanced.
+		 *	@return: new root of the subtree.
+		 */
+		int32 Balance(int32 node);
+
+	private:
+		float leafMargin_;
+
+		std::vector<Entry> entries_;
+		std::unordered_map<std::string, uint32> nameToIndex_;
+		std::vector<SceneObjectSP> cameras_;
+
+		std::vector<Node> nodes_;
+		std::vector<int32> freeNodes_;
+		int32 root_;
+
+		/*
+		 *	Indices of entries holding a Renderable without bounding box, rebuilt by UpdateTree.
+		 */
+		std::vector<uint32> unboundedEntries_;
+
+		/*
+		 *	Node and whether it is known to be totally inside the frustum.
+		 */
+		std::vector<std::pair<int32, bool>> traversalStack_;
+	};
+
+}
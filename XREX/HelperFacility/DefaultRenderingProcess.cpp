@@ -11,21 +11,42 @@
 #include "Rendering/Viewport.hpp"
 #include "Rendering/Renderable.hpp"
 #include "Rendering/RenderingTechnique.hpp"
+#include "Rendering/RenderingPipelineState.hpp"
 #include "Rendering/DefinedShaderName.hpp"
 #include "Rendering/Material.hpp"
 #include "Rendering/RenderingLayout.hpp"
 #include "Rendering/ProgramConnector.hpp"
 #include "Rendering/WorkLauncher.hpp"
 #include "Rendering/FrameBuffer.hpp"
+#include "Rendering/ShaderProgram.hpp"
+#include "Rendering/GraphicsBuffer.hpp"
+#include "Rendering/CommandBuffer.hpp"
+#include "Rendering/GL/GLCommandExecutor.hpp"
+#include "Rendering/TechniqueBuilder.hpp"
+#include "Rendering/GPUProfiler.hpp"
+#include "Rendering/FrameStatistics.hpp"
+#include "Base/TaskScheduler.hpp"
+#include "Base/Profiler.hpp"
 
 #include <CoreGL.hpp>
 
 #include <vector>
-#include <map>
+#include <algorithm>
 
 namespace XREX
 {
+	namespace
+	{
+		/*
+		 *	Fewer draws are not worth a task.
+		 */
+		uint32 const MinDrawCountPerSlice = 256;
+	}
+
+
+
 	DefaultRenderingProcess::DefaultRenderingProcess()
+		: sortingEnabled_(true), instancingEnabled_(true), indirectDrawingEnabled_(true), parallelRecordingEnabled_(true)
 	{
 	}
 
@@ -36,9 +57,18 @@ namespace XREX
 
 	void DefaultRenderingProcess::RenderScene(SceneSP const& scene)
 	{
+		CaptureSnapshot(scene, snapshot_);
+		RenderSnapshot(snapshot_);
+		snapshot_.Clear();
+		snapshot_.ReleaseSceneObjects();
+	}
+
+	void DefaultRenderingProcess::CaptureSnapshot(SceneSP const& scene, FrameSnapshot& snapshot)
+	{
+		ProfileScope scope(XREXContext::GetInstance().GetRenderingEngine().GetProfiler(), "CaptureSnapshot");
 		if (scene != nullptr)
 		{
-			std::vector<SceneObjectSP> cameras_ = scene->GetCameras();
+			scene->GetCameras(cameras_);
 			for (auto& camera : cameras_)
 			{
 				assert(camera->GetComponent<Camera>() != nullptr);
@@ -52,106 +82,471 @@ namespace XREX
 				return depthL > depthR;
 			});
 
+			uint32 objectCount = scene->GetObjectCount();
 			for (auto& camera : cameras_)
 			{
-				RenderACamera(scene, camera);
+				FrameSnapshot::CameraView& view = snapshot.AddCameraView();
+				CaptureACamera(scene, camera, view, snapshot);
+				uint32 uncullableCount = view.visibleObjectCount + cameras_.size();
+				view.culledObjectCount = objectCount > uncullableCount ? objectCount - uncullableCount : 0;
+			}
+			cameras_.clear();
+		}
+	}
+
+	void DefaultRenderingProcess::RenderSnapshot(FrameSnapshot const& snapshot)
+	{
+		lastDrawStatistics_ = DrawStatistics();
+		FrameStatistics* statistics = FrameStatistics::GetCurrent();
+		for (auto& view : snapshot.cameraViews)
+		{
+			if (statistics != nullptr)
+			{
+				statistics->visibleObjectCount += view->visibleObjectCount;
+				statistics->culledObjectCount += view->culledObjectCount;
+				statistics->collectedPackCount += view->packs.GetSize();
 			}
+			RenderACamera(*view);
 		}
 	}
 
-	void DefaultRenderingProcess::RenderACamera(SceneSP const& scene, SceneObjectSP const& cameraObject)
+	void DefaultRenderingProcess::CaptureACamera(SceneSP const& scene, SceneObjectSP const& cameraObject, FrameSnapshot::CameraView& view, FrameSnapshot& snapshot)
 	{
 		CameraSP camera = cameraObject->GetComponent<Camera>();
-		Size<uint32, 2> windowSize = XREXContext::GetInstance().GetMainWindow().GetClientRegionSize();
-		camera->GetViewport()->Bind(windowSize);
+		view.cameraObject = cameraObject;
+		view.viewport = *camera->GetViewport();
+		view.backgroundColor = camera->GetBackgroundColor();
+		view.viewMatrix = camera->GetViewMatrix();
+		view.projectionMatrix = camera->GetProjectionMatrix();
+		view.position = cameraObject->GetComponent<Transformation>()->GetWorldPosition();
 
-		Color const& backgroundColor = camera->GetBackgroundColor();
-		XREXContext::GetInstance().GetRenderingEngine().GetDefaultFrameBuffer()->Clear(FrameBuffer::ClearMask::All, backgroundColor,1, 0);
+		Profiler& profiler = XREXContext::GetInstance().GetRenderingEngine().GetProfiler();
+		std::vector<SceneObjectSP>& sceneObjects = visibleObjects_;
+		{
+			ProfileScope scope(profiler, "Cull");
+			scene->GetRenderableQueue(cameraObject, sceneObjects);
+		}
+		view.visibleObjectCount = sceneObjects.size();
 
-		floatM44 const& viewMatrix = camera->GetViewMatrix();
-		floatM44 const& projectionMatrix = camera->GetProjectionMatrix();
-		floatV3 const& cameraPosition = cameraObject->GetComponent<Transformation>()->GetWorldPosition();
+		{
+			ProfileScope scope(profiler, "Collect");
+			// packs only hold raw pointers, reference counts are only touched once for each scene object.
+			RenderablePackCollector collector(*view.packs.GetArena());
+			sortDepths_.clear();
+			for (SceneObjectSP const& sceneObject : sceneObjects)
+			{
+				RenderableSP renderable = sceneObject->GetComponent<Renderable>();
+				assert(renderable != nullptr);
+				assert(renderable->IsVisible());
 
-		std::vector<SceneObjectSP> sceneObjects = scene->GetRenderableQueue(cameraObject);
+				uint32 firstPack = collector.GetRenderablePacks().GetSize();
+				renderable->GetRenderablePack(collector, cameraObject);
+				uint32 packCount = collector.GetRenderablePacks().GetSize() - firstPack;
 
+				floatM44 worldMatrix = sceneObject->GetComponent<Transformation>()->GetWorldMatrix();
+				for (uint32 i = 0; i < packCount; ++i)
+				{
+					view.worldMatrices.PushBack(worldMatrix);
+				}
+				if (sortingEnabled_)
+				{
+					// view space depth of bounding sphere center
+					Sphere const& sphere = sceneObject->GetWorldBoundingSphere();
+					floatV3 center = sphere.IsEmpty() ? floatV3(worldMatrix(0, 3), worldMatrix(1, 3), worldMatrix(2, 3)) : sphere.GetCenter();
+					sortDepths_.insert(sortDepths_.end(), packCount, Transform(view.viewMatrix, center).Z());
+				}
+				view.owners.push_back(std::move(renderable));
+			}
+			sceneObjects.clear();
+			view.packs = collector.ExtractRenderablePacks();
+			// render thread binds copies, logic thread may set parameters of live materials meanwhile.
+			for (uint32 i = 0; i < view.packs.GetSize(); ++i)
+			{
+				Renderable::RenderablePack& pack = view.packs[i];
+				if (pack.material != nullptr)
+				{
+					pack.material = snapshot.CopyMaterial(*pack.material);
+				}
+			}
+		}
 
-		RenderablePackCollector collector;
-		for (SceneObjectSP sceneObject : sceneObjects)
+		ProfileScope scope(profiler, "Sort");
+		SortACamera(view);
+	}
+
+	void DefaultRenderingProcess::SortACamera(FrameSnapshot::CameraView& view)
+	{
+		uint32 count = view.packs.GetSize();
+		sortItems_.clear();
+		sortItems_.reserve(count);
+		if (!sortingEnabled_)
 		{
-			TransformationSP transformation = sceneObject->GetComponent<Transformation>();
-			RenderableSP renderable = sceneObject->GetComponent<Renderable>();
-			assert(renderable != nullptr);
-			assert(renderable->IsVisible());
+			for (uint32 i = 0; i < count; ++i)
+			{
+				sortItems_.push_back(RenderSortItem(RenderSortKey::Make(view.packs[i].renderingGroup, false, 0, 0, 0, 0), i));
+			}
+		}
+		else
+		{
+			techniqueIDs_.Clear(count);
+			materialIDs_.Clear(count);
+			layoutIDs_.Clear(count);
+
+			// depths are normalized by the farthest one
+			std::vector<float>& depths = sortDepths_;
+			assert(depths.size() == count);
+			float maxDepth = 0;
+			for (uint32 i = 0; i < count; ++i)
+			{
+				maxDepth = std::max(maxDepth, depths[i]);
+			}
+			float depthScale = maxDepth > 0 ? 1 / maxDepth : 0;
 
-			renderable->GetRenderablePack(collector, cameraObject);
+			for (uint32 i = 0; i < count; ++i)
+			{
+				Renderable::RenderablePack const& pack = view.packs[i];
+				bool transparent = pack.technique->GetBlendState()->GetState().blendEnable;
+				uint32 techniqueID = techniqueIDs_.GetID(pack.technique);
+				uint32 materialID = materialIDs_.GetID(pack.material);
+				uint32 layoutID = layoutIDs_.GetID(pack.layout);
+				uint64 key = RenderSortKey::Make(pack.renderingGroup, transparent, techniqueID, materialID, layoutID, depths[i] * depthScale);
+				sortItems_.push_back(RenderSortItem(key, i));
+			}
 		}
 
-		std::vector<Renderable::RenderablePack> allRenderableNeedToRender = collector.ExtractRenderablePacks();
+		RadixSort(sortItems_, sortBuffer_);
+
+		view.drawOrder.Reserve(count);
+		for (auto& item : sortItems_)
+		{
+			view.drawOrder.PushBack(item.index);
+		}
+	}
 
-		// TODO do some sorting works
-		std::map<int32, std::vector<Renderable::RenderablePack*>> renderingGroups;
-		for (auto& renderablePack : allRenderableNeedToRender)
+	void DefaultRenderingProcess::RenderACamera(FrameSnapshot::CameraView const& cameraView)
+	{
+		RenderingEngine& engine = XREXContext::GetInstance().GetRenderingEngine();
+		ProfileScope cameraScope(engine.GetProfiler(), "RenderACamera");
+		uint32 drawCount = cameraView.drawOrder.GetSize();
+		uint32 sliceCount = 1;
+		TaskScheduler& scheduler = XREXContext::GetInstance().GetTaskScheduler();
+		if (parallelRecordingEnabled_)
 		{
-			renderingGroups[renderablePack.renderingGroup].push_back(&renderablePack);
+			sliceCount = std::max(1u, std::min(scheduler.GetThreadCount(), drawCount / MinDrawCountPerSlice));
 		}
+		uint32 sliceSize = (drawCount + sliceCount - 1) / sliceCount;
 
-		IndexedDrawer drawer;
-		for (auto& group : renderingGroups)
+		while (commandBuffers_.size() < sliceCount)
+		{
+			commandBuffers_.push_back(MakeUP<CommandBuffer>());
+		}
+		sliceStatistics_.assign(sliceCount, DrawStatistics());
+		auto recordSlice = [this, &cameraView, &engine, drawCount, sliceSize] (uint32 slice)
+		{
+			ProfileScope scope(engine.GetProfiler(), "RecordSlice", static_cast<int32>(slice));
+			CommandBuffer& commands = *commandBuffers_[slice];
+			commands.Reset();
+			commands.SetSortKey(slice); // slices are in draw order
+			if (slice == 0)
+			{
+				commands.SetViewport(cameraView.viewport);
+				commands.Clear(*engine.GetDefaultFrameBuffer(), FrameBuffer::ClearMask::All, cameraView.backgroundColor, 1, 0);
+			}
+			uint32 begin = std::min(slice * sliceSize, drawCount);
+			uint32 end = std::min(begin + sliceSize, drawCount);
+			RecordDraws(commands, cameraView, begin, end, sliceStatistics_[slice]);
+		};
+		if (sliceCount == 1)
 		{
-			for (auto& renderablePack : group.second)
+			recordSlice(0);
+		}
+		else
+		{
+			scheduler.ParallelFor(0, sliceCount, 1, [&recordSlice] (uint32 rangeBegin, uint32 rangeEnd)
 			{
-				Renderable& ownerRenderable = *renderablePack->renderable;
-				RenderingTechniqueSP const& technique = renderablePack->technique;
-				LayoutAndProgramConnectorSP const& connector = renderablePack->connector;
-				RenderingLayoutSP const& layout = renderablePack->layout;
-				MaterialSP const& material = renderablePack->material;
+				for (uint32 slice = rangeBegin; slice < rangeEnd; ++slice)
+				{
+					recordSlice(slice);
+				}
+			});
+		}
 
-				floatM44 const& modelMatrix = ownerRenderable.GetOwnerSceneObject()->GetComponent<Transformation>()->GetWorldMatrix();
-				floatM44 normalMatrix = modelMatrix; // TODO do inverse transpose to the upper floatV3 of modelMatrix
+		executionOrder_.clear();
+		for (uint32 slice = 0; slice < sliceCount; ++slice)
+		{
+			executionOrder_.push_back(commandBuffers_[slice].get());
+			DrawStatistics const& statistics = sliceStatistics_[slice];
+			lastDrawStatistics_.drawCount += statistics.drawCount;
+			lastDrawStatistics_.packCount += statistics.packCount;
+			lastDrawStatistics_.techniqueChangeCount += statistics.techniqueChangeCount;
+			lastDrawStatistics_.materialChangeCount += statistics.materialChangeCount;
+			lastDrawStatistics_.layoutChangeCount += statistics.layoutChangeCount;
+		}
+		if (executor_ == nullptr)
+		{
+			executor_ = MakeUP<GLCommandExecutor>();
+		}
+		ProfileScope executeScope(engine.GetProfiler(), "Execute");
+		engine.GetGPUProfiler().BeginRange("Camera");
+		CommandBuffer::ExecuteInOrder(executionOrder_, *executor_);
+		engine.GetGPUProfiler().EndRange();
+	}
+
+	void DefaultRenderingProcess::RecordDraws(CommandBuffer& commands, FrameSnapshot::CameraView const& cameraView, uint32 begin, uint32 end, DrawStatistics& statistics) const
+	{
+		floatM44 const& viewMatrix = cameraView.viewMatrix;
+		floatM44 const& projectionMatrix = cameraView.projectionMatrix;
+		floatV3 const& cameraPosition = cameraView.position;
+		// ranges of rendering groups and techniques, only recorded while capturing
+		Profiler& engineProfiler = XREXContext::GetInstance().GetRenderingEngine().GetProfiler();
+		Profiler* profiler = engineProfiler.IsCapturing() ? &engineProfiler : nullptr;
 
-				// are these too hard coded?
+		int32 lastRenderingGroup = 0;
+		RenderingTechnique const* lastTechnique = nullptr;
+		Material const* lastMaterial = nullptr;
+		RenderingLayout const* lastLayout = nullptr;
+		LayoutAndProgramConnector const* lastConnector = nullptr;
+
+		for (uint32 i = begin; i < end; )
+		{
+			uint32 index = cameraView.drawOrder[i];
+			Renderable::RenderablePack const* renderablePack = &cameraView.packs[index];
+			RenderingTechnique* technique = renderablePack->technique;
+			LayoutAndProgramConnector* connector = renderablePack->connector;
+			RenderingLayout* layout = renderablePack->layout;
+			Material* material = renderablePack->material;
+
+			bool techniqueChanged = technique != lastTechnique;
+			bool materialChanged = material != lastMaterial;
+			bool renderingGroupChanged = i == begin || renderablePack->renderingGroup != lastRenderingGroup;
+			if (profiler != nullptr && (renderingGroupChanged || techniqueChanged))
+			{
+				if (i != begin)
 				{
-					TechniqueParameterSP const& model = technique->GetParameterByName(GetUniformString(DefinedUniform::ModelMatrix));
-					if (model)
+					commands.EndProfileRange(); // technique
+					if (renderingGroupChanged)
 					{
-						model->As<floatM44>().SetValue(modelMatrix);
-					}
-					TechniqueParameterSP const& normal = technique->GetParameterByName(GetUniformString(DefinedUniform::NormalMatrix));
-					if (normal)
-					{
-						normal->As<floatM44>().SetValue(normalMatrix);
-					}
-					TechniqueParameterSP const& view = technique->GetParameterByName(GetUniformString(DefinedUniform::ViewMatrix));
-					if (view)
-					{
-						view->As<floatM44>().SetValue(viewMatrix);
-					}
-					TechniqueParameterSP const& projection = technique->GetParameterByName(GetUniformString(DefinedUniform::ProjectionMatrix));
-					if (projection)
-					{
-						projection->As<floatM44>().SetValue(projectionMatrix);
-					}
-					TechniqueParameterSP const& position = technique->GetParameterByName(GetUniformString(DefinedUniform::CameraPosition));
-					if (position)
-					{
-						position->As<floatV3>().SetValue(cameraPosition);
+						commands.EndProfileRange();
 					}
 				}
+				if (renderingGroupChanged)
+				{
+					commands.BeginProfileRange("RenderingGroup", renderablePack->renderingGroup);
+				}
+				commands.BeginProfileRange(profiler->InternName(technique->GetBuildingInformation()->GetName()));
+			}
+			if (techniqueChanged)
+			{
+				commands.BindTechnique(technique);
+			}
+
+			floatM44 const& modelMatrix = cameraView.worldMatrices[index];
+			floatM44 normalMatrix = modelMatrix; // TODO do inverse transpose to the upper floatV3 of modelMatrix
+
+			// are these too hard coded?
+			{
+				TechniqueParameterSP const& model = technique->GetParameter(technique->GetParameterHandle(DefinedUniform::ModelMatrix));
+				if (model)
+				{
+					commands.SetParameter(*model, modelMatrix);
+				}
+				TechniqueParameterSP const& normal = technique->GetParameter(technique->GetParameterHandle(DefinedUniform::NormalMatrix));
+				if (normal)
+				{
+					commands.SetParameter(*normal, normalMatrix);
+				}
+				TechniqueParameterSP const& view = technique->GetParameter(technique->GetParameterHandle(DefinedUniform::ViewMatrix));
+				if (view)
+				{
+					commands.SetParameter(*view, viewMatrix);
+				}
+				TechniqueParameterSP const& projection = technique->GetParameter(technique->GetParameterHandle(DefinedUniform::ProjectionMatrix));
+				if (projection)
+				{
+					commands.SetParameter(*projection, projectionMatrix);
+				}
+				TechniqueParameterSP const& position = technique->GetParameter(technique->GetParameterHandle(DefinedUniform::CameraPosition));
+				if (position)
+				{
+					commands.SetParameter(*position, cameraPosition);
+				}
+			}
 
-				if (material)
+			// packs drawn by this draw, as instances or draws of a multi draw
+			uint32 packCount = 1;
+			bool multiDraw = technique->IsDrawParametersIncluded();
+			if (multiDraw)
+			{
+				packCount = indirectDrawingEnabled_ ? CountMultiDraws(cameraView, i, end - i) : 1;
+			}
+			else
+			{
+				TechniqueParameterSP const& instance = technique->GetParameter(technique->GetParameterHandle(DefinedUniform::InstanceTransformation));
+				if (instance)
 				{
-					material->BindToTechnique(renderablePack->technique);
-					material->SetAllTechniqueParameterValues();
+					ShaderResourceBufferSP const& instanceBuffer = instance->As<ShaderResourceBufferSP>().GetValue();
+					BufferBindingInformation const& instanceInformation = instanceBuffer->GetBufferInformation();
+					assert(instanceInformation.GetAllBufferVariableInformations().size() == 1);
+					uint32 maxCount = instancingEnabled_ ? instanceInformation.GetAllBufferVariableInformations()[0].GetElementCount() : 1;
+					packCount = CountInstances(cameraView, i, std::min(maxCount, end - i));
+					WriteInstanceTransformation(commands.SetBufferData(*instanceBuffer), *instanceBuffer, cameraView, i, packCount);
 				}
+			}
+
+			++statistics.drawCount;
+			statistics.packCount += packCount;
+			statistics.techniqueChangeCount += techniqueChanged ? 1 : 0;
+			statistics.materialChangeCount += materialChanged ? 1 : 0;
+			statistics.layoutChangeCount += layout != lastLayout ? 1 : 0;
+
+			// parameters of the technique still hold values of the material if both are the same as last draw.
+			if (material != nullptr && (techniqueChanged || materialChanged))
+			{
+				commands.BindMaterial(*material);
+			}
+			if (connector != lastConnector || layout != lastLayout)
+			{
+				commands.BindLayout(connector, layout);
+			}
+			if (multiDraw)
+			{
+				WriteMultiDraws(commands.MultiDraw(packCount), cameraView, i, packCount);
+			}
+			else
+			{
+				commands.Draw(packCount);
+			}
+
+			lastRenderingGroup = renderablePack->renderingGroup;
+			lastTechnique = technique;
+			lastMaterial = material;
+			lastLayout = layout;
+			lastConnector = connector;
+
+			i += packCount;
+		}
+		if (profiler != nullptr && begin != end)
+		{
+			commands.EndProfileRange(); // technique
+			commands.EndProfileRange(); // rendering group
+		}
+	}
+
+	uint32 DefaultRenderingProcess::CountInstances(FrameSnapshot::CameraView const& cameraView, uint32 first, uint32 maxCount) const
+	{
+		Renderable::RenderablePack const& firstPack = cameraView.packs[cameraView.drawOrder[first]];
+		uint32 end = std::min(first + maxCount, cameraView.drawOrder.GetSize());
+		uint32 count = 1;
+		while (first + count < end)
+		{
+			Renderable::RenderablePack const& pack = cameraView.packs[cameraView.drawOrder[first + count]];
+			if (pack.technique != firstPack.technique || pack.connector != firstPack.connector
+				|| pack.layout != firstPack.layout || pack.material != firstPack.material)
+			{
+				break;
+			}
+			++count;
+		}
+		return count;
+	}
 
-				drawer.SetTechnique(technique);
-				drawer.SetLayoutAndProgramConnector(connector);
-				drawer.SetRenderingLayout(layout);
-				drawer.Launch();
+	uint32 DefaultRenderingProcess::CountMultiDraws(FrameSnapshot::CameraView const& cameraView, uint32 first, uint32 maxCount) const
+	{
+		Renderable::RenderablePack const& firstPack = cameraView.packs[cameraView.drawOrder[first]];
+		uint32 end = std::min(first + maxCount, cameraView.drawOrder.GetSize());
+		uint32 count = 1;
+		while (first + count < end)
+		{
+			Renderable::RenderablePack const& pack = cameraView.packs[cameraView.drawOrder[first + count]];
+			// the connector of the first layout is used by all draws, it points to the shared buffers.
+			if (pack.technique != firstPack.technique || pack.material != firstPack.material || pack.renderingGroup != firstPack.renderingGroup
+				|| (pack.layout != firstPack.layout && (!pack.layout->SharesBuffersWith(*firstPack.layout)
+				|| pack.layout->GetIndexBuffer()->GetTopologicalType() != firstPack.layout->GetIndexBuffer()->GetTopologicalType())))
+			{
+				break;
 			}
+			++count;
+		}
+		return count;
+	}
+
+	void DefaultRenderingProcess::WriteMultiDraws(CommandBuffer::MultiDrawData const& data, FrameSnapshot::CameraView const& cameraView, uint32 first, uint32 count) const
+	{
+		for (uint32 i = 0; i < count; ++i)
+		{
+			uint32 index = cameraView.drawOrder[first + i];
+			RenderingLayout const& layout = *cameraView.packs[index].layout;
+			IndirectDrawer::DrawElementsIndirectCommand& command = data.commands[i];
+			command.count = layout.GetElementCount();
+			command.instanceCount = 1;
+			command.firstIndex = layout.GetFirstIndex();
+			command.baseVertex = layout.GetBaseVertex();
+			command.baseInstance = 0;
+			data.drawParameters[i] = cameraView.worldMatrices[index];
+		}
+	}
+
+	void DefaultRenderingProcess::WriteInstanceTransformation(void* data, ShaderResourceBuffer const& instanceBuffer, FrameSnapshot::CameraView const& cameraView, uint32 first, uint32 count) const
+	{
+		BufferBindingInformation::BufferVariableInformation const& matrices = instanceBuffer.GetBufferInformation().GetAllBufferVariableInformations()[0];
+		assert(matrices.GetElementType() == ElementType::FloatM44);
+		assert(count <= static_cast<uint32>(matrices.GetElementCount()));
+
+		uint8* matrixData = static_cast<uint8*>(data) + matrices.GetOffset();
+		for (uint32 i = 0; i < count; ++i)
+		{
+			*reinterpret_cast<floatM44*>(matrixData + matrices.GetArrayStride() * i) = cameraView.worldMatrices[cameraView.drawOrder[first + i]];
 		}
+	}
 
 
+
+	void DefaultRenderingProcess::IDTable::Clear(uint32 maxCount)
+	{
+		// at most half full, keeps probing short
+		uint32 slotCount = 16;
+		while (slotCount < maxCount * 2)
+		{
+			slotCount *= 2;
+		}
+		if (slots_.size() < slotCount)
+		{
+			slots_.resize(slotCount);
+		}
+		std::fill(slots_.begin(), slots_.end(), std::pair<void const*, uint32>(nullptr, 0));
+		count_ = 0;
+		nullID_ = NoID;
+	}
+
+	uint32 DefaultRenderingProcess::IDTable::GetID(void const* object)
+	{
+		if (object == nullptr) // null marks empty slots
+		{
+			if (nullID_ == NoID)
+			{
+				nullID_ = count_++;
+			}
+			return nullID_;
+		}
+		uint32 mask = slots_.size() - 1;
+		assert(count_ < mask);
+		// low bits of pointers are mostly 0 because of alignment
+		uint32 slot = (static_cast<uint32>(reinterpret_cast<uintptr_t>(object) >> 4) * 2654435761u) & mask;
+		while (true)
+		{
+			std::pair<void const*, uint32>& entry = slots_[slot];
+			if (entry.first == object)
+			{
+				return entry.second;
+			}
+			if (entry.first == nullptr)
+			{
+				entry.first = object;
+				entry.second = count_;
+				return count_++;
+			}
+			slot = (slot + 1) & mask;
+		}
 	}
 
 }
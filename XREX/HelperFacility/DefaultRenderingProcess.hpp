@@ -3,20 +3,204 @@
 #include "Declare.hpp"
 
 #include "Rendering/RenderingProcess.hpp"
+#include "Rendering/FrameSnapshot.hpp"
+#include "Rendering/CommandBuffer.hpp"
+#include "HelperFacility/RenderSortKey.hpp"
+
+#include <vector>
 
 namespace XREX
 {
 	class XREX_API DefaultRenderingProcess
 		: public RenderingProcess
 	{
+	public:
+		/*
+		 *	State changes of the last rendered frame, all cameras together.
+		 */
+		struct XREX_API DrawStatistics
+		{
+			/*
+			 *	Draw calls, an instanced draw and a multi draw count once.
+			 */
+			uint32 drawCount;
+			/*
+			 *	Renderable packs drawn.
+			 */
+			uint32 packCount;
+			uint32 techniqueChangeCount;
+			uint32 materialChangeCount;
+			uint32 layoutChangeCount;
+
+			DrawStatistics()
+				: drawCount(0), packCount(0), techniqueChangeCount(0), materialChangeCount(0), layoutChangeCount(0)
+			{
+			}
+		};
+
 	public:
 		DefaultRenderingProcess();
 		virtual ~DefaultRenderingProcess() override;
 
+		/*
+		 *	Capture a snapshot and render it immediately.
+		 */
 		virtual void RenderScene(SceneSP const& scene) override;
 
+		virtual bool IsSnapshotSupported() const override
+		{
+			return true;
+		}
+		virtual void CaptureSnapshot(SceneSP const& scene, FrameSnapshot& snapshot) override;
+		virtual void RenderSnapshot(FrameSnapshot const& snapshot) override;
+
+		/*
+		 *	Draws are sorted by RenderSortKey when enabled, otherwise only by rendering group in the order they are collected.
+		 *	Takes effect from next captured snapshot.
+		 */
+		void SetSortingEnabled(bool enabled)
+		{
+			sortingEnabled_ = enabled;
+		}
+		bool IsSortingEnabled() const
+		{
+			return sortingEnabled_;
+		}
+
+		/*
+		 *	Consecutive packs in draw order with the same technique, connector, layout and material are drawn by one instanced draw,
+		 *	if the technique includes InstanceTransformation system technique.
+		 */
+		void SetInstancingEnabled(bool enabled)
+		{
+			instancingEnabled_ = enabled;
+		}
+		bool IsInstancingEnabled() const
+		{
+			return instancingEnabled_;
+		}
+
+		/*
+		 *	Packs of techniques including DrawParameters system technique are drawn by IndirectDrawer.
+		 *	When enabled, consecutive packs in draw order with the same technique, material and rendering group,
+		 *	whose layouts share buffers (the same vertex format in the buffer arena of RenderingFactory), are drawn by one multi draw.
+		 *	Otherwise each of them is a multi draw of its own, so shaders work the same.
+		 */
+		void SetIndirectDrawingEnabled(bool enabled)
+		{
+			indirectDrawingEnabled_ = enabled;
+		}
+		bool IsIndirectDrawingEnabled() const
+		{
+			return indirectDrawingEnabled_;
+		}
+
+		/*
+		 *	Draws of a camera are recorded into CommandBuffers by TaskScheduler of XREXContext, a slice of the draw order by each task,
+		 *	then executed in draw order. Cameras with few draws are recorded by one slice on rendering thread.
+		 *	Instanced draws and multi draws do not cross slices.
+		 */
+		void SetParallelRecordingEnabled(bool enabled)
+		{
+			parallelRecordingEnabled_ = enabled;
+		}
+		bool IsParallelRecordingEnabled() const
+		{
+			return parallelRecordingEnabled_;
+		}
+
+		/*
+		 *	State changes are counted in each slice, so a change at the start of a slice is counted even if it is the same as the last slice.
+		 */
+		DrawStatistics const& GetLastDrawStatistics() const
+		{
+			return lastDrawStatistics_;
+		}
+
 	private:
-		void RenderACamera(SceneSP const& scene, SceneObjectSP const& cameraObject);
+		/*
+		 *	Ids of objects in a camera, assigned by order of first appearance, so they are small enough for RenderSortKey.
+		 *	Open addressing in a table kept between frames, clearing and inserting allocate nothing once it is large enough.
+		 */
+		class IDTable
+		{
+		public:
+			IDTable()
+				: count_(0), nullID_(NoID)
+			{
+			}
+
+			/*
+			 *	@maxCount: at most how many objects will be added before next Clear.
+			 */
+			void Clear(uint32 maxCount);
+			uint32 GetID(void const* object);
+
+		private:
+			static uint32 const NoID = static_cast<uint32>(-1);
+
+			std::vector<std::pair<void const*, uint32>> slots_;
+			uint32 count_;
+			uint32 nullID_;
+		};
+
+	private:
+		void CaptureACamera(SceneSP const& scene, SceneObjectSP const& cameraObject, FrameSnapshot::CameraView& view, FrameSnapshot& snapshot);
+		void SortACamera(FrameSnapshot::CameraView& view);
+		void RenderACamera(FrameSnapshot::CameraView const& cameraView);
+		/*
+		 *	Record draws of drawOrder[begin, end). Called by tasks, must only read.
+		 */
+		void RecordDraws(CommandBuffer& commands, FrameSnapshot::CameraView const& cameraView, uint32 begin, uint32 end, DrawStatistics& statistics) const;
+		/*
+		 *	@return: count of packs from drawOrder[first] that can be drawn together, at most maxCount.
+		 */
+		uint32 CountInstances(FrameSnapshot::CameraView const& cameraView, uint32 first, uint32 maxCount) const;
+		/*
+		 *	@return: count of packs from drawOrder[first] that can be drawn by one multi draw, at most maxCount.
+		 */
+		uint32 CountMultiDraws(FrameSnapshot::CameraView const& cameraView, uint32 first, uint32 maxCount) const;
+		void WriteMultiDraws(CommandBuffer::MultiDrawData const& data, FrameSnapshot::CameraView const& cameraView, uint32 first, uint32 count) const;
+		/*
+		 *	@data: data of the whole instance buffer.
+		 */
+		void WriteInstanceTransformation(void* data, ShaderResourceBuffer const& instanceBuffer, FrameSnapshot::CameraView const& cameraView, uint32 first, uint32 count) const;
+
+	private:
+		/*
+		 *	Reused by RenderScene.
+		 */
+		FrameSnapshot snapshot_;
+
+		bool sortingEnabled_;
+		bool instancingEnabled_;
+		bool indirectDrawingEnabled_;
+		bool parallelRecordingEnabled_;
+		/*
+		 *	One for each slice, kept with their memory between frames.
+		 */
+		std::vector<std::unique_ptr<CommandBuffer>> commandBuffers_;
+		std::vector<CommandBuffer*> executionOrder_;
+		std::vector<DrawStatistics> sliceStatistics_;
+		std::unique_ptr<GLCommandExecutor> executor_;
+		/*
+		 *	Used by CaptureSnapshot and CaptureACamera, emptied after use so no scene object is kept alive, memory is kept.
+		 */
+		std::vector<SceneObjectSP> cameras_;
+		std::vector<SceneObjectSP> visibleObjects_;
+		/*
+		 *	Used by CaptureACamera and SortACamera, kept to avoid allocations every frame.
+		 */
+		IDTable techniqueIDs_;
+		IDTable materialIDs_;
+		IDTable layoutIDs_;
+		/*
+		 *	View space depth of each pack, filled by CaptureACamera when sorting is enabled.
+		 */
+		std::vector<float> sortDepths_;
+		std::vector<RenderSortItem> sortItems_;
+		std::vector<RenderSortItem> sortBuffer_;
 
+		DrawStatistics lastDrawStatistics_;
 	};
 }
@@ -96,22 +96,49 @@ namespace XREX
 		return true;
 	}
 
-	vector<SceneObjectSP> NaiveManagedScene::GetRenderableQueue(SceneObjectSP const& camera)
+	void NaiveManagedScene::GetRenderableQueue(SceneObjectSP const& camera, vector<SceneObjectSP>& queue)
 	{
-		vector<SceneObjectSP> resultObjects;
+		queue.clear();
+		boxes_.Clear();
+		boxedObjects_.clear();
 		for(auto& sceneObject : objects_)
 		{
 			if (sceneObject->HasComponent<Renderable>() && sceneObject->GetComponent<Renderable>()->IsVisible())
 			{
-				resultObjects.push_back(sceneObject);
+				AxisAlignedBox const& worldBox = sceneObject->GetWorldBoundingBox();
+				if (camera == nullptr || worldBox.IsEmpty())
+				{
+					queue.push_back(sceneObject);
+				}
+				else
+				{
+					boxes_.Add(worldBox);
+					boxedObjects_.push_back(&sceneObject);
+				}
+			}
+		}
+
+		if (camera == nullptr)
+		{
+			return;
+		}
+
+		CameraSP cameraComponent = camera->GetComponent<Camera>();
+		Frustum frustum(cameraComponent->GetProjectionMatrix() * cameraComponent->GetViewMatrix());
+		visibilityMask_.resize(GetVisibilityMaskSize(boxes_.GetCount()));
+		CullBoxes(frustum, boxes_, visibilityMask_.data());
+		for (uint32 i = 0; i < boxedObjects_.size(); ++i)
+		{
+			if (IsVisible(visibilityMask_.data(), i))
+			{
+				queue.push_back(*boxedObjects_[i]);
 			}
 		}
-		return resultObjects;
 	}
 
-	std::vector<SceneObjectSP> NaiveManagedScene::GetCameras()
+	void NaiveManagedScene::GetCameras(vector<SceneObjectSP>& cameras)
 	{
-		vector<SceneObjectSP> cameras;
+		cameras.clear();
 		for(auto& camera : cameras_)
 		{
 			if (camera->HasComponent<Camera>() && camera->GetComponent<Camera>()->IsActive())
@@ -119,7 +146,6 @@ namespace XREX
 				cameras.push_back(camera);
 			}
 		}
-		return cameras;
 	}
 
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "Scene/Scene.hpp"
 #include "Scene/SceneObject.hpp"
+#include "Base/FrustumCulling.hpp"
 
 #include <vector>
 #include <algorithm>
@@ -52,13 +53,26 @@ namespace XREX
 			cameras_ = std::vector<SceneObjectSP>();
 		}
 
-		virtual std::vector<SceneObjectSP> GetRenderableQueue(SceneObjectSP const& camera) override;
+		/*
+		 *	Visible objects whose world bounding boxes intersect with the camera frustum, tested in batches by CullBoxes.
+		 *	Objects without a bounding box are never culled, neither is anything without camera.
+		 */
+		virtual void GetRenderableQueue(SceneObjectSP const& camera, std::vector<SceneObjectSP>& queue) override;
+		using Scene::GetRenderableQueue;
 
-		virtual std::vector<SceneObjectSP> GetCameras() override;
+		virtual void GetCameras(std::vector<SceneObjectSP>& cameras) override;
+		using Scene::GetCameras;
 
 	private:
 		std::vector<SceneObjectSP> objects_;
 		std::vector<SceneObjectSP> cameras_;
+
+		/*
+		 *	Per call buffers, kept to reuse memory.
+		 */
+		BoundingBoxArrays boxes_;
+		std::vector<SceneObjectSP const*> boxedObjects_;
+		std::vector<uint32> visibilityMask_;
 	};
 
 }
@@ -0,0 +1,159 @@
+#include "XREX.hpp"
+
+#include "RenderSortKey.hpp"
+
+#include <vector>
+#include <array>
+
+namespace XREX
+{
+
+	namespace
+	{
+		uint32 const GroupShift = 64 - RenderSortKey::GroupBits;
+		uint32 const TransparentShift = GroupShift - 1;
+
+		uint32 const OpaqueTechniqueShift = TransparentShift - RenderSortKey::IDBits;
+		uint32 const OpaqueMaterialShift = OpaqueTechniqueShift - RenderSortKey::IDBits;
+		uint32 const OpaqueLayoutShift = OpaqueMaterialShift - RenderSortKey::IDBits;
+		uint32 const OpaqueDepthShift = 0;
+
+		uint32 const TransparentDepthShift = TransparentShift - RenderSortKey::DepthBits;
+		uint32 const TransparentTechniqueShift = TransparentDepthShift - RenderSortKey::IDBits;
+		uint32 const TransparentMaterialShift = TransparentTechniqueShift - RenderSortKey::IDBits;
+		uint32 const TransparentLayoutShift = 0;
+
+		static_assert(OpaqueLayoutShift == RenderSortKey::DepthBits, "opaque key bits must add up to 64.");
+		static_assert(TransparentMaterialShift == RenderSortKey::IDBits, "transparent key bits must add up to 64.");
+
+		uint32 const RadixBits = 8;
+		uint32 const RadixSize = 1 << RadixBits;
+		uint32 const RadixPassCount = 64 / RadixBits;
+
+		inline uint32 GetField(uint64 key, uint32 shift, uint32 mask)
+		{
+			return static_cast<uint32>(key >> shift) & mask;
+		}
+	}
+
+
+
+	uint64 RenderSortKey::Make(int32 renderingGroup, bool transparent, uint32 techniqueID, uint32 materialID, uint32 layoutID, float depth)
+	{
+		int32 const halfGroupRange = 1 << (GroupBits - 1);
+		uint64 group = static_cast<uint64>(std::min(std::max(renderingGroup, -halfGroupRange), halfGroupRange - 1) + halfGroupRange);
+		uint64 quantizedDepth = static_cast<uint64>(std::min(std::max(depth, 0.f), 1.f) * MaxDepth + 0.5f);
+		uint64 technique = techniqueID & MaxID;
+		uint64 material = materialID & MaxID;
+		uint64 layout = layoutID & MaxID;
+
+		uint64 key = group << GroupShift;
+		if (transparent)
+		{
+			key |= uint64(1) << TransparentShift;
+			key |= (MaxDepth - quantizedDepth) << TransparentDepthShift;
+			key |= technique << TransparentTechniqueShift;
+			key |= material << TransparentMaterialShift;
+			key |= layout << TransparentLayoutShift;
+		}
+		else
+		{
+			key |= technique << OpaqueTechniqueShift;
+			key |= material << OpaqueMaterialShift;
+			key |= layout << OpaqueLayoutShift;
+			key |= quantizedDepth << OpaqueDepthShift;
+		}
+		return key;
+	}
+
+	int32 RenderSortKey::GetRenderingGroup(uint64 key)
+	{
+		return static_cast<int32>(GetField(key, GroupShift, (1 << GroupBits) - 1)) - (1 << (GroupBits - 1));
+	}
+
+	bool RenderSortKey::IsTransparent(uint64 key)
+	{
+		return GetField(key, TransparentShift, 1) != 0;
+	}
+
+	uint32 RenderSortKey::GetTechniqueID(uint64 key)
+	{
+		return GetField(key, IsTransparent(key) ? TransparentTechniqueShift : OpaqueTechniqueShift, MaxID);
+	}
+
+	uint32 RenderSortKey::GetMaterialID(uint64 key)
+	{
+		return GetField(key, IsTransparent(key) ? TransparentMaterialShift : OpaqueMaterialShift, MaxID);
+	}
+
+	uint32 RenderSortKey::GetLayoutID(uint64 key)
+	{
+		return GetField(key, IsTransparent(key) ? TransparentLayoutShift : OpaqueLayoutShift, MaxID);
+	}
+
+	uint32 RenderSortKey::GetDepth(uint64 key)
+	{
+		if (IsTransparent(key))
+		{
+			return MaxDepth - GetField(key, TransparentDepthShift, MaxDepth);
+		}
+		return GetField(key, OpaqueDepthShift, MaxDepth);
+	}
+
+
+
+	void RadixSort(std::vector<RenderSortItem>& items, std::vector<RenderSortItem>& buffer)
+	{
+		uint32 count = items.size();
+		if (count <= 1)
+		{
+			return;
+		}
+
+		// histograms of all passes in one go
+		std::array<std::array<uint32, RadixSize>, RadixPassCount> histograms;
+		for (auto& histogram : histograms)
+		{
+			histogram.fill(0);
+		}
+		for (auto& item : items)
+		{
+			for (uint32 pass = 0; pass < RadixPassCount; ++pass)
+			{
+				++histograms[pass][GetField(item.key, pass * RadixBits, RadixSize - 1)];
+			}
+		}
+
+		buffer.resize(count);
+		std::vector<RenderSortItem>* source = &items;
+		std::vector<RenderSortItem>* destination = &buffer;
+		for (uint32 pass = 0; pass < RadixPassCount; ++pass)
+		{
+			std::array<uint32, RadixSize>& histogram = histograms[pass];
+			uint32 shift = pass * RadixBits;
+			if (histogram[GetField((*source)[0].key, shift, RadixSize - 1)] == count)
+			{
+				continue; // all keys have the same digit, order will not change
+			}
+
+			uint32 offset = 0;
+			for (uint32& bucket : histogram)
+			{
+				uint32 bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+			for (auto& item : *source)
+			{
+				(*destination)[histogram[GetField(item.key, shift, RadixSize - 1)]++] = item;
+			}
+			std::swap(source, destination);
+		}
+
+		if (source != &items)
+		{
+			items.swap(buffer);
+		}
+	}
+
+}
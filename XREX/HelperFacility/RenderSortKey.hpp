@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	64 bit key of a draw, drawing in ascending order of keys gives:
+	 *	rendering groups in ascending order, in each group opaque draws before transparent draws.
+	 *	Opaque draws are grouped by technique, material and layout to reduce state changes, front to back inside a group.
+	 *	Transparent draws are back to front, grouped by states only when depth is the same.
+	 *
+	 *	opaque:      | group 8 | 0 | technique 12 | material 12 | layout 12 | depth 19 |
+	 *	transparent: | group 8 | 1 | inverted depth 19 | technique 12 | material 12 | layout 12 |
+	 */
+	class XREX_API RenderSortKey
+	{
+	public:
+		static uint32 const GroupBits = 8;
+		static uint32 const IDBits = 12;
+		static uint32 const DepthBits = 19;
+
+		static uint32 const MaxID = (1 << IDBits) - 1;
+		static uint32 const MaxDepth = (1 << DepthBits) - 1;
+
+	public:
+		/*
+		 *	@renderingGroup: clamped to [-128, 127].
+		 *	@techniqueID, materialID, layoutID: only the low IDBits bits are used,
+		 *		ids larger than MaxID still sort correctly, only grouping of states becomes less efficient.
+		 *	@depth: view depth normalized to [0, 1], clamped.
+		 */
+		static uint64 Make(int32 renderingGroup, bool transparent, uint32 techniqueID, uint32 materialID, uint32 layoutID, float depth);
+
+		static int32 GetRenderingGroup(uint64 key);
+		static bool IsTransparent(uint64 key);
+		static uint32 GetTechniqueID(uint64 key);
+		static uint32 GetMaterialID(uint64 key);
+		static uint32 GetLayoutID(uint64 key);
+		static uint32 GetDepth(uint64 key);
+
+	private:
+		RenderSortKey();
+	};
+
+	struct RenderSortItem
+	{
+		uint64 key;
+		/*
+		 *	Index of the draw the key belongs to.
+		 */
+		uint32 index;
+
+		RenderSortItem()
+		{
+		}
+		RenderSortItem(uint64 key, uint32 index)
+			: key(key), index(index)
+		{
+		}
+	};
+
+	/*
+	 *	Stable LSD radix sort by key in ascending order, 8 bits a pass.
+	 *	Passes in which all keys have the same digit are skipped, so keys only differing in a few bytes cost a few passes.
+	 *	@buffer: temporary storage. Keep it between calls to avoid allocations.
+	 */
+	XREX_API void RadixSort(std::vector<RenderSortItem>& items, std::vector<RenderSortItem>& buffer);
+
+}
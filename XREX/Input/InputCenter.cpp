@@ -24,12 +24,14 @@ namespace XREX
 
 	bool InputCenter::AddInputHandler(InputHandlerSP const& inputHandler)
 	{
+		std::lock_guard<std::mutex> lock(inputMutex_);
 		auto result = inputHandlers_.insert(inputHandler);
 		return result.second;
 	}
 
 	bool InputCenter::RemoveInputHandler(InputHandlerSP const& inputHandler)
 	{
+		std::lock_guard<std::mutex> lock(inputMutex_);
 		auto found = inputHandlers_.find(inputHandler);
 		if (found == inputHandlers_.end())
 		{
@@ -43,16 +45,22 @@ namespace XREX
 	void InputCenter::ExecuteAllQueuedActions()
 	{
 		double currentTime = XREXContext::GetInstance().GetElapsedTime();
-		for (auto i = inputHandlers_.begin(); i != inputHandlers_.end(); ++i)
+		std::queue<Action> actions;
 		{
-			(*i)->OnBeforeLogicFrame(currentTime);
+			std::lock_guard<std::mutex> lock(inputMutex_);
+			for (auto i = inputHandlers_.begin(); i != inputHandlers_.end(); ++i)
+			{
+				(*i)->OnBeforeLogicFrame(currentTime);
+			}
+			actions.swap(actionQueue_);
 		}
 
-		while (!actionQueue_.empty())
+		// actions modify the scene, execute them without holding the lock.
+		while (!actions.empty())
 		{
-			Action& action = actionQueue_.front();
+			Action& action = actions.front();
 			action.inputCommand();
-			actionQueue_.pop();
+			actions.pop();
 		}
 	}
 
@@ -60,18 +68,21 @@ namespace XREX
 
 	void InputCenter::InjectKeyDown(InputSemantic semantic)
 	{
+		std::lock_guard<std::mutex> lock(inputMutex_);
 		semanticStates_[static_cast<uint32>(semantic)] = true;
 		DispatchInputEvent(semantic, static_cast<uint32>(true));
 	}
 
 	void InputCenter::InjectKeyUp(InputSemantic semantic)
 	{
+		std::lock_guard<std::mutex> lock(inputMutex_);
 		semanticStates_[static_cast<uint32>(semantic)] = false;
 		DispatchInputEvent(semantic, static_cast<uint32>(false));
 	}
 
 	void InputCenter::InjectMouseDown(InputSemantic semantic, int32 x, int32 y)
 	{
+		std::lock_guard<std::mutex> lock(inputMutex_);
 		semanticStates_[static_cast<uint32>(semantic)] = true;
 		previousPointerPosition_ = pointerPosition_;
 		pointerPosition_ = intV2(x, y);
@@ -80,6 +91,7 @@ namespace XREX
 
 	void InputCenter::InjectMouseUp(InputSemantic semantic, int32 x, int32 y)
 	{
+		std::lock_guard<std::mutex> lock(inputMutex_);
 		semanticStates_[static_cast<uint32>(semantic)] = false;
 		previousPointerPosition_ = pointerPosition_;
 		pointerPosition_ = intV2(x, y);
@@ -88,6 +100,7 @@ namespace XREX
 
 	void InputCenter::InjectMouseWheel(InputSemantic semantic, int32 x, int32 y, int32 wheelDelta)
 	{
+		std::lock_guard<std::mutex> lock(inputMutex_);
 		previousPointerPosition_ = pointerPosition_;
 		pointerPosition_ = intV2(x, y);
 		DispatchInputEvent(semantic, wheelDelta);
@@ -95,6 +108,7 @@ namespace XREX
 
 	void InputCenter::InjectMouseMove(InputSemantic semantic, int32 x, int32 y)
 	{
+		std::lock_guard<std::mutex> lock(inputMutex_);
 		previousPointerPosition_ = pointerPosition_;
 		pointerPosition_ = intV2(x, y);
 		DispatchInputEvent(semantic, 0);
@@ -7,6 +7,7 @@
 #include <unordered_set>
 #include <queue>
 #include <functional>
+#include <mutex>
 
 namespace XREX
 {
@@ -235,6 +236,7 @@ namespace XREX
 
 		/*
 		 *	InputHandler generated action command should be enqueued here.
+		 *	Only called while dispatching input events or in InputHandler::OnBeforeLogicFrame, both are guarded by inputMutex_.
 		 */
 		void EnqueueAction(std::function<void()>&& action)
 		{
@@ -281,6 +283,7 @@ namespace XREX
 			Action& operator =(Action&& right)
 			{
 				inputCommand = std::move(right.inputCommand);
+				return *this;
 			}
 
 			std::function<void()> inputCommand;
@@ -295,6 +298,10 @@ namespace XREX
 
 		std::queue<Action> actionQueue_;
 
+		/*
+		 *	Input is injected by window thread, while actions are executed by logic thread when they are separated.
+		 */
+		std::mutex inputMutex_;
 	};
 
 }
@@ -0,0 +1,176 @@
+#include "XREX.hpp"
+
+#include "BufferArena.hpp"
+
+#include <algorithm>
+
+namespace XREX
+{
+
+	RangeAllocator::RangeAllocator(uint32 size)
+		: size_(size), allocatedSize_(0)
+	{
+		assert(size != 0);
+		freeRanges_[0] = size;
+	}
+
+	std::pair<bool, uint32> RangeAllocator::Allocate(uint32 size, uint32 alignment)
+	{
+		assert(size != 0 && alignment != 0);
+		for (auto i = freeRanges_.begin(); i != freeRanges_.end(); ++i)
+		{
+			uint32 start = i->first;
+			uint32 end = i->first + i->second;
+			uint32 alignedStart = (start + alignment - 1) / alignment * alignment;
+			if (alignedStart >= end || end - alignedStart < size)
+			{
+				continue;
+			}
+			freeRanges_.erase(i);
+			if (alignedStart != start) // padding stays free
+			{
+				freeRanges_[start] = alignedStart - start;
+			}
+			if (alignedStart + size != end)
+			{
+				freeRanges_[alignedStart + size] = end - (alignedStart + size);
+			}
+			allocatedSize_ += size;
+			return std::make_pair(true, alignedStart);
+		}
+		return std::make_pair(false, 0u);
+	}
+
+	void RangeAllocator::Free(uint32 offset, uint32 size)
+	{
+		assert(size != 0 && offset + size <= size_);
+		assert(allocatedSize_ >= size);
+		uint32 start = offset;
+		uint32 end = offset + size;
+		auto next = freeRanges_.lower_bound(offset);
+		assert(next == freeRanges_.end() || end <= next->first);
+		if (next != freeRanges_.begin())
+		{
+			auto previous = next;
+			--previous;
+			assert(previous->first + previous->second <= start);
+			if (previous->first + previous->second == start)
+			{
+				start = previous->first;
+				freeRanges_.erase(previous);
+			}
+		}
+		if (next != freeRanges_.end() && next->first == end)
+		{
+			end = next->first + next->second;
+			freeRanges_.erase(next);
+		}
+		freeRanges_[start] = end - start;
+		allocatedSize_ -= size;
+	}
+
+
+
+
+	struct BufferArena::Page
+		: Noncopyable
+	{
+		GraphicsBufferSP buffer;
+		RangeAllocator allocator;
+
+		explicit Page(GraphicsBufferSP&& theBuffer)
+			: buffer(std::move(theBuffer)), allocator(buffer->GetSize())
+		{
+		}
+	};
+
+	/*
+	 *	Owner of an allocated range, GraphicsBufferSPs returned by Allocate share it and point to the page.
+	 */
+	struct BufferArena::Range
+		: Noncopyable
+	{
+		std::shared_ptr<Page> page;
+		uint32 offset;
+		uint32 size;
+
+		Range(std::shared_ptr<Page> const& thePage, uint32 theOffset, uint32 theSize)
+			: page(thePage), offset(theOffset), size(theSize)
+		{
+		}
+		~Range()
+		{
+			page->allocator.Free(offset, size);
+		}
+	};
+
+
+
+	BufferArena::BufferArena(GraphicsBuffer::Usage usage, BufferView::BufferType typeHint, uint32 pageSizeInBytes)
+		: usage_(usage), typeHint_(typeHint), pageSize_(pageSizeInBytes)
+	{
+		assert(pageSizeInBytes != 0);
+	}
+
+	BufferArena::~BufferArena()
+	{
+	}
+
+	std::pair<GraphicsBufferSP, uint32> BufferArena::Allocate(void const* data, uint32 sizeInBytes, uint32 alignment)
+	{
+		assert(sizeInBytes != 0 && alignment != 0);
+		pages_.erase(std::remove_if(pages_.begin(), pages_.end(), [] (std::weak_ptr<Page> const& existingPage)
+		{
+			return existingPage.expired();
+		}), pages_.end());
+
+		std::shared_ptr<Page> page;
+		std::pair<bool, uint32> offset(false, 0);
+		for (auto& weakPage : pages_)
+		{
+			std::shared_ptr<Page> existingPage = weakPage.lock();
+			offset = existingPage->allocator.Allocate(sizeInBytes, alignment);
+			if (offset.first)
+			{
+				page = std::move(existingPage);
+				break;
+			}
+		}
+		if (!offset.first)
+		{
+			uint32 pageSize = std::max(pageSize_, sizeInBytes);
+			page = MakeSP<Page>(MakeSP<GraphicsBuffer>(usage_, pageSize, typeHint_));
+			pages_.push_back(page);
+			offset = page->allocator.Allocate(sizeInBytes, alignment);
+			assert(offset.first && offset.second == 0);
+		}
+		if (data != nullptr)
+		{
+			page->buffer->UpdateSubData(offset.second, sizeInBytes, data);
+		}
+		std::shared_ptr<Range> range = MakeSP<Range>(page, offset.second, sizeInBytes);
+		return std::make_pair(GraphicsBufferSP(range, page->buffer.get()), offset.second);
+	}
+
+	uint32 BufferArena::GetPageCount() const
+	{
+		return std::count_if(pages_.begin(), pages_.end(), [] (std::weak_ptr<Page> const& page)
+		{
+			return !page.expired();
+		});
+	}
+
+	uint32 BufferArena::GetAllocatedSize() const
+	{
+		uint32 size = 0;
+		for (auto& weakPage : pages_)
+		{
+			if (std::shared_ptr<Page> page = weakPage.lock())
+			{
+				size += page->allocator.GetAllocatedSize();
+			}
+		}
+		return size;
+	}
+
+}
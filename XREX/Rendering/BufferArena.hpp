@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Rendering/GraphicsBuffer.hpp"
+
+#include <map>
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Free list of a range [0, size), first fit. Free ranges are kept sorted by offset and merged with neighbours when released.
+	 *	Only book keeping, does not own any memory.
+	 */
+	class XREX_API RangeAllocator
+	{
+	public:
+		explicit RangeAllocator(uint32 size);
+
+		/*
+		 *	@alignment: offset is a multiple of it, need not be power of 2, e.g. size of a vertex.
+		 *	@return: first: false if no free range is large enough. second: offset.
+		 */
+		std::pair<bool, uint32> Allocate(uint32 size, uint32 alignment);
+		/*
+		 *	@offset, size: exactly what was allocated.
+		 */
+		void Free(uint32 offset, uint32 size);
+
+		uint32 GetSize() const
+		{
+			return size_;
+		}
+		uint32 GetAllocatedSize() const
+		{
+			return allocatedSize_;
+		}
+		uint32 GetFreeRangeCount() const
+		{
+			return freeRanges_.size();
+		}
+
+	private:
+		uint32 size_;
+		uint32 allocatedSize_;
+		/*
+		 *	offset -> size.
+		 */
+		std::map<uint32, uint32> freeRanges_;
+	};
+
+
+
+	/*
+	 *	Hands out ranges of large GraphicsBuffer pages, so many small static meshes share a few GL buffers.
+	 *	A range is released when the last GraphicsBufferSP returned by Allocate for it is destructed.
+	 *	Pages are owned only by their ranges, so ranges may outlive the arena, and a page is destructed with its last range.
+	 *	Only used on the rendering thread.
+	 */
+	class XREX_API BufferArena
+		: Noncopyable
+	{
+	public:
+		static uint32 const DefaultPageSizeInBytes = 16 * 1024 * 1024;
+
+	public:
+		BufferArena(GraphicsBuffer::Usage usage, BufferView::BufferType typeHint, uint32 pageSizeInBytes);
+		~BufferArena();
+
+		/*
+		 *	Allocate a range and upload data to it, a page just large enough is created for data larger than the page size.
+		 *	@data: can be null, the range is left uninitialized.
+		 *	@alignment: see RangeAllocator::Allocate.
+		 *	@return: first: the page, shares ownership of the range. second: offset of the range in bytes.
+		 */
+		std::pair<GraphicsBufferSP, uint32> Allocate(void const* data, uint32 sizeInBytes, uint32 alignment);
+
+		/*
+		 *	Pages having live ranges.
+		 */
+		uint32 GetPageCount() const;
+		/*
+		 *	Bytes of live ranges of all pages, not including alignment.
+		 */
+		uint32 GetAllocatedSize() const;
+
+	private:
+		struct Page;
+		struct Range;
+
+	private:
+		GraphicsBuffer::Usage usage_;
+		BufferView::BufferType typeHint_;
+		uint32 pageSize_;
+		/*
+		 *	Expired ones are removed in Allocate.
+		 */
+		std::vector<std::weak_ptr<Page>> pages_;
+	};
+
+}
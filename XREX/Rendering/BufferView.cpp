@@ -10,12 +10,12 @@
 namespace XREX
 {
 	BufferView::BufferView(BufferType type)
-		: type_(type)
+		: type_(type), rangeOffset_(0), rangeSize_(0)
 	{
 	}
 
 	BufferView::BufferView(BufferType type, GraphicsBufferSP const& buffer)
-		: type_(type), buffer_(buffer)
+		: type_(type), buffer_(buffer), rangeOffset_(0), rangeSize_(0)
 	{
 	}
 
@@ -28,13 +28,25 @@ namespace XREX
 	{
 		assert(SetBufferCheck(buffer));
 		buffer_ = buffer;
+		rangeOffset_ = 0;
+		rangeSize_ = 0;
+	}
+
+	void BufferView::SetBufferRange(GraphicsBufferSP const& buffer, uint32 offset, uint32 sizeInBytes)
+	{
+		assert(buffer != nullptr && sizeInBytes != 0);
+		assert(offset + sizeInBytes <= buffer->GetSize());
+		assert(SetBufferRangeCheck(buffer, offset, sizeInBytes));
+		buffer_ = buffer;
+		rangeOffset_ = offset;
+		rangeSize_ = sizeInBytes;
 	}
 
 
 	uint32 BufferView::GetBufferSize() const
 	{
 		assert(HaveBuffer());
-		return buffer_->GetSize();
+		return IsWholeBuffer() ? buffer_->GetSize() : rangeSize_;
 	}
 
 
@@ -47,7 +59,14 @@ namespace XREX
 	void BufferView::BindIndex(uint32 index)
 	{
 		assert(HaveBuffer());
-		buffer_->BindIndex(type_, index);
+		if (IsWholeBuffer())
+		{
+			buffer_->BindIndex(type_, index);
+		}
+		else
+		{
+			buffer_->BindIndexRange(type_, index, rangeOffset_, rangeSize_);
+		}
 	}
 
 	void BufferView::Unbind()
@@ -67,4 +86,9 @@ namespace XREX
 		return true;
 	}
 
+	bool BufferView::SetBufferRangeCheck(GraphicsBufferSP const& newBuffer, uint32 offset, uint32 sizeInBytes)
+	{
+		return true;
+	}
+
 }
@@ -21,6 +21,7 @@ namespace XREX
 			Texture,
 			AtomicCounter,
 			ShaderStorage,
+			DrawIndirect,
 
 			TypeCount,
 		};
@@ -46,7 +47,22 @@ namespace XREX
 			return buffer_;
 		}
 		void SetBuffer(GraphicsBufferSP const& buffer);
+		/*
+		 *	View only a range of the buffer, BindIndex binds the range instead of the whole buffer.
+		 */
+		void SetBufferRange(GraphicsBufferSP const& buffer, uint32 offset, uint32 sizeInBytes);
+		bool IsWholeBuffer() const
+		{
+			return rangeSize_ == 0;
+		}
+		uint32 GetRangeOffset() const
+		{
+			return rangeOffset_;
+		}
 
+		/*
+		 *	@return: size of the range if only a range is viewed.
+		 */
 		uint32 GetBufferSize() const;
 
 		virtual void Bind();
@@ -57,10 +73,16 @@ namespace XREX
 
 	protected:
 		virtual bool SetBufferCheck(GraphicsBufferSP const& newBuffer);
+		virtual bool SetBufferRangeCheck(GraphicsBufferSP const& newBuffer, uint32 offset, uint32 sizeInBytes);
 
 	private:
 		GraphicsBufferSP buffer_;
 		BufferType type_;
+		uint32 rangeOffset_;
+		/*
+		 *	0 if the whole buffer is viewed.
+		 */
+		uint32 rangeSize_;
 	};
 
 
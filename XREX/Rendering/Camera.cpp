@@ -17,6 +17,10 @@ namespace XREX
 		viewport_ = XREXContext::GetInstance().GetRenderingFactory().GetDefaultViewport();
 	}
 
+	Camera::~Camera()
+	{
+	}
+
 
 	void Camera::Update() const
 	{
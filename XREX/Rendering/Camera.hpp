@@ -21,9 +21,7 @@ namespace XREX
 	protected:
 		Camera();
 	public:
-		virtual ~Camera() override = 0
-		{
-		}
+		virtual ~Camera() override = 0;
 
 
 		bool IsActive() const
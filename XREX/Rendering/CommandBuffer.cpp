@@ -0,0 +1,361 @@
+#include "XREX.hpp"
+
+#include "CommandBuffer.hpp"
+
+#include "Rendering/RenderingLayout.hpp"
+#include "Rendering/RenderingTechnique.hpp"
+#include "Rendering/ShaderProgram.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace XREX
+{
+	namespace
+	{
+		/*
+		 *	Every command starts with a header, size includes the header and is a multiple of 8.
+		 */
+		struct CommandHeader
+		{
+			CommandBuffer::CommandType type;
+			uint32 size;
+		};
+
+		struct BindTechniqueCommand
+		{
+			RenderingTechnique* technique;
+		};
+		struct BindLayoutCommand
+		{
+			LayoutAndProgramConnector* connector;
+			RenderingLayout* layout;
+		};
+		/*
+		 *	A parameter block is a sequence of entries, each followed by its value padded to 8 bytes.
+		 */
+		struct ParameterEntry
+		{
+			TechniqueParameter* parameter;
+			ElementType type;
+			uint32 size;
+		};
+		struct SetBufferDataCommand
+		{
+			ShaderResourceBuffer* buffer;
+			uint32 size;
+		};
+		struct BindMaterialCommand
+		{
+			Material* material;
+		};
+		struct DrawCommand
+		{
+			uint32 indexCount;
+			uint32 firstIndex;
+			int32 baseVertex;
+			uint32 instanceCount;
+		};
+		/*
+		 *	Followed by drawCount indirect commands, then drawCount world matrices, each array starts 8 bytes aligned.
+		 */
+		struct MultiDrawCommand
+		{
+			uint32 drawCount;
+		};
+		struct DispatchCommand
+		{
+			uint32 groupCountX;
+			uint32 groupCountY;
+			uint32 groupCountZ;
+		};
+		struct SetViewportCommand
+		{
+			Viewport const* viewport;
+		};
+		struct ClearCommand
+		{
+			FrameBuffer* frameBuffer;
+			FrameBuffer::ClearMask clearMask;
+			Color clearColor;
+			float clearDepth;
+			uint16 clearStencil;
+		};
+		struct BeginProfileRangeCommand
+		{
+			char const* name;
+			int32 argument;
+			bool hasArgument;
+		};
+
+		uint32 const NoParameterBlock = static_cast<uint32>(-1);
+
+		uint32 Align8(uint32 size)
+		{
+			return (size + 7) & ~7;
+		}
+	}
+
+
+
+	ICommandExecutor::~ICommandExecutor()
+	{
+	}
+
+
+
+	void CommandBuffer::ExecuteInOrder(std::vector<CommandBuffer*>& buffers, ICommandExecutor& executor)
+	{
+		std::stable_sort(buffers.begin(), buffers.end(), [] (CommandBuffer const* left, CommandBuffer const* right)
+		{
+			return left->GetSortKey() < right->GetSortKey();
+		});
+		for (CommandBuffer const* buffer : buffers)
+		{
+			buffer->Execute(executor);
+		}
+	}
+
+	CommandBuffer::CommandBuffer()
+		: size_(0), commandCount_(0), parameterBlockOffset_(NoParameterBlock), recordingLayout_(nullptr), sortKey_(0)
+	{
+	}
+
+	CommandBuffer::~CommandBuffer()
+	{
+	}
+
+	void CommandBuffer::Reset()
+	{
+		size_ = 0;
+		commandCount_ = 0;
+		parameterBlockOffset_ = NoParameterBlock;
+		recordingLayout_ = nullptr;
+		sortKey_ = 0;
+	}
+
+	void* CommandBuffer::Grow(uint32 sizeInBytes)
+	{
+		assert(sizeInBytes % 8 == 0);
+		uint32 offset = size_;
+		size_ += sizeInBytes;
+		if (storage_.size() * sizeof(uint64) < size_)
+		{
+			storage_.resize(std::max<uint32>(size_ / sizeof(uint64), storage_.size() * 2));
+		}
+		return reinterpret_cast<uint8*>(storage_.data()) + offset;
+	}
+
+	void* CommandBuffer::Append(CommandType type, uint32 payloadSize)
+	{
+		uint32 size = Align8(sizeof(CommandHeader) + payloadSize);
+		CommandHeader* header = static_cast<CommandHeader*>(Grow(size));
+		header->type = type;
+		header->size = size;
+		++commandCount_;
+		parameterBlockOffset_ = NoParameterBlock;
+		return header + 1;
+	}
+
+	void CommandBuffer::BindTechnique(RenderingTechnique* technique)
+	{
+		static_cast<BindTechniqueCommand*>(Append(CommandType::BindTechnique, sizeof(BindTechniqueCommand)))->technique = technique;
+	}
+
+	void CommandBuffer::BindLayout(LayoutAndProgramConnector* connector, RenderingLayout* layout)
+	{
+		assert(layout != nullptr);
+		BindLayoutCommand* command = static_cast<BindLayoutCommand*>(Append(CommandType::BindLayout, sizeof(BindLayoutCommand)));
+		command->connector = connector;
+		command->layout = layout;
+		recordingLayout_ = layout;
+	}
+
+	void CommandBuffer::SetParameter(TechniqueParameter& parameter, ElementType type, void const* value, uint32 sizeInBytes)
+	{
+		assert(parameter.GetType() == type);
+		if (parameterBlockOffset_ == NoParameterBlock)
+		{
+			Append(CommandType::SetParameterBlock, 0);
+			parameterBlockOffset_ = size_ - Align8(sizeof(CommandHeader));
+		}
+		uint32 entrySize = Align8(sizeof(ParameterEntry) + sizeInBytes);
+		ParameterEntry* entry = static_cast<ParameterEntry*>(Grow(entrySize));
+		entry->parameter = &parameter;
+		entry->type = type;
+		entry->size = sizeInBytes;
+		memcpy(entry + 1, value, sizeInBytes);
+		reinterpret_cast<CommandHeader*>(reinterpret_cast<uint8*>(storage_.data()) + parameterBlockOffset_)->size += entrySize;
+	}
+
+	void* CommandBuffer::SetBufferData(ShaderResourceBuffer& buffer)
+	{
+		uint32 size = buffer.GetBufferInformation().GetDataSize();
+		SetBufferDataCommand* command = static_cast<SetBufferDataCommand*>(Append(CommandType::SetBufferData, Align8(sizeof(SetBufferDataCommand)) + size));
+		command->buffer = &buffer;
+		command->size = size;
+		void* data = reinterpret_cast<uint8*>(command) + Align8(sizeof(SetBufferDataCommand));
+		memset(data, 0, size);
+		return data;
+	}
+
+	void CommandBuffer::BindMaterial(Material& material)
+	{
+		static_cast<BindMaterialCommand*>(Append(CommandType::BindMaterial, sizeof(BindMaterialCommand)))->material = &material;
+	}
+
+	void CommandBuffer::Draw(uint32 instanceCount)
+	{
+		assert(recordingLayout_ != nullptr);
+		DrawCommand* command = static_cast<DrawCommand*>(Append(CommandType::Draw, sizeof(DrawCommand)));
+		command->indexCount = recordingLayout_->GetElementCount();
+		command->firstIndex = recordingLayout_->GetFirstIndex();
+		command->baseVertex = recordingLayout_->GetBaseVertex();
+		command->instanceCount = instanceCount;
+	}
+
+	CommandBuffer::MultiDrawData CommandBuffer::MultiDraw(uint32 drawCount)
+	{
+		assert(recordingLayout_ != nullptr);
+		uint32 commandsOffset = Align8(sizeof(MultiDrawCommand));
+		uint32 parametersOffset = commandsOffset + Align8(drawCount * sizeof(IndirectDrawer::DrawElementsIndirectCommand));
+		MultiDrawCommand* command = static_cast<MultiDrawCommand*>(Append(CommandType::MultiDraw, parametersOffset + drawCount * sizeof(floatM44)));
+		command->drawCount = drawCount;
+		MultiDrawData data;
+		data.commands = reinterpret_cast<IndirectDrawer::DrawElementsIndirectCommand*>(reinterpret_cast<uint8*>(command) + commandsOffset);
+		data.drawParameters = reinterpret_cast<floatM44*>(reinterpret_cast<uint8*>(command) + parametersOffset);
+		return data;
+	}
+
+	void CommandBuffer::Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ)
+	{
+		DispatchCommand* command = static_cast<DispatchCommand*>(Append(CommandType::Dispatch, sizeof(DispatchCommand)));
+		command->groupCountX = groupCountX;
+		command->groupCountY = groupCountY;
+		command->groupCountZ = groupCountZ;
+	}
+
+	void CommandBuffer::SetViewport(Viewport const& viewport)
+	{
+		static_cast<SetViewportCommand*>(Append(CommandType::SetViewport, sizeof(SetViewportCommand)))->viewport = &viewport;
+	}
+
+	void CommandBuffer::Clear(FrameBuffer& frameBuffer, FrameBuffer::ClearMask clearMask, Color const& clearColor, float clearDepth, uint16 clearStencil)
+	{
+		ClearCommand* command = static_cast<ClearCommand*>(Append(CommandType::Clear, sizeof(ClearCommand)));
+		command->frameBuffer = &frameBuffer;
+		command->clearMask = clearMask;
+		command->clearColor = clearColor;
+		command->clearDepth = clearDepth;
+		command->clearStencil = clearStencil;
+	}
+
+	void CommandBuffer::BeginProfileRange(char const* name)
+	{
+		BeginProfileRangeCommand* command = static_cast<BeginProfileRangeCommand*>(Append(CommandType::BeginProfileRange, sizeof(BeginProfileRangeCommand)));
+		command->name = name;
+		command->argument = 0;
+		command->hasArgument = false;
+	}
+
+	void CommandBuffer::BeginProfileRange(char const* name, int32 argument)
+	{
+		BeginProfileRangeCommand* command = static_cast<BeginProfileRangeCommand*>(Append(CommandType::BeginProfileRange, sizeof(BeginProfileRangeCommand)));
+		command->name = name;
+		command->argument = argument;
+		command->hasArgument = true;
+	}
+
+	void CommandBuffer::EndProfileRange()
+	{
+		Append(CommandType::EndProfileRange, 0);
+	}
+
+	void CommandBuffer::Execute(ICommandExecutor& executor) const
+	{
+		uint8 const* current = reinterpret_cast<uint8 const*>(storage_.data());
+		uint8 const* end = current + size_;
+		while (current < end)
+		{
+			CommandHeader const& header = *reinterpret_cast<CommandHeader const*>(current);
+			void const* payload = &header + 1;
+			switch (header.type)
+			{
+			case CommandType::BindTechnique:
+				executor.BindTechnique(static_cast<BindTechniqueCommand const*>(payload)->technique);
+				break;
+			case CommandType::BindLayout:
+				{
+					BindLayoutCommand const& command = *static_cast<BindLayoutCommand const*>(payload);
+					executor.BindLayout(command.connector, command.layout);
+				}
+				break;
+			case CommandType::SetParameterBlock:
+				{
+					uint8 const* entryPosition = static_cast<uint8 const*>(payload);
+					uint8 const* blockEnd = current + header.size;
+					while (entryPosition < blockEnd)
+					{
+						ParameterEntry const& entry = *reinterpret_cast<ParameterEntry const*>(entryPosition);
+						executor.SetParameter(*entry.parameter, entry.type, &entry + 1);
+						entryPosition += Align8(sizeof(ParameterEntry) + entry.size);
+					}
+				}
+				break;
+			case CommandType::SetBufferData:
+				{
+					SetBufferDataCommand const& command = *static_cast<SetBufferDataCommand const*>(payload);
+					executor.SetBufferData(*command.buffer, reinterpret_cast<uint8 const*>(&command) + Align8(sizeof(SetBufferDataCommand)), command.size);
+				}
+				break;
+			case CommandType::BindMaterial:
+				executor.BindMaterial(*static_cast<BindMaterialCommand const*>(payload)->material);
+				break;
+			case CommandType::Draw:
+				{
+					DrawCommand const& command = *static_cast<DrawCommand const*>(payload);
+					executor.Draw(command.indexCount, command.firstIndex, command.baseVertex, command.instanceCount);
+				}
+				break;
+			case CommandType::MultiDraw:
+				{
+					MultiDrawCommand const& command = *static_cast<MultiDrawCommand const*>(payload);
+					uint8 const* commandsPosition = reinterpret_cast<uint8 const*>(&command) + Align8(sizeof(MultiDrawCommand));
+					uint8 const* parametersPosition = commandsPosition + Align8(command.drawCount * sizeof(IndirectDrawer::DrawElementsIndirectCommand));
+					executor.MultiDraw(reinterpret_cast<IndirectDrawer::DrawElementsIndirectCommand const*>(commandsPosition),
+						reinterpret_cast<floatM44 const*>(parametersPosition), command.drawCount);
+				}
+				break;
+			case CommandType::Dispatch:
+				{
+					DispatchCommand const& command = *static_cast<DispatchCommand const*>(payload);
+					executor.Dispatch(command.groupCountX, command.groupCountY, command.groupCountZ);
+				}
+				break;
+			case CommandType::SetViewport:
+				executor.SetViewport(*static_cast<SetViewportCommand const*>(payload)->viewport);
+				break;
+			case CommandType::Clear:
+				{
+					ClearCommand const& command = *static_cast<ClearCommand const*>(payload);
+					executor.Clear(*command.frameBuffer, command.clearMask, command.clearColor, command.clearDepth, command.clearStencil);
+				}
+				break;
+			case CommandType::BeginProfileRange:
+				{
+					BeginProfileRangeCommand const& command = *static_cast<BeginProfileRangeCommand const*>(payload);
+					executor.BeginProfileRange(command.name, command.argument, command.hasArgument);
+				}
+				break;
+			case CommandType::EndProfileRange:
+				executor.EndProfileRange();
+				break;
+			default:
+				assert(false);
+				break;
+			}
+			current += header.size;
+		}
+	}
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Rendering/GraphicsType.hpp"
+#include "Rendering/FrameBuffer.hpp"
+#include "Rendering/WorkLauncher.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Receives commands replayed by CommandBuffer::Execute. GLCommandExecutor does the real work,
+	 *	other implementations can inspect or count commands without a context.
+	 */
+	struct XREX_API ICommandExecutor
+	{
+		virtual ~ICommandExecutor();
+
+		virtual void BindTechnique(RenderingTechnique* technique) = 0;
+		virtual void BindLayout(LayoutAndProgramConnector* connector, RenderingLayout* layout) = 0;
+		virtual void SetParameter(TechniqueParameter& parameter, ElementType type, void const* value) = 0;
+		virtual void SetBufferData(ShaderResourceBuffer& buffer, void const* data, uint32 sizeInBytes) = 0;
+		virtual void BindMaterial(Material& material) = 0;
+		virtual void Draw(uint32 indexCount, uint32 firstIndex, int32 baseVertex, uint32 instanceCount) = 0;
+		virtual void MultiDraw(IndirectDrawer::DrawElementsIndirectCommand const* commands, floatM44 const* drawParameters, uint32 drawCount) = 0;
+		virtual void Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ) = 0;
+		virtual void SetViewport(Viewport const& viewport) = 0;
+		virtual void Clear(FrameBuffer& frameBuffer, FrameBuffer::ClearMask clearMask, Color const& clearColor, float clearDepth, uint16 clearStencil) = 0;
+		virtual void BeginProfileRange(char const* name, int32 argument, bool hasArgument) = 0;
+		virtual void EndProfileRange() = 0;
+	};
+
+
+
+	/*
+	 *	Rendering commands recorded into linear memory, replayed later on the rendering thread.
+	 *	Recording does not call GL and does not change the objects it is given, so buffers for disjoint parts of a frame
+	 *	can be recorded by several threads at once, each thread with its own buffer.
+	 *	Commands only keep raw pointers, objects must stay alive until the buffer is executed or reset,
+	 *	e.g. by a FrameSnapshot.
+	 */
+	class XREX_API CommandBuffer
+		: Noncopyable
+	{
+	public:
+		enum class CommandType
+		{
+			BindTechnique,
+			BindLayout,
+			SetParameterBlock,
+			SetBufferData,
+			BindMaterial,
+			Draw,
+			MultiDraw,
+			Dispatch,
+			SetViewport,
+			Clear,
+			BeginProfileRange,
+			EndProfileRange,
+
+			CommandTypeCount
+		};
+
+		/*
+		 *	Where to write draws reserved by MultiDraw, valid until next recording call.
+		 */
+		struct MultiDrawData
+		{
+			IndirectDrawer::DrawElementsIndirectCommand* commands;
+			floatM44* drawParameters;
+		};
+
+	public:
+		/*
+		 *	Execute buffers in ascending order of sort keys, buffers with the same key in the given order.
+		 */
+		static void ExecuteInOrder(std::vector<CommandBuffer*>& buffers, ICommandExecutor& executor);
+
+	public:
+		CommandBuffer();
+		~CommandBuffer();
+
+		/*
+		 *	Remove all commands, memory is kept for next recording.
+		 */
+		void Reset();
+
+		void SetSortKey(uint64 key)
+		{
+			sortKey_ = key;
+		}
+		uint64 GetSortKey() const
+		{
+			return sortKey_;
+		}
+
+		void BindTechnique(RenderingTechnique* technique);
+		/*
+		 *	Following draws use all of layout, with connector bound.
+		 */
+		void BindLayout(LayoutAndProgramConnector* connector, RenderingLayout* layout);
+		/*
+		 *	Value is copied. Consecutive parameters are recorded into one block.
+		 */
+		template <typename T>
+		void SetParameter(TechniqueParameter& parameter, T const& value)
+		{
+			SetParameter(parameter, TypeToElementType<T>::Type, &value, sizeof(T));
+		}
+		void SetParameter(TechniqueParameter& parameter, ElementType type, void const* value, uint32 sizeInBytes);
+		/*
+		 *	Reserve space for the whole data of buffer, filled with 0.
+		 *	@return: where to write the data, valid until next recording call.
+		 */
+		void* SetBufferData(ShaderResourceBuffer& buffer);
+		/*
+		 *	Set values of the material to the technique bound.
+		 */
+		void BindMaterial(Material& material);
+		void Draw(uint32 instanceCount);
+		/*
+		 *	Reserve drawCount draws of ranges of the buffers of the layout bound, executed by one IndirectDrawer launch.
+		 *	Each draw has a command and a world matrix, see DrawParametersTechniqueFactory.
+		 */
+		MultiDrawData MultiDraw(uint32 drawCount);
+		void Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ);
+		void SetViewport(Viewport const& viewport);
+		void Clear(FrameBuffer& frameBuffer, FrameBuffer::ClearMask clearMask, Color const& clearColor, float clearDepth, uint16 clearStencil);
+		/*
+		 *	Ranges measured when executed, see Profiler. Must be nested and ended in the same buffer.
+		 *	@name: see Profiler::Event.
+		 */
+		void BeginProfileRange(char const* name);
+		void BeginProfileRange(char const* name, int32 argument);
+		void EndProfileRange();
+
+		void Execute(ICommandExecutor& executor) const;
+
+		uint32 GetCommandCount() const
+		{
+			return commandCount_;
+		}
+		uint32 GetSizeInBytes() const
+		{
+			return size_;
+		}
+
+	private:
+		/*
+		 *	@return: where to write the payload of the command.
+		 */
+		void* Append(CommandType type, uint32 payloadSize);
+		void* Grow(uint32 sizeInBytes);
+
+	private:
+		std::vector<uint64> storage_; // uint64 keeps commands 8 bytes aligned
+		uint32 size_;
+		uint32 commandCount_;
+		/*
+		 *	Offset of the last parameter block, or -1 if the last command is not one.
+		 */
+		uint32 parameterBlockOffset_;
+		/*
+		 *	Layout of the last BindLayout, used by Draw.
+		 */
+		RenderingLayout* recordingLayout_;
+		uint64 sortKey_;
+	};
+
+}
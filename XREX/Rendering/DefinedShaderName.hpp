@@ -1,3 +1,5 @@
+#pragma once
+
 #include <string>
 #include <array>
 
@@ -16,6 +18,11 @@ namespace XREX
 
 		CameraPosition,
 
+		/*
+		 *	Uniform block of per instance world matrices, see InstanceTransformationTechniqueFactory.
+		 */
+		InstanceTransformation,
+
 		DiffuseColor,
 		SpecularColor,
 		EmissiveColor,
@@ -50,6 +57,8 @@ namespace XREX
 
 			temp[static_cast<uint32>(DefinedUniform::CameraPosition)] = "cameraPosition";
 
+			temp[static_cast<uint32>(DefinedUniform::InstanceTransformation)] = "XREX_Uniform_InstanceTransformation";
+
 			temp[static_cast<uint32>(DefinedUniform::DiffuseColor)] = "diffuseColor";
 			temp[static_cast<uint32>(DefinedUniform::SpecularColor)] = "specularColor";
 			temp[static_cast<uint32>(DefinedUniform::EmissiveColor)] = "emissiveColor";
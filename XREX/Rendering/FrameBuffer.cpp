@@ -4,6 +4,7 @@
 #include "Rendering/Texture.hpp"
 #include "Rendering/TextureImage.hpp"
 #include "Rendering/RenderingPipelineState.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
 
 #include <CoreGL.hpp>
 
@@ -103,7 +104,7 @@ namespace XREX
 			gl::FramebufferParameteri(gl::GL_DRAW_FRAMEBUFFER, gl::GL_FRAMEBUFFER_DEFAULT_HEIGHT, description_->GetSize().Y());
 		}
 
-		std::vector<FrameBufferLayoutDescription::ChannelDescription const> const& channels = description_->GetAllChannels();
+		std::vector<FrameBufferLayoutDescription::ChannelDescription> const& channels = description_->GetAllChannels();
 		for (uint32 i = 0; i < channels.size(); ++i)
 		{
 			FrameBufferLayoutDescription::ChannelDescription const& channel = channels[i];
@@ -176,7 +177,7 @@ namespace XREX
 			break;
 		}
 #endif // XREX_DEBUG
-		gl::BindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, 0);
+		GLStateCache::GetCurrent()->BindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, 0);
 	}
 
 	FrameBuffer::~FrameBuffer()
@@ -184,6 +185,10 @@ namespace XREX
 		if (glFrameBufferID_ != 0)
 		{
 			gl::DeleteFramebuffers(1, &glFrameBufferID_);
+			if (GLStateCache* cache = GLStateCache::GetCurrent())
+			{
+				cache->OnFramebufferDeleted(glFrameBufferID_);
+			}
 			glFrameBufferID_ = 0;
 		}
 	}
@@ -204,21 +209,23 @@ namespace XREX
 
 	void FrameBuffer::BindWrite()
 	{
-		gl::BindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, glFrameBufferID_);
+		GLStateCache::GetCurrent()->BindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, glFrameBufferID_);
 	}
 
 	void FrameBuffer::BindRead()
 	{
-		gl::BindFramebuffer(gl::GL_READ_FRAMEBUFFER, glFrameBufferID_);
+		GLStateCache::GetCurrent()->BindFramebuffer(gl::GL_READ_FRAMEBUFFER, glFrameBufferID_);
 	}
 
 
 	void FrameBuffer::Clear(ClearMask clearMask, Color const& clearColor, float clearDepth, uint16 clearStencil)
 	{
 		BindWrite();
+		// write masks also affect clearing, set through the cache so that it still knows the current masks.
+		GLStateCache& cache = *GLStateCache::GetCurrent();
 		if (static_cast<uint32>(clearMask) & static_cast<uint32>(ClearMask::Color))
 		{
-			gl::ColorMask(true, true, true, true);
+			cache.ColorMask(true, true, true, true);
 			for (uint32 i = 0; i < description_->GetChannelCount(); ++i)
 			{ // TODO different format need to call different ClearBuffer, e.g. gl::ClearBufferiv() gl::ClearBufferuiv()
 				gl::ClearBufferfv(gl::GL_COLOR, i, clearColor.GetArray());
@@ -227,8 +234,9 @@ namespace XREX
 		if (static_cast<uint32>(clearMask) & static_cast<uint32>(ClearMask::Depth)
 			&& static_cast<uint32>(clearMask) & static_cast<uint32>(ClearMask::Stencil))
 		{
-			gl::DepthMask(true);
-			gl::StencilMask(true);
+			cache.DepthMask(true);
+			cache.StencilMaskSeparate(gl::GL_FRONT, ~0u);
+			cache.StencilMaskSeparate(gl::GL_BACK, ~0u);
 			int32 stencil = clearStencil;
 			gl::ClearBufferfi(gl::GL_DEPTH_STENCIL, 0, clearDepth, stencil);
 		}
@@ -236,12 +244,13 @@ namespace XREX
 		{
 			if (static_cast<uint32>(clearMask) & static_cast<uint32>(ClearMask::Depth))
 			{
-				gl::DepthMask(true);
+				cache.DepthMask(true);
 				gl::ClearBufferfv(gl::GL_DEPTH, 0, &clearDepth);
 			}
 			if (static_cast<uint32>(clearMask) & static_cast<uint32>(ClearMask::Stencil))
 			{
-				gl::StencilMask(true);
+				cache.StencilMaskSeparate(gl::GL_FRONT, ~0u);
+				cache.StencilMaskSeparate(gl::GL_BACK, ~0u);
 				int32 stencil = clearStencil;
 				gl::ClearBufferiv(gl::GL_STENCIL, 0, &stencil);
 			}
@@ -253,7 +262,7 @@ namespace XREX
 	void FrameBuffer::TextureCheck()
 	{
 		Size<uint32, 2> frameBufferSize = description_->GetSize();
-		std::vector<FrameBufferLayoutDescription::ChannelDescription const> const& channels = description_->GetAllChannels();
+		std::vector<FrameBufferLayoutDescription::ChannelDescription> const& channels = description_->GetAllChannels();
 		for (uint32 i = 0; i < channels.size(); ++i)
 		{
 			FrameBufferLayoutDescription::ChannelDescription const& channel = channels[i];
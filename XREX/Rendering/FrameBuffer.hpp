@@ -71,7 +71,7 @@ namespace XREX
 		{
 			return framebufferChannels_.size();
 		}
-		std::vector<ChannelDescription const> const& GetAllChannels() const
+		std::vector<ChannelDescription> const& GetAllChannels() const
 		{
 			return framebufferChannels_;
 		}
@@ -152,7 +152,7 @@ namespace XREX
 
 	private:
 		std::string name_;
-		std::vector<ChannelDescription const> framebufferChannels_;
+		std::vector<ChannelDescription> framebufferChannels_;
 		TexelFormat depth_;
 		TexelFormat stencil_;
 		DepthStencilCombinationState combined_;
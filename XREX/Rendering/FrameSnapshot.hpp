@@ -0,0 +1,220 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Rendering/Renderable.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/Viewport.hpp"
+#include "Base/FrameArena.hpp"
+
+#include <vector>
+#include <algorithm>
+
+namespace XREX
+{
+
+	/*
+	 *	Everything a RenderingProcess needs to render a frame, captured from scene at the end of a logic frame.
+	 *	Render thread only reads the snapshot, so logic thread can run the next frame on the live scene meanwhile.
+	 *	Values the logic thread may change, viewports and material parameters, are copied rather than referenced.
+	 *	Clear is called on render thread once the frame is drawn, so GPU resources referenced only by the snapshot are released with the context current.
+	 *	Scene objects are moved aside by it and released by ReleaseSceneObjects on logic thread, which owns the transformation hierarchy.
+	 */
+	struct XREX_API FrameSnapshot
+		: Noncopyable
+	{
+		struct CameraView
+			: Noncopyable
+		{
+			SceneObjectSP cameraObject;
+			Viewport viewport;
+			Color backgroundColor;
+			floatM44 viewMatrix;
+			floatM44 projectionMatrix;
+			floatV3 position;
+
+			/*
+			 *	packs and worldMatrices are parallel arrays in arena of the snapshot.
+			 */
+			FrameArray<Renderable::RenderablePack> packs;
+			FrameArray<floatM44> worldMatrices;
+			/*
+			 *	Indices into packs, in the order to draw.
+			 */
+			FrameArray<uint32> drawOrder;
+			/*
+			 *	Keep renderables alive, one for each renderable rather than each pack, RenderablePack only has a raw pointer to it.
+			 */
+			std::vector<RenderableSP> owners;
+			/*
+			 *	Scene objects passing culling, and the other scene objects except cameras.
+			 */
+			uint32 visibleObjectCount;
+			uint32 culledObjectCount;
+
+			CameraView()
+				: viewport(0, 0, 0, 0u, 0u), backgroundColor(0, 0, 0, 0), visibleObjectCount(0), culledObjectCount(0)
+			{
+			}
+
+			/*
+			 *	Release everything referenced except the camera object, which is moved into releasedSceneObjects. Memory of owners is kept.
+			 */
+			void Clear(std::vector<SceneObjectSP>& releasedSceneObjects)
+			{
+				if (cameraObject != nullptr)
+				{
+					releasedSceneObjects.push_back(std::move(cameraObject));
+				}
+				packs = FrameArray<Renderable::RenderablePack>();
+				worldMatrices = FrameArray<floatM44>();
+				drawOrder = FrameArray<uint32>();
+				owners.clear();
+				visibleObjectCount = 0;
+				culledObjectCount = 0;
+			}
+		};
+
+		uint32 frameIndex;
+		/*
+		 *	Time of beginning and end of the logic frame producing this snapshot, measured by FramePipeline.
+		 */
+		double logicBeginTime;
+		double logicEndTime;
+
+		/*
+		 *	In rendering order.
+		 */
+		std::vector<std::unique_ptr<CameraView>> cameraViews;
+		/*
+		 *	Cleared views kept for next AddCameraView, so a steady state frame allocates nothing.
+		 */
+		std::vector<std::unique_ptr<CameraView>> unusedCameraViews;
+		/*
+		 *	Memory of per frame arrays, reset by Clear.
+		 *	Each snapshot has its own arena, as several snapshots are alive at once when frames are pipelined.
+		 */
+		FrameArena arena;
+		/*
+		 *	Copies of materials used by packs, the first materialCopyCount of them are used by this snapshot.
+		 *	Kept by Clear with their parameters, so the same material copied into the same copy next time allocates nothing.
+		 */
+		std::vector<MaterialSP> materialCopies;
+		uint32 materialCopyCount;
+		/*
+		 *	Open addressing from materials to their copies, at most half full.
+		 *	Kept by Clear like materialCopies, so it allocates nothing once it is large enough.
+		 */
+		std::vector<std::pair<Material const*, Material*>> materialCopyIndex;
+		/*
+		 *	Scene objects referenced by the last rendered frame, waiting for ReleaseSceneObjects.
+		 */
+		std::vector<SceneObjectSP> releasedSceneObjects;
+
+		FrameSnapshot()
+			: frameIndex(0), logicBeginTime(0), logicEndTime(0), materialCopyCount(0)
+		{
+		}
+
+		/*
+		 *	@return: copy of current values of material, the same copy for the same material until Clear.
+		 */
+		Material* CopyMaterial(Material const& material)
+		{
+			if ((materialCopyCount + 1) * 2 > materialCopyIndex.size())
+			{
+				GrowMaterialCopyIndex();
+			}
+			std::pair<Material const*, Material*>& entry = FindMaterialCopyEntry(&material);
+			if (entry.first == nullptr)
+			{
+				if (materialCopyCount == materialCopies.size())
+				{
+					materialCopies.push_back(MakeSP<Material>(material.GetName()));
+				}
+				entry.first = &material;
+				entry.second = materialCopies[materialCopyCount++].get();
+				entry.second->CopyValuesFrom(material);
+			}
+			return entry.second;
+		}
+
+		/*
+		 *	@return: entry of material in materialCopyIndex, or the empty entry it would be inserted into.
+		 */
+		std::pair<Material const*, Material*>& FindMaterialCopyEntry(Material const* material)
+		{
+			uint32 mask = materialCopyIndex.size() - 1;
+			// low bits of pointers are mostly 0 because of alignment
+			uint32 slot = (static_cast<uint32>(reinterpret_cast<uintptr_t>(material) >> 4) * 2654435761u) & mask;
+			while (materialCopyIndex[slot].first != nullptr && materialCopyIndex[slot].first != material)
+			{
+				slot = (slot + 1) & mask;
+			}
+			return materialCopyIndex[slot];
+		}
+
+		void GrowMaterialCopyIndex()
+		{
+			std::vector<std::pair<Material const*, Material*>> oldIndex(std::max<size_t>(16, materialCopyIndex.size() * 2));
+			oldIndex.swap(materialCopyIndex);
+			for (auto& entry : oldIndex)
+			{
+				if (entry.first != nullptr)
+				{
+					FindMaterialCopyEntry(entry.first) = entry;
+				}
+			}
+		}
+
+		/*
+		 *	@return: a view at the end of cameraViews, arrays of it are empty and use arena.
+		 */
+		CameraView& AddCameraView()
+		{
+			if (unusedCameraViews.empty())
+			{
+				cameraViews.push_back(MakeUP<CameraView>());
+			}
+			else
+			{
+				cameraViews.push_back(std::move(unusedCameraViews.back()));
+				unusedCameraViews.pop_back();
+			}
+			CameraView& view = *cameraViews.back();
+			view.packs = FrameArray<Renderable::RenderablePack>(arena);
+			view.worldMatrices = FrameArray<floatM44>(arena);
+			view.drawOrder = FrameArray<uint32>(arena);
+			return view;
+		}
+
+		/*
+		 *	Called on render thread after the snapshot is rendered.
+		 */
+		void Clear()
+		{
+			for (auto& view : cameraViews)
+			{
+				view->Clear(releasedSceneObjects);
+				unusedCameraViews.push_back(std::move(view));
+			}
+			cameraViews.clear();
+			for (uint32 i = 0; i < materialCopyCount; ++i)
+			{
+				materialCopies[i]->ReleaseResourceValues();
+			}
+			std::fill(materialCopyIndex.begin(), materialCopyIndex.end(), std::pair<Material const*, Material*>(nullptr, nullptr));
+			materialCopyCount = 0;
+			arena.Reset();
+		}
+
+		/*
+		 *	Called on logic thread before the snapshot is captured again.
+		 */
+		void ReleaseSceneObjects()
+		{
+			releasedSceneObjects.clear();
+		}
+	};
+
+}
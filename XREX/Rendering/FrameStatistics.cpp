@@ -0,0 +1,149 @@
+#include "XREX.hpp"
+
+#include "FrameStatistics.hpp"
+
+#include "Rendering/RenderingLayout.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace XREX
+{
+	namespace
+	{
+		FrameStatistics* CurrentStatistics = nullptr;
+	}
+
+
+
+	FrameStatistics* FrameStatistics::GetCurrent()
+	{
+		return CurrentStatistics;
+	}
+
+	void FrameStatistics::SetCurrent(FrameStatistics* statistics)
+	{
+		CurrentStatistics = statistics;
+	}
+
+	void FrameStatistics::Clear()
+	{
+		frameTime = 0;
+		renderTime = 0;
+		drawCount = 0;
+		instanceCount = 0;
+		triangleCount = 0;
+		techniqueUseCount = 0;
+		programChangeCount = 0;
+		textureBindCount = 0;
+		bufferUpdateCount = 0;
+		bufferUploadedBytes = 0;
+		bufferMapCount = 0;
+		bufferMappedBytes = 0;
+		visibleObjectCount = 0;
+		culledObjectCount = 0;
+		collectedPackCount = 0;
+	}
+
+	void FrameStatistics::AddDraw(IndexBuffer const& indices, uint32 indexCount, uint32 instanceCount)
+	{
+		++drawCount;
+		this->instanceCount += instanceCount;
+		uint64 triangles = 0;
+		switch (indices.GetTopologicalType())
+		{
+		case IndexBuffer::TopologicalType::Triangles:
+			triangles = indexCount / 3;
+			break;
+		case IndexBuffer::TopologicalType::TriangleStrip:
+		case IndexBuffer::TopologicalType::TriangleFan:
+			triangles = indexCount >= 3 ? indexCount - 2 : 0;
+			break;
+		default:
+			break;
+		}
+		triangleCount += triangles * instanceCount;
+	}
+
+
+
+	FrameStatisticsHistory::FrameStatisticsHistory(uint32 capacity)
+		: frames_(capacity), next_(0), count_(0)
+	{
+		assert(capacity != 0);
+		sortedTimes_.reserve(capacity);
+	}
+
+	void FrameStatisticsHistory::Add(FrameStatistics const& statistics)
+	{
+		frames_[next_] = statistics;
+		next_ = (next_ + 1) % frames_.size();
+		count_ = std::min<uint32>(count_ + 1, frames_.size());
+	}
+
+	void FrameStatisticsHistory::Clear()
+	{
+		next_ = 0;
+		count_ = 0;
+	}
+
+	FrameStatistics const& FrameStatisticsHistory::GetFrame(uint32 index) const
+	{
+		assert(index < count_);
+		return frames_[(next_ + frames_.size() - count_ + index) % frames_.size()];
+	}
+
+	double FrameStatisticsHistory::GetMinFrameTime() const
+	{
+		double minTime = count_ == 0 ? 0 : GetFrame(0).frameTime;
+		for (uint32 i = 1; i < count_; ++i)
+		{
+			minTime = std::min(minTime, GetFrame(i).frameTime);
+		}
+		return minTime;
+	}
+
+	double FrameStatisticsHistory::GetMaxFrameTime() const
+	{
+		double maxTime = 0;
+		for (uint32 i = 0; i < count_; ++i)
+		{
+			maxTime = std::max(maxTime, GetFrame(i).frameTime);
+		}
+		return maxTime;
+	}
+
+	double FrameStatisticsHistory::GetAverageFrameTime() const
+	{
+		if (count_ == 0)
+		{
+			return 0;
+		}
+		double sum = 0;
+		for (uint32 i = 0; i < count_; ++i)
+		{
+			sum += GetFrame(i).frameTime;
+		}
+		return sum / count_;
+	}
+
+	double FrameStatisticsHistory::GetPercentileFrameTime(float percentile) const
+	{
+		assert(percentile >= 0 && percentile <= 1);
+		if (count_ == 0)
+		{
+			return 0;
+		}
+		sortedTimes_.clear();
+		for (uint32 i = 0; i < count_; ++i)
+		{
+			sortedTimes_.push_back(GetFrame(i).frameTime);
+		}
+		// nearest rank
+		uint32 rank = std::min(static_cast<uint32>(std::ceil(percentile * count_)), count_);
+		uint32 index = rank == 0 ? 0 : rank - 1;
+		std::nth_element(sortedTimes_.begin(), sortedTimes_.begin() + index, sortedTimes_.end());
+		return sortedTimes_[index];
+	}
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Work submitted by the rendering thread in a frame, from the end of the last frame to the end of this one.
+	 *	Counted by drawers, techniques, buffers and textures into GetCurrent(), kept by RenderingEngine after each frame.
+	 */
+	struct XREX_API FrameStatistics
+	{
+		/*
+		 *	Seconds from the beginning of the last frame to the beginning of this one.
+		 */
+		double frameTime;
+		/*
+		 *	Seconds spent in RenderAFrame.
+		 */
+		double renderTime;
+
+		/*
+		 *	Draws, an instanced draw counts once, each draw of a multi draw counts.
+		 */
+		uint32 drawCount;
+		uint32 instanceCount;
+		/*
+		 *	Triangles of triangle lists, strips and fans, all instances.
+		 */
+		uint64 triangleCount;
+		/*
+		 *	RenderingTechnique::Use calls and programs actually bound by them.
+		 */
+		uint32 techniqueUseCount;
+		uint32 programChangeCount;
+		uint32 textureBindCount;
+		/*
+		 *	Data given to GraphicsBuffer creation and updates.
+		 */
+		uint32 bufferUpdateCount;
+		uint64 bufferUploadedBytes;
+		uint32 bufferMapCount;
+		uint64 bufferMappedBytes;
+
+		/*
+		 *	Counted by the rendering process over all cameras.
+		 *	Objects culled are scene objects that are neither visible nor cameras, see FrameSnapshot::CameraView.
+		 */
+		uint32 visibleObjectCount;
+		uint32 culledObjectCount;
+		uint32 collectedPackCount;
+
+		/*
+		 *	Statistics being counted, nullptr if RenderingEngine is not created. Only used on the rendering thread.
+		 */
+		static FrameStatistics* GetCurrent();
+		static void SetCurrent(FrameStatistics* statistics);
+
+		FrameStatistics()
+		{
+			Clear();
+		}
+
+		void Clear();
+		/*
+		 *	Count a draw call of indexCount indices of indices.
+		 */
+		void AddDraw(IndexBuffer const& indices, uint32 indexCount, uint32 instanceCount);
+	};
+
+
+
+	/*
+	 *	Statistics of the last frames, oldest ones are replaced when full.
+	 *	Frame time summaries only look at GetCount() frames, so they are cheap enough to be read every frame.
+	 */
+	class XREX_API FrameStatisticsHistory
+	{
+	public:
+		static uint32 const DefaultCapacity = 256;
+
+	public:
+		explicit FrameStatisticsHistory(uint32 capacity = DefaultCapacity);
+
+		void Add(FrameStatistics const& statistics);
+		void Clear();
+
+		uint32 GetCount() const
+		{
+			return count_;
+		}
+		uint32 GetCapacity() const
+		{
+			return frames_.size();
+		}
+		/*
+		 *	@index: 0 is the oldest frame, GetCount() - 1 the latest.
+		 */
+		FrameStatistics const& GetFrame(uint32 index) const;
+
+		/*
+		 *	Frame time summaries of frames in the history, 0 if empty.
+		 */
+		double GetMinFrameTime() const;
+		double GetMaxFrameTime() const;
+		double GetAverageFrameTime() const;
+		/*
+		 *	@percentile: in [0, 1], e.g. 0.99 for the time 99% of frames do not exceed.
+		 */
+		double GetPercentileFrameTime(float percentile) const;
+
+	private:
+		std::vector<FrameStatistics> frames_;
+		/*
+		 *	Where the next frame goes.
+		 */
+		uint32 next_;
+		uint32 count_;
+		/*
+		 *	Reused by GetPercentileFrameTime.
+		 */
+		mutable std::vector<double> sortedTimes_;
+	};
+
+}
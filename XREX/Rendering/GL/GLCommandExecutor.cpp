@@ -0,0 +1,214 @@
+#include "XREX.hpp"
+
+#include "GLCommandExecutor.hpp"
+
+#include "Base/XREXContext.hpp"
+#include "Base/Window.hpp"
+#include "Rendering/RenderingEngine.hpp"
+#include "Rendering/RenderingTechnique.hpp"
+#include "Rendering/RenderingLayout.hpp"
+#include "Rendering/ProgramConnector.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/Viewport.hpp"
+#include "Rendering/GraphicsBuffer.hpp"
+#include "Rendering/ShaderProgram.hpp"
+#include "Rendering/UniformRingBuffer.hpp"
+#include "Rendering/GL/GLUtil.hpp"
+#include "Rendering/GPUProfiler.hpp"
+#include "Rendering/FrameStatistics.hpp"
+#include "Base/Profiler.hpp"
+
+#include <CoreGL.hpp>
+
+#include <cstring>
+
+namespace XREX
+{
+	namespace
+	{
+		template <typename T>
+		void SetParameterValue(TechniqueParameter& parameter, void const* value)
+		{
+			parameter.As<T>().SetValue(*static_cast<T const*>(value));
+		}
+	}
+
+
+
+	GLCommandExecutor::GLCommandExecutor()
+		: technique_(nullptr), connector_(nullptr), layout_(nullptr)
+	{
+	}
+
+	GLCommandExecutor::~GLCommandExecutor()
+	{
+	}
+
+	void GLCommandExecutor::BindTechnique(RenderingTechnique* technique)
+	{
+		technique_ = technique;
+	}
+
+	void GLCommandExecutor::BindLayout(LayoutAndProgramConnector* connector, RenderingLayout* layout)
+	{
+		connector_ = connector;
+		layout_ = layout;
+	}
+
+	void GLCommandExecutor::SetParameter(TechniqueParameter& parameter, ElementType type, void const* value)
+	{
+		switch (type)
+		{
+		case ElementType::Bool:
+			SetParameterValue<bool>(parameter, value);
+			break;
+		case ElementType::Uint8:
+			SetParameterValue<uint8>(parameter, value);
+			break;
+		case ElementType::Uint16:
+			SetParameterValue<uint16>(parameter, value);
+			break;
+		case ElementType::Uint32:
+			SetParameterValue<uint32>(parameter, value);
+			break;
+		case ElementType::Int8:
+			SetParameterValue<int8>(parameter, value);
+			break;
+		case ElementType::Int16:
+			SetParameterValue<int16>(parameter, value);
+			break;
+		case ElementType::Int32:
+			SetParameterValue<int32>(parameter, value);
+			break;
+		case ElementType::Float:
+			SetParameterValue<float>(parameter, value);
+			break;
+		case ElementType::FloatV2:
+			SetParameterValue<floatV2>(parameter, value);
+			break;
+		case ElementType::FloatV3:
+			SetParameterValue<floatV3>(parameter, value);
+			break;
+		case ElementType::FloatV4:
+			SetParameterValue<floatV4>(parameter, value);
+			break;
+		case ElementType::FloatM44:
+			SetParameterValue<floatM44>(parameter, value);
+			break;
+		case ElementType::Double:
+			SetParameterValue<double>(parameter, value);
+			break;
+		case ElementType::DoubleV2:
+			SetParameterValue<doubleV2>(parameter, value);
+			break;
+		case ElementType::DoubleV3:
+			SetParameterValue<doubleV3>(parameter, value);
+			break;
+		case ElementType::DoubleV4:
+			SetParameterValue<doubleV4>(parameter, value);
+			break;
+		case ElementType::DoubleM44:
+			SetParameterValue<doubleM44>(parameter, value);
+			break;
+		default:
+			assert(false); // resources are not recorded as values
+			break;
+		}
+	}
+
+	void GLCommandExecutor::SetBufferData(ShaderResourceBuffer& buffer, void const* data, uint32 sizeInBytes)
+	{
+		GraphicsBufferSP& fallbackBuffer = fallbackBuffers_[sizeInBytes];
+		if (fallbackBuffer == nullptr)
+		{
+			fallbackBuffer = MakeSP<GraphicsBuffer>(GraphicsBuffer::Usage::DynamicDraw, sizeInBytes, BufferView::BufferType::Uniform);
+		}
+		GraphicsBuffer::BufferMapper mapper = XREXContext::GetInstance().GetRenderingEngine().GetUniformRingBuffer().MapSlice(buffer, fallbackBuffer);
+		memcpy(mapper.GetPointer<void>(), data, sizeInBytes);
+	}
+
+	void GLCommandExecutor::BindMaterial(Material& material)
+	{
+		assert(technique_ != nullptr);
+		material.BindToTechnique(technique_->shared_from_this());
+		material.SetAllTechniqueParameterValues();
+	}
+
+	void GLCommandExecutor::Draw(uint32 indexCount, uint32 firstIndex, int32 baseVertex, uint32 instanceCount)
+	{
+		assert(technique_ != nullptr && connector_ != nullptr && layout_ != nullptr);
+		technique_->Use();
+		connector_->Bind();
+		uint32 glMode = GLDrawModeFromTopologicalType(layout_->GetIndexBuffer()->GetTopologicalType());
+		uint32 glIndexType = GLTypeFromElementType(layout_->GetIndexElementType());
+		void const* indexOffset = reinterpret_cast<void const*>(firstIndex * GetElementSizeInBytes(layout_->GetIndexElementType()));
+		if (instanceCount == 1)
+		{
+			gl::DrawElementsBaseVertex(glMode, indexCount, glIndexType, indexOffset, baseVertex);
+		}
+		else
+		{
+			gl::DrawElementsInstancedBaseVertex(glMode, indexCount, glIndexType, indexOffset, instanceCount, baseVertex);
+		}
+		if (FrameStatistics* statistics = FrameStatistics::GetCurrent())
+		{
+			statistics->AddDraw(*layout_->GetIndexBuffer(), indexCount, instanceCount);
+		}
+		// vertex array is left bound, so the next draw with the same connector does not bind it again.
+	}
+
+	void GLCommandExecutor::MultiDraw(IndirectDrawer::DrawElementsIndirectCommand const* commands, floatM44 const* drawParameters, uint32 drawCount)
+	{
+		assert(technique_ != nullptr && connector_ != nullptr && layout_ != nullptr);
+		technique_->Use();
+		connector_->Bind();
+		indirectDrawer_.CoreLaunch(*layout_, commands, drawParameters, drawCount);
+	}
+
+	void GLCommandExecutor::Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ)
+	{
+		assert(technique_ != nullptr);
+		technique_->Use();
+		gl::DispatchCompute(groupCountX, groupCountY, groupCountZ);
+	}
+
+	void GLCommandExecutor::SetViewport(Viewport const& viewport)
+	{
+		viewport.Bind(XREXContext::GetInstance().GetMainWindow().GetClientRegionSize());
+	}
+
+	void GLCommandExecutor::Clear(FrameBuffer& frameBuffer, FrameBuffer::ClearMask clearMask, Color const& clearColor, float clearDepth, uint16 clearStencil)
+	{
+		frameBuffer.Clear(clearMask, clearColor, clearDepth, clearStencil);
+	}
+
+	void GLCommandExecutor::BeginProfileRange(char const* name, int32 argument, bool hasArgument)
+	{
+		RenderingEngine& engine = XREXContext::GetInstance().GetRenderingEngine();
+		if (hasArgument)
+		{
+			engine.GetGPUProfiler().BeginRange(name, argument);
+		}
+		else
+		{
+			engine.GetGPUProfiler().BeginRange(name);
+		}
+		ProfileRange range;
+		range.name = name;
+		range.argument = argument;
+		range.hasArgument = hasArgument;
+		range.beginTime = engine.GetProfiler().BeginScope();
+		profileRanges_.push_back(range);
+	}
+
+	void GLCommandExecutor::EndProfileRange()
+	{
+		assert(!profileRanges_.empty());
+		RenderingEngine& engine = XREXContext::GetInstance().GetRenderingEngine();
+		ProfileRange const& range = profileRanges_.back();
+		engine.GetProfiler().EndScope(range.name, range.beginTime, range.argument, range.hasArgument);
+		engine.GetGPUProfiler().EndRange();
+		profileRanges_.pop_back();
+	}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Rendering/CommandBuffer.hpp"
+
+#include <unordered_map>
+
+namespace XREX
+{
+
+	/*
+	 *	Executes recorded commands with GL, only used on the rendering thread.
+	 *	Draws use the technique, connector and layout bound last, the technique is used again before every draw,
+	 *	as parameters may be changed between draws.
+	 */
+	class XREX_API GLCommandExecutor
+		: public ICommandExecutor, Noncopyable
+	{
+	public:
+		GLCommandExecutor();
+		virtual ~GLCommandExecutor() override;
+
+		virtual void BindTechnique(RenderingTechnique* technique) override;
+		virtual void BindLayout(LayoutAndProgramConnector* connector, RenderingLayout* layout) override;
+		virtual void SetParameter(TechniqueParameter& parameter, ElementType type, void const* value) override;
+		/*
+		 *	Data go to a slice of the uniform ring buffer of RenderingEngine.
+		 */
+		virtual void SetBufferData(ShaderResourceBuffer& buffer, void const* data, uint32 sizeInBytes) override;
+		virtual void BindMaterial(Material& material) override;
+		virtual void Draw(uint32 indexCount, uint32 firstIndex, int32 baseVertex, uint32 instanceCount) override;
+		/*
+		 *	Issued by an IndirectDrawer kept by the executor, the layout bound must share buffers with all draws.
+		 */
+		virtual void MultiDraw(IndirectDrawer::DrawElementsIndirectCommand const* commands, floatM44 const* drawParameters, uint32 drawCount) override;
+		virtual void Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ) override;
+		virtual void SetViewport(Viewport const& viewport) override;
+		virtual void Clear(FrameBuffer& frameBuffer, FrameBuffer::ClearMask clearMask, Color const& clearColor, float clearDepth, uint16 clearStencil) override;
+		/*
+		 *	Measured on CPU of the rendering thread and on GPU.
+		 */
+		virtual void BeginProfileRange(char const* name, int32 argument, bool hasArgument) override;
+		virtual void EndProfileRange() override;
+
+	private:
+		struct ProfileRange
+		{
+			char const* name;
+			int32 argument;
+			bool hasArgument;
+			double beginTime;
+		};
+
+	private:
+		RenderingTechnique* technique_;
+		LayoutAndProgramConnector* connector_;
+		RenderingLayout* layout_;
+		/*
+		 *	Buffer data go here when the uniform ring buffer is full, by size of the data.
+		 */
+		std::unordered_map<uint32, GraphicsBufferSP> fallbackBuffers_;
+		IndirectDrawer indirectDrawer_;
+		std::vector<ProfileRange> profileRanges_;
+	};
+
+}
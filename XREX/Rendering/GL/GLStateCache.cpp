@@ -0,0 +1,394 @@
+#include "XREX.hpp"
+
+#include "Rendering/GL/GLStateCache.hpp"
+
+#include "Rendering/FrameStatistics.hpp"
+
+#include <CoreGL.hpp>
+
+namespace XREX
+{
+
+	namespace
+	{
+		/*
+		 *	No GL object has this name, used for state not known yet.
+		 */
+		uint32 const UnknownName = 0xFFFFFFFF;
+
+		GLStateCache* CurrentCache = nullptr;
+
+		uint32 FaceIndex(uint32 glFace)
+		{
+			assert(glFace == gl::GL_FRONT || glFace == gl::GL_BACK);
+			return glFace == gl::GL_FRONT ? 0 : 1;
+		}
+
+		uint32 GetBoundName(uint32 binding)
+		{
+			return binding;
+		}
+		template <size_t N>
+		uint32 GetBoundName(std::array<uint32, N> const& binding)
+		{
+			return binding[0];
+		}
+
+		/*
+		 *	Reset bindings to deleted object to unknown.
+		 */
+		template <typename Key, typename Binding>
+		void ForgetName(std::unordered_map<Key, Binding>& bindings, uint32 glName)
+		{
+			for (auto i = bindings.begin(); i != bindings.end(); )
+			{
+				if (GetBoundName(i->second) == glName)
+				{
+					i = bindings.erase(i);
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+	}
+
+
+
+	GLStateCache* GLStateCache::GetCurrent()
+	{
+		return CurrentCache;
+	}
+
+	GLStateCache::GLStateCache()
+	{
+		assert(CurrentCache == nullptr);
+		CurrentCache = this;
+		Invalidate();
+	}
+
+	GLStateCache::~GLStateCache()
+	{
+		assert(CurrentCache == this);
+		CurrentCache = nullptr;
+	}
+
+	void GLStateCache::Invalidate()
+	{
+		glProgram_ = UnknownName;
+		glVertexArray_ = UnknownName;
+		glDrawFramebuffer_ = UnknownName;
+		glReadFramebuffer_ = UnknownName;
+		glActiveTextureUnit_ = UnknownName;
+		glBufferBases_.clear();
+		glTextures_.clear();
+		glSamplers_.clear();
+		glImages_.clear();
+		capabilities_.clear();
+
+		polygonMode_.known = false;
+		frontFace_.known = false;
+		cullFace_.known = false;
+		polygonOffset_.known = false;
+		depthMask_.known = false;
+		depthFunction_.known = false;
+		for (uint32 i = 0; i < 2; ++i)
+		{
+			stencilFunctions_[i].known = false;
+			stencilOperations_[i].known = false;
+			stencilMasks_[i].known = false;
+		}
+		blendEquation_.known = false;
+		blendFunction_.known = false;
+		colorMask_.known = false;
+		blendColor_.known = false;
+		viewport_.known = false;
+		scissor_.known = false;
+	}
+
+	void GLStateCache::BeginFrame()
+	{
+		lastFrameStatistics_ = currentFrameStatistics_;
+		currentFrameStatistics_ = Statistics();
+	}
+
+	void GLStateCache::UseProgram(uint32 glProgram)
+	{
+		if (UpdateName(glProgram_, glProgram))
+		{
+			gl::UseProgram(glProgram);
+			if (FrameStatistics* statistics = FrameStatistics::GetCurrent())
+			{
+				++statistics->programChangeCount;
+			}
+		}
+	}
+
+	void GLStateCache::BindVertexArray(uint32 glVertexArray)
+	{
+		if (UpdateName(glVertexArray_, glVertexArray))
+		{
+			gl::BindVertexArray(glVertexArray);
+		}
+	}
+
+	void GLStateCache::BindBufferBase(uint32 glTarget, uint32 index, uint32 glBuffer)
+	{
+		std::array<uint32, 3> binding;
+		binding[0] = glBuffer;
+		binding[1] = 0;
+		binding[2] = 0;
+		auto found = glBufferBases_.find(MakeBindingKey(glTarget, index));
+		if (Count(found == glBufferBases_.end() || found->second != binding))
+		{
+			glBufferBases_[MakeBindingKey(glTarget, index)] = binding;
+			gl::BindBufferBase(glTarget, index, glBuffer);
+		}
+	}
+
+	void GLStateCache::BindBufferRange(uint32 glTarget, uint32 index, uint32 glBuffer, uint32 offset, uint32 size)
+	{
+		assert(size != 0);
+		std::array<uint32, 3> binding;
+		binding[0] = glBuffer;
+		binding[1] = offset;
+		binding[2] = size;
+		auto found = glBufferBases_.find(MakeBindingKey(glTarget, index));
+		if (Count(found == glBufferBases_.end() || found->second != binding))
+		{
+			glBufferBases_[MakeBindingKey(glTarget, index)] = binding;
+			gl::BindBufferRange(glTarget, index, glBuffer, offset, size);
+		}
+	}
+
+	void GLStateCache::BindTexture(uint32 unit, uint32 glTarget, uint32 glTexture)
+	{
+		auto result = glTextures_.insert(std::make_pair(MakeBindingKey(unit, glTarget), UnknownName));
+		if (UpdateName(glActiveTextureUnit_, unit))
+		{
+			gl::ActiveTexture(gl::GL_TEXTURE0 + unit);
+		}
+		if (UpdateName(result.first->second, glTexture))
+		{
+			gl::BindTexture(glTarget, glTexture);
+		}
+	}
+
+	void GLStateCache::BindSampler(uint32 unit, uint32 glSampler)
+	{
+		auto result = glSamplers_.insert(std::make_pair(unit, UnknownName));
+		if (UpdateName(result.first->second, glSampler))
+		{
+			gl::BindSampler(unit, glSampler);
+		}
+	}
+
+	void GLStateCache::BindImageTexture(uint32 unit, uint32 glTexture, int32 level, bool layered, int32 layer, uint32 glAccess, uint32 glFormat)
+	{
+		std::array<uint32, 6> binding;
+		binding[0] = glTexture;
+		binding[1] = static_cast<uint32>(level);
+		binding[2] = layered ? 1 : 0;
+		binding[3] = static_cast<uint32>(layer);
+		binding[4] = glAccess;
+		binding[5] = glFormat;
+		auto found = glImages_.find(unit);
+		if (Count(found == glImages_.end() || found->second != binding))
+		{
+			glImages_[unit] = binding;
+			gl::BindImageTexture(unit, glTexture, level, layered, layer, glAccess, glFormat);
+		}
+	}
+
+	void GLStateCache::BindFramebuffer(uint32 glTarget, uint32 glFramebuffer)
+	{
+		assert(glTarget == gl::GL_DRAW_FRAMEBUFFER || glTarget == gl::GL_READ_FRAMEBUFFER);
+		if (UpdateName(glTarget == gl::GL_DRAW_FRAMEBUFFER ? glDrawFramebuffer_ : glReadFramebuffer_, glFramebuffer))
+		{
+			gl::BindFramebuffer(glTarget, glFramebuffer);
+		}
+	}
+
+	void GLStateCache::SetCapability(uint32 glCapability, bool enable)
+	{
+		auto found = capabilities_.find(glCapability);
+		if (Count(found == capabilities_.end() || found->second != enable))
+		{
+			capabilities_[glCapability] = enable;
+			if (enable)
+			{
+				gl::Enable(glCapability);
+			}
+			else
+			{
+				gl::Disable(glCapability);
+			}
+		}
+	}
+
+	void GLStateCache::PolygonMode(uint32 glMode)
+	{
+		if (Count(polygonMode_.Update(glMode)))
+		{
+			gl::PolygonMode(gl::GL_FRONT_AND_BACK, glMode);
+		}
+	}
+
+	void GLStateCache::FrontFace(uint32 glMode)
+	{
+		if (Count(frontFace_.Update(glMode)))
+		{
+			gl::FrontFace(glMode);
+		}
+	}
+
+	void GLStateCache::CullFace(uint32 glMode)
+	{
+		if (Count(cullFace_.Update(glMode)))
+		{
+			gl::CullFace(glMode);
+		}
+	}
+
+	void GLStateCache::PolygonOffset(float factor, float units)
+	{
+		if (Count(polygonOffset_.Update(factor, units)))
+		{
+			gl::PolygonOffset(factor, units);
+		}
+	}
+
+	void GLStateCache::DepthMask(bool enable)
+	{
+		if (Count(depthMask_.Update(enable ? 1 : 0)))
+		{
+			gl::DepthMask(enable);
+		}
+	}
+
+	void GLStateCache::DepthFunc(uint32 glFunction)
+	{
+		if (Count(depthFunction_.Update(glFunction)))
+		{
+			gl::DepthFunc(glFunction);
+		}
+	}
+
+	void GLStateCache::StencilFuncSeparate(uint32 glFace, uint32 glFunction, int32 reference, uint32 mask)
+	{
+		if (Count(stencilFunctions_[FaceIndex(glFace)].Update(glFunction, static_cast<uint32>(reference), mask)))
+		{
+			gl::StencilFuncSeparate(glFace, glFunction, reference, mask);
+		}
+	}
+
+	void GLStateCache::StencilOpSeparate(uint32 glFace, uint32 glStencilFail, uint32 glDepthFail, uint32 glDepthPass)
+	{
+		if (Count(stencilOperations_[FaceIndex(glFace)].Update(glStencilFail, glDepthFail, glDepthPass)))
+		{
+			gl::StencilOpSeparate(glFace, glStencilFail, glDepthFail, glDepthPass);
+		}
+	}
+
+	void GLStateCache::StencilMaskSeparate(uint32 glFace, uint32 mask)
+	{
+		if (Count(stencilMasks_[FaceIndex(glFace)].Update(mask)))
+		{
+			gl::StencilMaskSeparate(glFace, mask);
+		}
+	}
+
+	void GLStateCache::BlendEquationSeparate(uint32 glMode, uint32 glModeAlpha)
+	{
+		if (Count(blendEquation_.Update(glMode, glModeAlpha)))
+		{
+			gl::BlendEquationSeparate(glMode, glModeAlpha);
+		}
+	}
+
+	void GLStateCache::BlendFuncSeparate(uint32 glSource, uint32 glDestination, uint32 glSourceAlpha, uint32 glDestinationAlpha)
+	{
+		if (Count(blendFunction_.Update(glSource, glDestination, glSourceAlpha, glDestinationAlpha)))
+		{
+			gl::BlendFuncSeparate(glSource, glDestination, glSourceAlpha, glDestinationAlpha);
+		}
+	}
+
+	void GLStateCache::ColorMask(bool red, bool green, bool blue, bool alpha)
+	{
+		if (Count(colorMask_.Update(red ? 1 : 0, green ? 1 : 0, blue ? 1 : 0, alpha ? 1 : 0)))
+		{
+			gl::ColorMask(red, green, blue, alpha);
+		}
+	}
+
+	void GLStateCache::BlendColor(float red, float green, float blue, float alpha)
+	{
+		if (Count(blendColor_.Update(red, green, blue, alpha)))
+		{
+			gl::BlendColor(red, green, blue, alpha);
+		}
+	}
+
+	void GLStateCache::Viewport(int32 x, int32 y, uint32 width, uint32 height)
+	{
+		if (Count(viewport_.Update(x, y, static_cast<int32>(width), static_cast<int32>(height))))
+		{
+			gl::Viewport(x, y, width, height);
+		}
+	}
+
+	void GLStateCache::Scissor(int32 x, int32 y, uint32 width, uint32 height)
+	{
+		if (Count(scissor_.Update(x, y, static_cast<int32>(width), static_cast<int32>(height))))
+		{
+			gl::Scissor(x, y, width, height);
+		}
+	}
+
+	void GLStateCache::OnProgramDeleted(uint32 glProgram)
+	{
+		if (glProgram_ == glProgram)
+		{
+			glProgram_ = UnknownName;
+		}
+	}
+
+	void GLStateCache::OnVertexArrayDeleted(uint32 glVertexArray)
+	{
+		if (glVertexArray_ == glVertexArray)
+		{
+			glVertexArray_ = UnknownName;
+		}
+	}
+
+	void GLStateCache::OnBufferDeleted(uint32 glBuffer)
+	{
+		ForgetName(glBufferBases_, glBuffer);
+	}
+
+	void GLStateCache::OnTextureDeleted(uint32 glTexture)
+	{
+		ForgetName(glTextures_, glTexture);
+		ForgetName(glImages_, glTexture);
+	}
+
+	void GLStateCache::OnSamplerDeleted(uint32 glSampler)
+	{
+		ForgetName(glSamplers_, glSampler);
+	}
+
+	void GLStateCache::OnFramebufferDeleted(uint32 glFramebuffer)
+	{
+		if (glDrawFramebuffer_ == glFramebuffer)
+		{
+			glDrawFramebuffer_ = UnknownName;
+		}
+		if (glReadFramebuffer_ == glFramebuffer)
+		{
+			glReadFramebuffer_ = UnknownName;
+		}
+	}
+
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+
+namespace XREX
+{
+
+	/*
+	 *	Shadows GL state of the context and skips GL calls that do not change anything.
+	 *	All binding and fixed function state changes of XREX go through it, GL calls made by others must be followed by Invalidate.
+	 *	Owned by RenderingEngine, only used on the rendering thread.
+	 */
+	class XREX_API GLStateCache
+		: Noncopyable
+	{
+	public:
+		struct XREX_API Statistics
+		{
+			uint32 issuedCallCount;
+			uint32 skippedCallCount;
+
+			Statistics()
+				: issuedCallCount(0), skippedCallCount(0)
+			{
+			}
+		};
+
+	public:
+		/*
+		 *	Cache of the GL context of RenderingEngine, nullptr if RenderingEngine is not created or already destroyed.
+		 *	GL objects use it to notify their deletion, which may happen after RenderingEngine is destroyed.
+		 */
+		static GLStateCache* GetCurrent();
+
+	public:
+		GLStateCache();
+		~GLStateCache();
+
+		/*
+		 *	Forget all shadowed state, the next call of each state will be issued.
+		 */
+		void Invalidate();
+
+		/*
+		 *	Counters of current frame start again, previous ones can be got by GetLastFrameStatistics.
+		 */
+		void BeginFrame();
+		Statistics const& GetLastFrameStatistics() const
+		{
+			return lastFrameStatistics_;
+		}
+		Statistics const& GetCurrentFrameStatistics() const
+		{
+			return currentFrameStatistics_;
+		}
+
+		void UseProgram(uint32 glProgram);
+		void BindVertexArray(uint32 glVertexArray);
+		void BindBufferBase(uint32 glTarget, uint32 index, uint32 glBuffer);
+		/*
+		 *	@size: must not be 0.
+		 */
+		void BindBufferRange(uint32 glTarget, uint32 index, uint32 glBuffer, uint32 offset, uint32 size);
+		/*
+		 *	Also makes unit the active texture unit, so the texture can be modified after binding.
+		 */
+		void BindTexture(uint32 unit, uint32 glTarget, uint32 glTexture);
+		void BindSampler(uint32 unit, uint32 glSampler);
+		void BindImageTexture(uint32 unit, uint32 glTexture, int32 level, bool layered, int32 layer, uint32 glAccess, uint32 glFormat);
+		/*
+		 *	@glTarget: GL_DRAW_FRAMEBUFFER or GL_READ_FRAMEBUFFER.
+		 */
+		void BindFramebuffer(uint32 glTarget, uint32 glFramebuffer);
+
+		void SetCapability(uint32 glCapability, bool enable);
+
+		void PolygonMode(uint32 glMode);
+		void FrontFace(uint32 glMode);
+		void CullFace(uint32 glMode);
+		void PolygonOffset(float factor, float units);
+
+		void DepthMask(bool enable);
+		void DepthFunc(uint32 glFunction);
+		/*
+		 *	@glFace: GL_FRONT or GL_BACK.
+		 */
+		void StencilFuncSeparate(uint32 glFace, uint32 glFunction, int32 reference, uint32 mask);
+		void StencilOpSeparate(uint32 glFace, uint32 glStencilFail, uint32 glDepthFail, uint32 glDepthPass);
+		void StencilMaskSeparate(uint32 glFace, uint32 mask);
+
+		void BlendEquationSeparate(uint32 glMode, uint32 glModeAlpha);
+		void BlendFuncSeparate(uint32 glSource, uint32 glDestination, uint32 glSourceAlpha, uint32 glDestinationAlpha);
+		void ColorMask(bool red, bool green, bool blue, bool alpha);
+		void BlendColor(float red, float green, float blue, float alpha);
+
+		void Viewport(int32 x, int32 y, uint32 width, uint32 height);
+		void Scissor(int32 x, int32 y, uint32 width, uint32 height);
+
+		/*
+		 *	Called after GL objects are deleted, names may be reused by new objects.
+		 */
+		void OnProgramDeleted(uint32 glProgram);
+		void OnVertexArrayDeleted(uint32 glVertexArray);
+		void OnBufferDeleted(uint32 glBuffer);
+		void OnTextureDeleted(uint32 glTexture);
+		void OnSamplerDeleted(uint32 glSampler);
+		void OnFramebufferDeleted(uint32 glFramebuffer);
+
+	private:
+		/*
+		 *	A piece of state with up to 4 components, unknown until the first Update.
+		 */
+		template <typename T>
+		struct CachedState
+		{
+			std::array<T, 4> value;
+			bool known;
+
+			CachedState()
+				: known(false)
+			{
+			}
+			/*
+			 *	@return: true if the GL call should be issued.
+			 */
+			bool Update(T x, T y = T(), T z = T(), T w = T())
+			{
+				if (known && value[0] == x && value[1] == y && value[2] == z && value[3] == w)
+				{
+					return false;
+				}
+				value[0] = x;
+				value[1] = y;
+				value[2] = z;
+				value[3] = w;
+				known = true;
+				return true;
+			}
+		};
+
+		/*
+		 *	Count the call and return whether to issue it.
+		 */
+		bool Count(bool changed)
+		{
+			if (changed)
+			{
+				++currentFrameStatistics_.issuedCallCount;
+			}
+			else
+			{
+				++currentFrameStatistics_.skippedCallCount;
+			}
+			return changed;
+		}
+		bool UpdateName(uint32& current, uint32 glName)
+		{
+			if (current == glName)
+			{
+				return Count(false);
+			}
+			current = glName;
+			return Count(true);
+		}
+		static uint64 MakeBindingKey(uint32 high, uint32 low)
+		{
+			return (static_cast<uint64>(high) << 32) | low;
+		}
+
+	private:
+		uint32 glProgram_;
+		uint32 glVertexArray_;
+		uint32 glDrawFramebuffer_;
+		uint32 glReadFramebuffer_;
+		uint32 glActiveTextureUnit_;
+		/*
+		 *	Keyed by MakeBindingKey(target, index) and MakeBindingKey(unit, target).
+		 *	Buffer bindings are buffer, offset and size, size 0 for the whole buffer.
+		 */
+		std::unordered_map<uint64, std::array<uint32, 3>> glBufferBases_;
+		std::unordered_map<uint64, uint32> glTextures_;
+		std::unordered_map<uint32, uint32> glSamplers_;
+		std::unordered_map<uint32, std::array<uint32, 6>> glImages_;
+		std::unordered_map<uint32, bool> capabilities_;
+
+		CachedState<uint32> polygonMode_;
+		CachedState<uint32> frontFace_;
+		CachedState<uint32> cullFace_;
+		CachedState<float> polygonOffset_;
+		CachedState<uint32> depthMask_;
+		CachedState<uint32> depthFunction_;
+		/*
+		 *	Front and back.
+		 */
+		std::array<CachedState<uint32>, 2> stencilFunctions_;
+		std::array<CachedState<uint32>, 2> stencilOperations_;
+		std::array<CachedState<uint32>, 2> stencilMasks_;
+		CachedState<uint32> blendEquation_;
+		CachedState<uint32> blendFunction_;
+		CachedState<uint32> colorMask_;
+		CachedState<float> blendColor_;
+		CachedState<int32> viewport_;
+		CachedState<int32> scissor_;
+
+		Statistics currentFrameStatistics_;
+		Statistics lastFrameStatistics_;
+	};
+
+}
@@ -304,6 +304,8 @@ namespace XREX
 			return gl::GL_ATOMIC_COUNTER_BUFFER;
 		case BufferView::BufferType::ShaderStorage:
 			return gl::GL_SHADER_STORAGE_BUFFER;
+		case BufferView::BufferType::DrawIndirect:
+			return gl::GL_DRAW_INDIRECT_BUFFER;
 		case BufferView::BufferType::TypeCount:
 			assert(false);
 			return 0;
@@ -658,6 +660,31 @@ namespace XREX
 				static GLTextureFormat const Format(gl::GL_STENCIL_INDEX8, gl::GL_STENCIL_INDEX, gl::GL_FLOAT);
 				return Format;
 			}
+		case TexelFormat::BC1: // source format and type are not used by compressed uploads
+			{
+				static GLTextureFormat const Format(gl::GL_COMPRESSED_RGB_S3TC_DXT1_EXT, gl::GL_RGB, gl::GL_UNSIGNED_BYTE);
+				return Format;
+			}
+		case TexelFormat::BC3:
+			{
+				static GLTextureFormat const Format(gl::GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE);
+				return Format;
+			}
+		case TexelFormat::BC4:
+			{
+				static GLTextureFormat const Format(gl::GL_COMPRESSED_RED_RGTC1, gl::GL_RED, gl::GL_UNSIGNED_BYTE);
+				return Format;
+			}
+		case TexelFormat::BC5:
+			{
+				static GLTextureFormat const Format(gl::GL_COMPRESSED_RG_RGTC2, gl::GL_RG, gl::GL_UNSIGNED_BYTE);
+				return Format;
+			}
+		case TexelFormat::BC7:
+			{
+				static GLTextureFormat const Format(gl::GL_COMPRESSED_RGBA_BPTC_UNORM_ARB, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE);
+				return Format;
+			}
 		default:
 			{
 				static GLTextureFormat const Format;
@@ -0,0 +1,138 @@
+#include "XREX.hpp"
+
+#include "GPUProfiler.hpp"
+
+#include <CoreGL.hpp>
+
+#include <algorithm>
+
+namespace XREX
+{
+
+	GPUProfiler::GPUProfiler(Profiler& profiler)
+		: profiler_(profiler), track_(profiler.CreateTrack("GPU")), currentFrame_(0), droppedFrameCount_(0)
+	{
+	}
+
+	GPUProfiler::~GPUProfiler()
+	{
+		for (Frame& frame : frames_)
+		{
+			if (!frame.queries.empty())
+			{
+				gl::DeleteQueries(frame.queries.size(), frame.queries.data());
+			}
+		}
+	}
+
+	void GPUProfiler::BeginFrame()
+	{
+		currentFrame_ = (currentFrame_ + 1) % FrameLatency;
+		Frame& frame = frames_[currentFrame_];
+		if (frame.recording)
+		{
+			ReadResults(frame);
+		}
+		frame.usedQueryCount = 0;
+		frame.ranges.clear();
+		openRanges_.clear();
+		frame.recording = profiler_.IsCapturing();
+		if (frame.recording)
+		{
+			frame.cpuBaseTime = profiler_.GetCurrentTime();
+			GLint64 gpuTime = 0;
+			gl::GetInteger64v(gl::GL_TIMESTAMP, &gpuTime);
+			frame.gpuBaseTime = gpuTime;
+		}
+	}
+
+	void GPUProfiler::EndFrame()
+	{
+		assert(openRanges_.empty());
+	}
+
+	void GPUProfiler::BeginRange(char const* name)
+	{
+		BeginRange(name, 0, false);
+	}
+
+	void GPUProfiler::BeginRange(char const* name, int32 argument)
+	{
+		BeginRange(name, argument, true);
+	}
+
+	void GPUProfiler::BeginRange(char const* name, int32 argument, bool hasArgument)
+	{
+		Frame& frame = frames_[currentFrame_];
+		if (!frame.recording)
+		{
+			return;
+		}
+		Range range;
+		range.name = name;
+		range.argument = argument;
+		range.hasArgument = hasArgument;
+		range.depth = openRanges_.size();
+		range.beginQuery = IssueTimestamp(frame);
+		range.endQuery = range.beginQuery;
+		openRanges_.push_back(frame.ranges.size());
+		frame.ranges.push_back(range);
+	}
+
+	void GPUProfiler::EndRange()
+	{
+		Frame& frame = frames_[currentFrame_];
+		if (!frame.recording)
+		{
+			return;
+		}
+		assert(!openRanges_.empty());
+		frame.ranges[openRanges_.back()].endQuery = IssueTimestamp(frame);
+		openRanges_.pop_back();
+	}
+
+	uint32 GPUProfiler::IssueTimestamp(Frame& frame)
+	{
+		if (frame.usedQueryCount == frame.queries.size())
+		{
+			uint32 oldCount = frame.queries.size();
+			frame.queries.resize(std::max(16u, oldCount * 2));
+			gl::GenQueries(frame.queries.size() - oldCount, frame.queries.data() + oldCount);
+		}
+		gl::QueryCounter(frame.queries[frame.usedQueryCount], gl::GL_TIMESTAMP);
+		return frame.usedQueryCount++;
+	}
+
+	void GPUProfiler::ReadResults(Frame& frame)
+	{
+		frame.recording = false;
+		if (frame.usedQueryCount == 0)
+		{
+			return;
+		}
+		// queries finish in order, the last one being available means all are.
+		GLint available = 0;
+		gl::GetQueryObjectiv(frame.queries[frame.usedQueryCount - 1], gl::GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+		{
+			++droppedFrameCount_;
+			return;
+		}
+		for (Range const& range : frame.ranges)
+		{
+			GLuint64 beginTime = 0;
+			GLuint64 endTime = 0;
+			gl::GetQueryObjectui64v(frame.queries[range.beginQuery], gl::GL_QUERY_RESULT, &beginTime);
+			gl::GetQueryObjectui64v(frame.queries[range.endQuery], gl::GL_QUERY_RESULT, &endTime);
+			Profiler::Event event;
+			event.name = range.name;
+			event.beginTime = frame.cpuBaseTime + static_cast<int64>(beginTime - frame.gpuBaseTime) * 1e-9;
+			event.endTime = frame.cpuBaseTime + static_cast<int64>(endTime - frame.gpuBaseTime) * 1e-9;
+			event.depth = range.depth;
+			event.argument = range.argument;
+			event.hasArgument = range.hasArgument;
+			profiler_.AddEvent(track_, event);
+		}
+	}
+
+}
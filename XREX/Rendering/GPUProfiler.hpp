@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Base/Profiler.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Measures nested GPU time ranges of the rendering thread and adds them to a track of a Profiler.
+	 *	Ranges are measured by GL timestamp queries, as GL_TIME_ELAPSED queries can not be nested.
+	 *	Query sets are multi-buffered: results of a frame are read FrameLatency frames later, when the GPU has usually finished it,
+	 *	so reading never stalls. Frames whose results are still not available are dropped.
+	 *	GPU times are placed on the CPU timeline by the GPU clock sampled at the beginning of each frame.
+	 *	Results of the last FrameLatency frames of a capture are read after it stopped, so they are lost.
+	 *	Owned by RenderingEngine, only used on the rendering thread. Does nothing while the profiler is not capturing.
+	 */
+	class XREX_API GPUProfiler
+		: Noncopyable
+	{
+	public:
+		static uint32 const FrameLatency = 2;
+
+	public:
+		explicit GPUProfiler(Profiler& profiler);
+		~GPUProfiler();
+
+		/*
+		 *	Read results of the frame FrameLatency frames ago, start a new frame if the profiler is capturing.
+		 */
+		void BeginFrame();
+		void EndFrame();
+
+		/*
+		 *	@name: see Profiler::Event.
+		 */
+		void BeginRange(char const* name);
+		void BeginRange(char const* name, int32 argument);
+		void EndRange();
+
+		/*
+		 *	Frames whose results were not available in time.
+		 */
+		uint32 GetDroppedFrameCount() const
+		{
+			return droppedFrameCount_;
+		}
+
+	private:
+		struct Range
+		{
+			char const* name;
+			int32 argument;
+			bool hasArgument;
+			uint32 depth;
+			/*
+			 *	Indices into queries of the frame.
+			 */
+			uint32 beginQuery;
+			uint32 endQuery;
+		};
+
+		struct Frame
+		{
+			/*
+			 *	GL query objects, created on demand and kept.
+			 */
+			std::vector<uint32> queries;
+			uint32 usedQueryCount;
+			std::vector<Range> ranges;
+			/*
+			 *	CPU time and GPU time in nanoseconds at the beginning of the frame.
+			 */
+			double cpuBaseTime;
+			int64 gpuBaseTime;
+			bool recording;
+
+			Frame()
+				: usedQueryCount(0), cpuBaseTime(0), gpuBaseTime(0), recording(false)
+			{
+			}
+		};
+
+	private:
+		void BeginRange(char const* name, int32 argument, bool hasArgument);
+		/*
+		 *	@return: index of a query with a timestamp issued.
+		 */
+		uint32 IssueTimestamp(Frame& frame);
+		void ReadResults(Frame& frame);
+
+	private:
+		Profiler& profiler_;
+		uint32 track_;
+		Frame frames_[FrameLatency];
+		uint32 currentFrame_;
+		/*
+		 *	Indices into ranges of current frame, of ranges not ended yet.
+		 */
+		std::vector<uint32> openRanges_;
+		uint32 droppedFrameCount_;
+	};
+
+}
@@ -3,7 +3,9 @@
 #include "GraphicsBuffer.hpp"
 
 #include "Rendering/ShaderProgram.hpp"
+#include "Rendering/FrameStatistics.hpp"
 #include "Rendering/GL/GLUtil.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
 
 #include <CoreGL.hpp>
 
@@ -17,6 +19,28 @@ using std::vector;
 
 namespace XREX
 {
+	namespace
+	{
+		void CountUpload(uint32 sizeInBytes)
+		{
+			if (FrameStatistics* statistics = FrameStatistics::GetCurrent())
+			{
+				++statistics->bufferUpdateCount;
+				statistics->bufferUploadedBytes += sizeInBytes;
+			}
+		}
+
+		void CountMap(uint32 sizeInBytes)
+		{
+			if (FrameStatistics* statistics = FrameStatistics::GetCurrent())
+			{
+				++statistics->bufferMapCount;
+				statistics->bufferMappedBytes += sizeInBytes;
+			}
+		}
+	}
+
+
 
 	GraphicsBuffer::BufferMapper::BufferMapper(GraphicsBuffer& buffer, AccessType type)
 		: buffer_(buffer)
@@ -24,6 +48,12 @@ namespace XREX
 		data_ = buffer_.Map(type);
 	}
 
+	GraphicsBuffer::BufferMapper::BufferMapper(GraphicsBuffer& buffer, uint32 offset, uint32 sizeInBytes)
+		: buffer_(buffer)
+	{
+		data_ = buffer_.MapUnsynchronized(offset, sizeInBytes);
+	}
+
 	GraphicsBuffer::BufferMapper::BufferMapper(BufferMapper&& right)
 		: buffer_(right.buffer_), data_(right.data_)
 	{
@@ -79,6 +109,10 @@ namespace XREX
 		glCurrentBindingIndex_ = 0;
 		BindWrite();
 		gl::BufferData(gl::GL_COPY_WRITE_BUFFER, sizeInBytes, data, GLUsageFromUsage(usage_));
+		if (data != nullptr)
+		{
+			CountUpload(sizeInBytes);
+		}
 	}
 
 	void GraphicsBuffer::DoConsctruct(void const* data, uint32 sizeInBytes, BufferView::BufferType typeHint)
@@ -88,8 +122,16 @@ namespace XREX
 		assert(glBufferID_ != 0); // 0 is reserved by GL
 		glCurrentBindingTarget_ = GLBufferTypeFromBufferType(typeHint);
 		glCurrentBindingIndex_ = 0;
+		if (glCurrentBindingTarget_ == gl::GL_ELEMENT_ARRAY_BUFFER)
+		{ // index buffer binding is part of vertex array state, do not modify the vertex array left bound by last draw.
+			GLStateCache::GetCurrent()->BindVertexArray(0);
+		}
 		Bind(typeHint);
 		gl::BufferData(glCurrentBindingTarget_, sizeInBytes, data, GLUsageFromUsage(usage_));
+		if (data != nullptr)
+		{
+			CountUpload(sizeInBytes);
+		}
 	}
 
 	GraphicsBuffer::~GraphicsBuffer()
@@ -97,6 +139,10 @@ namespace XREX
 		if (glBufferID_ != 0)
 		{
 			gl::DeleteBuffers(1, &glBufferID_);
+			if (GLStateCache* cache = GLStateCache::GetCurrent())
+			{
+				cache->OnBufferDeleted(glBufferID_);
+			}
 			glBufferID_ = 0;
 		}
 	}
@@ -114,6 +160,15 @@ namespace XREX
 	{
 		BindWrite();
 		gl::BufferSubData(gl::GL_COPY_WRITE_BUFFER, 0, sizeInBytes_, data);
+		CountUpload(sizeInBytes_);
+	}
+
+	void GraphicsBuffer::UpdateSubData(uint32 offset, uint32 sizeInBytes, void const* data)
+	{
+		assert(offset + sizeInBytes <= sizeInBytes_);
+		BindWrite();
+		gl::BufferSubData(gl::GL_COPY_WRITE_BUFFER, offset, sizeInBytes, data);
+		CountUpload(sizeInBytes);
 	}
 
 
@@ -154,7 +209,15 @@ namespace XREX
 	{
 		glCurrentBindingTarget_ = GLBufferTypeFromBufferType(type);
 		glCurrentBindingIndex_ = index;
-		gl::BindBufferBase(glCurrentBindingTarget_, index, glBufferID_);
+		GLStateCache::GetCurrent()->BindBufferBase(glCurrentBindingTarget_, index, glBufferID_);
+	}
+
+	void GraphicsBuffer::BindIndexRange(BufferView::BufferType type, uint32 index, uint32 offset, uint32 sizeInBytes)
+	{
+		assert(offset + sizeInBytes <= sizeInBytes_);
+		glCurrentBindingTarget_ = GLBufferTypeFromBufferType(type);
+		glCurrentBindingIndex_ = index;
+		GLStateCache::GetCurrent()->BindBufferRange(glCurrentBindingTarget_, index, glBufferID_, offset, sizeInBytes);
 	}
 
 	void GraphicsBuffer::Unbind()
@@ -164,7 +227,7 @@ namespace XREX
 
 	void GraphicsBuffer::UnbindIndex()
 	{
-		gl::BindBufferBase(glCurrentBindingTarget_, glCurrentBindingIndex_, 0);
+		GLStateCache::GetCurrent()->BindBufferBase(glCurrentBindingTarget_, glCurrentBindingIndex_, 0);
 	}
 
 	void* GraphicsBuffer::Map(AccessType accessType)
@@ -173,6 +236,18 @@ namespace XREX
 		BindWrite();
 		void* p = gl::MapBuffer(gl::GL_COPY_WRITE_BUFFER, glAccessType);
 		assert(p != nullptr);
+		CountMap(sizeInBytes_);
+		return p;
+	}
+
+	void* GraphicsBuffer::MapUnsynchronized(uint32 offset, uint32 sizeInBytes)
+	{
+		assert(offset + sizeInBytes <= sizeInBytes_);
+		BindWrite();
+		void* p = gl::MapBufferRange(gl::GL_COPY_WRITE_BUFFER, offset, sizeInBytes,
+			gl::GL_MAP_WRITE_BIT | gl::GL_MAP_INVALIDATE_RANGE_BIT | gl::GL_MAP_UNSYNCHRONIZED_BIT);
+		assert(p != nullptr);
+		CountMap(sizeInBytes);
 		return p;
 	}
 
@@ -45,6 +45,7 @@ namespace XREX
 			friend class GraphicsBuffer;
 		private:
 			BufferMapper(GraphicsBuffer& buffer, AccessType type);
+			BufferMapper(GraphicsBuffer& buffer, uint32 offset, uint32 sizeInBytes);
 		public:
 			BufferMapper(BufferMapper&& right);
 
@@ -100,6 +101,7 @@ namespace XREX
 		void Resize(uint32 sizeInBytes);
 
 		void UpdateData(void const* data);
+		void UpdateSubData(uint32 offset, uint32 sizeInBytes, void const* data);
 
 		template <typename T>
 		void Clear(T const& data)
@@ -121,6 +123,7 @@ namespace XREX
 
 		void Bind(BufferView::BufferType type);
 		void BindIndex(BufferView::BufferType type, uint32 index);
+		void BindIndexRange(BufferView::BufferType type, uint32 index, uint32 offset, uint32 sizeInBytes);
 		void Unbind();
 		void UnbindIndex();
 
@@ -128,12 +131,21 @@ namespace XREX
 		{
 			return BufferMapper(*this, accessType);
 		}
+		/*
+		 *	Map a range for write without waiting for GPU, previous content of the range is discarded.
+		 *	Caller must make sure GPU is no longer using the range, e.g. by a fence.
+		 */
+		BufferMapper GetUnsynchronizedMapper(uint32 offset, uint32 sizeInBytes)
+		{
+			return BufferMapper(*this, offset, sizeInBytes);
+		}
 
 	private:
 		void DoConsctruct(void const* data, uint32 sizeInBytes);
 		void DoConsctruct(void const* data, uint32 sizeInBytes, BufferView::BufferType typeHint);
 
 		void* Map(AccessType accessType);
+		void* MapUnsynchronized(uint32 offset, uint32 sizeInBytes);
 		void Unmap();
 
 	private:
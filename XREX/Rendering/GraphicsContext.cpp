@@ -1,5 +1,7 @@
 #include "XREX.hpp"
 
+#ifndef XREX_HEADLESS
+
 #include "GraphicsContext.hpp"
 
 #include "Base/Settings.hpp"
@@ -230,6 +232,13 @@ namespace XREX
 		gl::GetIntegerv(gl::GL_MINOR_VERSION,&minorVersion_);
 		XREXContext::GetInstance().GetLogger().Log("OpenGL version: ").Log(majorVersion_).Log(".").Log(minorVersion_).EndLine();
 
+		int32 extensionCount = 0;
+		gl::GetIntegerv(gl::GL_NUM_EXTENSIONS, &extensionCount);
+		for (int32 i = 0; i < extensionCount; ++i)
+		{
+			extensions_.insert(reinterpret_cast<char const*>(gl::GetStringi(gl::GL_EXTENSIONS, i)));
+		}
+
 
 		string vendor, renderer, glVersion, glslVersion;
 		vendor = reinterpret_cast<char const*>(gl::GetString(gl::GL_VENDOR));
@@ -291,4 +300,6 @@ namespace XREX
 		::SwapBuffers(glHideWindows_->hDC_);
 	}
 
-}
\ No newline at end of file
+}
+
+#endif // XREX_HEADLESS
@@ -5,6 +5,7 @@
 #include "Rendering/RenderingEngine.hpp"
 
 #include <memory>
+#include <unordered_set>
 
 
 namespace XREX
@@ -32,11 +33,19 @@ namespace XREX
 		{
 			return correctlyCreated_;
 		}
+
+		/*
+		 *	@extension: full name like "GL_ARB_shader_draw_parameters".
+		 */
+		bool IsExtensionSupported(std::string const& extension) const
+		{
+			return extensions_.find(extension) != extensions_.end();
+		}
 	protected:
 		void OnMessageIdle();
 
 	private:
-		// used to hide windows.h to the cpp file
+		// used to hide windows.h, or EGL / OSMesa headers when XREX_HEADLESS, to the cpp file
 		struct GLHideWindows_;
 		std::unique_ptr<GLHideWindows_> glHideWindows_;
 
@@ -46,6 +55,7 @@ namespace XREX
 		uint32 sampleCount_;
 
 		std::string description_;
+		std::unordered_set<std::string> extensions_;
 
 		bool correctlyCreated_;
 	};
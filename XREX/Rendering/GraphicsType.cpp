@@ -376,6 +376,16 @@ namespace XREX
 		case TexelFormat::Stencil8:
 			assert(false);
 			return ElementType::ElementTypeCount;
+		case TexelFormat::BC1:
+			return ElementType::FloatV3;
+		case TexelFormat::BC3:
+			return ElementType::FloatV4;
+		case TexelFormat::BC4:
+			return ElementType::Float;
+		case TexelFormat::BC5:
+			return ElementType::FloatV2;
+		case TexelFormat::BC7:
+			return ElementType::FloatV4;
 		case TexelFormat::TexelFormatCount:
 			assert(false);
 			return ElementType::ElementTypeCount;
@@ -485,6 +495,13 @@ namespace XREX
 			return 4;
 		case TexelFormat::Stencil8:
 			return 1;
+		case TexelFormat::BC1:
+		case TexelFormat::BC3:
+		case TexelFormat::BC4:
+		case TexelFormat::BC5:
+		case TexelFormat::BC7:
+			assert(false); // use GetTexelDataSizeInBytes
+			return 0;
 		case TexelFormat::TexelFormatCount:
 			assert(false);
 			return 0;
@@ -494,6 +511,49 @@ namespace XREX
 		}
 	}
 
+	bool IsBlockCompressedTexelFormat(TexelFormat format)
+	{
+		switch (format)
+		{
+		case TexelFormat::BC1:
+		case TexelFormat::BC3:
+		case TexelFormat::BC4:
+		case TexelFormat::BC5:
+		case TexelFormat::BC7:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	uint32 GetTexelBlockSizeInBytes(TexelFormat format)
+	{
+		switch (format)
+		{
+		case TexelFormat::BC1:
+			return 8;
+		case TexelFormat::BC3:
+			return 16;
+		case TexelFormat::BC4:
+			return 8;
+		case TexelFormat::BC5:
+			return 16;
+		case TexelFormat::BC7:
+			return 16;
+		default:
+			return GetTexelSizeInBytes(format);
+		}
+	}
+
+	uint32 GetTexelDataSizeInBytes(TexelFormat format, uint32 width, uint32 height, uint32 depth)
+	{
+		if (IsBlockCompressedTexelFormat(format))
+		{
+			return (width + 3) / 4 * ((height + 3) / 4) * depth * GetTexelBlockSizeInBytes(format);
+		}
+		return width * height * depth * GetTexelSizeInBytes(format);
+	}
+
 	TexelFormat GetCorrespondingTexelFormat(ElementType type)
 	{
 		switch (type)
@@ -255,13 +255,35 @@ namespace XREX
 		Depth24Stencil8,
 		Stencil8,
 
+		/*
+		 *	Block compressed, each 4x4 texels block is stored as a whole, see GetTexelDataSizeInBytes.
+		 */
+		BC1, // RGB, 8 bytes per block
+		BC3, // RGBA, 16 bytes per block
+		BC4, // R, 8 bytes per block
+		BC5, // RG, 16 bytes per block
+		BC7, // RGBA, 16 bytes per block
+
 		TexelFormatCount
 	};
 
 	XREX_API ElementType GetCorrespondingElementType(TexelFormat format);
 
+	/*
+	 *	Not for block compressed formats, a texel of them has no size in bytes.
+	 */
 	XREX_API uint32 GetTexelSizeInBytes(TexelFormat format);
 
+	XREX_API bool IsBlockCompressedTexelFormat(TexelFormat format);
+	/*
+	 *	Bytes of a 4x4 block of block compressed formats, size of a texel of other formats.
+	 */
+	XREX_API uint32 GetTexelBlockSizeInBytes(TexelFormat format);
+	/*
+	 *	Bytes of tightly packed texels, partial blocks at the edges of block compressed formats are whole blocks.
+	 */
+	XREX_API uint32 GetTexelDataSizeInBytes(TexelFormat format, uint32 width, uint32 height, uint32 depth);
+
 	XREX_API TexelFormat GetCorrespondingTexelFormat(ElementType type);
 
 	enum class AccessType
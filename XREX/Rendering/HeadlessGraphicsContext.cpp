@@ -0,0 +1,298 @@
+#include "XREX.hpp"
+
+#ifdef XREX_HEADLESS
+
+#include "GraphicsContext.hpp"
+
+#include "Base/Settings.hpp"
+#include "Base/Window.hpp"
+#include "Base/Logger.hpp"
+
+#include "Rendering/GL/GLUtil.hpp"
+
+#include <sstream>
+
+#include <glload/gll.hpp>
+#include <CoreGL.hpp>
+
+#ifdef XREX_USE_OSMESA
+/*
+ *	osmesa.h includes GL/gl.h, whose macros conflict with CoreGL.hpp, so declare the few functions used here.
+ */
+extern "C"
+{
+	typedef struct osmesa_context* OSMesaContext;
+	OSMesaContext OSMesaCreateContextAttribs(int const* attribList, OSMesaContext shareList);
+	unsigned char OSMesaMakeCurrent(OSMesaContext context, void* buffer, unsigned int type, int width, int height);
+	void OSMesaDestroyContext(OSMesaContext context);
+}
+#else
+#define EGL_NO_X11 // no window system, keep X11 macros away
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+
+using std::string;
+
+namespace XREX
+{
+	namespace
+	{
+		int32 const MinMajorVersion = 4;
+		int32 const MinMinorVersion = 3;
+
+#ifdef XREX_USE_OSMESA
+		int32 const OSMesaFormat = 0x22;
+		int32 const OSMesaRGBA = 0x1908; // GL_RGBA
+		int32 const OSMesaDepthBits = 0x30;
+		int32 const OSMesaStencilBits = 0x31;
+		int32 const OSMesaProfile = 0x33;
+		int32 const OSMesaCoreProfile = 0x34;
+		int32 const OSMesaCompatibilityProfile = 0x35;
+		int32 const OSMesaContextMajorVersion = 0x36;
+		int32 const OSMesaContextMinorVersion = 0x37;
+#endif
+	}
+
+	/*
+	 *	Holds the offscreen context. Only the default frame buffer object of RenderingEngine is rendered to,
+	 *	so the context has no surface (EGL) or only a 1x1 color buffer it is required to have (OSMesa).
+	 */
+	struct GraphicsContext::GLHideWindows_
+	{
+		GLHideWindows_()
+		{
+#ifdef XREX_USE_OSMESA
+			context_ = nullptr;
+			pixel_ = 0;
+#else
+			display_ = EGL_NO_DISPLAY;
+			context_ = EGL_NO_CONTEXT;
+#endif
+		}
+
+#ifdef XREX_USE_OSMESA
+		bool Create(int32 majorVersion, int32 minorVersion)
+		{
+			int32 attributes[] =
+			{
+				OSMesaFormat, OSMesaRGBA,
+				OSMesaDepthBits, 0,
+				OSMesaStencilBits, 0,
+				OSMesaProfile,
+#ifdef USE_OPENGL_COMPATIBILITY_PROFILE
+				OSMesaCompatibilityProfile,
+#else
+				OSMesaCoreProfile,
+#endif
+				OSMesaContextMajorVersion, majorVersion,
+				OSMesaContextMinorVersion, minorVersion,
+				0,
+			};
+			context_ = OSMesaCreateContextAttribs(attributes, nullptr);
+			if (context_ == nullptr)
+			{
+				return false;
+			}
+			return OSMesaMakeCurrent(context_, &pixel_, gl::GL_UNSIGNED_BYTE, 1, 1) != 0;
+		}
+
+		void Destroy()
+		{
+			if (context_ != nullptr)
+			{
+				OSMesaDestroyContext(context_);
+				context_ = nullptr;
+			}
+		}
+#else
+		static EGLDisplay GetSurfacelessDisplay()
+		{
+			// EGL_MESA_platform_surfaceless needs no display server nor device, llvmpipe is used when there is no GPU.
+			PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+			if (getPlatformDisplay != nullptr)
+			{
+				EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+				if (display != EGL_NO_DISPLAY)
+				{
+					return display;
+				}
+			}
+			return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+
+		bool Create(int32 majorVersion, int32 minorVersion)
+		{
+			if (display_ == EGL_NO_DISPLAY)
+			{
+				display_ = GetSurfacelessDisplay();
+				EGLint eglMajor = 0;
+				EGLint eglMinor = 0;
+				if (display_ == EGL_NO_DISPLAY || !eglInitialize(display_, &eglMajor, &eglMinor) || !eglBindAPI(EGL_OPENGL_API))
+				{
+					XREXContext::GetInstance().GetLogger().LogLine("EGL initialize failed.");
+					display_ = EGL_NO_DISPLAY;
+					return false;
+				}
+			}
+
+			EGLint flags = 0;
+#ifndef USE_OPENGL_COMPATIBILITY_PROFILE
+			flags = EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR; // no deprecated GL API
+#endif
+#ifdef XREX_DEBUG
+			flags |= EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR;
+#endif
+			EGLint attributes[] =
+			{
+				EGL_CONTEXT_MAJOR_VERSION_KHR, majorVersion,
+				EGL_CONTEXT_MINOR_VERSION_KHR, minorVersion,
+				EGL_CONTEXT_FLAGS_KHR, flags,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR,
+#ifdef USE_OPENGL_COMPATIBILITY_PROFILE
+				EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT_KHR,
+#else
+				EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+#endif
+				EGL_NONE,
+			};
+			// EGL_KHR_no_config_context and EGL_KHR_surfaceless_context: no config nor surface is needed for rendering to frame buffer objects.
+			context_ = eglCreateContext(display_, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+			if (context_ == EGL_NO_CONTEXT)
+			{
+				return false;
+			}
+			return eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, context_) == EGL_TRUE;
+		}
+
+		void Destroy()
+		{
+			if (context_ != EGL_NO_CONTEXT)
+			{
+				eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+				eglDestroyContext(display_, context_);
+				context_ = EGL_NO_CONTEXT;
+			}
+		}
+#endif
+
+#ifdef XREX_USE_OSMESA
+		OSMesaContext context_;
+		uint32 pixel_;
+#else
+		EGLDisplay display_;
+		EGLContext context_;
+#endif
+	};
+
+
+
+	GraphicsContext::GraphicsContext(Window& window, Settings const& settings)
+		: correctlyCreated_(false)
+	{
+		glHideWindows_ = MakeUP<GLHideWindows_>();
+
+		// multisampling needs a multisample default frame buffer object, not supported.
+		sampleCount_ = 1;
+
+		int32 versions[][2] =
+		{
+			{ 4, 6 },
+			{ 4, 5 },
+			{ 4, 4 },
+			{ 4, 3 },
+		};
+		bool created = false;
+		for (uint32 i = 0; i < sizeof(versions) / sizeof(versions[0]) && !created; ++i)
+		{
+			created = glHideWindows_->Create(versions[i][0], versions[i][1]);
+			if (!created)
+			{
+				glHideWindows_->Destroy();
+			}
+		}
+		if (!created)
+		{
+			XREXContext::GetInstance().GetLogger().LogLine("headless GL context creation failed.");
+			assert(false);
+			return;
+		}
+
+		// the loader gets functions of the current context by the platform GetProcAddress, which also returns functions of EGL or OSMesa contexts in Mesa.
+		if (glload::LoadFunctions() != glload::LS_LOAD_FUNCTIONS_ALL)
+		{
+			XREXContext::GetInstance().GetLogger().LogLine("not all GL function are loaded.");
+		}
+
+		gl::GetIntegerv(gl::GL_MAJOR_VERSION, &majorVersion_);
+		gl::GetIntegerv(gl::GL_MINOR_VERSION, &minorVersion_);
+		XREXContext::GetInstance().GetLogger().Log("OpenGL version: ").Log(majorVersion_).Log(".").Log(minorVersion_).EndLine();
+
+		int32 extensionCount = 0;
+		gl::GetIntegerv(gl::GL_NUM_EXTENSIONS, &extensionCount);
+		for (int32 i = 0; i < extensionCount; ++i)
+		{
+			extensions_.insert(reinterpret_cast<char const*>(gl::GetStringi(gl::GL_EXTENSIONS, i)));
+		}
+
+		string vendor, renderer, glVersion, glslVersion;
+		vendor = reinterpret_cast<char const*>(gl::GetString(gl::GL_VENDOR));
+		renderer = reinterpret_cast<char const*>(gl::GetString(gl::GL_RENDERER));
+		glVersion = reinterpret_cast<char const*>(gl::GetString(gl::GL_VERSION));
+		glslVersion = reinterpret_cast<char const*>(gl::GetString(gl::GL_SHADING_LANGUAGE_VERSION));
+		std::stringstream oss;
+		oss << vendor << ". " << renderer << std::endl;
+		oss << glVersion << ", GLSL version: " << glslVersion;
+#ifdef XREX_USE_OSMESA
+		oss << " (headless, OSMesa)";
+#else
+		oss << " (headless, EGL)";
+#endif
+		description_ = oss.str();
+
+		XREXContext::GetInstance().GetLogger().LogLine(description_);
+
+		if (majorVersion_ < MinMajorVersion || (majorVersion_ == MinMajorVersion && minorVersion_ < MinMinorVersion))
+		{
+			XREXContext::GetInstance().GetLogger().Log("OpenGL version too low to run XREX, ").Log(MinMajorVersion).Log(".").Log(MinMinorVersion).Log(" required.");
+			assert(false);
+		}
+
+		uint32 glError = gl::GetError();
+		if (glError != gl::GL_NO_ERROR)
+		{
+			XREXContext::GetInstance().GetLogger().LogLine("GL error: " + ErrorStringFromGLError(glError));
+		}
+		correctlyCreated_ = true;
+	}
+
+
+	GraphicsContext::~GraphicsContext()
+	{
+		glHideWindows_->Destroy();
+#ifndef XREX_USE_OSMESA
+		if (glHideWindows_->display_ != EGL_NO_DISPLAY)
+		{
+			eglTerminate(glHideWindows_->display_);
+			glHideWindows_->display_ = EGL_NO_DISPLAY;
+		}
+#endif
+	}
+
+	void GraphicsContext::OnMessageIdle()
+	{
+		XREXContext::GetInstance().RenderAFrame();
+		SwapBuffers();
+	}
+
+	void GraphicsContext::SwapBuffers()
+	{
+		// nothing to present, make sure the frame is submitted as a swap would.
+		gl::Flush();
+	}
+
+}
+
+#endif // XREX_HEADLESS
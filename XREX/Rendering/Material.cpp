@@ -2,6 +2,8 @@
 
 #include "Material.hpp"
 
+#include <typeinfo>
+
 namespace XREX
 {
 
@@ -93,6 +95,44 @@ namespace XREX
 		pipelineParameter_.useDefaultBlendFactor = true;
 	}
 
+	void Material::CopyValuesFrom(Material const& source)
+	{
+		for (auto iter = parameters_.begin(); iter != parameters_.end(); )
+		{
+			if (source.parameters_.find(iter->first) == source.parameters_.end())
+			{
+				iter = parameters_.erase(iter);
+				cacheDirty_ = true;
+			}
+			else
+			{
+				++iter;
+			}
+		}
+		for (auto& parameterPair : source.parameters_)
+		{
+			TechniqueParameterSP& parameter = parameters_[parameterPair.first];
+			if (parameter != nullptr && typeid(*parameter) == typeid(*parameterPair.second))
+			{
+				parameter->GetValueFrom(*parameterPair.second);
+			}
+			else
+			{
+				parameter = parameterPair.second->Clone();
+				cacheDirty_ = true;
+			}
+		}
+		pipelineParameter_ = source.pipelineParameter_;
+	}
+
+	void Material::ReleaseResourceValues()
+	{
+		for (auto& parameterPair : parameters_)
+		{
+			parameterPair.second->ReleaseResourceValue();
+		}
+	}
+
 	void Material::BindToTechnique(RenderingTechniqueSP const& technique)
 	{
 		if (boundTechnique_.lock() == technique)
@@ -111,15 +151,14 @@ namespace XREX
 			UpdateBindingMapping();
 		}
 
+		RenderingTechniqueSP boundTechnique = boundTechnique_.lock();
+		assert(boundTechnique);
+
 		for (auto& parameterPair : parameterMappingCache_)
 		{
-			assert(!parameterPair.second.expired());
-			parameterPair.second.lock()->GetValueFrom(*parameterPair.first);
+			boundTechnique->GetParameter(parameterPair.second)->GetValueFrom(*parameterPair.first);
 		}
 
-		RenderingTechniqueSP boundTechnique = boundTechnique_.lock();
-		assert(boundTechnique);
-
 		TechniquePipelineParameters& parameters = boundTechnique->GetPipelineParameters();
 		if (!pipelineParameter_.useDefaultPolygonOffset)
 		{
@@ -146,12 +185,12 @@ namespace XREX
 		parameterMappingCache_.clear();
 		if (boundTechnique != nullptr)
 		{
-			for (auto& techniqueParameter : boundTechnique->GetAllParameters())
+			for (auto& materialParameter : parameters_)
 			{
-				TechniqueParameterSP materialParameter = GetParameter(techniqueParameter->GetName());
-				if (materialParameter)
+				ParameterHandle handle = boundTechnique->GetParameterHandle(materialParameter.first);
+				if (handle.IsValid())
 				{
-					parameterMappingCache_.push_back(std::make_pair(materialParameter, std::weak_ptr<TechniqueParameter>(techniqueParameter)));
+					parameterMappingCache_.push_back(std::make_pair(materialParameter.second, handle));
 				}
 			}
 		}
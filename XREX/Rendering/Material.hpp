@@ -70,13 +70,13 @@ namespace XREX
 			if (found == parameters_.end())
 			{
 				TechniqueParameterSP parameter = MakeParameter<T>(parameterName);
-				parameter->As<ResolveType<T>::Type>().SetValue(value);
+				parameter->As<typename ResolveType<T>::Type>().SetValue(value);
 				parameters_[parameterName] = std::move(parameter);
 				cacheDirty_ = true;
 			}
 			else
 			{
-				found->second->As<ResolveType<T>::Type>().SetValue(value);
+				found->second->As<typename ResolveType<T>::Type>().SetValue(value);
 			}
 		}
 
@@ -106,6 +106,16 @@ namespace XREX
 		void RemoveBlendFactor();
 
 
+		/*
+		 *	Make parameters and pipeline parameter settings the same as source, keeping the name and bound technique.
+		 *	Parameters already existing are assigned, so copying the same material again allocates nothing.
+		 */
+		void CopyValuesFrom(Material const& source);
+		/*
+		 *	Drop references to textures and images held by parameters, keeping the parameters themselves.
+		 */
+		void ReleaseResourceValues();
+
 		void BindToTechnique(RenderingTechniqueSP const& technique);
 
 		void SetAllTechniqueParameterValues();
@@ -130,7 +140,10 @@ namespace XREX
 		TechniquePipelineParameterSettings pipelineParameter_;
 
 		std::weak_ptr<RenderingTechnique> boundTechnique_;
-		std::vector<std::pair<TechniqueParameterSP, std::weak_ptr<TechniqueParameter>>> parameterMappingCache_;
+		/*
+		 *	Material parameters and handles of corresponding parameters in bound technique.
+		 */
+		std::vector<std::pair<TechniqueParameterSP, ParameterHandle>> parameterMappingCache_;
 		
 		bool cacheDirty_;
 	};
@@ -4,6 +4,7 @@
 
 #include "Base/XREXContext.hpp"
 #include "Rendering/RenderingFactory.hpp"
+#include "Rendering/RenderingLayout.hpp"
 #include "Rendering/RenderingTechnique.hpp"
 #include "Rendering/Material.hpp"
 
@@ -39,15 +40,32 @@ namespace XREX
 	SubMeshSP const& Mesh::CreateSubMesh(std::string const& name, RenderingLayoutSP const& layout)
 	{
 		subMeshes_.emplace_back(new SubMesh(*this, name, layout, nullptr, nullptr, RenderablePack::DefaultRenderingGroup));
+		MergeSubMeshBoundingVolume(*subMeshes_.back());
 		return subMeshes_.back();
 	}
 	SubMeshSP const& Mesh::CreateSubMesh(std::string const& name, RenderingLayoutSP const& layout, MaterialSP const& material, RenderingTechniqueSP const& technique, int32 renderingGroup /*= RenderablePack::DefaultRenderingGroup*/)
 	{
 		subMeshes_.emplace_back(new SubMesh(*this, name, layout, material, technique, renderingGroup));
+		MergeSubMeshBoundingVolume(*subMeshes_.back());
 		return subMeshes_.back();
 	}
 
 
+	void Mesh::MergeSubMeshBoundingVolume(SubMesh const& subMesh)
+	{
+		// an empty volume of the mesh is unbounded once it has a sub mesh, merging would make it bounded by later ones.
+		bool unbounded = subMesh.GetBoundingBox().IsEmpty() || subMesh.GetBoundingSphere().IsEmpty()
+			|| (subMeshes_.size() > 1 && (GetBoundingBox().IsEmpty() || GetBoundingSphere().IsEmpty()));
+		if (unbounded)
+		{
+			SetBoundingVolume(AxisAlignedBox(), Sphere());
+		}
+		else
+		{
+			SetBoundingVolume(GetBoundingBox().Merge(subMesh.GetBoundingBox()), GetBoundingSphere().Merge(subMesh.GetBoundingSphere()));
+		}
+	}
+
 
 	void Mesh::GetRenderablePack(RenderablePackCollector& collector, SceneObjectSP const& camera)
 	{
@@ -74,11 +92,22 @@ namespace XREX
 		{
 			clone.CreateSubMesh(subMesh->GetName(), subMesh->GetLayout(), subMesh->GetMaterial(), subMesh->GetTechnique());
 		}
+		clone.SetBoundingVolume(GetBoundingBox(), GetBoundingSphere());
 		return cloneSP;
 	}
 
 
 
+	AxisAlignedBox const& SubMesh::GetBoundingBox() const
+	{
+		return layout_->GetBoundingBox();
+	}
+
+	Sphere const& SubMesh::GetBoundingSphere() const
+	{
+		return layout_->GetBoundingSphere();
+	}
+
 	SubMesh::SubMesh(Mesh& mesh, std::string const& name, RenderingLayoutSP const& layout, MaterialSP const& material, RenderingTechniqueSP const& technique, int32 renderingGroup)
 		: mesh_(mesh), name_(name), material_(material), layout_(layout), renderingGroup_(renderingGroup)
 	{
@@ -96,7 +125,7 @@ namespace XREX
 		assert(technique_ != nullptr);
 		assert(connector_ != nullptr);
 		assert(layout_ != nullptr);
-		return Renderable::RenderablePack(this->mesh_, layout_, material_, connector_, technique_, renderingGroup_);
+		return Renderable::RenderablePack(this->mesh_, layout_.get(), material_.get(), connector_.get(), technique_.get(), renderingGroup_);
 	}
 
 	Renderable::SmallRenderablePack SubMesh::GetSmallRenderablePack(SceneObjectSP const& camera) const
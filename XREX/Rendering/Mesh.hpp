@@ -46,6 +46,12 @@ namespace XREX
 			return std::static_pointer_cast<Mesh>(ShallowClone());
 		}
 
+	private:
+		/*
+		 *	Merge bounding volumes of the sub mesh just created. If any sub mesh is unbounded, so is the mesh.
+		 */
+		void MergeSubMeshBoundingVolume(SubMesh const& subMesh);
+
 	private:
 		std::string name_;
 		std::vector<SubMeshSP> subMeshes_;
@@ -69,6 +75,11 @@ namespace XREX
 		{
 			return layout_;
 		}
+		/*
+		 *	Bounding volumes in model space, come from the layout.
+		 */
+		AxisAlignedBox const& GetBoundingBox() const;
+		Sphere const& GetBoundingSphere() const;
 
 		RenderingTechniqueSP const& GetTechnique() const
 		{
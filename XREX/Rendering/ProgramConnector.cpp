@@ -5,6 +5,7 @@
 #include "Rendering/RenderingLayout.hpp"
 #include "Rendering/ShaderProgram.hpp"
 #include "Rendering/GL/GLUtil.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
 
 #include <CoreGL.hpp>
 
@@ -17,7 +18,8 @@ namespace XREX
 	{
 		gl::GenVertexArrays(1, &glVAO_);
 		assert(glVAO_ != 0);
-		gl::BindVertexArray(glVAO_);
+		GLStateCache& cache = *GLStateCache::GetCurrent();
+		cache.BindVertexArray(glVAO_);
 
 		std::vector<VertexBufferSP> const& vertexBuffers = layout_->GetVertexBuffers();
 
@@ -92,7 +94,7 @@ namespace XREX
 		}
 		layout_->GetIndexBuffer()->Bind();
 
-		gl::BindVertexArray(0);
+		cache.BindVertexArray(0);
 		for (uint32 bufferIndex = 0; bufferIndex < vertexBuffers.size(); ++bufferIndex)
 		{
 			VertexBufferSP const& buffer = vertexBuffers[bufferIndex];
@@ -114,18 +116,22 @@ namespace XREX
 		if (glVAO_ != 0)
 		{
 			gl::DeleteVertexArrays(1, &glVAO_);
+			if (GLStateCache* cache = GLStateCache::GetCurrent())
+			{
+				cache->OnVertexArrayDeleted(glVAO_);
+			}
 			glVAO_ = 0;
 		}
 	}
 
 	void LayoutAndProgramConnector::Bind()
 	{
-		gl::BindVertexArray(glVAO_);
+		GLStateCache::GetCurrent()->BindVertexArray(glVAO_);
 	}
 
 	void LayoutAndProgramConnector::Unbind()
 	{
-		gl::BindVertexArray(0);
+		GLStateCache::GetCurrent()->BindVertexArray(0);
 	}
 
 }
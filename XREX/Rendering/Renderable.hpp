@@ -2,6 +2,7 @@
 #include "Declare.hpp"
 
 #include "Scene/Component.hpp"
+#include "Base/FrameArena.hpp"
 
 #include <vector>
 
@@ -13,31 +14,31 @@ namespace XREX
 		: public TemplateComponent<Renderable>, public std::enable_shared_from_this<Renderable>
 	{
 	public:
+		/*
+		 *	Plain data collected every frame, only raw pointers so collecting does not touch reference counts.
+		 *	Objects pointed to are kept alive by the Renderable, which is kept alive by FrameSnapshot.
+		 *	Resources of a Renderable replaced while a snapshot of it is in flight must be kept alive by the caller until the snapshot is rendered.
+		 */
 		struct RenderablePack
-			: XREX::Noncopyable
 		{
 			static int32 const DefaultRenderingGroup = 0;
 
 			Renderable* renderable;
-			RenderingLayoutSP layout;
-			MaterialSP material;
-			LayoutAndProgramConnectorSP connector;
-			RenderingTechniqueSP technique;
+			RenderingLayout* layout;
+			Material* material;
+			LayoutAndProgramConnector* connector;
+			RenderingTechnique* technique;
 			int32 renderingGroup;
 
-			RenderablePack(RenderablePack&& right);
-
 			explicit RenderablePack(Renderable& ownerRenderable)
-				: renderable(&ownerRenderable), renderingGroup(DefaultRenderingGroup)
+				: renderable(&ownerRenderable), layout(nullptr), material(nullptr), connector(nullptr), technique(nullptr), renderingGroup(DefaultRenderingGroup)
 			{
 			}
 			/*
 			 *	@renderingGroup: smaller value will be rendered before any RenderablePack with larger value.
 			 */
-			RenderablePack(Renderable& ownerRenderable, RenderingLayoutSP const& renderingLayout, MaterialSP const& material,
-				LayoutAndProgramConnectorSP const& connector, RenderingTechniqueSP const& renderingTechnique, int32 renderingGroup = DefaultRenderingGroup);
-			
-			RenderablePack& operator =(RenderablePack&& right);
+			RenderablePack(Renderable& ownerRenderable, RenderingLayout* renderingLayout, Material* material,
+				LayoutAndProgramConnector* connector, RenderingTechnique* renderingTechnique, int32 renderingGroup = DefaultRenderingGroup);
 		};
 
 		struct SmallRenderablePack
@@ -82,24 +83,61 @@ namespace XREX
 			visible_ = visible;
 		}
 
+		/*
+		 *	Bounding volumes in model space, used by Scene to do culling.
+		 *	Empty volume means the bound is unknown, the Renderable will never be culled.
+		 */
+		AxisAlignedBox const& GetBoundingBox() const
+		{
+			return boundingBox_;
+		}
+		Sphere const& GetBoundingSphere() const
+		{
+			return boundingSphere_;
+		}
+		void SetBoundingVolume(AxisAlignedBox const& boundingBox, Sphere const& boundingSphere)
+		{
+			boundingBox_ = boundingBox;
+			boundingSphere_ = boundingSphere;
+			++boundingVolumeVersion_;
+		}
+		/*
+		 *	Increased every time bounding volumes are set, used to check whether data depends on them need update.
+		 */
+		uint32 GetBoundingVolumeVersion() const
+		{
+			return boundingVolumeVersion_;
+		}
+
 		virtual RenderableSP ShallowClone() const = 0;
 
 
 	private:
 		bool visible_;
+		AxisAlignedBox boundingBox_;
+		Sphere boundingSphere_;
+		uint32 boundingVolumeVersion_;
 	};
 
 	/*
 	 * Can be used by RenderingProcess to collect renderable packs.
+	 * RenderablePacks go to a FrameArena, so collecting allocates nothing from heap once the arena is large enough.
 	 */
 	class RenderablePackCollector
 		: XREX::Noncopyable
 	{
 	public:
+		/*
+		 *	@arena: where packs are stored, they are valid until it is reset.
+		 */
+		explicit RenderablePackCollector(FrameArena& arena)
+			: packs_(arena)
+		{
+		}
 
-		void AddRenderablePack(Renderable::RenderablePack&& pack)
+		void AddRenderablePack(Renderable::RenderablePack const& pack)
 		{
-			packs_.emplace_back(std::move(pack));
+			packs_.PushBack(pack);
 		}
 		
 		void AddSmallRenderablePack(Renderable::SmallRenderablePack&& pack)
@@ -107,7 +145,7 @@ namespace XREX
 			smallPacks_.emplace_back(std::move(pack));
 		}
 
-		std::vector<Renderable::RenderablePack> const& GetRenderablePacks()
+		FrameArray<Renderable::RenderablePack> const& GetRenderablePacks()
 		{
 			return packs_;
 		}
@@ -117,10 +155,10 @@ namespace XREX
 			return smallPacks_;
 		}
 
-		std::vector<Renderable::RenderablePack> ExtractRenderablePacks()
+		FrameArray<Renderable::RenderablePack> ExtractRenderablePacks()
 		{
-			decltype(packs_) toReturn;
-			toReturn.swap(packs_);
+			FrameArray<Renderable::RenderablePack> toReturn = packs_;
+			packs_ = FrameArray<Renderable::RenderablePack>(*packs_.GetArena());
 			return toReturn;
 		}
 
@@ -132,7 +170,7 @@ namespace XREX
 		}
 
 	private:
-		std::vector<Renderable::RenderablePack> packs_;
+		FrameArray<Renderable::RenderablePack> packs_;
 		std::vector<Renderable::SmallRenderablePack> smallPacks_;
 	};
 
@@ -141,14 +179,6 @@ namespace XREX
 
 namespace std
 {
-	template <>
-	inline void swap<XREX::Renderable::RenderablePack>(XREX::Renderable::RenderablePack& left, XREX::Renderable::RenderablePack& right)
-	{
-		XREX::Renderable::RenderablePack temp = std::move(left);
-		left = std::move(right);
-		right = std::move(temp);
-	}
-
 	template <>
 	inline void swap<XREX::Renderable::SmallRenderablePack>(XREX::Renderable::SmallRenderablePack& left, XREX::Renderable::SmallRenderablePack& right)
 	{
@@ -8,11 +8,18 @@
 #include "Rendering/RenderingFactory.hpp"
 #include "Rendering/RenderingPipelineState.hpp"
 #include "Rendering/GL/GLUtil.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
+#include "Rendering/UniformRingBuffer.hpp"
 #include "Rendering/GraphicsContext.hpp"
 #include "Rendering/RenderingProcess.hpp"
 #include "Rendering/FrameBuffer.hpp"
+#include "Rendering/Texture.hpp"
+#include "Rendering/TextureImage.hpp"
 #include "Rendering/DefinedShaderName.hpp"
 #include "Rendering/SystemTechnique.hpp"
+#include "Rendering/GPUProfiler.hpp"
+#include "Rendering/FrameStatistics.hpp"
+#include "Base/Profiler.hpp"
 
 #include <CoreGL.hpp>
 
@@ -163,6 +170,39 @@ namespace XREX
 			}
 		};
 
+		/*
+		 *	Default frame buffer of headless contexts, which have no window system frame buffer.
+		 */
+		FrameBufferSP MakeOffscreenFrameBuffer(Size<uint32, 2> const& size, TexelFormat colorFormat, TexelFormat depthStencilFormat)
+		{
+			FrameBufferLayoutDescriptionSP description = MakeDescription(size, colorFormat, depthStencilFormat);
+			description->SetSizeMode(FrameBufferLayoutDescription::SizeMode::Fixed);
+
+			std::unordered_map<std::string, Texture2DImageSP const> colorTextures;
+			for (auto& channel : description->GetAllChannels())
+			{
+				Texture2DSP texture = MakeSP<Texture2D>(Texture::DataDescription<2>(channel.GetFormat(), size), false);
+				colorTextures.insert(std::make_pair(channel.GetChannel(), texture->GetImage(0)));
+			}
+
+			FrameBuffer::DepthStencilBinding depthStencil;
+			switch (description->GetDepthStencilCombinationState())
+			{
+			case FrameBufferLayoutDescription::DepthStencilCombinationState::DepthOnly:
+				depthStencil = FrameBuffer::DepthStencilBinding(MakeSP<Texture2D>(Texture::DataDescription<2>(description->GetDepthFormat(), size), false)->GetImage(0), nullptr);
+				break;
+			case FrameBufferLayoutDescription::DepthStencilCombinationState::StencilOnly:
+				depthStencil = FrameBuffer::DepthStencilBinding(nullptr, MakeSP<Texture2D>(Texture::DataDescription<2>(description->GetStencilFormat(), size), false)->GetImage(0));
+				break;
+			case FrameBufferLayoutDescription::DepthStencilCombinationState::Combined:
+				depthStencil = FrameBuffer::DepthStencilBinding(MakeSP<Texture2D>(Texture::DataDescription<2>(description->GetDepthStencilFormat(), size), false)->GetImage(0));
+				break;
+			default:
+				break;
+			}
+			return MakeSP<FrameBuffer>(std::move(description), std::move(colorTextures), depthStencil);
+		}
+
 	}
 
 
@@ -172,9 +212,21 @@ namespace XREX
 	{
 		// initialize the graphics context first
 		graphicsContext_ = MakeUP<GraphicsContext>(window, settings);
+		glStateCache_ = MakeUP<GLStateCache>();
+		uniformRingBuffer_ = MakeUP<UniformRingBuffer>(uint32(UniformRingBuffer::DefaultFrameSizeInBytes), uint32(UniformRingBuffer::DefaultFrameCount));
+		profiler_ = MakeUP<Profiler>();
+		gpuProfiler_ = MakeUP<GPUProfiler>(*profiler_);
+		currentFrameStatistics_ = MakeUP<FrameStatistics>();
+		lastFrameStatistics_ = MakeUP<FrameStatistics>();
+		frameStatisticsHistory_ = MakeUP<FrameStatisticsHistory>();
+		FrameStatistics::SetCurrent(currentFrameStatistics_.get());
 
 		// window may not have the size specified in settings, so use window.GetClientRegionSize() here to get the actual size.
+#ifdef XREX_HEADLESS
+		defaultFrameBuffer_ = MakeOffscreenFrameBuffer(window.GetClientRegionSize(), settings.renderingSettings.colorFormat, settings.renderingSettings.depthStencilFormat);
+#else
 		defaultFrameBuffer_ = MakeSP<DefaultFrameBuffer>(window.GetClientRegionSize(), settings.renderingSettings.colorFormat, settings.renderingSettings.depthStencilFormat);
+#endif
 
 #ifdef XREX_DEBUG
 		gl::DebugMessageCallback(&DebugCallback::Callback, this);
@@ -186,24 +238,27 @@ namespace XREX
 		gl::PixelStorei(gl::GL_PACK_ALIGNMENT, 1); // default 4
 
 
-		gl::Enable(gl::GL_SCISSOR_TEST);
+		glStateCache_->SetCapability(gl::GL_SCISSOR_TEST, true);
 
-		gl::Enable(gl::GL_POLYGON_OFFSET_FILL);
-		gl::Enable(gl::GL_POLYGON_OFFSET_POINT);
-		gl::Enable(gl::GL_POLYGON_OFFSET_LINE);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_FILL, true);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_POINT, true);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_LINE, true);
 		defaultRasterizerState_ = XREXContext::GetInstance().GetRenderingFactory().CreateRasterizerStateObject(RasterizerState());
 		defaultDepthStencilState_ = XREXContext::GetInstance().GetRenderingFactory().CreateDepthStencilStateObject(DepthStencilState());
 		defaultBlendState_ = XREXContext::GetInstance().GetRenderingFactory().CreateBlendStateObject(BlendState());
 
 		RegisterSystemTechniqueFactory(MakeUP<TransformationTechniqueFactory>());
 		RegisterSystemTechniqueFactory(MakeUP<CameraTechniqueFactory>());
+		RegisterSystemTechniqueFactory(MakeUP<InstanceTransformationTechniqueFactory>());
+		RegisterSystemTechniqueFactory(MakeUP<DrawParametersTechniqueFactory>());
 	}
 
 
 	RenderingEngine::~RenderingEngine()
 	{
-		beforeRenderingFunction_.swap(decltype(beforeRenderingFunction_)());
-		afterRenderingFunction_.swap(decltype(afterRenderingFunction_)());
+		FrameStatistics::SetCurrent(nullptr);
+		beforeRenderingFunction_ = nullptr;
+		afterRenderingFunction_ = nullptr;
 	}
 
 	uint32 RenderingEngine::GetGLError()
@@ -233,13 +288,49 @@ namespace XREX
 	}
 
 
+	void RenderingEngine::StartProfileCapture()
+	{
+		profiler_->StartCapture();
+	}
+
+	bool RenderingEngine::StopProfileCapture(std::string const& traceFileName)
+	{
+		profiler_->StopCapture();
+		return profiler_->SaveChromeTrace(traceFileName);
+	}
+
 	void RenderingEngine::SwapBuffers()
 	{
+		ProfileScope scope(*profiler_, "SwapBuffers");
 		graphicsContext_->SwapBuffers();
 	}
 
 	void RenderingEngine::RenderAFrame()
 	{
+		DoRenderAFrame([this] ()
+		{
+			SceneSP const& scene = XREXContext::GetInstance().GetScene();
+			assert(process_);
+			process_->RenderScene(scene);
+		});
+	}
+
+	void RenderingEngine::RenderAFrame(FrameSnapshot const& snapshot)
+	{
+		DoRenderAFrame([this, &snapshot] ()
+		{
+			assert(process_ && process_->IsSnapshotSupported());
+			process_->RenderSnapshot(snapshot);
+		});
+	}
+
+	void RenderingEngine::DoRenderAFrame(std::function<void()> const& renderScene)
+	{
+		ProfileScope frameScope(*profiler_, "RenderAFrame");
+		gpuProfiler_->BeginFrame();
+		gpuProfiler_->BeginRange("RenderAFrame");
+		glStateCache_->BeginFrame();
+		uniformRingBuffer_->BeginFrame();
 
 		// clear frame buffer globally first.
 		gl::ClearColor(0, 0, 0, 0);
@@ -250,39 +341,52 @@ namespace XREX
 		{
 			beforeRenderingFunction_(currentTime, delta);
 		}
+		// state may be changed by GL calls outside XREX, in the callbacks or by the GUI last frame.
+		glStateCache_->Invalidate();
 
 #ifdef USE_OPENGL_COMPATIBILITY_PROFILE
-		gl::Enable(gl::GL_POLYGON_OFFSET_FILL);
-		gl::Enable(gl::GL_POLYGON_OFFSET_POINT);
-		gl::Enable(gl::GL_POLYGON_OFFSET_LINE);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_FILL, true);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_POINT, true);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_LINE, true);
 #endif
 
-		SceneSP const& scene = XREXContext::GetInstance().GetScene();
-		assert(process_);
-		process_->RenderScene(scene);
-
+		{
+			ProfileScope scope(*profiler_, "RenderScene");
+			renderScene();
+		}
 
 #ifdef USE_OPENGL_COMPATIBILITY_PROFILE
-		gl::UseProgram(0);
+		glStateCache_->UseProgram(0);
+		glStateCache_->BindVertexArray(0);
 		gl::ActiveTexture(gl::GL_TEXTURE0);
-		gl::BindSampler(0, 0);
+		glStateCache_->BindSampler(0, 0);
 		gl::BindBuffer(gl::GL_ARRAY_BUFFER, 0);
 		gl::BindBuffer(gl::GL_ELEMENT_ARRAY_BUFFER, 0);
 		// TODO temp hack for CEGUI.
 		defaultRasterizerState_->Bind(0, 0);
 		defaultDepthStencilState_->Bind(0, 0);
 		defaultBlendState_->Bind(defaultBlendColor_);
-		gl::Disable(gl::GL_POLYGON_OFFSET_FILL);
-		gl::Disable(gl::GL_POLYGON_OFFSET_POINT);
-		gl::Disable(gl::GL_POLYGON_OFFSET_LINE);
-		gl::Disable(gl::GL_DEPTH_TEST);
-		gl::Disable(gl::GL_CULL_FACE);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_FILL, false);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_POINT, false);
+		glStateCache_->SetCapability(gl::GL_POLYGON_OFFSET_LINE, false);
+		glStateCache_->SetCapability(gl::GL_DEPTH_TEST, false);
+		glStateCache_->SetCapability(gl::GL_CULL_FACE, false);
 #endif
 
 		if (afterRenderingFunction_ != nullptr)
 		{
 			afterRenderingFunction_(currentTime, delta);
 		}
+		glStateCache_->Invalidate();
+		uniformRingBuffer_->EndFrame();
+		gpuProfiler_->EndRange();
+		gpuProfiler_->EndFrame();
+
+		currentFrameStatistics_->frameTime = delta;
+		currentFrameStatistics_->renderTime = timer_.Elapsed() - currentTime;
+		*lastFrameStatistics_ = *currentFrameStatistics_;
+		frameStatisticsHistory_->Add(*lastFrameStatistics_);
+		currentFrameStatistics_->Clear();
 
 		lastTime_ = currentTime;
 	}
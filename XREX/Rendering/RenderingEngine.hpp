@@ -23,6 +23,59 @@ namespace XREX
 			return *graphicsContext_;
 		}
 
+		GLStateCache& GetGLStateCache() const
+		{
+			return *glStateCache_;
+		}
+
+		/*
+		 *	CPU ranges of all threads and GPU ranges of frames, see StartProfileCapture.
+		 */
+		Profiler& GetProfiler() const
+		{
+			return *profiler_;
+		}
+		GPUProfiler& GetGPUProfiler() const
+		{
+			return *gpuProfiler_;
+		}
+		/*
+		 *	Record CPU and GPU ranges from next frame: frames, cameras, rendering groups, techniques and scopes of the rendering process.
+		 */
+		void StartProfileCapture();
+		/*
+		 *	Stop recording and save ranges recorded since StartProfileCapture as Chrome trace_event JSON.
+		 *	@return: false if the file can not be written.
+		 */
+		bool StopProfileCapture(std::string const& traceFileName);
+
+		/*
+		 *	Statistics being counted, of the frame being rendered.
+		 */
+		FrameStatistics& GetCurrentFrameStatistics() const
+		{
+			return *currentFrameStatistics_;
+		}
+		/*
+		 *	Statistics of the last frame finished by RenderAFrame.
+		 */
+		FrameStatistics const& GetLastFrameStatistics() const
+		{
+			return *lastFrameStatistics_;
+		}
+		FrameStatisticsHistory& GetFrameStatisticsHistory() const
+		{
+			return *frameStatisticsHistory_;
+		}
+
+		/*
+		 *	Per frame uniform data of system techniques are allocated from it.
+		 */
+		UniformRingBuffer& GetUniformRingBuffer() const
+		{
+			return *uniformRingBuffer_;
+		}
+
 		FrameBufferSP const& GetDefaultFrameBuffer() const
 		{
 			return defaultFrameBuffer_;
@@ -55,6 +108,10 @@ namespace XREX
 		void SwapBuffers();
 
 		void RenderAFrame();
+		/*
+		 *	Render a snapshot captured by RenderingProcess::CaptureSnapshot, without accessing the scene.
+		 */
+		void RenderAFrame(FrameSnapshot const& snapshot);
 
 
 		void OnBeforeRendering(std::function<void(double current, double delta)> const& beforeRenderingFunction)
@@ -66,8 +123,18 @@ namespace XREX
 			afterRenderingFunction_ = afterRenderingFunction;
 		}
 
+	private:
+		void DoRenderAFrame(std::function<void()> const& renderScene);
+
 	private:
 		std::unique_ptr<GraphicsContext> graphicsContext_;
+		std::unique_ptr<GLStateCache> glStateCache_;
+		std::unique_ptr<UniformRingBuffer> uniformRingBuffer_;
+		std::unique_ptr<Profiler> profiler_;
+		std::unique_ptr<GPUProfiler> gpuProfiler_;
+		std::unique_ptr<FrameStatistics> currentFrameStatistics_;
+		std::unique_ptr<FrameStatistics> lastFrameStatistics_;
+		std::unique_ptr<FrameStatisticsHistory> frameStatisticsHistory_;
 
 		RenderingProcessSP process_;
 
@@ -10,10 +10,87 @@
 #include "Rendering/Viewport.hpp"
 #include "Rendering/RenderingLayout.hpp"
 #include "Rendering/ProgramConnector.hpp"
+#include "Rendering/BufferArena.hpp"
 
 namespace XREX
 {
+	namespace
+	{
+		/*
+		 *	@return: size of a vertex if all channels are interleaved in vertices of the same size, otherwise 0.
+		 */
+		uint32 InterleavedVertexSize(VertexBuffer::DataLayoutDescription const& description, uint32 sizeInBytes)
+		{
+			uint32 vertexCount = description.GetVertexCount();
+			if (vertexCount == 0 || sizeInBytes % vertexCount != 0)
+			{
+				return 0;
+			}
+			uint32 vertexSize = sizeInBytes / vertexCount;
+			for (auto& channelLayout : description.GetAllLayouts())
+			{
+				uint32 elementSize = GetElementSizeInBytes(channelLayout.elementType);
+				uint32 strip = channelLayout.strip == 0 ? elementSize : channelLayout.strip;
+				if (strip != vertexSize || channelLayout.start + elementSize > vertexSize)
+				{
+					return 0;
+				}
+			}
+			return vertexSize;
+		}
+
+		/*
+		 *	Layouts with the same format can use one vertex array, as attribute locations are found by channel.
+		 */
+		std::string VertexFormatKey(VertexBuffer::DataLayoutDescription const& description)
+		{
+			std::string key;
+			for (auto& channelLayout : description.GetAllLayouts())
+			{
+				key += channelLayout.channel + ":" + std::to_string(static_cast<uint64>(channelLayout.start)) + ":" + std::to_string(static_cast<uint64>(channelLayout.strip))
+					+ ":" + std::to_string(static_cast<uint64>(channelLayout.elementType)) + (channelLayout.needNormalize ? ":n;" : ";");
+			}
+			return key;
+		}
+
+		/*
+		 *	@return: buffers, but those viewing ranges are copied to their own buffers if their base vertices differ,
+		 *	e.g. ranges of arenas of different formats, or a range with a whole buffer.
+		 */
+		std::vector<VertexBufferSP> WithSameBaseVertex(std::vector<VertexBufferSP> const& buffers)
+		{
+			if (RenderingLayout::HaveSameBaseVertex(buffers))
+			{
+				return buffers;
+			}
+			std::vector<VertexBufferSP> result;
+			for (auto& buffer : buffers)
+			{
+				if (buffer->IsWholeBuffer())
+				{
+					result.push_back(buffer);
+					continue;
+				}
+				VertexBuffer::DataLayoutDescription const& description = buffer->GetDataLayoutDescription();
+				VertexBuffer::DataLayoutDescription descriptionCopy(description.GetVertexCount());
+				for (auto& channelLayout : description.GetAllLayouts())
+				{
+					descriptionCopy.AddChannelLayout(VertexBuffer::DataLayoutDescription::ElementLayoutDescription(channelLayout));
+				}
+				GraphicsBufferSP const& shared = buffer->GetBuffer();
+				GraphicsBuffer::BufferMapper mapper = shared->GetMapper(AccessType::ReadOnly);
+				GraphicsBufferSP own = MakeSP<GraphicsBuffer>(shared->GetUsage(), mapper.GetPointer<uint8>() + buffer->GetRangeOffset(), buffer->GetBufferSize(), BufferView::BufferType::Vertex);
+				mapper.Finish();
+				result.push_back(MakeSP<VertexBuffer>(std::move(descriptionCopy), own));
+			}
+			return result;
+		}
+	}
+
+
+
 	RenderingFactory::RenderingFactory(Window& window, Settings const& settings)
+		: bufferArenaEnabled_(false)
 	{
 		renderingEngine_ = MakeUP<RenderingEngine>(window, settings);
 		GraphicsContext& graphicsContext = renderingEngine_->GetGraphicsContext();
@@ -26,6 +103,22 @@ namespace XREX
 		version[1] = '0' + graphicsContext.GetMinorVersion(); // int to one byte char
 		glslVersionString_ += version + "\n\n";
 
+		if (graphicsContext.GetMajorVersion() > 4 || (graphicsContext.GetMajorVersion() == 4 && graphicsContext.GetMinorVersion() >= 6))
+		{
+			drawIDMacroString_ = "#define XREX_DrawID gl_DrawID\n";
+			drawIDSupported_ = true;
+		}
+		else if (graphicsContext.IsExtensionSupported("GL_ARB_shader_draw_parameters"))
+		{
+			drawIDMacroString_ = "#extension GL_ARB_shader_draw_parameters : require\n#define XREX_DrawID gl_DrawIDARB\n";
+			drawIDSupported_ = true;
+		}
+		else
+		{
+			drawIDMacroString_ = "#define XREX_DrawID 0\n";
+			drawIDSupported_ = false;
+		}
+
 		auto depthOrder = std::numeric_limits<decltype(std::declval<Viewport>().GetDepthOrder())>::max();
 		defaultViewport_ = CreateViewport(depthOrder, 0.f, 0.f, 1.f, 1.f); // float parameters to use relative mode
 
@@ -73,6 +166,32 @@ namespace XREX
 		return connector;
 	}
 
+	void RenderingFactory::ReleaseUnusedConnectors()
+	{
+		for (auto i = connectors_.begin(); i != connectors_.end();)
+		{
+			// the key and the connector hold the layout.
+			if (i->second.use_count() == 1 && i->first.first.use_count() == 2)
+			{
+				i = connectors_.erase(i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	uint32 RenderingFactory::GetBufferArenaPageCount() const
+	{
+		uint32 count = indexArena_ == nullptr ? 0 : indexArena_->GetPageCount();
+		for (auto& arena : vertexArenas_)
+		{
+			count += arena.second->GetPageCount();
+		}
+		return count;
+	}
+
 	RasterizerStateObjectSP RenderingFactory::CreateRasterizerStateObject(RasterizerState const& rasterizerState)
 	{
 		return MakeSP<RasterizerStateObject>(rasterizerState);
@@ -162,9 +281,55 @@ namespace XREX
 		return MakeSP<IndexBuffer>(topologicalType, elementType, elementCount);
 	}
 
+	VertexBufferSP RenderingFactory::CreateVertexBuffer(GraphicsBuffer::Usage usage, void const* data, uint32 sizeInBytes, VertexBuffer::DataLayoutDescription&& description)
+	{
+		uint32 vertexSize = InterleavedVertexSize(description, sizeInBytes);
+		if (bufferArenaEnabled_ && usage == GraphicsBuffer::Usage::StaticDraw && vertexSize != 0)
+		{
+			std::unique_ptr<BufferArena>& arena = vertexArenas_[VertexFormatKey(description)];
+			if (arena == nullptr)
+			{
+				arena = MakeUP<BufferArena>(usage, BufferView::BufferType::Vertex, uint32(BufferArena::DefaultPageSizeInBytes));
+			}
+			std::pair<GraphicsBufferSP, uint32> range = arena->Allocate(data, sizeInBytes, vertexSize); // aligned to vertex for base vertex
+			VertexBufferSP vertexBuffer = CreateVertexBuffer(std::move(description));
+			vertexBuffer->SetBufferRange(range.first, range.second, sizeInBytes);
+			return vertexBuffer;
+		}
+		GraphicsBufferSP buffer = CreateGraphicsBuffer(usage, data, sizeInBytes);
+		return CreateVertexBuffer(std::move(description), std::move(buffer));
+	}
+
+	IndexBufferSP RenderingFactory::CreateIndexBuffer(GraphicsBuffer::Usage usage, void const* data, IndexBuffer::TopologicalType topologicalType, ElementType elementType, uint32 elementCount)
+	{
+		uint32 elementSize = GetElementSizeInBytes(elementType);
+		if (bufferArenaEnabled_ && usage == GraphicsBuffer::Usage::StaticDraw && elementCount != 0)
+		{
+			if (indexArena_ == nullptr)
+			{
+				indexArena_ = MakeUP<BufferArena>(usage, BufferView::BufferType::Index, uint32(BufferArena::DefaultPageSizeInBytes));
+			}
+			std::pair<GraphicsBufferSP, uint32> range = indexArena_->Allocate(data, elementSize * elementCount, elementSize);
+			IndexBufferSP indexBuffer = CreateIndexBuffer(topologicalType, elementType, elementCount);
+			indexBuffer->SetBufferRange(range.first, range.second, elementSize * elementCount);
+			return indexBuffer;
+		}
+		GraphicsBufferSP buffer = CreateGraphicsBuffer(usage, data, elementSize * elementCount);
+		return CreateIndexBuffer(topologicalType, elementType, elementCount, std::move(buffer));
+	}
+
 	RenderingLayoutSP RenderingFactory::CreateRenderingLayout(std::vector<VertexBufferSP> const& buffers, IndexBufferSP const& indexBuffer)
 	{
-		return MakeSP<RenderingLayout>(buffers, indexBuffer);
+		RenderingLayoutSP layout = MakeSP<RenderingLayout>(WithSameBaseVertex(buffers), indexBuffer);
+		layout->CalculateBoundingVolume();
+		return layout;
+	}
+
+	RenderingLayoutSP RenderingFactory::CreateRenderingLayout(std::vector<VertexBufferSP> const& buffers, IndexBufferSP const& indexBuffer, AxisAlignedBox const& boundingBox, Sphere const& boundingSphere)
+	{
+		RenderingLayoutSP layout = MakeSP<RenderingLayout>(WithSameBaseVertex(buffers), indexBuffer);
+		layout->SetBoundingVolume(boundingBox, boundingSphere);
+		return layout;
 	}
 
 	LayoutAndProgramConnectorSP RenderingFactory::CreateLayoutAndProgramConnector(RenderingLayoutSP const& layout, ProgramObjectSP const& program)
@@ -22,12 +22,47 @@ namespace XREX
 		{
 			return glslVersionString_;
 		}
+		/*
+		 *	Defines XREX_DrawID for vertex shaders, index of the draw in a multi draw, 0 if not supported.
+		 */
+		std::string const& GetDrawIDMacroString() const
+		{
+			return drawIDMacroString_;
+		}
+		/*
+		 *	Whether XREX_DrawID really gives the draw index, needs GL 4.6 or GL_ARB_shader_draw_parameters.
+		 */
+		bool IsDrawIDSupported() const
+		{
+			return drawIDSupported_;
+		}
 
 		ViewportSP const& GetDefaultViewport() const
 		{
 			return defaultViewport_;
 		}
 
+		/*
+		 *	Off by default. When enabled, static vertex and index data given to CreateVertexBuffer and CreateIndexBuffer
+		 *	is placed in shared BufferArena pages instead of a buffer per call.
+		 *	Vertex data of the same format shares pages and the layouts get base vertex and first index,
+		 *	see RenderingLayout::SharesBuffersWith. Vertex data not interleaved still gets its own buffer.
+		 *	Views of arena ranges must not be mapped or updated as whole buffers.
+		 *	A page is released when no buffer views it, connectors cached by GetConnector keep their layouts, see ReleaseUnusedConnectors.
+		 */
+		void SetBufferArenaEnabled(bool enable)
+		{
+			bufferArenaEnabled_ = enable;
+		}
+		bool IsBufferArenaEnabled() const
+		{
+			return bufferArenaEnabled_;
+		}
+		/*
+		 *	Pages of all buffer arenas having live ranges.
+		 */
+		uint32 GetBufferArenaPageCount() const;
+
 
 		TextureSP const& GetBlackTexture1D() const
 		{
@@ -88,18 +123,16 @@ namespace XREX
 		template <typename T>
 		VertexBufferSP CreateVertexBuffer(GraphicsBuffer::Usage usage, std::vector<T> const& data, std::string const& channel)
 		{
-			GraphicsBufferSP buffer = CreateGraphicsBuffer(usage, data.data(), data.size() * sizeof(T));
 			VertexBuffer::DataLayoutDescription description(data.size());
 			description.AddChannelLayout(VertexBuffer::DataLayoutDescription::ElementLayoutDescription(0, 0, TypeToElementType<T>::Type, channel));
-			return CreateVertexBuffer(std::move(description), std::move(buffer));
+			return CreateVertexBuffer(usage, data.data(), data.size() * sizeof(T), std::move(description));
 		}
 		template <typename T>
 		VertexBufferSP CreateVertexBuffer(GraphicsBuffer::Usage usage, std::vector<T> const& data, std::string const& channel, bool normalized)
 		{
-			GraphicsBufferSP buffer = CreateGraphicsBuffer(usage, data.data(), data.size() * sizeof(T));
 			VertexBuffer::DataLayoutDescription description(data.size());
 			description.AddChannelLayout(VertexBuffer::DataLayoutDescription::ElementLayoutDescription(0, 0, TypeToElementType<T>::Type, channel, normalized));
-			return CreateVertexBuffer(std::move(description), std::move(buffer));
+			return CreateVertexBuffer(usage, data.data(), data.size() * sizeof(T), std::move(description));
 		}
 
 		VertexBufferSP CreateVertexBuffer(VertexBuffer::DataLayoutDescription&& description, GraphicsBufferSP const& buffer);
@@ -107,19 +140,33 @@ namespace XREX
 		template <typename T>
 		VertexBufferSP CreateVertexBuffer(GraphicsBuffer::Usage usage, std::vector<T> const& data, VertexBuffer::DataLayoutDescription&& description)
 		{
-			GraphicsBufferSP buffer = CreateGraphicsBuffer(usage, data.data(), data.size() * sizeof(T));
-			return CreateVertexBuffer(std::move(description), std::move(buffer));
+			return CreateVertexBuffer(usage, data.data(), data.size() * sizeof(T), std::move(description));
 		}
+		/*
+		 *	Uses the buffer arena if enabled and usage is StaticDraw.
+		 */
+		VertexBufferSP CreateVertexBuffer(GraphicsBuffer::Usage usage, void const* data, uint32 sizeInBytes, VertexBuffer::DataLayoutDescription&& description);
 		IndexBufferSP CreateIndexBuffer(IndexBuffer::TopologicalType topologicalType, ElementType elementType, uint32 elementCount, GraphicsBufferSP const& buffer);
 		IndexBufferSP CreateIndexBuffer(IndexBuffer::TopologicalType topologicalType, ElementType elementType, uint32 elementCount);
 		template <typename T>
 		IndexBufferSP CreateIndexBuffer(GraphicsBuffer::Usage usage, std::vector<T> const& data, IndexBuffer::TopologicalType topologicalType)
 		{
-			GraphicsBufferSP buffer = CreateGraphicsBuffer(usage, data.data(), data.size() * sizeof(T));
-			return CreateIndexBuffer(topologicalType, TypeToElementType<T>::Type, data.size(), std::move(buffer));
+			return CreateIndexBuffer(usage, data.data(), topologicalType, TypeToElementType<T>::Type, data.size());
 		}
+		/*
+		 *	Uses the buffer arena if enabled and usage is StaticDraw.
+		 */
+		IndexBufferSP CreateIndexBuffer(GraphicsBuffer::Usage usage, void const* data, IndexBuffer::TopologicalType topologicalType, ElementType elementType, uint32 elementCount);
 
+		/*
+		 *	Bounding volumes are calculated by reading back the position channel.
+		 *	Ranges of buffers are copied to their own buffers if they do not have the same base vertex, see RenderingLayout::HaveSameBaseVertex.
+		 */
 		RenderingLayoutSP CreateRenderingLayout(std::vector<VertexBufferSP> const& buffers, IndexBufferSP const& indexBuffer);
+		/*
+		 *	Use known bounding volumes, avoid reading back the vertex buffer.
+		 */
+		RenderingLayoutSP CreateRenderingLayout(std::vector<VertexBufferSP> const& buffers, IndexBufferSP const& indexBuffer, AxisAlignedBox const& boundingBox, Sphere const& boundingSphere);
 		LayoutAndProgramConnectorSP CreateLayoutAndProgramConnector(RenderingLayoutSP const& layout, ProgramObjectSP const& program);
 
 		SamplerSP CreateSampler(SamplerState const& samplerState);
@@ -175,9 +222,16 @@ namespace XREX
 		ViewportSP CreateViewport(int32 depthOrder, float left, float bottom, float width, float height);
 
 		LayoutAndProgramConnectorSP GetConnector(RenderingLayoutSP const& layout, RenderingTechniqueSP const& technique);
+		/*
+		 *	Release cached connectors used by nothing else, so their layouts and buffers can be released.
+		 */
+		void ReleaseUnusedConnectors();
 
 	private:
 		std::string glslVersionString_;
+		std::string drawIDMacroString_;
+		bool drawIDSupported_;
+		bool bufferArenaEnabled_;
 		ViewportSP defaultViewport_;
 		TextureSP blackTexture1D_;
 		TextureSP blackTexture2D_;
@@ -185,6 +239,12 @@ namespace XREX
 		TextureSP blackTextureCube_;
 		SamplerSP defaultSampler_;
 		std::unique_ptr<RenderingEngine> renderingEngine_;
+		/*
+		 *	Vertex arenas are per vertex format, the key is made from the DataLayoutDescription.
+		 *	Pages are owned by their ranges, arenas only find pages to allocate from.
+		 */
+		std::unordered_map<std::string, std::unique_ptr<BufferArena>> vertexArenas_;
+		std::unique_ptr<BufferArena> indexArena_;
 
 		std::unordered_map<std::pair<RenderingLayoutSP, RenderingTechniqueSP>, LayoutAndProgramConnectorSP, STLPairHasher<RenderingLayoutSP, RenderingTechniqueSP>> connectors_;
 	};
@@ -4,6 +4,7 @@
 
 #include "Rendering/GraphicsBuffer.hpp"
 #include "Rendering/ShaderProgram.hpp"
+#include "Rendering/DefinedShaderName.hpp"
 #include "Rendering/GL/GLUtil.hpp"
 
 #include <CoreGL.hpp>
@@ -26,6 +27,58 @@ namespace XREX
 	{
 	}
 
+	bool VertexBuffer::DataLayoutDescription::CalculateBoundingVolume(void const* data, AxisAlignedBox* outBox, Sphere* outSphere) const
+	{
+		assert(data != nullptr);
+		std::string const& positionChannel = GetInputAttributeString(DefinedInputAttribute::Position);
+		auto& layouts = GetAllLayouts();
+		auto found = std::find_if(layouts.begin(), layouts.end(), [&positionChannel] (DataLayoutDescription::ElementLayoutDescription const& layout)
+		{
+			return layout.channel == positionChannel;
+		});
+		if (found == layouts.end() || (found->elementType != ElementType::FloatV3 && found->elementType != ElementType::FloatV4))
+		{
+			return false;
+		}
+
+		uint32 strip = found->strip == 0 ? GetElementSizeInBytes(found->elementType) : found->strip;
+		uint8 const* positions = static_cast<uint8 const*>(data) + found->start;
+		uint32 vertexCount = GetVertexCount();
+
+		AxisAlignedBox box;
+		for (uint32 i = 0; i < vertexCount; ++i)
+		{
+			box = box.Merge(floatV3(reinterpret_cast<float const*>(positions + i * strip)));
+		}
+		// centered at the box, tighter than the sphere bounding the box.
+		Sphere sphere;
+		if (!box.IsEmpty())
+		{
+			floatV3 center = box.GetCenter();
+			float radiusSquared = 0;
+			for (uint32 i = 0; i < vertexCount; ++i)
+			{
+				radiusSquared = std::max(radiusSquared, (floatV3(reinterpret_cast<float const*>(positions + i * strip)) - center).LengthSquared());
+			}
+			sphere = Sphere(center, std::sqrt(radiusSquared));
+		}
+
+		if (outBox)
+		{
+			*outBox = box;
+		}
+		if (outSphere)
+		{
+			*outSphere = sphere;
+		}
+		return true;
+	}
+
+	bool VertexBuffer::CalculateBoundingVolume(void const* data, AxisAlignedBox* outBox, Sphere* outSphere) const
+	{
+		return layoutDescription_.CalculateBoundingVolume(data, outBox, outSphere);
+	}
+
 
 
 	IndexBuffer::IndexBuffer(TopologicalType topologicalType, ElementType elementType, uint32 elementCount)
@@ -44,11 +97,51 @@ namespace XREX
 		return GetElementSizeInBytes(elementType_) * elementCount_ == newBuffer->GetSize();
 	}
 
+	bool IndexBuffer::SetBufferRangeCheck(GraphicsBufferSP const& newBuffer, uint32 offset, uint32 sizeInBytes)
+	{
+		uint32 elementSize = GetElementSizeInBytes(elementType_);
+		return elementSize * elementCount_ == sizeInBytes && offset % elementSize == 0;
+	}
+
+
+
+	int32 RenderingLayout::GetBaseVertexOf(VertexBuffer const& buffer)
+	{
+		if (buffer.IsWholeBuffer())
+		{
+			return 0;
+		}
+		uint32 vertexSize = buffer.GetBufferSize() / buffer.GetElementCount();
+		assert(buffer.GetRangeOffset() % vertexSize == 0);
+		return buffer.GetRangeOffset() / vertexSize;
+	}
+
+	bool RenderingLayout::HaveSameBaseVertex(vector<VertexBufferSP> const& buffers)
+	{
+		for (uint32 i = 1; i < buffers.size(); ++i)
+		{
+			if (GetBaseVertexOf(*buffers[i]) != GetBaseVertexOf(*buffers[0]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
 
 
 	RenderingLayout::RenderingLayout(vector<VertexBufferSP> const& buffers, IndexBufferSP const& indexBuffer)
-		: buffers_(buffers), indexBuffer_(indexBuffer)
+		: buffers_(buffers), indexBuffer_(indexBuffer), firstIndex_(0), baseVertex_(0)
 	{
+		if (!indexBuffer_->IsWholeBuffer())
+		{
+			firstIndex_ = indexBuffer_->GetRangeOffset() / GetElementSizeInBytes(indexBuffer_->GetElementType());
+		}
+		assert(HaveSameBaseVertex(buffers_)); // one base vertex for all buffers
+		if (!buffers_.empty())
+		{
+			baseVertex_ = GetBaseVertexOf(*buffers_[0]);
+		}
 
 	#ifdef XREX_DEBUG
 		int32 elementCount = -1;
@@ -76,4 +169,38 @@ namespace XREX
 		return indexBuffer_->GetElementType();
 	}
 
+	bool RenderingLayout::SharesBuffersWith(RenderingLayout const& other) const
+	{
+		if (buffers_.size() != other.buffers_.size() || indexBuffer_->GetBuffer() != other.indexBuffer_->GetBuffer()
+			|| GetIndexElementType() != other.GetIndexElementType())
+		{
+			return false;
+		}
+		for (uint32 i = 0; i < buffers_.size(); ++i)
+		{
+			if (buffers_[i]->GetBuffer() != other.buffers_[i]->GetBuffer())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool RenderingLayout::CalculateBoundingVolume()
+	{
+		for (auto& buffer : buffers_)
+		{
+			if (buffer->GetBuffer() == nullptr)
+			{
+				continue;
+			}
+			GraphicsBuffer::BufferMapper mapper = buffer->GetBuffer()->GetMapper(AccessType::ReadOnly);
+			if (buffer->CalculateBoundingVolume(mapper.GetPointer<uint8>() + buffer->GetRangeOffset(), &boundingBox_, &boundingSphere_))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
 }
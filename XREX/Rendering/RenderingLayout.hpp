@@ -63,6 +63,15 @@ namespace XREX
 				return vertexCount_;
 			}
 
+			/*
+			 *	Calculate bounding volumes of position channel.
+			 *	@data: vertex data laid out as this description.
+			 *	@outBox: can be null if not care.
+			 *	@outSphere: can be null if not care.
+			 *	@return: false if there is no position channel or position is not FloatV3/FloatV4.
+			 */
+			bool CalculateBoundingVolume(void const* data, AxisAlignedBox* outBox, Sphere* outSphere) const;
+
 		private:
 			uint32 vertexCount_;
 			std::vector<ElementLayoutDescription> channelLayouts_;
@@ -83,6 +92,15 @@ namespace XREX
 			return layoutDescription_.GetVertexCount();
 		}
 
+		/*
+		 *	Calculate bounding volumes of position channel.
+		 *	@data: CPU side copy of the vertex data, laid out as the DataLayoutDescription.
+		 *	@outBox: can be null if not care.
+		 *	@outSphere: can be null if not care.
+		 *	@return: false if there is no position channel or position is not FloatV3/FloatV4.
+		 */
+		bool CalculateBoundingVolume(void const* data, AxisAlignedBox* outBox, Sphere* outSphere) const;
+
 	private:
 		DataLayoutDescription layoutDescription_;
 	};
@@ -125,6 +143,7 @@ namespace XREX
 
 	private:
 		virtual bool SetBufferCheck(GraphicsBufferSP const& newBuffer) override;
+		virtual bool SetBufferRangeCheck(GraphicsBufferSP const& newBuffer, uint32 offset, uint32 sizeInBytes) override;
 
 
 	private:
@@ -139,6 +158,20 @@ namespace XREX
 	{
 
 	public:
+		/*
+		 *	Base vertex of the vertex buffer, offset of its range in vertices, 0 if it views the whole buffer.
+		 */
+		static int32 GetBaseVertexOf(VertexBuffer const& buffer);
+		/*
+		 *	Draws have one base vertex for all vertex buffers, a layout can only be made of buffers having the same base vertex.
+		 *	RenderingFactory::CreateRenderingLayout copies ranges of other buffers to their own buffers.
+		 */
+		static bool HaveSameBaseVertex(std::vector<VertexBufferSP> const& buffers);
+
+	public:
+		/*
+		 *	@buffers: must have the same base vertex, see HaveSameBaseVertex.
+		 */
 		RenderingLayout(std::vector<VertexBufferSP> const& buffers, IndexBufferSP const& indexBuffer);
 		~RenderingLayout();
 
@@ -157,10 +190,54 @@ namespace XREX
 			return indexBuffer_;
 		}
 
+		/*
+		 *	Where the data of this layout starts when its buffers are ranges of shared buffers, 0 otherwise.
+		 *	Draws of the layout use them, as vertex arrays always point to the start of the buffers.
+		 */
+		uint32 GetFirstIndex() const
+		{
+			return firstIndex_;
+		}
+		int32 GetBaseVertex() const
+		{
+			return baseVertex_;
+		}
+		/*
+		 *	Whether the two layouts use the same vertex and index buffers,
+		 *	then both can be drawn with a vertex array of either, e.g. by IndirectDrawer.
+		 */
+		bool SharesBuffersWith(RenderingLayout const& other) const;
+
+		/*
+		 *	Bounding volumes of position channel in model space, empty if not calculated.
+		 */
+		AxisAlignedBox const& GetBoundingBox() const
+		{
+			return boundingBox_;
+		}
+		Sphere const& GetBoundingSphere() const
+		{
+			return boundingSphere_;
+		}
+		void SetBoundingVolume(AxisAlignedBox const& boundingBox, Sphere const& boundingSphere)
+		{
+			boundingBox_ = boundingBox;
+			boundingSphere_ = boundingSphere;
+		}
+		/*
+		 *	Read back the vertex buffer containing position channel to calculate bounding volumes.
+		 *	@return: false if no vertex buffer has usable position channel.
+		 */
+		bool CalculateBoundingVolume();
+
 
 	private:
 		std::vector<VertexBufferSP> buffers_;
 		IndexBufferSP indexBuffer_;
+		uint32 firstIndex_;
+		int32 baseVertex_;
+		AxisAlignedBox boundingBox_;
+		Sphere boundingSphere_;
 	};
 
 
@@ -3,6 +3,7 @@
 #include "RenderingPipelineState.hpp"
 
 #include "Rendering/GL/GLUtil.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
 
 #include <CoreGL.hpp>
 
@@ -91,12 +92,13 @@ namespace XREX
 
 	void RasterizerStateObject::Bind(float polygonOffsetFactor, float polygonOffsetUnits)
 	{
-		gl::PolygonMode(gl::GL_FRONT_AND_BACK, glPolygonMode_);
-		gl::FrontFace(glFrontFace_);
-		SetGLState(gl::GL_CULL_FACE, glCullFaceEnable_);
-		gl::CullFace(glCullFace_);
-		gl::PolygonOffset(polygonOffsetFactor, polygonOffsetUnits);
-		SetGLState(gl::GL_MULTISAMPLE, state_.multisampleEnable);
+		GLStateCache& cache = *GLStateCache::GetCurrent();
+		cache.PolygonMode(glPolygonMode_);
+		cache.FrontFace(glFrontFace_);
+		cache.SetCapability(gl::GL_CULL_FACE, glCullFaceEnable_);
+		cache.CullFace(glCullFace_);
+		cache.PolygonOffset(polygonOffsetFactor, polygonOffsetUnits);
+		cache.SetCapability(gl::GL_MULTISAMPLE, state_.multisampleEnable);
 	}
 
 
@@ -119,16 +121,17 @@ namespace XREX
 
 	void DepthStencilStateObject::Bind(uint16 frontStencilReference, uint16 backStencilReference)
 	{
-		SetGLState(gl::GL_DEPTH_TEST, state_.depthTestEnable);
-		SetGLState(gl::GL_STENCIL_TEST, state_.stencilTestEnable);
-		gl::DepthMask(state_.depthWriteMask);
-		gl::DepthFunc(glDepthFunction_);
-		gl::StencilFuncSeparate(gl::GL_FRONT, glFrontStencilFunction_, frontStencilReference, state_.frontStencilReadMask);
-		gl::StencilOpSeparate(gl::GL_FRONT, glFrontStencilFail_, glFrontStencilDepthFail_, glFrontStencilPass_);
-		gl::StencilMaskSeparate(gl::GL_FRONT, state_.frontStencilWriteMask);
-		gl::StencilFuncSeparate(gl::GL_BACK, glBackStencilFunction_, backStencilReference, state_.backStencilReadMask);
-		gl::StencilOpSeparate(gl::GL_BACK, glBackStencilFail_, glBackStencilDepthFail_, glBackStencilPass_);
-		gl::StencilMaskSeparate(gl::GL_BACK, state_.backStencilWriteMask);
+		GLStateCache& cache = *GLStateCache::GetCurrent();
+		cache.SetCapability(gl::GL_DEPTH_TEST, state_.depthTestEnable);
+		cache.SetCapability(gl::GL_STENCIL_TEST, state_.stencilTestEnable);
+		cache.DepthMask(state_.depthWriteMask);
+		cache.DepthFunc(glDepthFunction_);
+		cache.StencilFuncSeparate(gl::GL_FRONT, glFrontStencilFunction_, frontStencilReference, state_.frontStencilReadMask);
+		cache.StencilOpSeparate(gl::GL_FRONT, glFrontStencilFail_, glFrontStencilDepthFail_, glFrontStencilPass_);
+		cache.StencilMaskSeparate(gl::GL_FRONT, state_.frontStencilWriteMask);
+		cache.StencilFuncSeparate(gl::GL_BACK, glBackStencilFunction_, backStencilReference, state_.backStencilReadMask);
+		cache.StencilOpSeparate(gl::GL_BACK, glBackStencilFail_, glBackStencilDepthFail_, glBackStencilPass_);
+		cache.StencilMaskSeparate(gl::GL_BACK, state_.backStencilWriteMask);
 	}
 
 
@@ -148,12 +151,13 @@ namespace XREX
 
 	void BlendStateObject::Bind(Color const& blendFactor)
 	{
-		SetGLState(gl::GL_SAMPLE_ALPHA_TO_COVERAGE, state_.alphaToCoverageEnable);
-		SetGLState(gl::GL_BLEND, state_.blendEnable);
-		gl::BlendEquationSeparate(glBlendOperation_, glBlendOperationAlpha_);
-		gl::BlendFuncSeparate(glSourceBlend_, glDestinationBlend_, glSourceBlendAlpha_, glDestinationBlendAlpha_);
-		gl::ColorMask(state_.redMask, state_.greenMask, state_.blueMask, state_.alphaMask);
-		gl::BlendColor(blendFactor.R(), blendFactor.G(), blendFactor.B(), blendFactor.A());
+		GLStateCache& cache = *GLStateCache::GetCurrent();
+		cache.SetCapability(gl::GL_SAMPLE_ALPHA_TO_COVERAGE, state_.alphaToCoverageEnable);
+		cache.SetCapability(gl::GL_BLEND, state_.blendEnable);
+		cache.BlendEquationSeparate(glBlendOperation_, glBlendOperationAlpha_);
+		cache.BlendFuncSeparate(glSourceBlend_, glDestinationBlend_, glSourceBlendAlpha_, glDestinationBlendAlpha_);
+		cache.ColorMask(state_.redMask, state_.greenMask, state_.blueMask, state_.alphaMask);
+		cache.BlendColor(blendFactor.R(), blendFactor.G(), blendFactor.B(), blendFactor.A());
 	}
 
 
@@ -12,6 +12,28 @@ namespace XREX
 		virtual ~RenderingProcess();
 
 		virtual void RenderScene(SceneSP const& scene) = 0;
+
+		/*
+		 *	Processes supporting snapshots can be used when XREXContext runs logic and rendering in separate threads.
+		 */
+		virtual bool IsSnapshotSupported() const
+		{
+			return false;
+		}
+		/*
+		 *	Called on logic thread. Capture everything RenderSnapshot needs from the scene.
+		 */
+		virtual void CaptureSnapshot(SceneSP const& scene, FrameSnapshot& snapshot)
+		{
+			assert(false);
+		}
+		/*
+		 *	Called on render thread, while logic thread is running next frame. Must not access the scene.
+		 */
+		virtual void RenderSnapshot(FrameSnapshot const& snapshot)
+		{
+			assert(false);
+		}
 	};
 }
 
@@ -11,6 +11,8 @@
 #include "Rendering/TextureImage.hpp"
 #include "Rendering/FrameBuffer.hpp"
 #include "Rendering/TechniqueBuilder.hpp"
+#include "Rendering/SystemTechnique.hpp"
+#include "Rendering/FrameStatistics.hpp"
 
 #include <algorithm>
 #include <sstream>
@@ -24,6 +26,21 @@ namespace XREX
 
 	TechniqueParameterSP const TechniqueParameter::NullTechniqueParameter = nullptr;
 
+	namespace
+	{
+		bool IsIncluded(TechniqueBuildingInformation const& information, TechniqueBuildingInformation const* included)
+		{
+			for (auto& include : information.GetAllIncludes())
+			{
+				if (include.get() == included || IsIncluded(*include, included))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
 
 
 
@@ -68,6 +85,20 @@ namespace XREX
 		}
 	}
 
+	TechniqueParameterSP SimpleTextureParameter::Clone() const
+	{
+		auto parameter = MakeSP<SimpleTextureParameter>(GetName());
+		parameter->SetValue(GetValue());
+		return parameter;
+	}
+
+	TechniqueParameterSP SimpleImageParameter::Clone() const
+	{
+		auto parameter = MakeSP<SimpleImageParameter>(GetName());
+		parameter->SetValue(GetValue());
+		return parameter;
+	}
+
 	XREX::ElementType ImageParameter::GetType() const 
 	{
 		switch (GetBindingInformation().GetImageType())
@@ -123,6 +154,7 @@ namespace XREX
 		samplers_(std::move(pack.samplers))
 	{
 		InitializeParameterInformations();
+		drawParametersIncluded_ = IsIncluded(*buildingInformation_, DrawParametersTechniqueFactory().GetTechniqueInformationToInclude().get());
 	}
 
 	RenderingTechnique::~RenderingTechnique()
@@ -167,6 +199,11 @@ namespace XREX
 
 
 	TechniqueParameterSP const& RenderingTechnique::GetParameterByName(string const& name)
+	{
+		return GetParameter(GetParameterHandle(name));
+	}
+
+	ParameterHandle RenderingTechnique::GetParameterHandle(string const& name) const
 	{
 		auto i = find_if(parameters_.begin(), parameters_.end(), [&name] (TechniqueParameterSP const& parameter)
 		{
@@ -174,14 +211,18 @@ namespace XREX
 		});
 		if (i == parameters_.end())
 		{
-			return TechniqueParameter::NullTechniqueParameter;
+			return ParameterHandle();
 		}
-		return *i;
+		return ParameterHandle(i - parameters_.begin());
 	}
 
 
 	void RenderingTechnique::Use()
 	{
+		if (FrameStatistics* statistics = FrameStatistics::GetCurrent())
+		{
+			++statistics->techniqueUseCount;
+		}
 		program_->Bind();
 		SetupAllResources();
 	}
@@ -405,6 +446,10 @@ namespace XREX
 			program_->ConnectUniformParameter(uniformInformation.GetChannel(), parameter);
 		}
 
+		for (uint32 i = 0; i < static_cast<uint32>(DefinedUniform::DefinedUniformCount); ++i)
+		{
+			definedParameterHandles_[i] = GetParameterHandle(GetUniformString(static_cast<DefinedUniform>(i)));
+		}
 	}
 
 
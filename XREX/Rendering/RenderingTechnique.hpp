@@ -3,6 +3,7 @@
 #include "Declare.hpp"
 
 #include "ShaderProgram.hpp"
+#include "DefinedShaderName.hpp"
 
 #include <string>
 #include <vector>
@@ -38,6 +39,16 @@ namespace XREX
 		virtual ElementType GetType() const = 0;
 
 		virtual void GetValueFrom(TechniqueParameter const& right) = 0;
+		/*
+		 *	@return: a new parameter of the same type with the same name and value.
+		 */
+		virtual TechniqueParameterSP Clone() const = 0;
+		/*
+		 *	Drop references to GPU resources held as value, values of other parameters are kept.
+		 */
+		virtual void ReleaseResourceValue()
+		{
+		}
 
 		template <typename T>
 		ConcreteTechniqueParameter<T>& As()
@@ -85,6 +96,13 @@ namespace XREX
 			value_ = CheckedCast<ConcreteTechniqueParameter const&>(right).value_;
 		}
 
+		virtual TechniqueParameterSP Clone() const override
+		{
+			auto parameter = MakeSP<ConcreteTechniqueParameter>(GetName());
+			parameter->value_ = value_;
+			return parameter;
+		}
+
 	private:
 		T value_;
 	};
@@ -102,6 +120,18 @@ namespace XREX
 		}
 
 		virtual ElementType GetType() const override;
+		virtual TechniqueParameterSP Clone() const override;
+		/*
+		 *	Type of a parameter without value is unknown, so it is not checked.
+		 */
+		virtual void GetValueFrom(TechniqueParameter const& right) override
+		{
+			SetValue(CheckedCast<ConcreteTechniqueParameter<TextureSP> const&>(right).GetValue());
+		}
+		virtual void ReleaseResourceValue() override
+		{
+			SetValue(TextureSP());
+		}
 	};
 	/*
 	 *	Used for Material to store image parameters.
@@ -116,6 +146,18 @@ namespace XREX
 		}
 
 		virtual ElementType GetType() const override;
+		virtual TechniqueParameterSP Clone() const override;
+		/*
+		 *	Type of a parameter without value is unknown, so it is not checked.
+		 */
+		virtual void GetValueFrom(TechniqueParameter const& right) override
+		{
+			SetValue(CheckedCast<ConcreteTechniqueParameter<TextureImageSP> const&>(right).GetValue());
+		}
+		virtual void ReleaseResourceValue() override
+		{
+			SetValue(TextureImageSP());
+		}
 	};
 
 	/*
@@ -204,8 +246,44 @@ namespace XREX
 
 
 
+	/*
+	 *	Index of a parameter in a RenderingTechnique, resolved by name once with RenderingTechnique::GetParameterHandle.
+	 *	Only meaningful to the technique resolving it.
+	 */
+	class XREX_API ParameterHandle
+	{
+		friend class RenderingTechnique;
+
+	public:
+		ParameterHandle()
+			: index_(InvalidIndex)
+		{
+		}
+
+		bool IsValid() const
+		{
+			return index_ != InvalidIndex;
+		}
+
+	private:
+		explicit ParameterHandle(uint32 index)
+			: index_(index)
+		{
+		}
+
+	private:
+		static uint32 const InvalidIndex = 0xFFFFFFFF;
+
+		uint32 index_;
+	};
+
+
+
+	/*
+	 *	Must be owned by a RenderingTechniqueSP, draw items only keep raw pointers and share ownership by shared_from_this when needed.
+	 */
 	class XREX_API RenderingTechnique
-		: Noncopyable
+		: public std::enable_shared_from_this<RenderingTechnique>, Noncopyable
 	{
 	public:
 		struct ConstructerParameterPack
@@ -239,6 +317,7 @@ namespace XREX
 				depthStencilState = std::move(right.depthStencilState);
 				blendState = std::move(right.blendState);
 				samplers = std::move(right.samplers);
+				return *this;
 			}
 		};
 	public:
@@ -258,6 +337,19 @@ namespace XREX
 			return program_;
 		}
 
+		RasterizerStateObjectSP const& GetRasterizerState() const
+		{
+			return rasterizerState_;
+		}
+		DepthStencilStateObjectSP const& GetDepthStencilState() const
+		{
+			return depthStencilState_;
+		}
+		BlendStateObjectSP const& GetBlendState() const
+		{
+			return blendState_;
+		}
+
 		TechniquePipelineParameters& GetPipelineParameters() // non const
 		{
 			return pipelineParameters_;
@@ -280,10 +372,45 @@ namespace XREX
 		}
 
 		/*
+		 *	Linear search, resolve a handle once instead of calling it for every use.
 		 *	@return null pointer if not exist.
 		 */
 		TechniqueParameterSP const& GetParameterByName(std::string const& name);
 
+		/*
+		 *	Linear search, keep the handle for later uses.
+		 *	@return: invalid handle if not exist.
+		 */
+		ParameterHandle GetParameterHandle(std::string const& name) const;
+		/*
+		 *	Resolved when the technique is created.
+		 *	@return: invalid handle if the technique do not have the uniform.
+		 */
+		ParameterHandle GetParameterHandle(DefinedUniform definedUniform) const
+		{
+			return definedParameterHandles_[static_cast<uint32>(definedUniform)];
+		}
+		/*
+		 *	@return null pointer if handle is invalid.
+		 */
+		TechniqueParameterSP const& GetParameter(ParameterHandle handle) const
+		{
+			if (!handle.IsValid())
+			{
+				return TechniqueParameter::NullTechniqueParameter;
+			}
+			assert(handle.index_ < parameters_.size());
+			return parameters_[handle.index_];
+		}
+
+
+		/*
+		 *	Whether the technique includes DrawParameters system technique, then its draws are issued by IndirectDrawer.
+		 */
+		bool IsDrawParametersIncluded() const
+		{
+			return drawParametersIncluded_;
+		}
 
 		void Use();
 
@@ -297,6 +424,7 @@ namespace XREX
 		TechniqueBuildingInformationSP buildingInformation_;
 
 		std::vector<TechniqueParameterSP> parameters_;
+		std::array<ParameterHandle, static_cast<uint32>(DefinedUniform::DefinedUniformCount)> definedParameterHandles_;
 
 		std::vector<std::function<void()>> parameterSetters_;
 
@@ -311,6 +439,8 @@ namespace XREX
 		TechniquePipelineParameters pipelineParameters_;
 
 		FrameBufferSP framebuffer_;
+
+		bool drawParametersIncluded_;
 	};
 
 
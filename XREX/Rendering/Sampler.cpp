@@ -3,6 +3,7 @@
 #include "Sampler.hpp"
 
 #include "Rendering/GL/GLUtil.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
 
 #include <CoreGL.hpp>
 
@@ -85,13 +86,17 @@ namespace XREX
 		if (glSamplerID_ != 0)
 		{
 			gl::DeleteSamplers(1, &glSamplerID_);
+			if (GLStateCache* cache = GLStateCache::GetCurrent())
+			{
+				cache->OnSamplerDeleted(glSamplerID_);
+			}
 			glSamplerID_ = 0;
 		}
 	}
 
 	void Sampler::Bind(uint32 textureChannel)
 	{
-		gl::BindSampler(textureChannel, glSamplerID_);
+		GLStateCache::GetCurrent()->BindSampler(textureChannel, glSamplerID_);
 	}
 
 }
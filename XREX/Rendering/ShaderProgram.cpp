@@ -10,6 +10,7 @@
 #include "Rendering/Texture.hpp"
 #include "Rendering/Sampler.hpp"
 #include "Rendering/TextureImage.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
 
 #include "Rendering/GL/GLUtil.hpp"
 
@@ -47,6 +48,19 @@ namespace XREX
 			return XREXContext::GetInstance().GetRenderingFactory().GetGLSLVersionString();
 		}
 
+		/*
+		 *	Only vertex shaders have draw id.
+		 */
+		std::string const& DrawIDMacro(ShaderObject::ShaderType type)
+		{
+			static std::string const Empty;
+			if (type != ShaderObject::ShaderType::VertexShader)
+			{
+				return Empty;
+			}
+			return XREXContext::GetInstance().GetRenderingFactory().GetDrawIDMacroString();
+		}
+
 		std::string const& DebugMacro()
 		{
 #ifdef XREX_DEBUG
@@ -86,6 +100,8 @@ namespace XREX
 
 		std::vector<char const*> cstrings;
 		cstrings.push_back(VersionMacro().c_str());
+		// #extension directives must precede everything else but #version on Mesa
+		cstrings.push_back(DrawIDMacro(type_).c_str());
 		cstrings.push_back(DebugMacro().c_str());
 		cstrings.push_back(macroToDefine.c_str());
 		for (auto source : sources)
@@ -167,6 +183,10 @@ namespace XREX
 		if (glProgramID_ != 0)
 		{
 			gl::DeleteProgram(glProgramID_);
+			if (GLStateCache* cache = GLStateCache::GetCurrent())
+			{
+				cache->OnProgramDeleted(glProgramID_);
+			}
 			glProgramID_ = 0;
 		}
 	}
@@ -225,7 +245,7 @@ namespace XREX
 	void ProgramObject::Bind()
 	{
 		assert(validate_);
-		gl::UseProgram(glProgramID_);
+		GLStateCache::GetCurrent()->UseProgram(glProgramID_);
 
 		SetupAllUniforms();
 
@@ -893,6 +913,11 @@ namespace XREX
 		return true;
 	}
 
+	bool ShaderResourceBuffer::SetBufferRangeCheck(GraphicsBufferSP const& newBuffer, uint32 offset, uint32 sizeInBytes)
+	{
+		return sizeInBytes == information_.GetDataSize();
+	}
+
 
 
 	ShaderResourceBuffer::VariableSetter::VariableSetter()
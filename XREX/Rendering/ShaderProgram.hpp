@@ -359,24 +359,24 @@ namespace XREX
 
 		struct XREX_API InformationPack
 		{
-			std::vector<AttributeInputInformation const> const& attributeInputs;
-			std::vector<FragmentOutputInformation const> const& fragmentOutputs;
-			std::vector<BufferInformation const> const& uniformBuffers;
-			std::vector<BufferInformation const> const& shaderStorageBuffers;
-			std::vector<BufferInformation const> const& atomicCounterBuffers;
-			std::vector<TextureInformation const> const& textures;
-			std::vector<ImageInformation const> const& images;
+			std::vector<AttributeInputInformation> const& attributeInputs;
+			std::vector<FragmentOutputInformation> const& fragmentOutputs;
+			std::vector<BufferInformation> const& uniformBuffers;
+			std::vector<BufferInformation> const& shaderStorageBuffers;
+			std::vector<BufferInformation> const& atomicCounterBuffers;
+			std::vector<TextureInformation> const& textures;
+			std::vector<ImageInformation> const& images;
 
 			/*
 			 *	The index of all Informations will be used by program as binding index.
 			 */
-			InformationPack(std::vector<AttributeInputInformation const> const& attributeInputs,
-				std::vector<FragmentOutputInformation const> const& fragmentOutputs,
-				std::vector<BufferInformation const> const& uniformBuffers,
-				std::vector<BufferInformation const> const& shaderStorageBuffers,
-				std::vector<BufferInformation const> const& atomicCounterBuffers,
-				std::vector<TextureInformation const> const& textures,
-				std::vector<ImageInformation const> const& images)
+			InformationPack(std::vector<AttributeInputInformation> const& attributeInputs,
+				std::vector<FragmentOutputInformation> const& fragmentOutputs,
+				std::vector<BufferInformation> const& uniformBuffers,
+				std::vector<BufferInformation> const& shaderStorageBuffers,
+				std::vector<BufferInformation> const& atomicCounterBuffers,
+				std::vector<TextureInformation> const& textures,
+				std::vector<ImageInformation> const& images)
 				: attributeInputs(attributeInputs), fragmentOutputs(fragmentOutputs),
 				uniformBuffers(uniformBuffers), shaderStorageBuffers(shaderStorageBuffers), atomicCounterBuffers(atomicCounterBuffers),
 				textures(textures), images(images)
@@ -555,10 +555,22 @@ namespace XREX
 			void SetValue(BufferMapper& mapper, T const& value)
 			{
 				assert(variableInformation_.GetElementType() == TypeToElementType<T>::Type);
+#ifdef XREX_DEBUG
 				assert(&mapper.buffer_ == buffer_);
+#endif
 				uint8* pointer = mapper.mapper_.GetPointer<uint8>();
 				*reinterpret_cast<T*>(pointer + variableInformation_.GetOffset()) = value;
 			}
+			/*
+			 *	@sliceMapper: mapping of the range the ShaderResourceBuffer views, see BufferView::SetBufferRange.
+			 */
+			template <typename T>
+			void SetValue(GraphicsBuffer::BufferMapper& sliceMapper, T const& value)
+			{
+				assert(variableInformation_.GetElementType() == TypeToElementType<T>::Type);
+				uint8* pointer = sliceMapper.GetPointer<uint8>();
+				*reinterpret_cast<T*>(pointer + variableInformation_.GetOffset()) = value;
+			}
 
 
 			template <typename T>
@@ -566,21 +578,23 @@ namespace XREX
 			{
 				assert(variableInformation_.GetElementType() == TypeToElementType<T>::Type);
 				assert(variableInformation_.GetElementCount() == value.size());
+#ifdef XREX_DEBUG
 				assert(&mapper.buffer_ == buffer_);
-				uint8* pointer = mapper_.GetPointer<uint8>();
+#endif
+				uint8* pointer = mapper.mapper_.GetPointer<uint8>();
 				uint8* start = pointer + variableInformation_.GetOffset();
 				if (variableInformation_.GetArrayStride() == 0) // tightly packed data
 				{
 					for (uint32 i = 0; i < variableInformation_.GetElementCount(); ++i)
 					{
-						*reinterpret_cast<T*>(start)[i] = value[i];
+						reinterpret_cast<T*>(start)[i] = value[i];
 					}
 				}
 				else
 				{
 					for (uint32 i = 0; i < variableInformation_.GetElementCount(); ++i)
 					{
-						*static_cast<T*>(start + variableInformation_.GetArrayStride() * i) = value[i];
+						*reinterpret_cast<T*>(start + variableInformation_.GetArrayStride() * i) = value[i];
 					}
 				}
 			}
@@ -602,7 +616,7 @@ namespace XREX
 
 		BufferMapper GetMapper()
 		{
-			assert(HaveBuffer());
+			assert(HaveBuffer() && IsWholeBuffer());
 			return BufferMapper(*this);
 		}
 
@@ -610,6 +624,7 @@ namespace XREX
 
 	private:
 		virtual bool SetBufferCheck(GraphicsBufferSP const& newBuffer) override;
+		virtual bool SetBufferRangeCheck(GraphicsBufferSP const& newBuffer, uint32 offset, uint32 sizeInBytes) override;
 
 	private:
 		BufferBindingInformation const& information_;
@@ -177,7 +177,7 @@ namespace XREX
 			: type_(BufferView::BufferType::TypeCount)
 		{
 		}
-		BufferInformation(std::string channel, std::string shaderInstanceName, BufferView::BufferType type, std::vector<VariableInformation const>&& bufferVariableInformations)
+		BufferInformation(std::string channel, std::string shaderInstanceName, BufferView::BufferType type, std::vector<VariableInformation>&& bufferVariableInformations)
 			: channel_(std::move(channel)), shaderInstanceName_(std::move(shaderInstanceName)), type_(type), bufferVariableInformations_(std::move(bufferVariableInformations))
 		{
 		}
@@ -191,7 +191,7 @@ namespace XREX
 			return type_;
 		}
 
-		std::vector<VariableInformation const> const& GetAllBufferVariableInformations() const
+		std::vector<VariableInformation> const& GetAllBufferVariableInformations() const
 		{
 			return bufferVariableInformations_;
 		}
@@ -200,7 +200,7 @@ namespace XREX
 		std::string channel_;
 		std::string shaderInstanceName_;
 		BufferView::BufferType type_;
-		std::vector<VariableInformation const> bufferVariableInformations_;
+		std::vector<VariableInformation> bufferVariableInformations_;
 	};
 
 }
\ No newline at end of file
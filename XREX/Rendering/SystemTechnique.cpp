@@ -6,12 +6,24 @@
 #include "Rendering/RenderingFactory.hpp"
 #include "Rendering/TechniqueBuilder.hpp"
 #include "Rendering/RenderingTechnique.hpp"
+#include "Rendering/RenderingEngine.hpp"
+#include "Rendering/UniformRingBuffer.hpp"
+#include "Rendering/DefinedShaderName.hpp"
+#include "Rendering/WorkLauncher.hpp"
 
 #include "Rendering/Camera.hpp"
 
 namespace XREX
 {
 
+	IComponentParameterSetter::~IComponentParameterSetter()
+	{
+	}
+
+	ISystemTechniqueFactory::~ISystemTechniqueFactory()
+	{
+	}
+
 	TechniqueBuildingInformationSP const& TransformationTechniqueFactory::GetTechniqueInformationToInclude() const
 	{
 		static TechniqueBuildingInformationSP const Builder = []
@@ -50,7 +62,7 @@ namespace XREX
 			TechniqueBuildingInformationSP techniqueInformation = MakeSP<TechniqueBuildingInformation>("XREX_Uniform_ModelTransformation");
 			techniqueInformation->AddCommonCode(MakeSP<std::string>(std::move(code)));
 
-			std::vector<VariableInformation const> modelVariables;
+			std::vector<VariableInformation> modelVariables;
 			modelVariables.push_back(VariableInformation("WorldFromModel", ElementType::FloatM44, 0));
 			modelVariables.push_back(VariableInformation("WorldFromModelNormal", ElementType::FloatM44, 0));
 			modelVariables.push_back(VariableInformation("ViewFromModel", ElementType::FloatM44, 0));
@@ -71,9 +83,9 @@ namespace XREX
 		if (modelParameter_ != nullptr)
 		{
 			parameterBuffer_ = modelParameter_->As<ShaderResourceBufferSP>().GetValue();
-			GraphicsBufferSP buffer = XREXContext::GetInstance().GetRenderingFactory().CreateGraphicsBufferWithBufferInformation(
+			fallbackBuffer_ = XREXContext::GetInstance().GetRenderingFactory().CreateGraphicsBufferWithBufferInformation(
 				GraphicsBuffer::Usage::DynamicDraw, parameterBuffer_->GetBufferInformation());
-			parameterBuffer_->SetBuffer(buffer);
+			parameterBuffer_->SetBuffer(fallbackBuffer_);
 
 			auto worldFromModelResult = parameterBuffer_->GetSetter("XREX_Uniform_ModelTransformation.WorldFromModel");
 			assert(worldFromModelResult.first);
@@ -105,7 +117,7 @@ namespace XREX
 			floatM44 viewMatrix = camera_->GetViewMatrix();
 			floatM44 projectionMatrix = camera_->GetProjectionMatrix();
 
-			ShaderResourceBuffer::BufferMapper mapper = parameterBuffer_->GetMapper();
+			GraphicsBuffer::BufferMapper mapper = XREXContext::GetInstance().GetRenderingEngine().GetUniformRingBuffer().MapSlice(*parameterBuffer_, fallbackBuffer_);
 			floatM44 modelMatrix = component->GetWorldMatrix();
 			floatM44 viewFromModelMatrix = viewMatrix * modelMatrix;
 			floatM44 clipFromModelMatrix = projectionMatrix * viewFromModelMatrix;
@@ -140,7 +152,7 @@ namespace XREX
 			TechniqueBuildingInformationSP techniqueInformation = MakeSP<TechniqueBuildingInformation>("XREX_Uniform_CameraTransformation");
 			techniqueInformation->AddCommonCode(MakeSP<std::string>(std::move(code)));
 
-			std::vector<VariableInformation const> cameraVariables;
+			std::vector<VariableInformation> cameraVariables;
 			cameraVariables.push_back(VariableInformation("ViewFromWorld", ElementType::FloatM44, 0));
 			cameraVariables.push_back(VariableInformation("ClipFromView", ElementType::FloatM44, 0));
 			cameraVariables.push_back(VariableInformation("ClipFromWorld", ElementType::FloatM44, 0));
@@ -161,9 +173,9 @@ namespace XREX
 		if (cameraParameter_ != nullptr)
 		{
 			parameterBuffer_ = cameraParameter_->As<ShaderResourceBufferSP>().GetValue();
-			GraphicsBufferSP buffer = XREXContext::GetInstance().GetRenderingFactory().CreateGraphicsBufferWithBufferInformation(
+			fallbackBuffer_ = XREXContext::GetInstance().GetRenderingFactory().CreateGraphicsBufferWithBufferInformation(
 				GraphicsBuffer::Usage::DynamicDraw, parameterBuffer_->GetBufferInformation());
-			parameterBuffer_->SetBuffer(buffer);
+			parameterBuffer_->SetBuffer(fallbackBuffer_);
 
 			auto viewFromeWorldResult = parameterBuffer_->GetSetter("XREX_Uniform_CameraTransformation.ViewFromWorld");
 			assert(viewFromeWorldResult.first);
@@ -187,7 +199,7 @@ namespace XREX
 			floatM44 viewMatrix = component->GetViewMatrix();
 			floatM44 projectionMatrix = component->GetProjectionMatrix();
 
-			ShaderResourceBuffer::BufferMapper mapper = parameterBuffer_->GetMapper();
+			GraphicsBuffer::BufferMapper mapper = XREXContext::GetInstance().GetRenderingEngine().GetUniformRingBuffer().MapSlice(*parameterBuffer_, fallbackBuffer_);
 			floatM44 clipFromWorld = projectionMatrix * viewMatrix;
 
 			viewFromeWorld_.SetValue(mapper, viewMatrix);
@@ -198,4 +210,56 @@ namespace XREX
 		}
 	}
 
+
+
+
+	TechniqueBuildingInformationSP const& InstanceTransformationTechniqueFactory::GetTechniqueInformationToInclude() const
+	{
+		static TechniqueBuildingInformationSP const Builder = []
+		{
+			std::string const& channel = GetUniformString(DefinedUniform::InstanceTransformation);
+			std::string code =
+				"\n"
+				"uniform " + channel + "\n"
+				"{\n"
+				"	mat4 WorldFromModel[" + std::to_string(static_cast<uint64>(MaxInstanceCount)) + "];\n"
+				"} XREX_InstanceTransformation;\n"
+				"\n"
+				;
+			TechniqueBuildingInformationSP techniqueInformation = MakeSP<TechniqueBuildingInformation>(channel);
+			techniqueInformation->AddCommonCode(MakeSP<std::string>(std::move(code)));
+
+			std::vector<VariableInformation> instanceVariables;
+			instanceVariables.push_back(VariableInformation("WorldFromModel", ElementType::FloatM44, MaxInstanceCount));
+			techniqueInformation->AddUniformBufferInformation(BufferInformation(
+				channel, "XREX_InstanceTransformation", BufferView::BufferType::Uniform, std::move(instanceVariables)));
+
+			return techniqueInformation;
+		} ();
+		return Builder;
+	}
+
+
+
+
+	TechniqueBuildingInformationSP const& DrawParametersTechniqueFactory::GetTechniqueInformationToInclude() const
+	{
+		static TechniqueBuildingInformationSP const Builder = []
+		{
+			// shader storage buffers are not reflected by ProgramObject yet, IndirectDrawer binds it to a fixed binding index.
+			std::string code =
+				"\n"
+				"layout(std430, binding = " + std::to_string(static_cast<uint64>(IndirectDrawer::DrawParameterBindingIndex)) + ") readonly buffer XREX_DrawParameterBuffer\n"
+				"{\n"
+				"	mat4 WorldFromModel[];\n"
+				"} XREX_DrawParameters;\n"
+				"\n"
+				;
+			TechniqueBuildingInformationSP techniqueInformation = MakeSP<TechniqueBuildingInformation>("XREX_DrawParameters");
+			techniqueInformation->AddCommonCode(MakeSP<std::string>(std::move(code)));
+			return techniqueInformation;
+		} ();
+		return Builder;
+	}
+
 }
@@ -28,9 +28,7 @@ namespace XREX
 
 	struct XREX_API IComponentParameterSetter
 	{
-		virtual ~IComponentParameterSetter() = 0
-		{
-		};
+		virtual ~IComponentParameterSetter() = 0;
 	};
 
 	struct XREX_API ComponentParameterSetterBase
@@ -62,9 +60,7 @@ namespace XREX
 
 	struct XREX_API ISystemTechniqueFactory
 	{
-		virtual ~ISystemTechniqueFactory() = 0
-		{
-		}
+		virtual ~ISystemTechniqueFactory() = 0;
 		virtual std::string const& GetIndexName() const = 0;
 		/*
 		 *	Notice: Every call should return the same instance.
@@ -110,6 +106,10 @@ namespace XREX
 		CameraSP camera_;
 		TechniqueParameterSP modelParameter_;
 		ShaderResourceBufferSP parameterBuffer_;
+		/*
+		 *	Used when the uniform ring buffer of this frame is full.
+		 */
+		GraphicsBufferSP fallbackBuffer_;
 
 		ShaderResourceBuffer::VariableSetter worldFromModel_;
 		ShaderResourceBuffer::VariableSetter worldFromModelNormal_;
@@ -141,11 +141,54 @@ namespace XREX
 	private:
 		TechniqueParameterSP cameraParameter_;
 		ShaderResourceBufferSP parameterBuffer_;
+		/*
+		 *	Used when the uniform ring buffer of this frame is full.
+		 */
+		GraphicsBufferSP fallbackBuffer_;
 
 		ShaderResourceBuffer::VariableSetter viewFromeWorld_;
 		ShaderResourceBuffer::VariableSetter clipFromView_;
 		ShaderResourceBuffer::VariableSetter clipFromWorld_;
 		ShaderResourceBuffer::VariableSetter cameraPositionInWorld_;
 	};
+
+
+
+
+	/*
+	 *	World matrices of instances drawn by one instanced draw, filled by DefaultRenderingProcess.
+	 *	Vertex shaders get the matrix of current instance by XREX_InstanceTransformation.WorldFromModel[gl_InstanceID].
+	 *	Techniques without it are drawn one pack a draw with modelMatrix uniform.
+	 */
+	struct XREX_API InstanceTransformationTechniqueFactory
+		: ISystemTechniqueFactory
+	{
+		static uint32 const MaxInstanceCount = 64;
+
+		virtual std::string const& GetIndexName() const override
+		{
+			static std::string const IndexName = "InstanceTransformation";
+			return IndexName;
+		}
+		virtual TechniqueBuildingInformationSP const& GetTechniqueInformationToInclude() const override;
+	};
+
+
+
+
+	/*
+	 *	Per draw data of IndirectDrawer, vertex shaders get the matrix of current draw by XREX_DrawParameters.WorldFromModel[XREX_DrawID].
+	 *	DefaultRenderingProcess draws packs of techniques including it by multi draws, see SetIndirectDrawingEnabled.
+	 */
+	struct XREX_API DrawParametersTechniqueFactory
+		: ISystemTechniqueFactory
+	{
+		virtual std::string const& GetIndexName() const override
+		{
+			static std::string const IndexName = "DrawParameters";
+			return IndexName;
+		}
+		virtual TechniqueBuildingInformationSP const& GetTechniqueInformationToInclude() const override;
+	};
 }
 
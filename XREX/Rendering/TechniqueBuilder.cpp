@@ -25,10 +25,10 @@ namespace XREX
 
 	namespace
 	{
-		template <typename Information, std::vector<Information const> const&(TechniqueBuildingInformation::*Getter)() const>
-		std::vector<Information const> CollectInformation(std::vector<TechniqueBuildingInformation const*> const& includes)
+		template <typename Information, std::vector<Information> const&(TechniqueBuildingInformation::*Getter)() const>
+		std::vector<Information> CollectInformation(std::vector<TechniqueBuildingInformation const*> const& includes)
 		{
-			std::vector<Information const> informations;
+			std::vector<Information> informations;
 			for (auto builder : includes)
 			{
 				for (Information const& information : XREX_POINTER_CALL_MEMBER_FUNCTION(builder, Getter)())
@@ -41,7 +41,7 @@ namespace XREX
 		/*
 		 *	Check there is nothing in includes.
 		 */
-		template <typename Information, std::vector<Information const> const&(TechniqueBuildingInformation::*Getter)() const>
+		template <typename Information, std::vector<Information> const&(TechniqueBuildingInformation::*Getter)() const>
 		bool CheckNoInclude(TechniqueBuildingInformationSP const& rootInformation, std::vector<TechniqueBuildingInformation const*> const& includes)
 		{
 			for (auto information : includes)
@@ -84,9 +84,9 @@ namespace XREX
 			return descriptions;
 		}
 
-		std::vector<FragmentOutputInformation const> GenerateFragmentOutputInformations(FrameBufferLayoutDescriptionSP const& framebufferDescription)
+		std::vector<FragmentOutputInformation> GenerateFragmentOutputInformations(FrameBufferLayoutDescriptionSP const& framebufferDescription)
 		{
-			std::vector<FragmentOutputInformation const> fragmentOutputs;
+			std::vector<FragmentOutputInformation> fragmentOutputs;
 			for (auto& channelDescription : framebufferDescription->GetAllChannels())
 			{
 				fragmentOutputs.push_back(FragmentOutputInformation(channelDescription.GetChannel(), Texture::TexelTypeFromTexelFormat(channelDescription.GetFormat())));
@@ -150,7 +150,7 @@ namespace XREX
 			succeed = false;
 		}
 
-		std::vector<FragmentOutputInformation const> fragmentOutputs;
+		std::vector<FragmentOutputInformation> fragmentOutputs;
 		std::vector<FrameBufferLayoutDescriptionSP> framebufferDescriptions = CollectFrameBufferDescription(includes);
 		if (framebufferDescriptions.size() > 1)
 		{
@@ -170,12 +170,12 @@ namespace XREX
 		{
 			assert(false); // impossible
 		}
-		std::vector<AttributeInputInformation const> const& attributes = techniqueInformation_->GetAllAttributeInputInformations();
-		std::vector<BufferInformation const> uniformBuffers = CollectInformation<BufferInformation, &TechniqueBuildingInformation::GetAllUniformBufferInformations>(includes);
-		std::vector<BufferInformation const> shaderStorageBuffers = CollectInformation<BufferInformation, &TechniqueBuildingInformation::GetAllShaderStorageBufferInformations>(includes);
-		std::vector<BufferInformation const> atomicCounterBuffers = CollectInformation<BufferInformation, &TechniqueBuildingInformation::GetAllAtomicCounterBufferInformations>(includes);
-		std::vector<TextureInformation const> textures = CollectInformation<TextureInformation, &TechniqueBuildingInformation::GetAllTextureInformations>(includes);
-		std::vector<ImageInformation const> images = CollectInformation<ImageInformation, &TechniqueBuildingInformation::GetAllImageInformations>(includes);
+		std::vector<AttributeInputInformation> const& attributes = techniqueInformation_->GetAllAttributeInputInformations();
+		std::vector<BufferInformation> uniformBuffers = CollectInformation<BufferInformation, &TechniqueBuildingInformation::GetAllUniformBufferInformations>(includes);
+		std::vector<BufferInformation> shaderStorageBuffers = CollectInformation<BufferInformation, &TechniqueBuildingInformation::GetAllShaderStorageBufferInformations>(includes);
+		std::vector<BufferInformation> atomicCounterBuffers = CollectInformation<BufferInformation, &TechniqueBuildingInformation::GetAllAtomicCounterBufferInformations>(includes);
+		std::vector<TextureInformation> textures = CollectInformation<TextureInformation, &TechniqueBuildingInformation::GetAllTextureInformations>(includes);
+		std::vector<ImageInformation> images = CollectInformation<ImageInformation, &TechniqueBuildingInformation::GetAllImageInformations>(includes);
 
 		bool linkResult = program->Link(ProgramObject::InformationPack(attributes, fragmentOutputs, uniformBuffers, shaderStorageBuffers, atomicCounterBuffers, textures, images));
 
@@ -99,7 +99,7 @@ namespace XREX
 			framebuffeDescription_ = std::move(framebufferDescription);
 		}
 
-		std::vector<AttributeInputInformation const> const& GetAllAttributeInputInformations() const
+		std::vector<AttributeInputInformation> const& GetAllAttributeInputInformations() const
 		{
 			return attributeInputInformations_;
 		}
@@ -107,12 +107,12 @@ namespace XREX
 		{
 			attributeInputInformations_.push_back(information);
 		}
-		std::vector<FragmentOutputInformation const> const& GetAllFragmentOutputInformations() const
+		std::vector<FragmentOutputInformation> const& GetAllFragmentOutputInformations() const
 		{
 			return fragmentOutputInformations_;
 		}
 
-		std::vector<BufferInformation const> const& GetAllUniformBufferInformations() const
+		std::vector<BufferInformation> const& GetAllUniformBufferInformations() const
 		{
 			return uniformBufferInformations_;
 		}
@@ -120,7 +120,7 @@ namespace XREX
 		{
 			uniformBufferInformations_.push_back(information);
 		}
-		std::vector<BufferInformation const> const& GetAllShaderStorageBufferInformations() const
+		std::vector<BufferInformation> const& GetAllShaderStorageBufferInformations() const
 		{
 			return shaderStorageBufferInformations_;
 		}
@@ -128,7 +128,7 @@ namespace XREX
 		{
 			shaderStorageBufferInformations_.push_back(information);
 		}
-		std::vector<BufferInformation const> const& GetAllAtomicCounterBufferInformations() const
+		std::vector<BufferInformation> const& GetAllAtomicCounterBufferInformations() const
 		{
 			return atomicCounterBufferInformations_;
 		}
@@ -136,7 +136,7 @@ namespace XREX
 		{
 			atomicCounterBufferInformations_.push_back(information);
 		}
-		std::vector<TextureInformation const> const& GetAllTextureInformations() const
+		std::vector<TextureInformation> const& GetAllTextureInformations() const
 		{
 			return textureInformations_;
 		}
@@ -144,7 +144,7 @@ namespace XREX
 		{
 			textureInformations_.push_back(information);
 		}
-		std::vector<ImageInformation const> const& GetAllImageInformations() const
+		std::vector<ImageInformation> const& GetAllImageInformations() const
 		{
 			return imageInformations_;
 		}
@@ -168,13 +168,13 @@ namespace XREX
 
 		FrameBufferLayoutDescriptionSP framebuffeDescription_;
 
-		std::vector<AttributeInputInformation const> attributeInputInformations_;
-		std::vector<FragmentOutputInformation const> fragmentOutputInformations_;
-		std::vector<BufferInformation const> uniformBufferInformations_;
-		std::vector<BufferInformation const> shaderStorageBufferInformations_;
-		std::vector<BufferInformation const> atomicCounterBufferInformations_;
-		std::vector<TextureInformation const> textureInformations_;
-		std::vector<ImageInformation const> imageInformations_;
+		std::vector<AttributeInputInformation> attributeInputInformations_;
+		std::vector<FragmentOutputInformation> fragmentOutputInformations_;
+		std::vector<BufferInformation> uniformBufferInformations_;
+		std::vector<BufferInformation> shaderStorageBufferInformations_;
+		std::vector<BufferInformation> atomicCounterBufferInformations_;
+		std::vector<TextureInformation> textureInformations_;
+		std::vector<ImageInformation> imageInformations_;
 		
 	};
 
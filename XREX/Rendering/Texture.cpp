@@ -5,8 +5,10 @@
 #include "Rendering/TextureImage.hpp"
 #include "Rendering/GraphicsBuffer.hpp"
 #include "Rendering/TextureImage.hpp"
+#include "Rendering/FrameStatistics.hpp"
 
 #include "Rendering/GL/GLUtil.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
 
 #include <CoreGL.hpp>
 
@@ -118,6 +120,16 @@ namespace XREX
 		case TexelFormat::Stencil8:
 			assert(false);
 			return TexelType::TexelTypeCount;
+		case TexelFormat::BC1:
+			return TexelType::FloatV3;
+		case TexelFormat::BC3:
+			return TexelType::FloatV4;
+		case TexelFormat::BC4:
+			return TexelType::FloatV1;
+		case TexelFormat::BC5:
+			return TexelType::FloatV2;
+		case TexelFormat::BC7:
+			return TexelType::FloatV4;
 		case TexelFormat::TexelFormatCount:
 			assert(false);
 			return TexelType::TexelTypeCount;
@@ -140,6 +152,10 @@ namespace XREX
 		if (glTextureID_ != 0)
 		{
 			gl::DeleteTextures(1, &glTextureID_);
+			if (GLStateCache* cache = GLStateCache::GetCurrent())
+			{
+				cache->OnTextureDeleted(glTextureID_);
+			}
 			glTextureID_ = 0;
 		}
 	}
@@ -147,14 +163,16 @@ namespace XREX
 	void Texture::Bind(uint32 index)
 	{
 		lastBindingIndex_ = index;
-		gl::ActiveTexture(gl::GL_TEXTURE0 + lastBindingIndex_);
-		gl::BindTexture(glBindingTarget_, glTextureID_);
+		GLStateCache::GetCurrent()->BindTexture(lastBindingIndex_, glBindingTarget_, glTextureID_);
+		if (FrameStatistics* statistics = FrameStatistics::GetCurrent())
+		{
+			++statistics->textureBindCount;
+		}
 	}
 
 	void Texture::Unbind()
 	{
-		gl::ActiveTexture(gl::GL_TEXTURE0 + lastBindingIndex_);
-		gl::BindTexture(glBindingTarget_, 0);
+		GLStateCache::GetCurrent()->BindTexture(lastBindingIndex_, glBindingTarget_, 0);
 	}
 
 	void Texture::RecreateMipmap()
@@ -171,28 +189,62 @@ namespace XREX
 
 
 	template <>
-	void DimensionalTexture<1>::DoFillTexture(DataDescription<1> const& description, uint32 mipmapLevel, void const* data)
+	void DimensionalTexture<1>::DoAllocateStorage(uint32 mipmapCount)
+	{
+		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description_.GetFormat());
+		gl::TexStorage1D(glBindingTarget_, mipmapCount, glFormat.glInternalFormat, description_.GetSize().X());
+	}
+	template <>
+	void DimensionalTexture<2>::DoAllocateStorage(uint32 mipmapCount)
+	{
+		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description_.GetFormat());
+		gl::TexStorage2D(glBindingTarget_, mipmapCount, glFormat.glInternalFormat, description_.GetSize().X(), description_.GetSize().Y());
+	}
+	template <>
+	void DimensionalTexture<3>::DoAllocateStorage(uint32 mipmapCount)
+	{
+		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description_.GetFormat());
+		gl::TexStorage3D(glBindingTarget_, mipmapCount, glFormat.glInternalFormat, description_.GetSize().X(), description_.GetSize().Y(), description_.GetSize().Z());
+	}
+
+	/*
+	 *	Block compressed data is uploaded as it is, storage is immutable so SubImage instead of CompressedTexImage.
+	 */
+	template <>
+	void DimensionalTexture<1>::DoFillTexture(uint32 mipmapLevel, void const* data)
 	{
-		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description.GetFormat());
-// 		gl::TexStorage1D(glBindingTarget_, mipmapLevel, glFormat.glInternalFormat, description.GetSize()[0]);
-// 		gl::TexSubImage1D(glBindingTarget_, mipmapLevel, 0, description.GetSize()[0], glFormat.glSourceFormat, glFormat.glTextureElementType, data);
-		gl::TexImage1D(glBindingTarget_, mipmapLevel, glFormat.glInternalFormat, description.GetSize().X(), 0, glFormat.glSourceFormat, glFormat.glTextureElementType, data);
+		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description_.GetFormat());
+		Size<uint32, 1> size = description_.GetMipmapSize(mipmapLevel);
+		if (IsBlockCompressedTexelFormat(description_.GetFormat()))
+		{
+			gl::CompressedTexSubImage1D(glBindingTarget_, mipmapLevel, 0, size.X(), glFormat.glInternalFormat, description_.GetMipmapSizeInBytes(mipmapLevel), data);
+			return;
+		}
+		gl::TexSubImage1D(glBindingTarget_, mipmapLevel, 0, size.X(), glFormat.glSourceFormat, glFormat.glTextureElementType, data);
 	}
 	template <>
-	void DimensionalTexture<2>::DoFillTexture(DataDescription<2> const& description, uint32 mipmapLevel, void const* data)
+	void DimensionalTexture<2>::DoFillTexture(uint32 mipmapLevel, void const* data)
 	{
-		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description.GetFormat());
-// 		gl::TexStorage2D(glBindingTarget_, mipmapLevel, glFormat.glInternalFormat, description.GetSize()[0], description.GetSize()[1]);
-// 		gl::TexSubImage2D(glBindingTarget_, mipmapLevel, 0, 0, description.GetSize()[0], description.GetSize()[1], glFormat.glSourceFormat, glFormat.glTextureElementType, data);
-		gl::TexImage2D(glBindingTarget_, mipmapLevel, glFormat.glInternalFormat, description.GetSize().X(), description.GetSize().Y(), 0, glFormat.glSourceFormat, glFormat.glTextureElementType, data);
+		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description_.GetFormat());
+		Size<uint32, 2> size = description_.GetMipmapSize(mipmapLevel);
+		if (IsBlockCompressedTexelFormat(description_.GetFormat()))
+		{
+			gl::CompressedTexSubImage2D(glBindingTarget_, mipmapLevel, 0, 0, size.X(), size.Y(), glFormat.glInternalFormat, description_.GetMipmapSizeInBytes(mipmapLevel), data);
+			return;
+		}
+		gl::TexSubImage2D(glBindingTarget_, mipmapLevel, 0, 0, size.X(), size.Y(), glFormat.glSourceFormat, glFormat.glTextureElementType, data);
 	}
 	template <>
-	void DimensionalTexture<3>::DoFillTexture(DataDescription<3> const& description, uint32 mipmapLevel, void const* data)
+	void DimensionalTexture<3>::DoFillTexture(uint32 mipmapLevel, void const* data)
 	{
-		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description.GetFormat());
-// 		gl::TexStorage3D(glBindingTarget_, mipmapLevel, glFormat.glInternalFormat, description.GetSize()[0], description.GetSize()[1], description.GetSize()[2]);
-// 		gl::TexSubImage3D(glBindingTarget_, mipmapLevel, 0, 0, 0, description.GetSize()[0], description.GetSize()[1], description.GetSize()[2], glFormat.glSourceFormat, glFormat.glTextureElementType, data);
-		gl::TexImage3D(glBindingTarget_, mipmapLevel, glFormat.glInternalFormat, description.GetSize().X(), description.GetSize().Y(), description.GetSize().Z(), 0, glFormat.glSourceFormat, glFormat.glTextureElementType, data);
+		GLTextureFormat const& glFormat = GLTextureFormatFromTexelFormat(description_.GetFormat());
+		Size<uint32, 3> size = description_.GetMipmapSize(mipmapLevel);
+		if (IsBlockCompressedTexelFormat(description_.GetFormat()))
+		{
+			gl::CompressedTexSubImage3D(glBindingTarget_, mipmapLevel, 0, 0, 0, size.X(), size.Y(), size.Z(), glFormat.glInternalFormat, description_.GetMipmapSizeInBytes(mipmapLevel), data);
+			return;
+		}
+		gl::TexSubImage3D(glBindingTarget_, mipmapLevel, 0, 0, 0, size.X(), size.Y(), size.Z(), glFormat.glSourceFormat, glFormat.glTextureElementType, data);
 	}
 
 
@@ -222,22 +274,13 @@ namespace XREX
 	DimensionalTexture<Dimension>::DimensionalTexture(DataDescription<Dimension> const& description, bool generateMipmap)
 		: Texture(TextureDimensionToTextureType<Dimension>::TextureType), description_(description)
 	{
+		assert(!generateMipmap || !IsBlockCompressedTexelFormat(description.GetFormat())); // GL does not generate compressed mipmap
 		Bind(0);
-		DoFillTexture(description, 0, nullptr);
-		mipmapCount_ = 1;
+		mipmapCount_ = generateMipmap ? description.GetFullMipmapCount() : 1;
+		DoAllocateStorage(mipmapCount_);
 
 		if (generateMipmap)
 		{
-			Size<uint32, Dimension> size = description.GetSize();
-			mipmapCount_ = 1;
-			while (*std::max_element(size.data.begin(), size.data.end()) > 1)
-			{
-				for (uint32 i = 0; i < Dimension; ++i)
-				{
-					size[i] = std::max(size[i] / 2, 1u);
-				}
-				++mipmapCount_;
-			}
 			RecreateMipmap();
 		}
 	}
@@ -247,46 +290,25 @@ namespace XREX
 		: Texture(TextureDimensionToTextureType<Dimension>::TextureType), description_(description)
 	{
 		assert(data.size() > 0);
+		assert(data.size() <= description.GetFullMipmapCount());
+		assert(!generateMipmap || !IsBlockCompressedTexelFormat(description.GetFormat())); // GL does not generate compressed mipmap
 		Bind(0);
 
+		mipmapCount_ = generateMipmap ? description.GetFullMipmapCount() : data.size();
+		DoAllocateStorage(mipmapCount_); // immutable, levels not given are never sampled
+
 		if (!generateMipmap)
 		{
-			DataDescription<Dimension> descriptionOfALevel = description;
-			Size<uint32, Dimension> size = description.GetSize();
 			for (uint32 mipmapLevel = 0; mipmapLevel < data.size(); ++mipmapLevel)
 			{
-				void const* dataOfALevel = data[mipmapLevel];
-				DoFillTexture(descriptionOfALevel, mipmapLevel, dataOfALevel);
-				for (uint32 i = 0; i < Dimension; ++i)
-				{
-					size[i] = std::max(size[i] / 2, 1u);
-				}
-				descriptionOfALevel = DataDescription<Dimension>(description.GetFormat(), size);
+				DoFillTexture(mipmapLevel, data[mipmapLevel]);
 			}
 		}
 		else
 		{
-			DoFillTexture(description, 0, data[0]);
-		}
-
-		if (generateMipmap)
-		{
-			Size<uint32, Dimension> size = description.GetSize();
-			mipmapCount_ = 1;
-			while (*std::max_element(size.data.begin(), size.data.end()) > 1)
-			{
-				for (uint32 i = 0; i < Dimension; ++i)
-				{
-					size[i] = std::max(size[i] / 2, 1u);
-				}
-				++mipmapCount_;
-			}
+			DoFillTexture(0, data[0]);
 			RecreateMipmap();
 		}
-		else
-		{
-			mipmapCount_ = data.size();
-		}
 	}
 
 
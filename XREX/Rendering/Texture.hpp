@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <array>
+#include <algorithm>
 
 namespace XREX
 {
@@ -68,6 +69,38 @@ namespace XREX
 				return size_;
 			}
 
+			/*
+			 *	Each level halves the size, but at least 1.
+			 */
+			Size<uint32, Dimension> GetMipmapSize(uint32 level) const
+			{
+				Size<uint32, Dimension> size = size_;
+				for (uint32 i = 0; i < Dimension; ++i)
+				{
+					size[i] = std::max(size[i] >> level, 1u);
+				}
+				return size;
+			}
+			/*
+			 *	Levels of a full mipmap chain, down to 1 texel.
+			 */
+			uint32 GetFullMipmapCount() const
+			{
+				uint32 count = 1;
+				uint32 largest = *std::max_element(size_.data.begin(), size_.data.end());
+				while (largest > 1)
+				{
+					largest /= 2;
+					++count;
+				}
+				return count;
+			}
+			uint32 GetMipmapSizeInBytes(uint32 level) const
+			{
+				Size<uint32, Dimension> size = GetMipmapSize(level);
+				return GetTexelDataSizeInBytes(format_, size[0], Dimension > 1 ? size[1] : 1, Dimension > 2 ? size[2] : 1);
+			}
+
 		private:
 			static_assert(Dimension <= 3, "Dimension must <= 3");
 			TexelFormat format_;
@@ -127,7 +160,9 @@ namespace XREX
 
 		DimensionalTexture(DataDescription<Dimension> const& description, bool generateMipmap);
 		/*
-		 *	@generateMipmap: true will generate mipmap, ignore data vector except data at index 0.
+		 *	Storage is immutable, allocated for data.size() levels, or full mipmap chain if generateMipmap.
+		 *	@data: tightly packed texels of each level, see DataDescription::GetMipmapSizeInBytes.
+		 *	@generateMipmap: true will generate mipmap, ignore data vector except data at index 0. Not for block compressed formats.
 		 */
 		DimensionalTexture(DataDescription<Dimension> const& description, std::vector<void const*> const& data, bool generateMipmap);
 
@@ -147,7 +182,8 @@ namespace XREX
 		}
 
 	private:
-		void DoFillTexture(DataDescription<Dimension> const& description, uint32 mipmapLevel, void const* data);
+		void DoAllocateStorage(uint32 mipmapCount);
+		void DoFillTexture(uint32 mipmapLevel, void const* data);
 
 	private:
 		DataDescription<Dimension> description_;
@@ -5,6 +5,7 @@
 #include "Rendering/Texture.hpp"
 
 #include "Rendering/GL/GLUtil.hpp"
+#include "Rendering/GL/GLStateCache.hpp"
 
 #include <CoreGL.hpp>
 
@@ -28,12 +29,12 @@ namespace XREX
 	void TextureImage::Bind(uint32 index, TexelFormat format, AccessType accessType)
 	{
 		lastBindingIndex_ = index;
-		gl::BindImageTexture(lastBindingIndex_, texture_->GetID(), level_, true, 0, GLAccessTypeFromAccessType(accessType), GLTextureFormatFromTexelFormat(format).glInternalFormat);
+		GLStateCache::GetCurrent()->BindImageTexture(lastBindingIndex_, texture_->GetID(), level_, true, 0, GLAccessTypeFromAccessType(accessType), GLTextureFormatFromTexelFormat(format).glInternalFormat);
 	}
 
 	void TextureImage::Unbind()
 	{
-		gl::BindImageTexture(lastBindingIndex_, 0, level_, true, 0, gl::GL_READ_WRITE, gl::GL_RGBA32F);
+		GLStateCache::GetCurrent()->BindImageTexture(lastBindingIndex_, 0, level_, true, 0, gl::GL_READ_WRITE, gl::GL_RGBA32F);
 	}
 
 
@@ -0,0 +1,111 @@
+#include "XREX.hpp"
+
+#include "UniformRingBuffer.hpp"
+
+#include "Rendering/GraphicsBuffer.hpp"
+#include "Rendering/ShaderProgram.hpp"
+#include "Rendering/RenderingEngine.hpp"
+#include "Base/XREXContext.hpp"
+#include "Base/Profiler.hpp"
+
+#include <CoreGL.hpp>
+
+namespace XREX
+{
+
+	namespace
+	{
+		/*
+		 *	1ms, BeginFrame keeps waiting until the fence is signaled.
+		 */
+		uint64 const FenceWaitTimeout = 1000000;
+	}
+
+
+
+	UniformRingBuffer::UniformRingBuffer(uint32 frameSizeInBytes, uint32 frameCount)
+		: frameSize_(frameSizeInBytes), fences_(frameCount, nullptr), currentFrame_(frameCount - 1), frameUsedSize_(0), inFrame_(false), waitCount_(0)
+	{
+		assert(frameSizeInBytes != 0 && frameCount != 0);
+		int32 alignment = 0;
+		gl::GetIntegerv(gl::GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		alignment_ = std::max(alignment, 1);
+		frameSize_ = (frameSize_ + alignment_ - 1) / alignment_ * alignment_; // so each segment starts aligned
+		buffer_ = MakeSP<GraphicsBuffer>(GraphicsBuffer::Usage::StreamDraw, frameSize_ * frameCount, BufferView::BufferType::Uniform);
+	}
+
+	UniformRingBuffer::~UniformRingBuffer()
+	{
+		for (void* fence : fences_)
+		{
+			if (fence != nullptr)
+			{
+				gl::DeleteSync(static_cast<GLsync>(fence));
+			}
+		}
+	}
+
+	void UniformRingBuffer::BeginFrame()
+	{
+		assert(!inFrame_);
+		currentFrame_ = (currentFrame_ + 1) % fences_.size();
+		if (fences_[currentFrame_] != nullptr)
+		{
+			GLsync fence = static_cast<GLsync>(fences_[currentFrame_]);
+			uint32 result = gl::ClientWaitSync(fence, 0, 0);
+			if (result == gl::GL_TIMEOUT_EXPIRED)
+			{
+				++waitCount_;
+				ProfileScope scope(XREXContext::GetInstance().GetRenderingEngine().GetProfiler(), "WaitUniformRingBuffer");
+				do
+				{
+					result = gl::ClientWaitSync(fence, gl::GL_SYNC_FLUSH_COMMANDS_BIT, FenceWaitTimeout);
+				} while (result == gl::GL_TIMEOUT_EXPIRED);
+			}
+			assert(result != gl::GL_WAIT_FAILED);
+			gl::DeleteSync(fence);
+			fences_[currentFrame_] = nullptr;
+		}
+		frameUsedSize_ = 0;
+		inFrame_ = true;
+	}
+
+	void UniformRingBuffer::EndFrame()
+	{
+		assert(inFrame_);
+		assert(fences_[currentFrame_] == nullptr);
+		if (frameUsedSize_ != 0)
+		{
+			fences_[currentFrame_] = gl::FenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+		inFrame_ = false;
+	}
+
+	std::pair<bool, uint32> UniformRingBuffer::Allocate(uint32 sizeInBytes)
+	{
+		assert(sizeInBytes != 0);
+		uint32 alignedSize = (sizeInBytes + alignment_ - 1) / alignment_ * alignment_;
+		if (!inFrame_ || frameUsedSize_ + alignedSize > frameSize_)
+		{
+			return std::make_pair(false, 0u);
+		}
+		uint32 offset = currentFrame_ * frameSize_ + frameUsedSize_;
+		frameUsedSize_ += alignedSize;
+		return std::make_pair(true, offset);
+	}
+
+	GraphicsBuffer::BufferMapper UniformRingBuffer::MapSlice(ShaderResourceBuffer& buffer, GraphicsBufferSP const& fallbackBuffer)
+	{
+		uint32 size = buffer.GetBufferInformation().GetDataSize();
+		std::pair<bool, uint32> slice = Allocate(size);
+		if (slice.first)
+		{
+			buffer.SetBufferRange(buffer_, slice.second, size);
+			return buffer_->GetUnsynchronizedMapper(slice.second, size);
+		}
+		assert(fallbackBuffer != nullptr);
+		buffer.SetBuffer(fallbackBuffer);
+		return fallbackBuffer->GetMapper(AccessType::WriteOnly);
+	}
+
+}
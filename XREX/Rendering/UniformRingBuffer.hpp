@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Rendering/GraphicsBuffer.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Frame scoped sub-allocator of one uniform GraphicsBuffer, for uniform data rewritten every frame.
+	 *	The buffer is split into a segment per frame in flight. Slices of the current segment are written unsynchronized
+	 *	and bound by range, so writing the data of an object never waits for GPU to finish the draw of the previous one.
+	 *	A fence is placed at the end of each frame, a segment is reused only after GPU passed its fence.
+	 *	Owned by RenderingEngine, only used on the rendering thread.
+	 */
+	class XREX_API UniformRingBuffer
+		: Noncopyable
+	{
+	public:
+		static uint32 const DefaultFrameSizeInBytes = 4 * 1024 * 1024;
+		static uint32 const DefaultFrameCount = 3;
+
+	public:
+		UniformRingBuffer(uint32 frameSizeInBytes, uint32 frameCount);
+		~UniformRingBuffer();
+
+		/*
+		 *	Start using the next segment, wait if GPU is still reading it.
+		 */
+		void BeginFrame();
+		/*
+		 *	Place the fence protecting the segment used by this frame.
+		 */
+		void EndFrame();
+
+		/*
+		 *	Offset is aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+		 *	@return: first: false if called outside a frame or the segment of this frame has no space left. second: offset in GetBuffer().
+		 */
+		std::pair<bool, uint32> Allocate(uint32 sizeInBytes);
+		/*
+		 *	Point buffer to a new slice and map the slice,
+		 *	or to fallbackBuffer and map it if there is no space left in this frame.
+		 */
+		GraphicsBuffer::BufferMapper MapSlice(ShaderResourceBuffer& buffer, GraphicsBufferSP const& fallbackBuffer);
+
+		GraphicsBufferSP const& GetBuffer() const
+		{
+			return buffer_;
+		}
+
+		/*
+		 *	Bytes allocated by the current frame, including alignment.
+		 */
+		uint32 GetFrameUsedSize() const
+		{
+			return frameUsedSize_;
+		}
+		/*
+		 *	How many times BeginFrame had to wait for GPU.
+		 */
+		uint32 GetWaitCount() const
+		{
+			return waitCount_;
+		}
+
+	private:
+		GraphicsBufferSP buffer_;
+		uint32 frameSize_;
+		uint32 alignment_;
+		/*
+		 *	GLsync of each segment, nullptr if not fenced.
+		 */
+		std::vector<void*> fences_;
+		uint32 currentFrame_;
+		uint32 frameUsedSize_;
+		bool inFrame_;
+		uint32 waitCount_;
+	};
+
+}
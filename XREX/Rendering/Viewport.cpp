@@ -2,6 +2,8 @@
 
 #include "Viewport.hpp"
 
+#include "Rendering/GL/GLStateCache.hpp"
+
 #include <CoreGL.hpp>
 
 namespace XREX
@@ -23,20 +25,22 @@ namespace XREX
 	{
 	}
 
-	void Viewport::Bind(Size<uint32, 2> const& windowSize)
+	void Viewport::Bind(Size<uint32, 2> const& windowSize) const
 	{
 		if (absolute_)
 		{
-			DataUnion::Absolute& absolute = data_.absolute;
-			gl::Viewport(absolute.left, absolute.bottom, absolute.width, absolute.height);
-			gl::Scissor(absolute.left, absolute.bottom, absolute.width, absolute.height);
+			DataUnion::Absolute const& absolute = data_.absolute;
+			GLStateCache& cache = *GLStateCache::GetCurrent();
+			cache.Viewport(absolute.left, absolute.bottom, absolute.width, absolute.height);
+			cache.Scissor(absolute.left, absolute.bottom, absolute.width, absolute.height);
 		}
 		else
 		{
-			DataUnion::Relative& relative = data_.relative;
-			gl::Viewport(static_cast<int32>(relative.left * windowSize.X()), static_cast<int32>(relative.bottom * windowSize.Y()),
+			DataUnion::Relative const& relative = data_.relative;
+			GLStateCache& cache = *GLStateCache::GetCurrent();
+			cache.Viewport(static_cast<int32>(relative.left * windowSize.X()), static_cast<int32>(relative.bottom * windowSize.Y()),
 				static_cast<uint32>(relative.width * windowSize.X()), static_cast<uint32>(relative.height * windowSize.Y()));
-			gl::Scissor(static_cast<int32>(relative.left * windowSize.X()), static_cast<int32>(relative.bottom * windowSize.Y()),
+			cache.Scissor(static_cast<int32>(relative.left * windowSize.X()), static_cast<int32>(relative.bottom * windowSize.Y()),
 				static_cast<uint32>(relative.width * windowSize.X()), static_cast<uint32>(relative.height * windowSize.Y()));
 		}
 	}
@@ -5,8 +5,10 @@
 
 namespace XREX
 {
+	/*
+	 *	Copyable, FrameSnapshot keeps a copy of the viewport of each camera by value.
+	 */
 	class XREX_API Viewport
-		: Noncopyable
 	{
 	public:
 		/*
@@ -49,7 +51,7 @@ namespace XREX
 		/*
 		 *	If viewport is absolute mode, parameter is ignored.
 		 */
-		void Bind(Size<uint32, 2> const& windowSize);
+		void Bind(Size<uint32, 2> const& windowSize) const;
 
 	private:
 
@@ -2,10 +2,14 @@
 
 #include "WorkLauncher.hpp"
 
+#include "Base/XREXContext.hpp"
+#include "Rendering/RenderingFactory.hpp"
 #include "Rendering/RenderingLayout.hpp"
+#include "Rendering/GraphicsBuffer.hpp"
 #include "Rendering/ShaderProgram.hpp"
 #include "Rendering/ProgramConnector.hpp"
 #include "Rendering/RenderingTechnique.hpp"
+#include "Rendering/FrameStatistics.hpp"
 #include "Rendering/GL/GLUtil.hpp"
 
 #include <CoreGL.hpp>
@@ -13,6 +17,25 @@
 
 namespace XREX
 {
+	namespace
+	{
+		/*
+		 *	Make buffer sizeInBytes large, previous content is discarded.
+		 *	Existing storage is always orphaned, so writing does not wait for draws still reading it.
+		 */
+		void PrepareBuffer(GraphicsBufferSP& buffer, uint32 sizeInBytes, BufferView::BufferType type)
+		{
+			if (buffer == nullptr)
+			{
+				buffer = MakeSP<GraphicsBuffer>(GraphicsBuffer::Usage::StreamDraw, sizeInBytes, type);
+			}
+			else
+			{
+				buffer->Resize(sizeInBytes);
+			}
+		}
+	}
+
 	IWorkLauncher::~IWorkLauncher()
 	{
 	}
@@ -25,15 +48,120 @@ namespace XREX
 		technique_->Use();
 		layoutConnector_->Bind();
 		CoreLaunch();
-		layoutConnector_->Unbind();
+		// vertex array is left bound, so the next draw with the same connector does not bind it again.
 	}
 
 	void IndexedDrawer::CoreLaunch()
 	{
 		assert(layout_ != nullptr);
 		assert(layout_->GetIndexBuffer() != nullptr);
-		gl::DrawElements(GLDrawModeFromTopologicalType(layout_->GetIndexBuffer()->GetTopologicalType()),
-			layout_->GetElementCount(),  GLTypeFromElementType(layout_->GetIndexElementType()), reinterpret_cast<void const*>(0));
+		// layouts in shared buffers start at first index and base vertex, both are 0 otherwise.
+		void const* indexOffset = reinterpret_cast<void const*>(layout_->GetFirstIndex() * GetElementSizeInBytes(layout_->GetIndexElementType()));
+		if (instanceCount_ == 1)
+		{
+			gl::DrawElementsBaseVertex(GLDrawModeFromTopologicalType(layout_->GetIndexBuffer()->GetTopologicalType()),
+				layout_->GetElementCount(),  GLTypeFromElementType(layout_->GetIndexElementType()), indexOffset, layout_->GetBaseVertex());
+		}
+		else
+		{
+			gl::DrawElementsInstancedBaseVertex(GLDrawModeFromTopologicalType(layout_->GetIndexBuffer()->GetTopologicalType()),
+				layout_->GetElementCount(), GLTypeFromElementType(layout_->GetIndexElementType()), indexOffset, instanceCount_, layout_->GetBaseVertex());
+		}
+		if (FrameStatistics* statistics = FrameStatistics::GetCurrent())
+		{
+			statistics->AddDraw(*layout_->GetIndexBuffer(), layout_->GetElementCount(), instanceCount_);
+		}
+	}
+
+
+
+	void IndirectDrawer::AddDraw(uint32 firstIndex, uint32 indexCount, int32 baseVertex, floatM44 const& worldFromModel)
+	{
+		DrawElementsIndirectCommand command;
+		command.count = indexCount;
+		command.instanceCount = 1;
+		command.firstIndex = firstIndex;
+		command.baseVertex = baseVertex;
+		command.baseInstance = 0;
+		commands_.push_back(command);
+		drawParameters_.push_back(worldFromModel);
+	}
+
+	void IndirectDrawer::AddDraw(RenderingLayout const& layout, floatM44 const& worldFromModel)
+	{
+		assert(layout_ != nullptr && layout_->SharesBuffersWith(layout));
+		AddDraw(layout.GetFirstIndex(), layout.GetElementCount(), layout.GetBaseVertex(), worldFromModel);
+	}
+
+	void IndirectDrawer::ClearDraws()
+	{
+		commands_.clear();
+		drawParameters_.clear();
+	}
+
+	void IndirectDrawer::Launch()
+	{
+		assert(layout_ != nullptr && layout_->GetIndexBuffer() != nullptr);
+		assert(layoutConnector_ != nullptr);
+		assert(technique_ != nullptr);
+		if (commands_.empty())
+		{
+			return;
+		}
+		technique_->Use();
+		layoutConnector_->Bind();
+		CoreLaunch(*layout_, commands_.data(), drawParameters_.data(), commands_.size());
+	}
+
+	void IndirectDrawer::CoreLaunch(RenderingLayout const& layout, DrawElementsIndirectCommand const* commands, floatM44 const* drawParameters, uint32 drawCount)
+	{
+		assert(layout.GetIndexBuffer() != nullptr);
+		if (drawCount == 0)
+		{
+			return;
+		}
+		uint32 glMode = GLDrawModeFromTopologicalType(layout.GetIndexBuffer()->GetTopologicalType());
+		uint32 glIndexType = GLTypeFromElementType(layout.GetIndexElementType());
+		if (XREXContext::GetInstance().GetRenderingFactory().IsDrawIDSupported())
+		{
+			uint32 parameterSize = drawCount * sizeof(floatM44);
+			PrepareBuffer(drawParameterBuffer_, parameterSize, BufferView::BufferType::ShaderStorage);
+			drawParameterBuffer_->UpdateData(drawParameters);
+			drawParameterBuffer_->BindIndex(BufferView::BufferType::ShaderStorage, DrawParameterBindingIndex);
+
+			PrepareBuffer(commandBuffer_, drawCount * sizeof(DrawElementsIndirectCommand), BufferView::BufferType::DrawIndirect);
+			commandBuffer_->UpdateData(commands);
+			commandBuffer_->Bind(BufferView::BufferType::DrawIndirect);
+			gl::MultiDrawElementsIndirect(glMode, glIndexType, nullptr, drawCount, sizeof(DrawElementsIndirectCommand));
+		}
+		else
+		{ // XREX_DrawID is always 0, bind parameters of each draw as a range instead.
+			int32 alignment = 0;
+			gl::GetIntegerv(gl::GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			uint32 stride = (sizeof(floatM44) + alignment - 1) / alignment * alignment;
+			alignedDrawParameters_.resize(drawCount * stride);
+			for (uint32 i = 0; i < drawCount; ++i)
+			{
+				*reinterpret_cast<floatM44*>(&alignedDrawParameters_[i * stride]) = drawParameters[i];
+			}
+			PrepareBuffer(drawParameterBuffer_, alignedDrawParameters_.size(), BufferView::BufferType::ShaderStorage);
+			drawParameterBuffer_->UpdateData(alignedDrawParameters_.data());
+
+			uint32 indexSize = GetElementSizeInBytes(layout.GetIndexElementType());
+			for (uint32 i = 0; i < drawCount; ++i)
+			{
+				DrawElementsIndirectCommand const& command = commands[i];
+				drawParameterBuffer_->BindIndexRange(BufferView::BufferType::ShaderStorage, DrawParameterBindingIndex, i * stride, sizeof(floatM44));
+				gl::DrawElementsBaseVertex(glMode, command.count, glIndexType, reinterpret_cast<void const*>(command.firstIndex * indexSize), command.baseVertex);
+			}
+		}
+		if (FrameStatistics* statistics = FrameStatistics::GetCurrent())
+		{
+			for (uint32 i = 0; i < drawCount; ++i)
+			{
+				statistics->AddDraw(*layout.GetIndexBuffer(), commands[i].count, commands[i].instanceCount);
+			}
+		}
 	}
 
 }
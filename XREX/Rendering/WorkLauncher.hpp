@@ -2,6 +2,8 @@
 
 #include "Declare.hpp"
 
+#include <vector>
+
 namespace XREX
 {
 	struct XREX_API IWorkLauncher
@@ -16,6 +18,11 @@ namespace XREX
 		: public IWorkLauncher, Noncopyable
 	{
 	public:
+		IndexedDrawer()
+			: instanceCount_(1)
+		{
+		}
+
 		void SetRenderingLayout(RenderingLayoutSP const& layout)
 		{
 			layout_ = layout;
@@ -36,6 +43,14 @@ namespace XREX
 		{
 			technique_ = technique;
 		}
+		/*
+		 *	Draw the layout instanceCount times in one draw, default 1.
+		 */
+		void SetInstanceCount(uint32 instanceCount)
+		{
+			assert(instanceCount != 0);
+			instanceCount_ = instanceCount;
+		}
 
 		virtual void Launch() override;
 
@@ -49,6 +64,90 @@ namespace XREX
 		LayoutAndProgramConnectorSP layoutConnector_;
 		FrameBufferSP frameBuffer_;
 		RenderingTechniqueSP technique_;
+		uint32 instanceCount_;
+	};
+
+
+	/*
+	 *	Draws many ranges of the buffers of one RenderingLayout with one glMultiDrawElementsIndirect.
+	 *	Each draw has its own world matrix, vertex shaders read it by XREX_DrawParameters.WorldFromModel[XREX_DrawID],
+	 *	declared by DrawParameters system technique.
+	 *	Without draw id support each draw is issued by its own call, with the matrix bound as a range, so shaders work the same.
+	 */
+	class XREX_API IndirectDrawer
+		: public IWorkLauncher, Noncopyable
+	{
+	public:
+		/*
+		 *	Layout required by glMultiDrawElementsIndirect.
+		 */
+		struct DrawElementsIndirectCommand
+		{
+			uint32 count;
+			uint32 instanceCount;
+			uint32 firstIndex;
+			int32 baseVertex;
+			uint32 baseInstance;
+		};
+
+		/*
+		 *	Shader storage binding index of XREX_DrawParameters.
+		 */
+		static uint32 const DrawParameterBindingIndex = 0;
+
+	public:
+		/*
+		 *	All draws use the vertex and index buffers of the layout.
+		 */
+		void SetRenderingLayout(RenderingLayoutSP const& layout)
+		{
+			layout_ = layout;
+		}
+		void SetLayoutAndProgramConnector(LayoutAndProgramConnectorSP const& connector)
+		{
+			layoutConnector_ = connector;
+		}
+		void SetTechnique(RenderingTechniqueSP const& technique)
+		{
+			technique_ = technique;
+		}
+
+		/*
+		 *	@firstIndex, indexCount: range in the index buffer of the layout.
+		 *	@baseVertex: added to each index.
+		 */
+		void AddDraw(uint32 firstIndex, uint32 indexCount, int32 baseVertex, floatM44 const& worldFromModel);
+		/*
+		 *	Draw all of a layout sharing buffers with the layout set, e.g. created with the buffer arena of RenderingFactory.
+		 */
+		void AddDraw(RenderingLayout const& layout, floatM44 const& worldFromModel);
+		void ClearDraws();
+		uint32 GetDrawCount() const
+		{
+			return commands_.size();
+		}
+
+		virtual void Launch() override;
+
+		/*
+		 *	Draw the given draws instead of the ones added, with the technique and a connector of a layout sharing buffers with layout in use.
+		 *	Buffers of the draws are kept by the drawer, used by GLCommandExecutor.
+		 */
+		void CoreLaunch(RenderingLayout const& layout, DrawElementsIndirectCommand const* commands, floatM44 const* drawParameters, uint32 drawCount);
+
+	private:
+		RenderingLayoutSP layout_;
+		LayoutAndProgramConnectorSP layoutConnector_;
+		RenderingTechniqueSP technique_;
+
+		std::vector<DrawElementsIndirectCommand> commands_;
+		std::vector<floatM44> drawParameters_;
+		/*
+		 *	Used when draw id is not supported, parameters aligned for binding by range.
+		 */
+		std::vector<uint8> alignedDrawParameters_;
+		GraphicsBufferSP commandBuffer_;
+		GraphicsBufferSP drawParameterBuffer_;
 	};
 
 }
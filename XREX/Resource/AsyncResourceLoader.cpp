@@ -0,0 +1,338 @@
+#include "XREX.hpp"
+
+#include "AsyncResourceLoader.hpp"
+
+#include "Base/Timer.hpp"
+
+#include <algorithm>
+
+namespace XREX
+{
+
+	AsyncLoadingResultBase::AsyncLoadingResultBase(State state, int32 priority)
+		: state_(state), priority_(priority)
+	{
+	}
+
+	AsyncLoadingResultBase::~AsyncLoadingResultBase()
+	{
+	}
+
+	AsyncLoadingResultBase::State AsyncLoadingResultBase::GetState() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return state_;
+	}
+
+	bool AsyncLoadingResultBase::IsFinished() const
+	{
+		State state = GetState();
+		return state == State::Created || state == State::Failed || state == State::Cancelled;
+	}
+
+	void AsyncLoadingResultBase::RaisePriority(int32 priority)
+	{
+		int32 current = priority_;
+		while (current < priority && !priority_.compare_exchange_weak(current, priority))
+		{
+		}
+	}
+
+	bool AsyncLoadingResultBase::Cancel()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		switch (state_)
+		{
+		case State::Queued:
+		case State::Decoded:
+			state_ = State::Cancelled;
+			DoRelease();
+			break;
+		case State::Decoding:
+			state_ = State::Cancelled; // data is released when decoding finishes
+			break;
+		case State::Cancelled:
+			return true;
+		default:
+			return false;
+		}
+		stateChanged_.notify_all();
+		return true;
+	}
+
+	void AsyncLoadingResultBase::Wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		stateChanged_.wait(lock, [this] ()
+		{
+			return state_ != State::Queued && state_ != State::Decoding;
+		});
+	}
+
+	void AsyncLoadingResultBase::AddDependency(std::shared_ptr<AsyncLoadingResultBase> const& dependency)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		dependencies_.push_back(dependency);
+	}
+
+	bool AsyncLoadingResultBase::Finish()
+	{
+		if (BeginDecoding())
+		{
+			Decode(); // no loading thread started it, do not wait for one
+		}
+		else
+		{
+			Wait();
+		}
+		return Create();
+	}
+
+	bool AsyncLoadingResultBase::BeginDecoding()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (state_ != State::Queued)
+		{
+			return false;
+		}
+		state_ = State::Decoding;
+		return true;
+	}
+
+	bool AsyncLoadingResultBase::Decode()
+	{
+		bool decoded = DoDecode();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (state_ == State::Cancelled)
+			{
+				decoded = false;
+			}
+			else
+			{
+				assert(state_ == State::Decoding);
+				state_ = decoded ? State::Decoded : State::Failed;
+			}
+			if (!decoded)
+			{
+				DoRelease();
+			}
+		}
+		stateChanged_.notify_all();
+		return decoded;
+	}
+
+	bool AsyncLoadingResultBase::Create()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (state_ != State::Decoded)
+			{
+				return state_ == State::Created;
+			}
+			state_ = State::Creating; // can not be cancelled from now on
+		}
+		DoCreate();
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			state_ = State::Created;
+			dependencies_.clear();
+		}
+		stateChanged_.notify_all();
+		return true;
+	}
+
+	bool AsyncLoadingResultBase::AreDependenciesFinished() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return std::all_of(dependencies_.begin(), dependencies_.end(), [] (AsyncLoadingResultBaseSP const& dependency)
+		{
+			return dependency->IsFinished();
+		});
+	}
+
+
+
+	namespace
+	{
+		/*
+		 *	Highest priority, the earliest one among equal priorities.
+		 *	@return: end if no one satisfies condition.
+		 */
+		template <typename Condition>
+		std::vector<AsyncLoadingResultBaseSP>::iterator FindNext(std::vector<AsyncLoadingResultBaseSP>& queue, Condition const& condition)
+		{
+			auto next = queue.end();
+			for (auto i = queue.begin(); i != queue.end(); ++i)
+			{
+				if ((next == queue.end() || (*i)->GetPriority() > (*next)->GetPriority()) && condition(**i))
+				{
+					next = i;
+				}
+			}
+			return next;
+		}
+
+		/*
+		 *	Results cancelled, or finished on the context thread by AsyncLoadingResult::Create, are not scheduled any more.
+		 */
+		void RemoveAbandoned(std::vector<AsyncLoadingResultBaseSP>& queue, AsyncLoadingResultBase::State expectedState)
+		{
+			queue.erase(std::remove_if(queue.begin(), queue.end(), [expectedState] (AsyncLoadingResultBaseSP const& result)
+			{
+				return result->GetState() != expectedState;
+			}), queue.end());
+		}
+	}
+
+
+	AsyncResourceLoader::AsyncResourceLoader(uint32 threadCount)
+		: decodingCount_(0), running_(true)
+	{
+		threadCount = std::max(threadCount, 1u);
+		for (uint32 i = 0; i < threadCount; ++i)
+		{
+			threads_.push_back(std::thread([this] ()
+			{
+				LoadingThreadMain();
+			}));
+		}
+	}
+
+	AsyncResourceLoader::~AsyncResourceLoader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			running_ = false;
+		}
+		queued_.notify_all();
+		for (std::thread& thread : threads_)
+		{
+			thread.join();
+		}
+		for (AsyncLoadingResultBaseSP const& result : decodeQueue_)
+		{
+			result->Cancel();
+		}
+	}
+
+	void AsyncResourceLoader::Load(AsyncLoadingResultBaseSP const& result)
+	{
+		bool accepted;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			accepted = running_;
+			if (accepted)
+			{
+				decodeQueue_.push_back(result);
+			}
+		}
+		if (!accepted)
+		{
+			result->Cancel();
+			return;
+		}
+		queued_.notify_one();
+	}
+
+	AsyncResourceLoader::UploadStatistics AsyncResourceLoader::Upload(double timeBudget, uint64 byteBudget)
+	{
+		UploadStatistics statistics;
+		Timer timer;
+		while (true)
+		{
+			AsyncLoadingResultBaseSP next;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				RemoveAbandoned(uploadQueue_, AsyncLoadingResultBase::State::Decoded);
+				auto found = FindNext(uploadQueue_, [] (AsyncLoadingResultBase const& result)
+				{
+					return result.AreDependenciesFinished();
+				});
+				if (found == uploadQueue_.end())
+				{
+					break;
+				}
+				uint64 dataSize = (*found)->GetDataSize();
+				if (statistics.createdCount > 0 && statistics.createdBytes + dataSize > byteBudget)
+				{
+					break;
+				}
+				next = std::move(*found);
+				uploadQueue_.erase(found);
+			}
+			uint64 dataSize = next->GetDataSize();
+			if (next->Create())
+			{
+				++statistics.createdCount;
+				statistics.createdBytes += dataSize;
+			}
+			if (timer.Elapsed() >= timeBudget || statistics.createdBytes >= byteBudget)
+			{
+				break;
+			}
+		}
+		statistics.time = timer.Elapsed();
+		return statistics;
+	}
+
+	uint32 AsyncResourceLoader::GetPendingCount() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32 count = decodingCount_;
+		for (AsyncLoadingResultBaseSP const& result : decodeQueue_)
+		{
+			count += result->GetState() == AsyncLoadingResultBase::State::Queued;
+		}
+		for (AsyncLoadingResultBaseSP const& result : uploadQueue_)
+		{
+			count += result->GetState() == AsyncLoadingResultBase::State::Decoded;
+		}
+		return count;
+	}
+
+	void AsyncResourceLoader::LoadingThreadMain()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		while (true)
+		{
+			RemoveAbandoned(decodeQueue_, AsyncLoadingResultBase::State::Queued);
+			auto found = FindNext(decodeQueue_, [] (AsyncLoadingResultBase const&)
+			{
+				return true;
+			});
+			if (found == decodeQueue_.end())
+			{
+				if (!running_)
+				{
+					return;
+				}
+				queued_.wait(lock);
+				continue;
+			}
+			if (!running_)
+			{
+				return; // left in queue, cancelled by destructor
+			}
+			AsyncLoadingResultBaseSP result = std::move(*found);
+			decodeQueue_.erase(found);
+			if (!result->BeginDecoding())
+			{
+				continue;
+			}
+			++decodingCount_;
+			lock.unlock();
+
+			bool decoded = result->Decode();
+
+			lock.lock();
+			--decodingCount_;
+			if (decoded)
+			{
+				uploadQueue_.push_back(std::move(result));
+			}
+		}
+	}
+
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include "Declare.hpp"
+#include "LoadingResult.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Type independent part of AsyncLoadingResult, scheduled by AsyncResourceLoader.
+	 *	Data is decoded by a loading thread, then objects are created on the context thread by AsyncResourceLoader::Upload.
+	 */
+	class XREX_API AsyncLoadingResultBase
+	{
+		friend class AsyncResourceLoader;
+
+	public:
+		enum class State
+		{
+			Queued,
+			Decoding,
+			Decoded,
+			Creating,
+			Created,
+			Failed,
+			Cancelled,
+		};
+
+	public:
+		virtual ~AsyncLoadingResultBase();
+
+		State GetState() const;
+		/*
+		 *	Created, failed or cancelled.
+		 */
+		bool IsFinished() const;
+
+		int32 GetPriority() const
+		{
+			return priority_;
+		}
+		/*
+		 *	Larger priority is decoded and created earlier. Only raises, a lower priority is ignored.
+		 */
+		void RaisePriority(int32 priority);
+
+		/*
+		 *	Drop the request if it is not being created or finished.
+		 *	@return: false if it is too late to cancel.
+		 */
+		bool Cancel();
+		/*
+		 *	Block until data is decoded, failed or cancelled.
+		 *	Objects are created on the context thread, call Create there to finish immediately.
+		 */
+		void Wait();
+
+		/*
+		 *	Not created before all dependencies are finished, e.g. textures of a mesh.
+		 *	Called while decoding.
+		 */
+		void AddDependency(std::shared_ptr<AsyncLoadingResultBase> const& dependency);
+
+	protected:
+		AsyncLoadingResultBase(State state, int32 priority);
+
+		/*
+		 *	Make sure data is decoded, decoding on calling thread if no loading thread has started it yet,
+		 *	then create the object. Must be called on the context thread.
+		 *	@return: true if the object is created.
+		 */
+		bool Finish();
+
+		/*
+		 *	Called on a loading thread, or on the context thread by Finish.
+		 *	@return: false if failed.
+		 */
+		virtual bool DoDecode() = 0;
+		/*
+		 *	Called on the context thread.
+		 */
+		virtual void DoCreate() = 0;
+		/*
+		 *	Release decoded data after being cancelled.
+		 */
+		virtual void DoRelease() = 0;
+		/*
+		 *	Bytes uploaded by DoCreate.
+		 */
+		virtual uint64 GetDataSize() const = 0;
+
+	private:
+		/*
+		 *	Change state from Queued to Decoding.
+		 *	@return: false if it is already taken, cancelled or failed.
+		 */
+		bool BeginDecoding();
+		/*
+		 *	Decode and change state to Decoded or Failed. BeginDecoding must have succeeded.
+		 *	@return: true if decoded and not cancelled meanwhile.
+		 */
+		bool Decode();
+		/*
+		 *	@return: true if created, false if failed or cancelled meanwhile.
+		 */
+		bool Create();
+		bool AreDependenciesFinished() const;
+
+	private:
+		mutable std::mutex mutex_;
+		std::condition_variable stateChanged_;
+		State state_;
+		std::atomic<int32> priority_;
+		std::vector<std::shared_ptr<AsyncLoadingResultBase>> dependencies_;
+	};
+
+	typedef std::shared_ptr<AsyncLoadingResultBase> AsyncLoadingResultBaseSP;
+
+
+
+	/*
+	 *	Future like LoadingResult, returned immediately while data is loaded in background.
+	 *	Succeeded is true until loading failed or cancelled.
+	 *	Create returns the object if created, otherwise finishes loading on the calling thread, which must be the context thread.
+	 */
+	template <typename Type>
+	class AsyncLoadingResult
+		: public LoadingResult<Type>, public AsyncLoadingResultBase
+	{
+	public:
+		typedef std::function<std::shared_ptr<LoadingResult<Type>>(AsyncLoadingResultBase& result)> DecodeFunction;
+		typedef std::function<void(std::shared_ptr<Type> const& createdObject)> CreateCallback;
+
+	public:
+		/*
+		 *	Failed result, e.g. file not found.
+		 */
+		AsyncLoadingResult()
+			: AsyncLoadingResultBase(State::Failed, 0)
+		{
+		}
+		/*
+		 *	Already created object.
+		 */
+		explicit AsyncLoadingResult(std::shared_ptr<Type> const& object)
+			: AsyncLoadingResultBase(object ? State::Created : State::Failed, 0), object_(object)
+		{
+		}
+		/*
+		 *	@decodeFunction: called on a loading thread, returns data ready to create the object.
+		 */
+		AsyncLoadingResult(DecodeFunction decodeFunction, int32 priority)
+			: AsyncLoadingResultBase(State::Queued, priority), decodeFunction_(std::move(decodeFunction))
+		{
+		}
+
+		/*
+		 *	Called on the context thread after the object is created by loader.
+		 */
+		void SetOnCreate(CreateCallback callback)
+		{
+			onCreate_ = std::move(callback);
+		}
+
+		virtual bool Succeeded() const override
+		{
+			State state = GetState();
+			return state != State::Failed && state != State::Cancelled;
+		}
+
+		virtual std::shared_ptr<Type> Create() override
+		{
+			if (!Finish())
+			{
+				return nullptr;
+			}
+			return object_;
+		}
+
+		/*
+		 *	@return: nullptr if not created yet.
+		 */
+		std::shared_ptr<Type> const& GetCreated() const
+		{
+			static std::shared_ptr<Type> const null;
+			return GetState() == State::Created ? object_ : null;
+		}
+
+		virtual uint64 GetDataSize() const override
+		{
+			return data_ ? data_->GetDataSize() : 0;
+		}
+
+	protected:
+		virtual bool DoDecode() override
+		{
+			data_ = decodeFunction_(*this);
+			decodeFunction_ = nullptr;
+			return data_ && data_->Succeeded();
+		}
+		virtual void DoCreate() override
+		{
+			object_ = data_->Create();
+			data_.reset();
+			if (onCreate_)
+			{
+				onCreate_(object_);
+				onCreate_ = nullptr;
+			}
+		}
+		virtual void DoRelease() override
+		{
+			data_.reset();
+			decodeFunction_ = nullptr;
+			onCreate_ = nullptr;
+		}
+
+	private:
+		DecodeFunction decodeFunction_;
+		CreateCallback onCreate_;
+		std::shared_ptr<LoadingResult<Type>> data_;
+		std::shared_ptr<Type> object_;
+	};
+
+	typedef AsyncLoadingResult<Texture> AsyncTextureLoadingResult;
+	typedef std::shared_ptr<AsyncTextureLoadingResult> AsyncTextureLoadingResultSP;
+
+	typedef AsyncLoadingResult<Mesh> AsyncMeshLoadingResult;
+	typedef std::shared_ptr<AsyncMeshLoadingResult> AsyncMeshLoadingResultSP;
+
+
+
+	/*
+	 *	Decodes AsyncLoadingResults on its own loading threads, highest priority first,
+	 *	so file reading and decoding never block the context thread or tasks of TaskScheduler.
+	 *	Decoded results are created on the context thread by Upload, limited by a time and byte budget each call.
+	 */
+	class XREX_API AsyncResourceLoader
+		: Noncopyable
+	{
+	public:
+		struct XREX_API UploadStatistics
+		{
+			uint32 createdCount;
+			uint64 createdBytes;
+			/*
+			 *	In seconds.
+			 */
+			double time;
+
+			UploadStatistics()
+				: createdCount(0), createdBytes(0), time(0)
+			{
+			}
+		};
+
+	public:
+		/*
+		 *	@threadCount: at least 1.
+		 */
+		explicit AsyncResourceLoader(uint32 threadCount);
+		/*
+		 *	Results not decoded yet are cancelled.
+		 */
+		~AsyncResourceLoader();
+
+		void Load(AsyncLoadingResultBaseSP const& result);
+
+		/*
+		 *	Create decoded results on the context thread, highest priority first, until timeBudget seconds or byteBudget bytes are used.
+		 *	At least one result is created if any is ready, so a result larger than the budget still gets created.
+		 */
+		UploadStatistics Upload(double timeBudget, uint64 byteBudget);
+
+		/*
+		 *	Results queued, being decoded or waiting to be created.
+		 */
+		uint32 GetPendingCount() const;
+
+	private:
+		void LoadingThreadMain();
+
+	private:
+		mutable std::mutex mutex_;
+		std::condition_variable queued_;
+		std::vector<AsyncLoadingResultBaseSP> decodeQueue_;
+		std::vector<AsyncLoadingResultBaseSP> uploadQueue_;
+		uint32 decodingCount_;
+		bool running_;
+		std::vector<std::thread> threads_;
+	};
+
+}
@@ -0,0 +1,588 @@
+#include "XREX.hpp"
+
+#include "BlockCompression.hpp"
+
+#include "Base/TaskScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace XREX
+{
+	namespace
+	{
+		uint32 const BlockTexelCount = 16;
+		uint32 const ColorRefinementCount = 2;
+
+		/*
+		 *	Texels of a 4x4 block in structure of arrays layout, RGBA channels in [0, 255].
+		 */
+		struct BlockTexels
+		{
+			float channels[4][BlockTexelCount];
+		};
+
+		void LoadBlock(uint8 const* rgbaTexels, uint32 width, uint32 height, uint32 blockX, uint32 blockY, BlockTexels* block)
+		{
+			for (uint32 y = 0; y < 4; ++y)
+			{
+				uint32 sourceY = std::min(blockY * 4 + y, height - 1);
+				for (uint32 x = 0; x < 4; ++x)
+				{
+					uint32 sourceX = std::min(blockX * 4 + x, width - 1);
+					uint8 const* texel = rgbaTexels + (sourceY * width + sourceX) * 4;
+					for (uint32 c = 0; c < 4; ++c)
+					{
+						block->channels[c][y * 4 + x] = texel[c];
+					}
+				}
+			}
+		}
+
+		/*
+		 *	Index of the nearest palette entry of each texel, the first one if some are equally near.
+		 *	@return: sum of squared distances.
+		 */
+#if defined(XREX_SIMD_AVX)
+		template <uint32 ChannelCount, uint32 PaletteSize>
+		float SelectIndices(float const* const (&channels)[ChannelCount], float const (&palette)[PaletteSize][ChannelCount], uint32 (&indices)[BlockTexelCount])
+		{
+			__m256 totalError = _mm256_setzero_ps();
+			for (uint32 group = 0; group < BlockTexelCount; group += 8)
+			{
+				__m256 texel[ChannelCount];
+				for (uint32 c = 0; c < ChannelCount; ++c)
+				{
+					texel[c] = _mm256_loadu_ps(channels[c] + group);
+				}
+				__m256 bestError = _mm256_set1_ps(std::numeric_limits<float>::max());
+				__m256 bestIndex = _mm256_setzero_ps();
+				for (uint32 p = 0; p < PaletteSize; ++p)
+				{
+					__m256 error = _mm256_setzero_ps();
+					for (uint32 c = 0; c < ChannelCount; ++c)
+					{
+						__m256 difference = _mm256_sub_ps(texel[c], _mm256_set1_ps(palette[p][c]));
+						error = _mm256_add_ps(error, _mm256_mul_ps(difference, difference));
+					}
+					__m256 closer = _mm256_cmp_ps(error, bestError, _CMP_LT_OQ);
+					bestError = _mm256_min_ps(error, bestError);
+					bestIndex = _mm256_blendv_ps(bestIndex, _mm256_set1_ps(static_cast<float>(p)), closer);
+				}
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(indices + group), _mm256_cvttps_epi32(bestIndex));
+				totalError = _mm256_add_ps(totalError, bestError);
+			}
+			float errors[8];
+			_mm256_storeu_ps(errors, totalError);
+			return ((errors[0] + errors[1]) + (errors[2] + errors[3])) + ((errors[4] + errors[5]) + (errors[6] + errors[7]));
+		}
+#elif defined(XREX_SIMD_SSE)
+		template <uint32 ChannelCount, uint32 PaletteSize>
+		float SelectIndices(float const* const (&channels)[ChannelCount], float const (&palette)[PaletteSize][ChannelCount], uint32 (&indices)[BlockTexelCount])
+		{
+			__m128 totalError = _mm_setzero_ps();
+			for (uint32 group = 0; group < BlockTexelCount; group += 4)
+			{
+				__m128 texel[ChannelCount];
+				for (uint32 c = 0; c < ChannelCount; ++c)
+				{
+					texel[c] = _mm_loadu_ps(channels[c] + group);
+				}
+				__m128 bestError = _mm_set1_ps(std::numeric_limits<float>::max());
+				__m128i bestIndex = _mm_setzero_si128();
+				for (uint32 p = 0; p < PaletteSize; ++p)
+				{
+					__m128 error = _mm_setzero_ps();
+					for (uint32 c = 0; c < ChannelCount; ++c)
+					{
+						__m128 difference = _mm_sub_ps(texel[c], _mm_set1_ps(palette[p][c]));
+						error = _mm_add_ps(error, _mm_mul_ps(difference, difference));
+					}
+					__m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+					bestError = _mm_min_ps(error, bestError);
+					bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(p)), _mm_andnot_si128(closer, bestIndex));
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + group), bestIndex);
+				totalError = _mm_add_ps(totalError, bestError);
+			}
+			float errors[4];
+			_mm_storeu_ps(errors, totalError);
+			return (errors[0] + errors[1]) + (errors[2] + errors[3]);
+		}
+#else
+		template <uint32 ChannelCount, uint32 PaletteSize>
+		float SelectIndices(float const* const (&channels)[ChannelCount], float const (&palette)[PaletteSize][ChannelCount], uint32 (&indices)[BlockTexelCount])
+		{
+			float totalError = 0;
+			for (uint32 i = 0; i < BlockTexelCount; ++i)
+			{
+				float bestError = std::numeric_limits<float>::max();
+				indices[i] = 0;
+				for (uint32 p = 0; p < PaletteSize; ++p)
+				{
+					float error = 0;
+					for (uint32 c = 0; c < ChannelCount; ++c)
+					{
+						float difference = channels[c][i] - palette[p][c];
+						error += difference * difference;
+					}
+					if (error < bestError)
+					{
+						bestError = error;
+						indices[i] = p;
+					}
+				}
+				totalError += bestError;
+			}
+			return totalError;
+		}
+#endif
+
+
+
+		/*
+		 *	Color block, shared by BC1 and BC3: two RGB565 endpoints and 2 bits index of each texel.
+		 *	Encoded blocks always have color0 > color1 or equal endpoints, which is the 4 colors mode in both formats.
+		 */
+
+		uint16 QuantizeColor(float const (&color)[3])
+		{
+			uint32 red = static_cast<uint32>(std::min(std::max(color[0], 0.f), 255.f) * 31 / 255 + 0.5f);
+			uint32 green = static_cast<uint32>(std::min(std::max(color[1], 0.f), 255.f) * 63 / 255 + 0.5f);
+			uint32 blue = static_cast<uint32>(std::min(std::max(color[2], 0.f), 255.f) * 31 / 255 + 0.5f);
+			return static_cast<uint16>(red << 11 | green << 5 | blue);
+		}
+
+		void UnquantizeColor(uint16 color, uint32 (&result)[3])
+		{
+			uint32 red = color >> 11 & 31;
+			uint32 green = color >> 5 & 63;
+			uint32 blue = color & 31;
+			result[0] = red << 3 | red >> 2;
+			result[1] = green << 2 | green >> 4;
+			result[2] = blue << 3 | blue >> 2;
+		}
+
+		/*
+		 *	@fourColors: false for 3 colors and black, only BC1 blocks with color0 <= color1.
+		 */
+		void MakeColorPalette(uint16 color0, uint16 color1, bool fourColors, uint32 (&palette)[4][3])
+		{
+			UnquantizeColor(color0, palette[0]);
+			UnquantizeColor(color1, palette[1]);
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				if (fourColors)
+				{
+					palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+				}
+				else
+				{
+					palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+					palette[3][c] = 0;
+				}
+			}
+		}
+
+		/*
+		 *	Line through the mean along the principal axis of texel colors, clipped to the extreme projections.
+		 */
+		void FindColorEndpoints(BlockTexels const& block, float (&endpoints)[2][3])
+		{
+			float mean[3] = { 0, 0, 0 };
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				for (uint32 i = 0; i < BlockTexelCount; ++i)
+				{
+					mean[c] += block.channels[c][i];
+				}
+				mean[c] /= BlockTexelCount;
+			}
+			float covariance[3][3] = { };
+			for (uint32 i = 0; i < BlockTexelCount; ++i)
+			{
+				float difference[3] = { block.channels[0][i] - mean[0], block.channels[1][i] - mean[1], block.channels[2][i] - mean[2] };
+				for (uint32 row = 0; row < 3; ++row)
+				{
+					for (uint32 column = 0; column < 3; ++column)
+					{
+						covariance[row][column] += difference[row] * difference[column];
+					}
+				}
+			}
+
+			// power iteration, starting from the column of the largest variance
+			uint32 largest = 0;
+			for (uint32 c = 1; c < 3; ++c)
+			{
+				if (covariance[c][c] > covariance[largest][largest])
+				{
+					largest = c;
+				}
+			}
+			float axis[3] = { covariance[0][largest], covariance[1][largest], covariance[2][largest] };
+			for (uint32 iteration = 0; iteration < 8; ++iteration)
+			{
+				float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+				if (length < 1e-6f)
+				{
+					break;
+				}
+				float normalized[3] = { axis[0] / length, axis[1] / length, axis[2] / length };
+				for (uint32 row = 0; row < 3; ++row)
+				{
+					axis[row] = covariance[row][0] * normalized[0] + covariance[row][1] * normalized[1] + covariance[row][2] * normalized[2];
+				}
+			}
+			float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			if (length < 1e-6f) // all texels have the same color
+			{
+				std::copy(mean, mean + 3, endpoints[0]);
+				std::copy(mean, mean + 3, endpoints[1]);
+				return;
+			}
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				axis[c] /= length;
+			}
+
+			float minimum = std::numeric_limits<float>::max();
+			float maximum = -std::numeric_limits<float>::max();
+			for (uint32 i = 0; i < BlockTexelCount; ++i)
+			{
+				float projection = (block.channels[0][i] - mean[0]) * axis[0] + (block.channels[1][i] - mean[1]) * axis[1] + (block.channels[2][i] - mean[2]) * axis[2];
+				minimum = std::min(minimum, projection);
+				maximum = std::max(maximum, projection);
+			}
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				endpoints[0][c] = mean[c] + axis[c] * maximum;
+				endpoints[1][c] = mean[c] + axis[c] * minimum;
+			}
+		}
+
+		/*
+		 *	Least squares endpoints for the selected indices.
+		 *	@return: false if all texels use the same weight and endpoints can not be solved.
+		 */
+		bool RefineColorEndpoints(BlockTexels const& block, uint32 const (&indices)[BlockTexelCount], float (&endpoints)[2][3])
+		{
+			static float const Weights[4] = { 1.f, 0.f, 2.f / 3, 1.f / 3 }; // of endpoint 0
+			float aa = 0, ab = 0, bb = 0;
+			float ax[3] = { 0, 0, 0 };
+			float bx[3] = { 0, 0, 0 };
+			for (uint32 i = 0; i < BlockTexelCount; ++i)
+			{
+				float a = Weights[indices[i]];
+				float b = 1 - a;
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				for (uint32 c = 0; c < 3; ++c)
+				{
+					ax[c] += a * block.channels[c][i];
+					bx[c] += b * block.channels[c][i];
+				}
+			}
+			float determinant = aa * bb - ab * ab;
+			if (std::abs(determinant) < 1e-6f)
+			{
+				return false;
+			}
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				endpoints[0][c] = (bb * ax[c] - ab * bx[c]) / determinant;
+				endpoints[1][c] = (aa * bx[c] - ab * ax[c]) / determinant;
+			}
+			return true;
+		}
+
+		void EncodeColorBlock(BlockTexels const& block, uint8* output)
+		{
+			float const* const channels[3] = { block.channels[0], block.channels[1], block.channels[2] };
+			float endpoints[2][3];
+			FindColorEndpoints(block, endpoints);
+
+			float bestError = std::numeric_limits<float>::max();
+			uint16 bestColors[2] = { 0, 0 };
+			uint32 bestIndices = 0;
+			for (uint32 iteration = 0; iteration <= ColorRefinementCount; ++iteration)
+			{
+				uint16 color0 = QuantizeColor(endpoints[0]);
+				uint16 color1 = QuantizeColor(endpoints[1]);
+				if (color0 < color1)
+				{
+					std::swap(color0, color1);
+				}
+				uint32 palette[4][3];
+				MakeColorPalette(color0, color1, true, palette);
+				float floatPalette[4][3];
+				for (uint32 p = 0; p < 4; ++p)
+				{
+					for (uint32 c = 0; c < 3; ++c)
+					{
+						floatPalette[p][c] = static_cast<float>(palette[p][c]);
+					}
+				}
+				uint32 indices[BlockTexelCount];
+				float error = SelectIndices(channels, floatPalette, indices);
+				if (error >= bestError)
+				{
+					break;
+				}
+				bestError = error;
+				bestColors[0] = color0;
+				bestColors[1] = color1;
+				bestIndices = 0;
+				for (uint32 i = 0; i < BlockTexelCount; ++i)
+				{
+					bestIndices |= indices[i] << (i * 2);
+				}
+				if (error == 0 || !RefineColorEndpoints(block, indices, endpoints))
+				{
+					break;
+				}
+			}
+
+			output[0] = static_cast<uint8>(bestColors[0]);
+			output[1] = static_cast<uint8>(bestColors[0] >> 8);
+			output[2] = static_cast<uint8>(bestColors[1]);
+			output[3] = static_cast<uint8>(bestColors[1] >> 8);
+			for (uint32 i = 0; i < 4; ++i)
+			{
+				output[4 + i] = static_cast<uint8>(bestIndices >> (i * 8));
+			}
+		}
+
+		void DecodeColorBlock(uint8 const* block, bool allowThreeColors, uint8* rgbaTexels, uint32 texelStride)
+		{
+			uint16 color0 = static_cast<uint16>(block[0] | block[1] << 8);
+			uint16 color1 = static_cast<uint16>(block[2] | block[3] << 8);
+			uint32 indices = block[4] | block[5] << 8 | block[6] << 16 | static_cast<uint32>(block[7]) << 24;
+			uint32 palette[4][3];
+			MakeColorPalette(color0, color1, !allowThreeColors || color0 > color1, palette);
+			for (uint32 i = 0; i < BlockTexelCount; ++i)
+			{
+				uint32 index = indices >> (i * 2) & 3;
+				uint8* texel = rgbaTexels + ((i / 4) * texelStride + i % 4) * 4;
+				for (uint32 c = 0; c < 3; ++c)
+				{
+					texel[c] = static_cast<uint8>(palette[index][c]);
+				}
+			}
+		}
+
+
+
+		/*
+		 *	Single channel block, BC4 and alpha of BC3: two 8 bits endpoints and 3 bits index of each texel.
+		 *	Encoded blocks use the 8 values mode, value0 > value1, or equal endpoints.
+		 */
+
+		/*
+		 *	@eightValues: false for 6 values, 0 and 255, blocks with value0 <= value1.
+		 */
+		void MakeSingleChannelPalette(uint32 value0, uint32 value1, bool eightValues, uint32 (&palette)[8])
+		{
+			palette[0] = value0;
+			palette[1] = value1;
+			if (eightValues)
+			{
+				for (uint32 i = 2; i < 8; ++i)
+				{
+					palette[i] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+				}
+			}
+			else
+			{
+				for (uint32 i = 2; i < 6; ++i)
+				{
+					palette[i] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+				}
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+		}
+
+		void EncodeSingleChannelBlock(float const* values, uint8* output)
+		{
+			float minimum = *std::min_element(values, values + BlockTexelCount);
+			float maximum = *std::max_element(values, values + BlockTexelCount);
+			uint32 value0 = static_cast<uint32>(maximum + 0.5f);
+			uint32 value1 = static_cast<uint32>(minimum + 0.5f);
+			uint32 palette[8];
+			MakeSingleChannelPalette(value0, value1, true, palette);
+			float floatPalette[8][1];
+			for (uint32 p = 0; p < 8; ++p)
+			{
+				floatPalette[p][0] = static_cast<float>(palette[p]);
+			}
+			float const* const channels[1] = { values };
+			uint32 indices[BlockTexelCount];
+			SelectIndices(channels, floatPalette, indices);
+
+			output[0] = static_cast<uint8>(value0);
+			output[1] = static_cast<uint8>(value1);
+			uint64 packedIndices = 0;
+			for (uint32 i = 0; i < BlockTexelCount; ++i)
+			{
+				packedIndices |= static_cast<uint64>(indices[i]) << (i * 3);
+			}
+			for (uint32 i = 0; i < 6; ++i)
+			{
+				output[2 + i] = static_cast<uint8>(packedIndices >> (i * 8));
+			}
+		}
+
+		void DecodeSingleChannelBlock(uint8 const* block, uint8* rgbaTexels, uint32 texelStride, uint32 channel)
+		{
+			uint32 palette[8];
+			MakeSingleChannelPalette(block[0], block[1], block[0] > block[1], palette);
+			uint64 indices = 0;
+			for (uint32 i = 0; i < 6; ++i)
+			{
+				indices |= static_cast<uint64>(block[2 + i]) << (i * 8);
+			}
+			for (uint32 i = 0; i < BlockTexelCount; ++i)
+			{
+				uint32 index = static_cast<uint32>(indices >> (i * 3) & 7);
+				rgbaTexels[((i / 4) * texelStride + i % 4) * 4 + channel] = static_cast<uint8>(palette[index]);
+			}
+		}
+
+
+
+		void CompressBlockRows(TexelFormat format, uint8 const* rgbaTexels, uint32 width, uint32 height, uint32 beginRow, uint32 endRow, uint8* output)
+		{
+			uint32 blockWidth = (width + 3) / 4;
+			uint32 blockSize = GetTexelBlockSizeInBytes(format);
+			BlockTexels block;
+			for (uint32 blockY = beginRow; blockY < endRow; ++blockY)
+			{
+				for (uint32 blockX = 0; blockX < blockWidth; ++blockX)
+				{
+					LoadBlock(rgbaTexels, width, height, blockX, blockY, &block);
+					uint8* destination = output + (blockY * blockWidth + blockX) * blockSize;
+					switch (format)
+					{
+					case TexelFormat::BC1:
+						EncodeColorBlock(block, destination);
+						break;
+					case TexelFormat::BC3:
+						EncodeSingleChannelBlock(block.channels[3], destination);
+						EncodeColorBlock(block, destination + 8);
+						break;
+					case TexelFormat::BC4:
+						EncodeSingleChannelBlock(block.channels[0], destination);
+						break;
+					case TexelFormat::BC5:
+						EncodeSingleChannelBlock(block.channels[0], destination);
+						EncodeSingleChannelBlock(block.channels[1], destination + 8);
+						break;
+					default:
+						assert(false);
+						break;
+					}
+				}
+			}
+		}
+	}
+
+
+
+	bool IsBlockCompressionSupported(TexelFormat format)
+	{
+		switch (format)
+		{
+		case TexelFormat::BC1:
+		case TexelFormat::BC3:
+		case TexelFormat::BC4:
+		case TexelFormat::BC5:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	std::vector<uint8> CompressTexels(TexelFormat format, uint8 const* rgbaTexels, uint32 width, uint32 height)
+	{
+		if (!IsBlockCompressionSupported(format) || width == 0 || height == 0)
+		{
+			return std::vector<uint8>();
+		}
+		std::vector<uint8> result(GetTexelDataSizeInBytes(format, width, height, 1));
+		CompressBlockRows(format, rgbaTexels, width, height, 0, (height + 3) / 4, result.data());
+		return result;
+	}
+
+	std::vector<uint8> ParallelCompressTexels(TaskScheduler& scheduler, TexelFormat format, uint8 const* rgbaTexels, uint32 width, uint32 height)
+	{
+		if (!IsBlockCompressionSupported(format) || width == 0 || height == 0)
+		{
+			return std::vector<uint8>();
+		}
+		std::vector<uint8> result(GetTexelDataSizeInBytes(format, width, height, 1));
+		uint8* output = result.data();
+		scheduler.ParallelFor(0, (height + 3) / 4, 1, [format, rgbaTexels, width, height, output] (uint32 beginRow, uint32 endRow)
+		{
+			CompressBlockRows(format, rgbaTexels, width, height, beginRow, endRow, output);
+		});
+		return result;
+	}
+
+	std::vector<uint8> DecompressTexels(TexelFormat format, uint8 const* blocks, uint32 width, uint32 height)
+	{
+		if (!IsBlockCompressionSupported(format) || width == 0 || height == 0)
+		{
+			return std::vector<uint8>();
+		}
+		uint32 blockWidth = (width + 3) / 4;
+		uint32 blockHeight = (height + 3) / 4;
+		uint32 blockSize = GetTexelBlockSizeInBytes(format);
+		// decode whole blocks into a padded image, then crop
+		uint32 paddedWidth = blockWidth * 4;
+		std::vector<uint8> padded(paddedWidth * blockHeight * 4 * 4, 0);
+		for (uint32 i = 3; i < padded.size(); i += 4)
+		{
+			padded[i] = 255;
+		}
+		for (uint32 blockY = 0; blockY < blockHeight; ++blockY)
+		{
+			for (uint32 blockX = 0; blockX < blockWidth; ++blockX)
+			{
+				uint8 const* block = blocks + (blockY * blockWidth + blockX) * blockSize;
+				uint8* texels = &padded[(blockY * 4 * paddedWidth + blockX * 4) * 4];
+				switch (format)
+				{
+				case TexelFormat::BC1:
+					DecodeColorBlock(block, true, texels, paddedWidth);
+					break;
+				case TexelFormat::BC3:
+					DecodeSingleChannelBlock(block, texels, paddedWidth, 3);
+					DecodeColorBlock(block + 8, false, texels, paddedWidth);
+					break;
+				case TexelFormat::BC4:
+					DecodeSingleChannelBlock(block, texels, paddedWidth, 0);
+					break;
+				case TexelFormat::BC5:
+					DecodeSingleChannelBlock(block, texels, paddedWidth, 0);
+					DecodeSingleChannelBlock(block + 8, texels, paddedWidth, 1);
+					break;
+				default:
+					assert(false);
+					break;
+				}
+			}
+		}
+
+		std::vector<uint8> result(width * height * 4);
+		for (uint32 y = 0; y < height; ++y)
+		{
+			std::copy_n(&padded[y * paddedWidth * 4], width * 4, &result[y * width * 4]);
+		}
+		return result;
+	}
+
+}
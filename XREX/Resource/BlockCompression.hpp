@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include "Rendering/GraphicsType.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	CPU encoder of block compressed texel formats, for baking textures offline.
+	 *	Input texels are tightly packed RGBA8, BC4 encodes R, BC5 encodes R and G, BC1 ignores alpha.
+	 *	Texels of partial blocks at the right and bottom edges are clamped from the last column and row.
+	 *	Output is laid out as GetTexelDataSizeInBytes, blocks in rows from the top left one.
+	 */
+
+	/*
+	 *	BC1, BC3, BC4 and BC5 can be encoded. BC7 can only be uploaded.
+	 */
+	XREX_API bool IsBlockCompressionSupported(TexelFormat format);
+
+	/*
+	 *	@return: empty if format is not supported.
+	 */
+	XREX_API std::vector<uint8> CompressTexels(TexelFormat format, uint8 const* rgbaTexels, uint32 width, uint32 height);
+	/*
+	 *	Compress rows of blocks in parallel with TaskScheduler::ParallelFor. Output is the same as CompressTexels.
+	 */
+	XREX_API std::vector<uint8> ParallelCompressTexels(TaskScheduler& scheduler, TexelFormat format, uint8 const* rgbaTexels, uint32 width, uint32 height);
+
+	/*
+	 *	Decode as GL does, for measuring encoding error. Channels not stored are 0, alpha is 255.
+	 *	@return: tightly packed RGBA8 texels, empty if format is not supported.
+	 */
+	XREX_API std::vector<uint8> DecompressTexels(TexelFormat format, uint8 const* blocks, uint32 width, uint32 height);
+
+}
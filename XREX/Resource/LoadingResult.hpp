@@ -16,6 +16,14 @@ namespace XREX
 
 		virtual bool Succeeded() const = 0;
 
+		/*
+		 *	Bytes of data uploaded by Create, used to budget uploads of asynchronous loading.
+		 */
+		virtual uint64 GetDataSize() const
+		{
+			return 0;
+		}
+
 		/*
 		 *	Create object from data.
 		 *	Cache the texture when first called.
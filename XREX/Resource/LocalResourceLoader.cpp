@@ -73,6 +73,18 @@ namespace XREX
 	{
 		return meshLoader_->LoadMesh(fileName);
 	}
+	MeshLoadingResultSP LocalResourceLoader::LoadMesh(std::string const& fileName, MeshLoader::TextureLoadingFunction const& loadTexture)
+	{
+		return meshLoader_->LoadMesh(fileName, loadTexture);
+	}
+	MeshLoadingResultSP LocalResourceLoader::LoadMeshCache(std::string const& cacheFileName, MeshLoader::TextureLoadingFunction const& loadTexture)
+	{
+		return meshLoader_->LoadMeshCache(cacheFileName, loadTexture);
+	}
+	bool LocalResourceLoader::SaveMeshCache(MeshLoadingResultSP const& loadingResult, std::string const& cacheFileName)
+	{
+		return meshLoader_->SaveMeshCache(loadingResult, cacheFileName);
+	}
 
 	TextureLoadingResultSP LocalResourceLoader::LoadTexture1D(std::string const& fileName, bool generateMipmap)
 	{
@@ -2,6 +2,7 @@
 
 #include "Declare.hpp"
 #include "Resource/LoadingResult.hpp"
+#include "Resource/MeshLoader.hpp"
 
 #include <string>
 
@@ -18,6 +19,9 @@ namespace XREX
 		std::shared_ptr<std::wstring> LoadWString(std::string const& fileName);
 
 		MeshLoadingResultSP LoadMesh(std::string const& fileName);
+		MeshLoadingResultSP LoadMesh(std::string const& fileName, MeshLoader::TextureLoadingFunction const& loadTexture);
+		MeshLoadingResultSP LoadMeshCache(std::string const& cacheFileName, MeshLoader::TextureLoadingFunction const& loadTexture);
+		bool SaveMeshCache(MeshLoadingResultSP const& loadingResult, std::string const& cacheFileName);
 		TextureLoadingResultSP LoadTexture1D(std::string const& fileName, bool generateMipmap);
 		TextureLoadingResultSP LoadTexture2D(std::string const& fileName, bool generateMipmap);
 		TextureLoadingResultSP LoadTexture3D(std::string const& fileName, bool generateMipmap);
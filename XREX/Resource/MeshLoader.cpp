@@ -14,17 +14,23 @@
 #include "Rendering/Material.hpp"
 #include "Rendering/Sampler.hpp"
 #include "Resource/TextureLoader.hpp"
+#include "Base/MappedFile.hpp"
+#include "Resource/MeshOptimizer.hpp"
+#include "Base/FileSystem.hpp"
 
+#ifndef XREX_WITHOUT_ASSIMP
 #include <assimp/Importer.hpp>      // C++ importer interface
+#include <assimp/IOSystem.hpp>
+#include <assimp/IOStream.hpp>
 #include <assimp/scene.h>           // Output vertex structure
 #include <assimp/postprocess.h>     // Post processing flags
+#endif // XREX_WITHOUT_ASSIMP
 
 #include <vector>
 #include <sstream>
 #include <array>
 #include <iostream>
-
-#include <filesystem>
+#include <fstream>
 
 using std::vector;
 
@@ -56,25 +62,53 @@ namespace XREX
 					: private XREX::Noncopyable
 				{
 					VertexBuffer::DataLayoutDescription description;
-					std::vector<uint8> vertex;
 					IndexBuffer::TopologicalType primitiveType;
 					ElementType indexType;
+					std::vector<uint8> vertex;
 					std::vector<uint16> index16;
 					std::vector<uint32> index32;
+					/*
+					 *	Point to data of above vectors, or into the mapped cache file.
+					 */
+					uint8 const* vertexData;
+					uint32 vertexSize;
+					uint8 const* indexData;
+					uint32 indexCount;
+					AxisAlignedBox boundingBox;
+					Sphere boundingSphere;
 
 					LayoutData(VertexBuffer::DataLayoutDescription&& theDescription, std::vector<uint8>&& theVertex, IndexBuffer::TopologicalType thePrimitiveType, std::vector<uint16>&& theIndex)
-						: description(std::move(theDescription)), vertex(std::move(theVertex)), primitiveType(thePrimitiveType), index16(std::move(theIndex)), indexType(ElementType::Uint16)
+						: description(std::move(theDescription)), vertex(std::move(theVertex)), primitiveType(thePrimitiveType), index16(std::move(theIndex)), indexType(ElementType::Uint16),
+						vertexData(vertex.data()), vertexSize(vertex.size()), indexData(reinterpret_cast<uint8 const*>(index16.data())), indexCount(index16.size())
 					{
+						description.CalculateBoundingVolume(vertexData, &boundingBox, &boundingSphere);
 					}
 					LayoutData(VertexBuffer::DataLayoutDescription&& theDescription, std::vector<uint8>&& theVertex, IndexBuffer::TopologicalType thePrimitiveType, std::vector<uint32>&& theIndex)
-						: description(std::move(theDescription)), vertex(std::move(theVertex)), primitiveType(thePrimitiveType), index32(std::move(theIndex)), indexType(ElementType::Uint32)
+						: description(std::move(theDescription)), vertex(std::move(theVertex)), primitiveType(thePrimitiveType), index32(std::move(theIndex)), indexType(ElementType::Uint32),
+						vertexData(vertex.data()), vertexSize(vertex.size()), indexData(reinterpret_cast<uint8 const*>(index32.data())), indexCount(index32.size())
+					{
+						description.CalculateBoundingVolume(vertexData, &boundingBox, &boundingSphere);
+					}
+					/*
+					 *	Data in the mapped cache file.
+					 */
+					LayoutData(VertexBuffer::DataLayoutDescription&& theDescription, uint8 const* theVertexData, uint32 theVertexSize, IndexBuffer::TopologicalType thePrimitiveType,
+						ElementType theIndexType, uint8 const* theIndexData, uint32 theIndexCount, AxisAlignedBox const& theBoundingBox, Sphere const& theBoundingSphere)
+						: description(std::move(theDescription)), primitiveType(thePrimitiveType), indexType(theIndexType),
+						vertexData(theVertexData), vertexSize(theVertexSize), indexData(theIndexData), indexCount(theIndexCount), boundingBox(theBoundingBox), boundingSphere(theBoundingSphere)
 					{
 					}
-					LayoutData(LayoutData&& right)
+					LayoutData(LayoutData&& right) // moving vectors keeps their data, so are the pointers
 						: description(std::move(right.description)), vertex(std::move(right.vertex)), index16(std::move(right.index16)), index32(std::move(right.index32)),
-						primitiveType(right.primitiveType), indexType(right.indexType)
+						primitiveType(right.primitiveType), indexType(right.indexType), vertexData(right.vertexData), vertexSize(right.vertexSize), indexData(right.indexData), indexCount(right.indexCount),
+						boundingBox(right.boundingBox), boundingSphere(right.boundingSphere)
 					{
 					}
+
+					uint32 GetIndexSize() const
+					{
+						return indexCount * GetElementSizeInBytes(indexType);
+					}
 				};
 
 				struct MaterialData
@@ -84,27 +118,33 @@ namespace XREX
 						: private XREX::Noncopyable
 					{
 						std::string name;
+						/*
+						 *	As referenced by the model file.
+						 */
+						std::string path;
 						TextureLoadingResultSP loadingResult;
 
-						TextureData(std::string const& theName, TextureLoadingResultSP&& theLoadingResult)
-							: name(theName), loadingResult(std::move(theLoadingResult))
+						TextureData(std::string const& theName, std::string const& thePath, TextureLoadingResultSP&& theLoadingResult)
+							: name(theName), path(thePath), loadingResult(std::move(theLoadingResult))
 						{
 						}
 						TextureData(TextureData&& right)
-							: name(std::move(right.name)), loadingResult(std::move(right.loadingResult))
+							: name(std::move(right.name)), path(std::move(right.path)), loadingResult(std::move(right.loadingResult))
 						{
 						}
 					};
 
-					MaterialSP material;
+					std::string name;
+					std::vector<std::pair<std::string, floatV3>> colors;
+					std::vector<std::pair<std::string, float>> values;
 					std::vector<TextureData> textures;
 
-					MaterialData(MaterialSP&& theMaterial, std::vector<TextureData>&& theTextures)
-						: material(std::move(theMaterial)), textures(std::move(theTextures))
+					explicit MaterialData(std::string const& theName)
+						: name(theName)
 					{
 					}
 					MaterialData(MaterialData&& right)
-						: material(std::move(right.material)), textures(std::move(right.textures))
+						: name(std::move(right.name)), colors(std::move(right.colors)), values(std::move(right.values)), textures(std::move(right.textures))
 					{
 					}
 				};
@@ -114,6 +154,14 @@ namespace XREX
 				std::vector<LayoutData> layouts;
 				std::vector<MaterialData> materials;
 				std::vector<std::tuple<std::string, uint32, uint32>> subMeshes; // tuple<(name), (material index), (mesh index)>
+				/*
+				 *	Files read by the importer, the model file and files it references such as material libraries, with their last write time.
+				 */
+				std::vector<std::pair<std::string, uint64>> sourceFiles;
+				/*
+				 *	Holds the cache file layouts point into, null if loaded from model file.
+				 */
+				std::shared_ptr<MappedFile> mappedFile;
 
 				std::vector<RenderingLayoutSP> createdLayouts;
 				std::vector<MaterialSP> createdMaterials;
@@ -152,32 +200,39 @@ namespace XREX
 
 				MeshSP DoLoad()
 				{
+					RenderingFactory& factory = XREXContext::GetInstance().GetRenderingFactory();
 					createdLayouts.reserve(layouts.size());
 					for (auto& layoutToCreate : layouts)
 					{
-						VertexBufferSP vertices = XREXContext::GetInstance().GetRenderingFactory().CreateVertexBuffer(
-							GraphicsBuffer::Usage::StaticDraw, layoutToCreate.vertex, std::move(layoutToCreate.description));
-						IndexBufferSP indices = (layoutToCreate.indexType == ElementType::Uint16)
-							? XREXContext::GetInstance().GetRenderingFactory().CreateIndexBuffer(
-								GraphicsBuffer::Usage::StaticDraw, layoutToCreate.index16, layoutToCreate.primitiveType)
-							: XREXContext::GetInstance().GetRenderingFactory().CreateIndexBuffer(
-								GraphicsBuffer::Usage::StaticDraw, layoutToCreate.index32, layoutToCreate.primitiveType);
+						VertexBufferSP vertices = factory.CreateVertexBuffer(
+							GraphicsBuffer::Usage::StaticDraw, layoutToCreate.vertexData, layoutToCreate.vertexSize, std::move(layoutToCreate.description));
+						IndexBufferSP indices = factory.CreateIndexBuffer(
+							GraphicsBuffer::Usage::StaticDraw, layoutToCreate.indexData, layoutToCreate.primitiveType, layoutToCreate.indexType, layoutToCreate.indexCount);
 
 						vector<VertexBufferSP> vertexBuffers(1);
 						vertexBuffers[0] = vertices;
-						RenderingLayoutSP layout = XREXContext::GetInstance().GetRenderingFactory().CreateRenderingLayout(vertexBuffers, indices);
+						RenderingLayoutSP layout = factory.CreateRenderingLayout(vertexBuffers, indices, layoutToCreate.boundingBox, layoutToCreate.boundingSphere);
 						createdLayouts.push_back(layout);
 					}
 
 					createdMaterials.reserve(materials.size());
-					for (auto& materialToFinish : materials)
+					for (auto& materialToCreate : materials)
 					{
-						for (auto& textureToCreate : materialToFinish.textures)
+						MaterialSP material = MakeSP<Material>(materialToCreate.name);
+						for (auto& color : materialToCreate.colors)
+						{
+							material->SetParameter(color.first, color.second);
+						}
+						for (auto& value : materialToCreate.values)
+						{
+							material->SetParameter(value.first, value.second);
+						}
+						for (auto& textureToCreate : materialToCreate.textures)
 						{
 							TextureSP texture = textureToCreate.loadingResult->Create();
-							materialToFinish.material->SetParameter(textureToCreate.name, texture);
+							material->SetParameter(textureToCreate.name, texture);
 						}
-						createdMaterials.push_back(std::move(materialToFinish.material));
+						createdMaterials.push_back(std::move(material));
 					}
 
 					MeshSP createdMesh = MakeSP<Mesh>(name);
@@ -187,6 +242,17 @@ namespace XREX
 						createdMesh->CreateSubMesh(std::get<0>(meshIndex), createdLayouts[std::get<2>(meshIndex)], createdMaterials[std::get<1>(meshIndex)], nullptr);
 					}
 
+					// data is in GPU buffers now
+					for (auto& layout : layouts)
+					{
+						layout.vertexData = nullptr;
+						layout.indexData = nullptr;
+						std::vector<uint8>().swap(layout.vertex);
+						std::vector<uint16>().swap(layout.index16);
+						std::vector<uint32>().swap(layout.index32);
+					}
+					mappedFile.reset();
+
 					return createdMesh;
 				}
 
@@ -224,22 +290,570 @@ namespace XREX
 				return nullptr;
 			}
 
+			/*
+			 *	Vertices and indices only, textures are loaded separately.
+			 */
+			virtual uint64 GetDataSize() const override
+			{
+				uint64 size = 0;
+				if (Succeeded())
+				{
+					for (auto& layout : data_->layouts)
+					{
+						size += layout.vertexSize + layout.GetIndexSize();
+					}
+				}
+				return size;
+			}
+
+			/*
+			 *	FNV-1a over 8 byte words, the tail of each blob byte by byte.
+			 */
+			uint64 HashData() const
+			{
+				uint64 hash = 14695981039346656037ULL;
+				auto hashBlob = [&hash] (uint8 const* data, uint32 size)
+				{
+					uint32 wordCount = size / sizeof(uint64);
+					for (uint32 i = 0; i < wordCount; ++i)
+					{
+						uint64 word;
+						memcpy(&word, data + i * sizeof(uint64), sizeof(word));
+						hash = (hash ^ word) * 1099511628211ULL;
+					}
+					for (uint32 i = wordCount * sizeof(uint64); i < size; ++i)
+					{
+						hash = (hash ^ data[i]) * 1099511628211ULL;
+					}
+				};
+				for (auto& layout : data_->layouts)
+				{
+					if (layout.vertexData == nullptr) // already created, data is released
+					{
+						return 0;
+					}
+					hashBlob(layout.vertexData, layout.vertexSize);
+					hashBlob(layout.indexData, layout.GetIndexSize());
+				}
+				return hash;
+			}
+
 			std::unique_ptr<DataDetail> data_;
 		};
 
 
+		/*
+		 *	Texture referenced by a material, relative to the model file first.
+		 */
+		TextureLoadingResultSP LoadMaterialTexture(MeshLoader::TextureLoadingFunction const& loadTexture, std::string const& directoryPath, std::string const& path)
+		{
+			TextureLoadingResultSP texureLoadingResult = loadTexture(directoryPath + path);
+			if (!texureLoadingResult->Succeeded())
+			{
+				texureLoadingResult = loadTexture(path);
+			}
+			return texureLoadingResult;
+		}
+
+		uint64 GetFileWriteTime(std::string const& fileName)
+		{
+			return FileSystem::LastWriteTime(FileSystem::path(fileName));
+		}
+
+
+
+#ifndef XREX_WITHOUT_ASSIMP
+		/*
+		 *	Read only file of RecordingIOSystem.
+		 */
+		struct InputFileIOStream
+			: Assimp::IOStream
+		{
+			mutable std::ifstream stream_; // tellg is not const
+			size_t size_;
+
+			explicit InputFileIOStream(std::string const& fileName)
+				: stream_(fileName, std::ios::in | std::ios::binary), size_(0)
+			{
+				if (stream_)
+				{
+					stream_.seekg(0, std::ios::end);
+					size_ = static_cast<size_t>(stream_.tellg());
+					stream_.seekg(0, std::ios::beg);
+				}
+			}
+
+			virtual size_t Read(void* buffer, size_t size, size_t count) override
+			{
+				if (size == 0)
+				{
+					return 0;
+				}
+				stream_.read(static_cast<char*>(buffer), size * count);
+				size_t readCount = static_cast<size_t>(stream_.gcount()) / size;
+				stream_.clear(); // reading to the end is not an error for the importer
+				return readCount;
+			}
+			virtual size_t Write(void const* buffer, size_t size, size_t count) override
+			{
+				return 0;
+			}
+			virtual aiReturn Seek(size_t offset, aiOrigin origin) override
+			{
+				std::ios::seekdir const directions[] = { std::ios::beg, std::ios::cur, std::ios::end };
+				// offset is negative for aiOrigin_END, stored in size_t.
+				stream_.seekg(static_cast<std::streamoff>(static_cast<std::ptrdiff_t>(offset)), directions[origin]);
+				return stream_ ? aiReturn_SUCCESS : aiReturn_FAILURE;
+			}
+			virtual size_t Tell() const override
+			{
+				return static_cast<size_t>(stream_.tellg());
+			}
+			virtual size_t FileSize() const override
+			{
+				return size_;
+			}
+			virtual void Flush() override
+			{
+			}
+		};
+
+		/*
+		 *	Records files opened by the importer, so a mesh cache knows all files it depends on.
+		 *	Owned by the Importer it is given to.
+		 */
+		struct RecordingIOSystem
+			: Assimp::IOSystem
+		{
+			std::vector<std::string>& openedFiles_;
+
+			explicit RecordingIOSystem(std::vector<std::string>& openedFiles)
+				: openedFiles_(openedFiles)
+			{
+			}
+
+			virtual bool Exists(char const* file) const override
+			{
+				FileSystem::path path(file);
+				return FileSystem::exists(path) && FileSystem::IsRegularFile(path);
+			}
+			virtual char getOsSeparator() const override
+			{
+#ifdef _WIN32
+				return '\\';
+#else
+				return '/';
+#endif
+			}
+			virtual Assimp::IOStream* Open(char const* file, char const* mode) override
+			{
+				if (std::string(mode).find_first_of("wa+") != std::string::npos) // the importer only reads
+				{
+					return nullptr;
+				}
+				std::unique_ptr<InputFileIOStream> stream(new InputFileIOStream(file));
+				if (!stream->stream_)
+				{
+					return nullptr;
+				}
+				std::string fullPath = FileSystem::Complete(FileSystem::path(file)).string();
+				if (std::find(openedFiles_.begin(), openedFiles_.end(), fullPath) == openedFiles_.end())
+				{
+					openedFiles_.push_back(fullPath);
+				}
+				return stream.release();
+			}
+			virtual void Close(Assimp::IOStream* file) override
+			{
+				delete file;
+			}
+		};
+#endif // XREX_WITHOUT_ASSIMP
+
+
+
+		/*
+		 *	Mesh cache file, native byte order, all numbers are uint32 unless noted:
+		 *	header: magic "XRMC", version, offset of the data section, total file size.
+		 *	tables: mesh name, source files, layouts, materials, sub meshes. Strings are length followed by characters.
+		 *		Source files are full path and last write time as low and high uint32, the cache is stale if any of them changed.
+		 *	data section: vertex and index data of layouts, each starts at 16 bytes aligned offset relative to the data section.
+		 *	Enums are stored as their values, bump MeshCacheVersion if any of them changes, or if imported data changes.
+		 *	Version 2: layouts are optimized by MeshOptimizer.
+		 *	Version 3: source files.
+		 */
+		uint32 const MeshCacheMagic = 'X' | 'R' << 8 | 'M' << 16 | 'C' << 24;
+		uint32 const MeshCacheVersion = 3;
+		uint32 const MeshCacheHeaderSize = 4 * sizeof(uint32);
+		uint32 const MeshCacheDataAlignment = 16;
+
+		uint32 AlignMeshCacheOffset(uint32 offset)
+		{
+			return (offset + MeshCacheDataAlignment - 1) / MeshCacheDataAlignment * MeshCacheDataAlignment;
+		}
+
+		struct MeshCacheWriter
+		{
+			std::vector<uint8> buffer;
+
+			void Write(void const* data, uint32 size)
+			{
+				buffer.insert(buffer.end(), static_cast<uint8 const*>(data), static_cast<uint8 const*>(data) + size);
+			}
+			void Write(uint32 value)
+			{
+				Write(&value, sizeof(value));
+			}
+			void Write(uint64 value)
+			{
+				Write(static_cast<uint32>(value));
+				Write(static_cast<uint32>(value >> 32));
+			}
+			void Write(float value)
+			{
+				Write(&value, sizeof(value));
+			}
+			void Write(floatV3 const& value)
+			{
+				Write(value.X());
+				Write(value.Y());
+				Write(value.Z());
+			}
+			void Write(std::string const& value)
+			{
+				Write(static_cast<uint32>(value.size()));
+				Write(value.data(), value.size());
+			}
+			void Pad(uint32 alignedSize)
+			{
+				assert(alignedSize >= buffer.size());
+				buffer.resize(alignedSize, 0);
+			}
+		};
+
+		/*
+		 *	Every read is checked against the end of the tables, a broken file fails instead of crashing.
+		 */
+		struct MeshCacheReader
+		{
+			uint8 const* current;
+			uint8 const* end;
+			bool failed;
+
+			MeshCacheReader(uint8 const* begin, uint8 const* theEnd)
+				: current(begin), end(theEnd), failed(false)
+			{
+			}
+
+			bool Read(void* data, uint32 size)
+			{
+				if (failed || static_cast<uint32>(end - current) < size)
+				{
+					failed = true;
+					return false;
+				}
+				memcpy(data, current, size);
+				current += size;
+				return true;
+			}
+			uint32 ReadUint32()
+			{
+				uint32 value = 0;
+				Read(&value, sizeof(value));
+				return value;
+			}
+			uint64 ReadUint64()
+			{
+				uint64 low = ReadUint32();
+				uint64 high = ReadUint32();
+				return low | high << 32;
+			}
+			float ReadFloat()
+			{
+				float value = 0;
+				Read(&value, sizeof(value));
+				return value;
+			}
+			floatV3 ReadFloatV3()
+			{
+				float x = ReadFloat();
+				float y = ReadFloat();
+				float z = ReadFloat();
+				return floatV3(x, y, z);
+			}
+			std::string ReadString()
+			{
+				uint32 length = ReadUint32();
+				if (failed || static_cast<uint32>(end - current) < length)
+				{
+					failed = true;
+					return std::string();
+				}
+				std::string value(reinterpret_cast<char const*>(current), length);
+				current += length;
+				return value;
+			}
+		};
 
+		bool WriteMeshCache(ModelLoadingResultDetail::DataDetail const& data, std::string const& cacheFileName)
+		{
+			MeshCacheWriter tables;
+			tables.Write(data.name);
+
+			tables.Write(static_cast<uint32>(data.sourceFiles.size()));
+			for (auto& sourceFile : data.sourceFiles)
+			{
+				tables.Write(sourceFile.first);
+				tables.Write(sourceFile.second);
+			}
+
+			uint32 dataSize = 0;
+			tables.Write(static_cast<uint32>(data.layouts.size()));
+			for (auto& layout : data.layouts)
+			{
+				if (layout.vertexData == nullptr) // already created, data is released
+				{
+					return false;
+				}
+				VertexBuffer::DataLayoutDescription const& description = layout.description;
+				tables.Write(description.GetVertexCount());
+				tables.Write(description.GetChannelLayoutCount());
+				for (auto& channel : description.GetAllLayouts())
+				{
+					tables.Write(channel.start);
+					tables.Write(channel.strip);
+					tables.Write(static_cast<uint32>(channel.elementType));
+					tables.Write(static_cast<uint32>(channel.needNormalize));
+					tables.Write(channel.channel);
+				}
+				tables.Write(static_cast<uint32>(layout.primitiveType));
+				tables.Write(static_cast<uint32>(layout.indexType));
+				tables.Write(layout.indexCount);
+				tables.Write(dataSize);
+				tables.Write(layout.vertexSize);
+				dataSize = AlignMeshCacheOffset(dataSize + layout.vertexSize);
+				tables.Write(dataSize);
+				tables.Write(layout.GetIndexSize());
+				dataSize = AlignMeshCacheOffset(dataSize + layout.GetIndexSize());
+				tables.Write(layout.boundingBox.GetMin());
+				tables.Write(layout.boundingBox.GetMax());
+				tables.Write(layout.boundingSphere.GetCenter());
+				tables.Write(layout.boundingSphere.GetRadius());
+			}
+
+			tables.Write(static_cast<uint32>(data.materials.size()));
+			for (auto& material : data.materials)
+			{
+				tables.Write(material.name);
+				tables.Write(static_cast<uint32>(material.colors.size()));
+				for (auto& color : material.colors)
+				{
+					tables.Write(color.first);
+					tables.Write(color.second);
+				}
+				tables.Write(static_cast<uint32>(material.values.size()));
+				for (auto& value : material.values)
+				{
+					tables.Write(value.first);
+					tables.Write(value.second);
+				}
+				tables.Write(static_cast<uint32>(material.textures.size()));
+				for (auto& texture : material.textures)
+				{
+					tables.Write(texture.name);
+					tables.Write(texture.path);
+				}
+			}
+
+			tables.Write(static_cast<uint32>(data.subMeshes.size()));
+			for (auto& subMesh : data.subMeshes)
+			{
+				tables.Write(std::get<0>(subMesh));
+				tables.Write(std::get<1>(subMesh));
+				tables.Write(std::get<2>(subMesh));
+			}
+
+			MeshCacheWriter file;
+			uint32 dataOffset = AlignMeshCacheOffset(MeshCacheHeaderSize + tables.buffer.size());
+			file.Write(MeshCacheMagic);
+			file.Write(MeshCacheVersion);
+			file.Write(dataOffset);
+			file.Write(dataOffset + dataSize);
+			file.Write(tables.buffer.data(), tables.buffer.size());
+			for (auto& layout : data.layouts)
+			{
+				file.Pad(AlignMeshCacheOffset(file.buffer.size()));
+				file.Write(layout.vertexData, layout.vertexSize);
+				file.Pad(AlignMeshCacheOffset(file.buffer.size()));
+				file.Write(layout.indexData, layout.GetIndexSize());
+			}
+			file.Pad(dataOffset + dataSize);
+
+			std::ofstream stream(cacheFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!stream)
+			{
+				return false;
+			}
+			stream.write(reinterpret_cast<char const*>(file.buffer.data()), file.buffer.size());
+			return static_cast<bool>(stream);
+		}
+
+		/*
+		 *	@return: null if the file is not a valid cache of current version, or any file it was imported from changed.
+		 */
+		std::shared_ptr<ModelLoadingResultDetail> ReadMeshCache(std::string const& cacheFileName, MeshLoader::TextureLoadingFunction const& loadTexture)
+		{
+			std::shared_ptr<MappedFile> mappedFile = MakeSP<MappedFile>(cacheFileName);
+			if (!mappedFile->IsMapped() || mappedFile->GetSize() < MeshCacheHeaderSize)
+			{
+				return nullptr;
+			}
+			uint8 const* fileData = mappedFile->GetData();
+			MeshCacheReader header(fileData, fileData + MeshCacheHeaderSize);
+			uint32 magic = header.ReadUint32();
+			uint32 version = header.ReadUint32();
+			uint32 dataOffset = header.ReadUint32();
+			uint32 fileSize = header.ReadUint32();
+			if (magic != MeshCacheMagic || version != MeshCacheVersion || fileSize != mappedFile->GetSize() || dataOffset < MeshCacheHeaderSize || dataOffset > fileSize)
+			{
+				return nullptr;
+			}
+			uint8 const* blobs = fileData + dataOffset;
+			uint32 dataSize = fileSize - dataOffset;
+
+			MeshCacheReader reader(fileData + MeshCacheHeaderSize, blobs);
+			std::shared_ptr<ModelLoadingResultDetail> result = MakeSP<ModelLoadingResultDetail>(reader.ReadString());
+
+			uint32 sourceFileCount = reader.ReadUint32();
+			for (uint32 i = 0; i < sourceFileCount && !reader.failed; ++i)
+			{
+				std::string sourceFile = reader.ReadString();
+				uint64 writeTime = reader.ReadUint64();
+				if (reader.failed || !FileSystem::exists(FileSystem::path(sourceFile)) || GetFileWriteTime(sourceFile) != writeTime)
+				{
+					return nullptr;
+				}
+				result->data_->sourceFiles.push_back(std::make_pair(sourceFile, writeTime));
+			}
+
+			uint32 layoutCount = reader.ReadUint32();
+			for (uint32 i = 0; i < layoutCount && !reader.failed; ++i)
+			{
+				VertexBuffer::DataLayoutDescription description(reader.ReadUint32());
+				uint32 channelCount = reader.ReadUint32();
+				for (uint32 j = 0; j < channelCount && !reader.failed; ++j)
+				{
+					uint32 start = reader.ReadUint32();
+					uint32 strip = reader.ReadUint32();
+					uint32 elementType = reader.ReadUint32();
+					bool normalize = reader.ReadUint32() != 0;
+					std::string channel = reader.ReadString();
+					if (elementType >= static_cast<uint32>(ElementType::ElementTypeCount))
+					{
+						return nullptr;
+					}
+					description.AddChannelLayout(VertexBuffer::DataLayoutDescription::ElementLayoutDescription(start, strip, static_cast<ElementType>(elementType), channel, normalize));
+				}
+				uint32 primitiveType = reader.ReadUint32();
+				ElementType indexType = static_cast<ElementType>(reader.ReadUint32());
+				uint32 indexCount = reader.ReadUint32();
+				uint32 vertexOffset = reader.ReadUint32();
+				uint32 vertexSize = reader.ReadUint32();
+				uint32 indexOffset = reader.ReadUint32();
+				uint32 indexSize = reader.ReadUint32();
+				floatV3 boxMin = reader.ReadFloatV3();
+				floatV3 boxMax = reader.ReadFloatV3();
+				floatV3 sphereCenter = reader.ReadFloatV3();
+				float sphereRadius = reader.ReadFloat();
+				if (reader.failed || primitiveType >= static_cast<uint32>(IndexBuffer::TopologicalType::DrawingModeCount)
+					|| (indexType != ElementType::Uint16 && indexType != ElementType::Uint32) || indexSize != indexCount * GetElementSizeInBytes(indexType)
+					|| vertexOffset > dataSize || vertexSize > dataSize - vertexOffset || indexOffset > dataSize || indexSize > dataSize - indexOffset)
+				{
+					return nullptr;
+				}
+				AxisAlignedBox boundingBox;
+				if (boxMin.X() <= boxMax.X() && boxMin.Y() <= boxMax.Y() && boxMin.Z() <= boxMax.Z()) // otherwise an empty box
+				{
+					boundingBox = AxisAlignedBox(boxMin, boxMax);
+				}
+				result->AddSubMeshData(ModelLoadingResultDetail::DataDetail::LayoutData(std::move(description), blobs + vertexOffset, vertexSize,
+					static_cast<IndexBuffer::TopologicalType>(primitiveType), indexType, blobs + indexOffset, indexCount, boundingBox, Sphere(sphereCenter, sphereRadius)));
+			}
+
+			FileSystem::path cachePath(cacheFileName);
+			std::string directoryPath = cachePath.parent_path().string() + "/";
+			uint32 materialCount = reader.ReadUint32();
+			for (uint32 i = 0; i < materialCount && !reader.failed; ++i)
+			{
+				ModelLoadingResultDetail::DataDetail::MaterialData material(reader.ReadString());
+				uint32 colorCount = reader.ReadUint32();
+				for (uint32 j = 0; j < colorCount && !reader.failed; ++j)
+				{
+					std::string name = reader.ReadString();
+					material.colors.push_back(std::make_pair(name, reader.ReadFloatV3()));
+				}
+				uint32 valueCount = reader.ReadUint32();
+				for (uint32 j = 0; j < valueCount && !reader.failed; ++j)
+				{
+					std::string name = reader.ReadString();
+					material.values.push_back(std::make_pair(name, reader.ReadFloat()));
+				}
+				uint32 textureCount = reader.ReadUint32();
+				for (uint32 j = 0; j < textureCount && !reader.failed; ++j)
+				{
+					std::string name = reader.ReadString();
+					std::string path = reader.ReadString();
+					if (reader.failed)
+					{
+						return nullptr; // do not load textures of a broken file
+					}
+					material.textures.push_back(ModelLoadingResultDetail::DataDetail::MaterialData::TextureData(name, path, LoadMaterialTexture(loadTexture, directoryPath, path)));
+				}
+				result->AddMaterialData(std::move(material));
+			}
+
+			uint32 subMeshCount = reader.ReadUint32();
+			for (uint32 i = 0; i < subMeshCount && !reader.failed; ++i)
+			{
+				std::string name = reader.ReadString();
+				uint32 materialIndex = reader.ReadUint32();
+				uint32 layoutIndex = reader.ReadUint32();
+				if (materialIndex >= materialCount || layoutIndex >= layoutCount)
+				{
+					return nullptr;
+				}
+				result->AddSubMesh(std::make_tuple(name, materialIndex, layoutIndex));
+			}
+			if (reader.failed)
+			{
+				return nullptr;
+			}
+
+			result->data_->mappedFile = std::move(mappedFile);
+			return result;
+		}
+
+
+
+#ifndef XREX_WITHOUT_ASSIMP
 		struct SceneProcessor
 		{
 			aiScene const& scene_;
 			std::string directoryPath_;
+			MeshLoader::TextureLoadingFunction const& loadTexture_;
+			bool optimize_;
+			/*
+			 *	Owned by caller of LoadMesh, may be null.
+			 */
+			std::vector<MeshLoader::OptimizationStatistics>* optimizationStatistics_;
 
 			std::shared_ptr<ModelLoadingResultDetail> result_;
 
-			SceneProcessor(aiScene const& theScene, std::string const& filePath)
-				: scene_(theScene)
+			SceneProcessor(aiScene const& theScene, std::string const& filePath, MeshLoader::TextureLoadingFunction const& loadTexture,
+				bool optimize, std::vector<MeshLoader::OptimizationStatistics>* optimizationStatistics)
+				: scene_(theScene), loadTexture_(loadTexture), optimize_(optimize), optimizationStatistics_(optimizationStatistics)
 			{
-				std::tr2::sys::path scenePath(filePath);
+				FileSystem::path scenePath(filePath);
 				directoryPath_ = scenePath.parent_path().string() + "/";
 				result_ = MakeSP<ModelLoadingResultDetail>(scenePath.string());
 				ProcessScene();
@@ -294,45 +908,45 @@ namespace XREX
 					{
 						assert(false);
 					}
-					MaterialSP material = MakeSP<Material>(name.C_Str());
+					ModelLoadingResultDetail::DataDetail::MaterialData material(name.C_Str());
 					static_assert(sizeof(aiColor3D) == sizeof(floatV3), "size not match.");
 					aiColor3D aiColor;
 					if (AI_SUCCESS == loaderMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiColor))
 					{
 						floatV3 color;
 						memcpy_s(&color, sizeof(floatV3), &aiColor, sizeof(aiColor3D));
-						material->SetParameter(GetUniformString(DefinedUniform::DiffuseColor), color);
+						material.colors.push_back(std::make_pair(GetUniformString(DefinedUniform::DiffuseColor), color));
 					}
 					if (AI_SUCCESS == loaderMaterial->Get(AI_MATKEY_COLOR_SPECULAR, aiColor))
 					{
 						floatV3 color;
 						memcpy_s(&color, sizeof(floatV3), &aiColor, sizeof(aiColor3D));
-						material->SetParameter(GetUniformString(DefinedUniform::SpecularColor), color);
+						material.colors.push_back(std::make_pair(GetUniformString(DefinedUniform::SpecularColor), color));
 					}
 					if (AI_SUCCESS == loaderMaterial->Get(AI_MATKEY_COLOR_EMISSIVE, aiColor))
 					{
 						floatV3 color;
 						memcpy_s(&color, sizeof(floatV3), &aiColor, sizeof(aiColor3D));
-						material->SetParameter(GetUniformString(DefinedUniform::EmissiveColor), color);
+						material.colors.push_back(std::make_pair(GetUniformString(DefinedUniform::EmissiveColor), color));
 					}
 					if (AI_SUCCESS == loaderMaterial->Get(AI_MATKEY_COLOR_TRANSPARENT, aiColor))
 					{
 						floatV3 color;
 						memcpy_s(&color, sizeof(floatV3), &aiColor, sizeof(aiColor3D));
-						material->SetParameter(GetUniformString(DefinedUniform::TransparentColor), color);
+						material.colors.push_back(std::make_pair(GetUniformString(DefinedUniform::TransparentColor), color));
 					}
 					float value;
 					if (AI_SUCCESS == loaderMaterial->Get(AI_MATKEY_OPACITY, value))
 					{
-						material->SetParameter(GetUniformString(DefinedUniform::Opacity), value);
+						material.values.push_back(std::make_pair(GetUniformString(DefinedUniform::Opacity), value));
 					}
 					if (AI_SUCCESS == loaderMaterial->Get(AI_MATKEY_SHININESS, value))
 					{
-						material->SetParameter(GetUniformString(DefinedUniform::Shininess), value);
+						material.values.push_back(std::make_pair(GetUniformString(DefinedUniform::Shininess), value));
 					}
 					if (AI_SUCCESS == loaderMaterial->Get(AI_MATKEY_SHININESS_STRENGTH, value))
 					{
-						material->SetParameter(GetUniformString(DefinedUniform::SpecularLevel), value);
+						material.values.push_back(std::make_pair(GetUniformString(DefinedUniform::SpecularLevel), value));
 					}
 
 
@@ -361,8 +975,6 @@ namespace XREX
 					std::array<aiTextureMapMode, 3> textureMapModes;
 					textureMapModes.fill(_aiTextureMapMode_Force32Bit);
 
-					std::vector<ModelLoadingResultDetail::DataDetail::MaterialData::TextureData> texturesToLoad;
-
 					for (auto& textureType : TextureTypes)
 					{
 						textureCount = loaderMaterial->GetTextureCount(textureType.first);
@@ -372,11 +984,7 @@ namespace XREX
 						{
 							if (AI_SUCCESS == loaderMaterial->GetTexture(textureType.first, j, &path, &textureMapping, &uvIndex, &blend, &textureOp, textureMapModes.data()))
 							{
-								TextureLoadingResultSP texureLoadingResult = XREXContext::GetInstance().GetResourceManager().LoadTexture2D(directoryPath_ + path.C_Str());
-								if (!texureLoadingResult->Succeeded())
-								{
-									texureLoadingResult = XREXContext::GetInstance().GetResourceManager().LoadTexture2D(path.C_Str());
-								}
+								TextureLoadingResultSP texureLoadingResult = LoadMaterialTexture(loadTexture_, directoryPath_, path.C_Str());
 
 								assert(textureType.second != ""); // TODO log failure rather than assert
 
@@ -406,11 +1014,11 @@ namespace XREX
 									}
 								}
 
-								texturesToLoad.push_back(ModelLoadingResultDetail::DataDetail::MaterialData::TextureData(textureType.second, std::move(texureLoadingResult)));
+								material.textures.push_back(ModelLoadingResultDetail::DataDetail::MaterialData::TextureData(textureType.second, path.C_Str(), std::move(texureLoadingResult)));
 							}
 						}
 					}
-					result_->AddMaterialData(ModelLoadingResultDetail::DataDetail::MaterialData(std::move(material), std::move(texturesToLoad)));
+					result_->AddMaterialData(std::move(material));
 				}
 			}
 
@@ -550,6 +1158,28 @@ namespace XREX
 						break;
 					}
 
+					if (optimize_ && primitiveType == IndexBuffer::TopologicalType::Triangles)
+					{
+						MeshLoader::OptimizationStatistics statistics;
+						statistics.name = mesh->mName.C_Str();
+						statistics.vertexCount = mesh->mNumVertices;
+						statistics.triangleCount = mesh->mNumFaces;
+						if (!useLargeIndexBuffer)
+						{
+							vector<uint32> indices(indexData16.begin(), indexData16.end());
+							OptimizeLayout(data, totalLengthPerElement, mesh->mNumVertices, mesh->HasPositions(), indices, &statistics);
+							std::copy(indices.begin(), indices.end(), indexData16.begin());
+						}
+						else
+						{
+							OptimizeLayout(data, totalLengthPerElement, mesh->mNumVertices, mesh->HasPositions(), indexData32, &statistics);
+						}
+						if (optimizationStatistics_ != nullptr)
+						{
+							optimizationStatistics_->push_back(std::move(statistics));
+						}
+					}
+
 					if (!useLargeIndexBuffer)
 					{
 						result_->AddSubMeshData(ModelLoadingResultDetail::DataDetail::LayoutData(std::move(dataDescription), std::move(data), primitiveType, std::move(indexData16)));
@@ -563,6 +1193,21 @@ namespace XREX
 			}
 
 
+			/*
+			 *	Positions are the first channel if there are.
+			 */
+			void OptimizeLayout(vector<uint8>& vertex, uint32 vertexStride, uint32 vertexCount, bool hasPositions, vector<uint32>& indices, MeshLoader::OptimizationStatistics* statistics)
+			{
+				statistics->before = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+				std::vector<uint32> clusters = OptimizeVertexCache(indices.data(), indices.size(), vertexCount);
+				if (hasPositions)
+				{
+					OptimizeOverdraw(indices.data(), indices.size(), vertex.data(), vertexStride, vertexCount, clusters);
+				}
+				OptimizeVertexFetch(vertex.data(), vertexStride, vertexCount, indices.data(), indices.size());
+				statistics->after = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+			}
+
 			void ProcessNode(aiNode const& node)
 			{
 				uint32* meshIndices = node.mMeshes;
@@ -580,10 +1225,12 @@ namespace XREX
 			}
 
 		};
+#endif // XREX_WITHOUT_ASSIMP
 
 	}
 
 	MeshLoader::MeshLoader()
+		: optimizationEnabled_(true)
 	{
 	}
 
@@ -594,7 +1241,30 @@ namespace XREX
 
 	MeshLoadingResultSP MeshLoader::LoadMesh(std::string const& fileName)
 	{
+		return LoadMesh(fileName, [] (std::string const& textureFileName)
+		{
+			return XREXContext::GetInstance().GetResourceManager().LoadTexture2D(textureFileName);
+		});
+	}
+
+	MeshLoadingResultSP MeshLoader::LoadMesh(std::string const& fileName, TextureLoadingFunction const& loadTexture)
+	{
+		return LoadMesh(fileName, loadTexture, nullptr);
+	}
+
+	MeshLoadingResultSP MeshLoader::LoadMesh(std::string const& fileName, TextureLoadingFunction const& loadTexture, std::vector<OptimizationStatistics>* optimizationStatistics)
+	{
+		if (optimizationStatistics != nullptr)
+		{
+			optimizationStatistics->clear();
+		}
+#ifdef XREX_WITHOUT_ASSIMP
+		XREXContext::GetInstance().GetLogger().LogLine("XREX is built without assimp, cannot import mesh: " + fileName);
+		return MakeSP<NullModelLoadingResult>();
+#else
+		std::vector<std::string> sourceFiles;
 		Assimp::Importer importer;
+		importer.SetIOHandler(new RecordingIOSystem(sourceFiles));
 
 		aiScene const* scene = importer.ReadFile(fileName,
 			//aiProcess_GenSmoothNormals |
@@ -611,7 +1281,56 @@ namespace XREX
 			return MakeSP<NullModelLoadingResult>();
 		}
 		// Everything will be cleaned up by the importer destructor
-		return SceneProcessor(*scene, fileName).result_;
+		std::shared_ptr<ModelLoadingResultDetail> result = SceneProcessor(*scene, fileName, loadTexture, optimizationEnabled_, optimizationStatistics).result_;
+		for (auto& sourceFile : sourceFiles)
+		{
+			result->data_->sourceFiles.push_back(std::make_pair(sourceFile, GetFileWriteTime(sourceFile)));
+		}
+		return result;
+#endif // XREX_WITHOUT_ASSIMP
+	}
+
+	std::string MeshLoader::GetMeshCacheFileName(std::string const& fileName)
+	{
+		return fileName + ".xrmc";
+	}
+
+	bool MeshLoader::SaveMeshCache(MeshLoadingResultSP const& loadingResult, std::string const& cacheFileName)
+	{
+		std::shared_ptr<ModelLoadingResultDetail> detail = std::dynamic_pointer_cast<ModelLoadingResultDetail>(loadingResult);
+		if (detail == nullptr || !detail->Succeeded())
+		{
+			return false;
+		}
+		return WriteMeshCache(*detail->data_, cacheFileName);
+	}
+
+	uint64 MeshLoader::HashMeshData(MeshLoadingResultSP const& loadingResult)
+	{
+		std::shared_ptr<ModelLoadingResultDetail> detail = std::dynamic_pointer_cast<ModelLoadingResultDetail>(loadingResult);
+		if (detail == nullptr || !detail->Succeeded())
+		{
+			return 0;
+		}
+		return detail->HashData();
+	}
+
+	MeshLoadingResultSP MeshLoader::LoadMeshCache(std::string const& cacheFileName)
+	{
+		return LoadMeshCache(cacheFileName, [] (std::string const& textureFileName)
+		{
+			return XREXContext::GetInstance().GetResourceManager().LoadTexture2D(textureFileName);
+		});
+	}
+
+	MeshLoadingResultSP MeshLoader::LoadMeshCache(std::string const& cacheFileName, TextureLoadingFunction const& loadTexture)
+	{
+		std::shared_ptr<ModelLoadingResultDetail> result = ReadMeshCache(cacheFileName, loadTexture);
+		if (result == nullptr)
+		{
+			return MakeSP<NullModelLoadingResult>();
+		}
+		return result;
 	}
 
 }
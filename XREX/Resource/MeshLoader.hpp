@@ -2,6 +2,10 @@
 
 #include "Declare.hpp"
 #include "LoadingResult.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <functional>
+#include <string>
 
 namespace XREX
 {
@@ -9,14 +13,79 @@ namespace XREX
 	class XREX_API MeshLoader
 		: Noncopyable
 	{
+	public:
+		/*
+		 *	Returns the loading result of a texture referenced by a material.
+		 */
+		typedef std::function<TextureLoadingResultSP(std::string const& fileName)> TextureLoadingFunction;
+
+		/*
+		 *	Vertex cache efficiency of a triangle layout, in authoring order and after optimization.
+		 */
+		struct OptimizationStatistics
+		{
+			std::string name;
+			uint32 vertexCount;
+			uint32 triangleCount;
+			VertexCacheStatistics before;
+			VertexCacheStatistics after;
+		};
+
 	public:
 		MeshLoader();
 		~MeshLoader();
 
+		/*
+		 *	Enabled by default. Triangles of imported meshes are reordered for vertex cache and overdraw,
+		 *	then vertices for fetch locality, see MeshOptimizer.hpp. Mesh caches are saved optimized, not processed when loaded.
+		 */
+		void SetOptimizationEnabled(bool enabled)
+		{
+			optimizationEnabled_ = enabled;
+		}
+		bool IsOptimizationEnabled() const
+		{
+			return optimizationEnabled_;
+		}
 		/*
 		 *	@return: mesh and texture data ready to create mesh.
 		 */
 		MeshLoadingResultSP LoadMesh(std::string const& fileName);
+		/*
+		 *	@loadTexture: called for each texture, instead of ResourceManager::LoadTexture2D.
+		 */
+		MeshLoadingResultSP LoadMesh(std::string const& fileName, TextureLoadingFunction const& loadTexture);
+		/*
+		 *	@optimizationStatistics: owned by caller, filled with statistics of each triangle layout, left empty if optimization is disabled.
+		 *		MeshLoader keeps no state of a load, so one loader can be used by several loading threads.
+		 */
+		MeshLoadingResultSP LoadMesh(std::string const& fileName, TextureLoadingFunction const& loadTexture, std::vector<OptimizationStatistics>* optimizationStatistics);
+
+		/*
+		 *	Binary cache of a loaded model, vertex and index data are mapped from the file and passed to buffer creation as they are.
+		 *	Textures are still referenced by path and loaded by their own loader.
+		 *	@return: fileName with cache file extension appended, where ResourceManager looks for the cache of a model.
+		 */
+		static std::string GetMeshCacheFileName(std::string const& fileName);
+		/*
+		 *	Write data of a result returned by LoadMesh or LoadMeshCache, must be called before the mesh is created.
+		 *	Files read to import the model, such as material libraries, are recorded with their last write time.
+		 *	@return: false if the result has no data or file can not be written.
+		 */
+		bool SaveMeshCache(MeshLoadingResultSP const& loadingResult, std::string const& cacheFileName);
+		/*
+		 *	Reads every byte of vertex and index data of a result returned by LoadMesh or LoadMeshCache, as creating the mesh does.
+		 *	@return: hash of the data, the same for an imported model and its cache. 0 if the result has no data or the mesh is created.
+		 */
+		static uint64 HashMeshData(MeshLoadingResultSP const& loadingResult);
+		/*
+		 *	@return: failed result if the file is missing, broken, of another cache version, or any file the model was imported from changed.
+		 */
+		MeshLoadingResultSP LoadMeshCache(std::string const& cacheFileName);
+		MeshLoadingResultSP LoadMeshCache(std::string const& cacheFileName, TextureLoadingFunction const& loadTexture);
+
+	private:
+		bool optimizationEnabled_;
 	};
 
 }
@@ -0,0 +1,323 @@
+#include "XREX.hpp"
+
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace XREX
+{
+	namespace
+	{
+		uint32 const NoVertex = ~0u;
+
+		/*
+		 *	Triangles using each vertex, a triangle using a vertex twice is listed twice.
+		 */
+		struct VertexAdjacency
+		{
+			std::vector<uint32> offsets;
+			std::vector<uint32> triangles;
+
+			VertexAdjacency(uint32 const* indices, uint32 indexCount, uint32 vertexCount)
+				: offsets(vertexCount + 1, 0), triangles(indexCount)
+			{
+				for (uint32 i = 0; i < indexCount; ++i)
+				{
+					++offsets[indices[i] + 1];
+				}
+				for (uint32 v = 0; v < vertexCount; ++v)
+				{
+					offsets[v + 1] += offsets[v];
+				}
+				std::vector<uint32> filled(offsets.begin(), offsets.end() - 1);
+				for (uint32 i = 0; i < indexCount; ++i)
+				{
+					triangles[filled[indices[i]]++] = i / 3;
+				}
+			}
+		};
+
+		floatV3 LoadPosition(uint8 const* positions, uint32 vertexStride, uint32 vertex)
+		{
+			floatV3 position;
+			memcpy(&position, positions + vertex * vertexStride, sizeof(position));
+			return position;
+		}
+	}
+
+
+
+	VertexCacheStatistics AnalyzeVertexCache(uint32 const* indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize)
+	{
+		VertexCacheStatistics statistics;
+		if (indexCount < 3)
+		{
+			return statistics;
+		}
+		// a vertex is in the FIFO cache if it was inserted within last cacheSize insertions
+		std::vector<uint32> insertedTime(vertexCount, 0);
+		std::vector<bool> referenced(vertexCount, false);
+		uint32 time = cacheSize + 1;
+		uint32 missCount = 0;
+		uint32 referencedCount = 0;
+		for (uint32 i = 0; i < indexCount; ++i)
+		{
+			uint32 vertex = indices[i];
+			assert(vertex < vertexCount);
+			if (!referenced[vertex])
+			{
+				referenced[vertex] = true;
+				++referencedCount;
+			}
+			if (time - insertedTime[vertex] > cacheSize)
+			{
+				insertedTime[vertex] = time++;
+				++missCount;
+			}
+		}
+		statistics.acmr = static_cast<float>(missCount) / (indexCount / 3);
+		statistics.atvr = static_cast<float>(missCount) / referencedCount;
+		return statistics;
+	}
+
+	std::vector<uint32> OptimizeVertexCache(uint32* indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize)
+	{
+		std::vector<uint32> clusters;
+		uint32 triangleCount = indexCount / 3;
+		if (triangleCount == 0)
+		{
+			return clusters;
+		}
+		VertexAdjacency adjacency(indices, triangleCount * 3, vertexCount);
+		std::vector<uint32> liveTriangleCount(vertexCount);
+		for (uint32 v = 0; v < vertexCount; ++v)
+		{
+			liveTriangleCount[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+		}
+		std::vector<uint32> insertedTime(vertexCount, 0);
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32> deadEnds;
+		std::vector<uint32> candidates;
+		std::vector<uint32> result;
+		result.reserve(triangleCount * 3);
+		uint32 time = cacheSize + 1;
+		uint32 cursor = 0;
+
+		// vertices of recently emitted triangles, then vertices in input order
+		auto skipDeadEnd = [&] () -> uint32
+		{
+			while (!deadEnds.empty())
+			{
+				uint32 vertex = deadEnds.back();
+				deadEnds.pop_back();
+				if (liveTriangleCount[vertex] > 0)
+				{
+					return vertex;
+				}
+			}
+			while (cursor < triangleCount * 3)
+			{
+				uint32 vertex = indices[cursor++];
+				if (liveTriangleCount[vertex] > 0)
+				{
+					return vertex;
+				}
+			}
+			return NoVertex;
+		};
+
+		clusters.push_back(0);
+		uint32 fanning = indices[0];
+		while (fanning != NoVertex)
+		{
+			// emit all remaining triangles around the fanning vertex
+			candidates.clear();
+			for (uint32 i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; ++i)
+			{
+				uint32 triangle = adjacency.triangles[i];
+				if (emitted[triangle])
+				{
+					continue;
+				}
+				emitted[triangle] = true;
+				for (uint32 k = 0; k < 3; ++k)
+				{
+					uint32 vertex = indices[triangle * 3 + k];
+					result.push_back(vertex);
+					deadEnds.push_back(vertex);
+					candidates.push_back(vertex);
+					--liveTriangleCount[vertex];
+					if (time - insertedTime[vertex] > cacheSize)
+					{
+						insertedTime[vertex] = time++;
+					}
+				}
+			}
+
+			// next fanning vertex is the oldest candidate still in cache after its remaining triangles are emitted
+			uint32 next = NoVertex;
+			int32 bestPriority = -1;
+			for (uint32 vertex : candidates)
+			{
+				if (liveTriangleCount[vertex] == 0)
+				{
+					continue;
+				}
+				int32 priority = 0;
+				if (time - insertedTime[vertex] + 2 * liveTriangleCount[vertex] <= cacheSize)
+				{
+					priority = static_cast<int32>(time - insertedTime[vertex]);
+				}
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = vertex;
+				}
+			}
+			if (next == NoVertex)
+			{
+				next = skipDeadEnd();
+				if (next != NoVertex)
+				{
+					clusters.push_back(result.size() / 3);
+				}
+			}
+			fanning = next;
+		}
+
+		assert(result.size() == triangleCount * 3);
+		std::copy(result.begin(), result.end(), indices);
+		return clusters;
+	}
+
+	void OptimizeOverdraw(uint32* indices, uint32 indexCount, uint8 const* positions, uint32 vertexStride, uint32 vertexCount, std::vector<uint32> const& clusters,
+		uint32 cacheSize, float threshold)
+	{
+		uint32 triangleCount = indexCount / 3;
+		if (triangleCount == 0 || clusters.empty())
+		{
+			return;
+		}
+		assert(clusters[0] == 0);
+
+		// soft boundaries: split where the cluster so far already reuses the cache as well as the whole mesh
+		float splitACMR = AnalyzeVertexCache(indices, triangleCount * 3, vertexCount, cacheSize).acmr * threshold;
+		std::vector<uint32> splitClusters;
+		std::vector<uint32> insertedTime(vertexCount, 0);
+		uint32 time = cacheSize + 1;
+		for (uint32 c = 0; c < clusters.size(); ++c)
+		{
+			uint32 end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+			uint32 missCount = 0;
+			splitClusters.push_back(clusters[c]);
+			time += cacheSize + 1; // clusters are reordered, so each one starts with an empty cache
+			for (uint32 triangle = clusters[c]; triangle < end; ++triangle)
+			{
+				for (uint32 k = 0; k < 3; ++k)
+				{
+					uint32 vertex = indices[triangle * 3 + k];
+					if (time - insertedTime[vertex] > cacheSize)
+					{
+						insertedTime[vertex] = time++;
+						++missCount;
+					}
+				}
+				if (triangle + 1 < end && missCount <= splitACMR * (triangle + 1 - splitClusters.back()))
+				{
+					splitClusters.push_back(triangle + 1);
+					missCount = 0;
+					time += cacheSize + 1;
+				}
+			}
+		}
+
+		// occlusion potential of a cluster: how far it faces away from the mesh center
+		std::vector<floatV3> clusterCenters(splitClusters.size(), floatV3::Zero);
+		std::vector<floatV3> clusterNormals(splitClusters.size(), floatV3::Zero);
+		floatV3 meshCenter = floatV3::Zero;
+		float meshArea = 0;
+		for (uint32 c = 0; c < splitClusters.size(); ++c)
+		{
+			uint32 end = c + 1 < splitClusters.size() ? splitClusters[c + 1] : triangleCount;
+			float clusterArea = 0;
+			for (uint32 triangle = splitClusters[c]; triangle < end; ++triangle)
+			{
+				floatV3 position0 = LoadPosition(positions, vertexStride, indices[triangle * 3]);
+				floatV3 position1 = LoadPosition(positions, vertexStride, indices[triangle * 3 + 1]);
+				floatV3 position2 = LoadPosition(positions, vertexStride, indices[triangle * 3 + 2]);
+				floatV3 normal = Cross(position1 - position0, position2 - position0); // length is twice the area
+				float area = normal.Length();
+				floatV3 center = (position0 + position1 + position2) / 3.f;
+				clusterCenters[c] = clusterCenters[c] + center * area;
+				clusterNormals[c] = clusterNormals[c] + normal;
+				clusterArea += area;
+			}
+			meshCenter = meshCenter + clusterCenters[c];
+			meshArea += clusterArea;
+			if (clusterArea > 0)
+			{
+				clusterCenters[c] = clusterCenters[c] / clusterArea;
+			}
+		}
+		if (meshArea > 0)
+		{
+			meshCenter = meshCenter / meshArea;
+		}
+		std::vector<float> occlusionPotentials(splitClusters.size());
+		for (uint32 c = 0; c < splitClusters.size(); ++c)
+		{
+			float normalLength = clusterNormals[c].Length();
+			occlusionPotentials[c] = normalLength > 0 ? Dot(clusterCenters[c] - meshCenter, clusterNormals[c] / normalLength) : 0;
+		}
+
+		std::vector<uint32> order(splitClusters.size());
+		for (uint32 c = 0; c < order.size(); ++c)
+		{
+			order[c] = c;
+		}
+		std::stable_sort(order.begin(), order.end(), [&occlusionPotentials] (uint32 left, uint32 right)
+		{
+			return occlusionPotentials[left] > occlusionPotentials[right];
+		});
+
+		std::vector<uint32> result;
+		result.reserve(triangleCount * 3);
+		for (uint32 c : order)
+		{
+			uint32 end = c + 1 < splitClusters.size() ? splitClusters[c + 1] : triangleCount;
+			result.insert(result.end(), indices + splitClusters[c] * 3, indices + end * 3);
+		}
+		std::copy(result.begin(), result.end(), indices);
+	}
+
+	void OptimizeVertexFetch(uint8* vertices, uint32 vertexStride, uint32 vertexCount, uint32* indices, uint32 indexCount)
+	{
+		std::vector<uint32> remap(vertexCount, NoVertex);
+		uint32 newCount = 0;
+		for (uint32 i = 0; i < indexCount; ++i)
+		{
+			uint32& newIndex = remap[indices[i]];
+			if (newIndex == NoVertex)
+			{
+				newIndex = newCount++;
+			}
+			indices[i] = newIndex;
+		}
+		for (uint32 v = 0; v < vertexCount; ++v)
+		{
+			if (remap[v] == NoVertex)
+			{
+				remap[v] = newCount++;
+			}
+		}
+
+		std::vector<uint8> result(vertexCount * vertexStride);
+		for (uint32 v = 0; v < vertexCount; ++v)
+		{
+			memcpy(&result[remap[v] * vertexStride], vertices + v * vertexStride, vertexStride);
+		}
+		std::copy(result.begin(), result.end(), vertices);
+	}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Reordering of indexed triangle lists for the GPU, run when meshes are imported.
+	 *	All of them are deterministic and keep the set of triangles and the winding of each one.
+	 *	Usual order: OptimizeVertexCache, then OptimizeOverdraw with its clusters, then OptimizeVertexFetch.
+	 */
+
+	/*
+	 *	Post transform vertex cache is modeled as FIFO of this many vertices.
+	 */
+	uint32 const DefaultVertexCacheSize = 16;
+
+	struct XREX_API VertexCacheStatistics
+	{
+		/*
+		 *	Average cache miss ratio, transformed vertices per triangle, 0.5 at best for large regular meshes, 3 at worst.
+		 */
+		float acmr;
+		/*
+		 *	Average transformed to vertex ratio, transformed vertices per referenced vertex, 1 at best.
+		 */
+		float atvr;
+
+		VertexCacheStatistics()
+			: acmr(0), atvr(0)
+		{
+		}
+	};
+
+	XREX_API VertexCacheStatistics AnalyzeVertexCache(uint32 const* indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize = DefaultVertexCacheSize);
+
+	/*
+	 *	Tipsify of Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced Overdraw. Linear time.
+	 *	@return: first triangle of each cluster, starting with 0. A cluster starts where the cache is effectively flushed,
+	 *		so clusters can be reordered without much loss of cache reuse.
+	 */
+	XREX_API std::vector<uint32> OptimizeVertexCache(uint32* indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize = DefaultVertexCacheSize);
+
+	/*
+	 *	Split clusters further where their ACMR drops to threshold times ACMR of the whole mesh, then sort clusters
+	 *	facing outwards from the mesh center first, so they tend to be drawn before triangles they occlude.
+	 *	@positions: float x, y, z of each vertex, vertexStride bytes apart.
+	 *	@clusters: returned by OptimizeVertexCache for the same indices.
+	 *	@threshold: larger values split more clusters, reducing overdraw at the cost of ACMR.
+	 */
+	XREX_API void OptimizeOverdraw(uint32* indices, uint32 indexCount, uint8 const* positions, uint32 vertexStride, uint32 vertexCount, std::vector<uint32> const& clusters,
+		uint32 cacheSize = DefaultVertexCacheSize, float threshold = 1.05f);
+
+	/*
+	 *	Reorder vertices in order of first use by indices and remap indices, so vertices are fetched mostly sequentially.
+	 *	Vertices not referenced are moved to the end.
+	 */
+	XREX_API void OptimizeVertexFetch(uint8* vertices, uint32 vertexStride, uint32 vertexCount, uint32* indices, uint32 indexCount);
+
+}
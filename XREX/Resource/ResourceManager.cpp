@@ -4,22 +4,24 @@
 
 #include "Base/XREXContext.hpp"
 #include "Resource/LocalResourceLoader.hpp"
+#include "Resource/TextureLoader.hpp"
 #include "Rendering/Texture.hpp"
 #include "Rendering/Mesh.hpp"
 #include "Rendering/RenderingTechnique.hpp"
+#include "Base/FileSystem.hpp"
 
 
-#include <filesystem>
+#include <future>
 
 namespace XREX
 {
 	namespace
 	{
-		bool Locate(std::vector<std::tr2::sys::path> const& locations, bool containsDirectory, std::tr2::sys::path const& path, std::tr2::sys::path* locatedPath)
+		bool Locate(std::vector<FileSystem::path> const& locations, bool containsDirectory, FileSystem::path const& path, FileSystem::path* locatedPath)
 		{
 			if (path.has_root_path())
 			{
-				if (std::tr2::sys::exists(path) && std::tr2::sys::is_regular(path))
+				if (FileSystem::exists(path) && FileSystem::IsRegularFile(path))
 				{
 					*locatedPath = path;
 					return true;
@@ -27,17 +29,17 @@ namespace XREX
 			}
 			else
 			{
-				for (std::tr2::sys::path const& location : locations)
+				for (FileSystem::path const& location : locations)
 				{
-					std::tr2::sys::path pathToTry = location / path;
+					FileSystem::path pathToTry = location / path;
 					bool found = false;
 					if (!containsDirectory)
 					{
-						found = std::tr2::sys::exists(pathToTry) && std::tr2::sys::is_regular(pathToTry);
+						found = FileSystem::exists(pathToTry) && FileSystem::IsRegularFile(pathToTry);
 					}
 					else
 					{
-						found = std::tr2::sys::exists(pathToTry) && (std::tr2::sys::is_regular(pathToTry) || std::tr2::sys::is_directory(pathToTry));
+						found = FileSystem::exists(pathToTry) && (FileSystem::IsRegularFile(pathToTry) || FileSystem::is_directory(pathToTry));
 					}
 					if (found)
 					{
@@ -49,10 +51,10 @@ namespace XREX
 			return false;
 		}
 
-		bool LocatePathString(std::vector<std::tr2::sys::path> const& locations, bool containsDirectory, std::string const& relativePath, std::string* resultPath)
+		bool LocatePathString(std::vector<FileSystem::path> const& locations, bool containsDirectory, std::string const& relativePath, std::string* resultPath)
 		{
-			std::tr2::sys::path resourceLocation;
-			if (!Locate(locations, containsDirectory, std::tr2::sys::path(relativePath), &resourceLocation))
+			FileSystem::path resourceLocation;
+			if (!Locate(locations, containsDirectory, FileSystem::path(relativePath), &resourceLocation))
 			{
 				return false;
 			}
@@ -64,18 +66,18 @@ namespace XREX
 
 	struct ResourceManager::HideFileSystemHeader
 	{
-		std::tr2::sys::path rootPath;
-		std::vector<std::tr2::sys::path> paths;
+		FileSystem::path rootPath;
+		std::vector<FileSystem::path> paths;
 		HideFileSystemHeader(std::string const& root)
-			: rootPath(std::tr2::sys::complete(std::tr2::sys::path(root)))
+			: rootPath(FileSystem::Complete(FileSystem::path(root)))
 		{
-			assert(std::tr2::sys::exists(rootPath) && std::tr2::sys::is_directory(rootPath));
+			assert(FileSystem::exists(rootPath) && FileSystem::is_directory(rootPath));
 			paths.push_back(rootPath);
 		}
 	};
 
-	ResourceManager::ResourceManager(std::string const& rootPath)
-		: hideFileSystemHeader_(MakeUP<HideFileSystemHeader>(rootPath))
+	ResourceManager::ResourceManager(std::string const& rootPath, uint32 loadingThreadCount)
+		: hideFileSystemHeader_(MakeUP<HideFileSystemHeader>(rootPath)), meshCacheEnabled_(true), asyncLoader_(MakeUP<AsyncResourceLoader>(loadingThreadCount))
 	{
 	}
 
@@ -86,12 +88,13 @@ namespace XREX
 
 	bool ResourceManager::AddResourceLocation(std::string const& path)
 	{
-		std::tr2::sys::path pathObj = std::tr2::sys::path(path);
+		std::lock_guard<std::recursive_mutex> lock(mutex_);
+		FileSystem::path pathObj = FileSystem::path(path);
 		if (!pathObj.has_root_path())
 		{
 			pathObj = hideFileSystemHeader_->rootPath / pathObj;
 		}
-		if (std::tr2::sys::exists(pathObj) && std::tr2::sys::is_directory(pathObj))
+		if (FileSystem::exists(pathObj) && FileSystem::is_directory(pathObj))
 		{
 			if (std::find(hideFileSystemHeader_->paths.begin(), hideFileSystemHeader_->paths.end(), pathObj) == hideFileSystemHeader_->paths.end())
 			{
@@ -104,6 +107,7 @@ namespace XREX
 
 	bool ResourceManager::LocatePath(std::string const& relativePath, std::string* resultPath)
 	{
+		std::lock_guard<std::recursive_mutex> lock(mutex_);
 		return LocatePathString(hideFileSystemHeader_->paths, true, relativePath, resultPath);
 	}
 
@@ -114,7 +118,19 @@ namespace XREX
 		struct LoadingResultProxy
 			: LoadingResult<Type>
 		{
+			/*
+			 *	Tag of a proxy whose result is given later by Publish.
+			 */
+			struct Pending
+			{
+			};
+
 			std::shared_ptr<LoadingResult<Type>> actualResult;
+			/*
+			 *	Valid for pending proxies, requests of the same file made before Publish wait on it.
+			 */
+			std::promise<std::shared_ptr<LoadingResult<Type>>> publishedResult;
+			std::shared_future<std::shared_ptr<LoadingResult<Type>>> publishedResultFuture;
 			std::shared_ptr<Type> object;
 			std::function<void(std::shared_ptr<Type> const& loadedObject)> onLoad;
 
@@ -122,6 +138,11 @@ namespace XREX
 			{
 			}
 
+			explicit LoadingResultProxy(Pending)
+				: publishedResultFuture(publishedResult.get_future().share())
+			{
+			}
+
 			LoadingResultProxy(std::shared_ptr<LoadingResult<Type>> const& result)
 				: actualResult(result)
 			{
@@ -136,9 +157,30 @@ namespace XREX
 				onLoad = std::move(callback);
 			}
 
+			/*
+			 *	Give the result of the loading function to a pending proxy, called once by the thread running it.
+			 */
+			void Publish(std::shared_ptr<LoadingResult<Type>> const& result)
+			{
+				assert(publishedResultFuture.valid());
+				publishedResult.set_value(result);
+			}
+
+			/*
+			 *	Waits for Publish if pending.
+			 */
+			std::shared_ptr<LoadingResult<Type>> const& GetActualResult() const
+			{
+				return publishedResultFuture.valid() ? publishedResultFuture.get() : actualResult;
+			}
+
 			virtual bool Succeeded() const override
 			{
-				return object || (actualResult && actualResult->Succeeded());
+				return object || (GetActualResult() && GetActualResult()->Succeeded());
+			}
+			virtual uint64 GetDataSize() const override
+			{
+				return !object && GetActualResult() ? GetActualResult()->GetDataSize() : 0;
 			}
 			virtual std::shared_ptr<Type> Create() override
 			{
@@ -146,9 +188,10 @@ namespace XREX
 				{
 					return object; // already loaded
 				}
-				if (actualResult && actualResult->Succeeded())
+				std::shared_ptr<LoadingResult<Type>> const& result = GetActualResult();
+				if (result && result->Succeeded())
 				{
-					object = actualResult->Create();
+					object = result->Create();
 					onLoad(object); // the lambda in DoLoadTexture
 					return object;
 				}
@@ -159,89 +202,232 @@ namespace XREX
 			}
 		};
 
+		/*
+		 *	Callback to move the created object from objectLoadingCache to objects.
+		 */
+		template <typename Type>
+		std::function<void(std::shared_ptr<Type> const& object)> MakeCachingHandler(std::recursive_mutex& mutex,
+			std::unordered_map<std::string, std::shared_ptr<Type>>& objects, std::unordered_map<std::string, std::shared_ptr<LoadingResult<Type>>>& objectLoadingCache,
+			std::string const& fullPath)
+		{
+			return [&mutex, &objects, &objectLoadingCache, fullPath] (std::shared_ptr<Type> const& object)
+			{
+				std::lock_guard<std::recursive_mutex> lock(mutex);
+				auto found = objectLoadingCache.find(fullPath);
+				if (found == objectLoadingCache.end())
+				{
+					assert(false);
+				}
+				objectLoadingCache.erase(found);
+				objects.insert(std::make_pair(fullPath, object));
+			};
+		}
+
+		/*
+		 *	Asynchronous loading failed or cancelled, load again if requested again.
+		 */
 		template <typename Type>
-		std::shared_ptr<LoadingResult<Type>> DoLoad(std::vector<std::tr2::sys::path> const& paths,
+		void RemoveAbandonedLoading(std::unordered_map<std::string, std::shared_ptr<LoadingResult<Type>>>& objectLoadingCache, std::string const& fullPath)
+		{
+			auto found = objectLoadingCache.find(fullPath);
+			// asynchronous ones first, Succeeded of a pending synchronous loading waits for it.
+			if (found != objectLoadingCache.end() && std::dynamic_pointer_cast<AsyncLoadingResultBase>(found->second) && !found->second->Succeeded())
+			{
+				objectLoadingCache.erase(found);
+			}
+		}
+
+		/*
+		 *	The loading function runs without holding the mutex, so other threads can use the caches while a file is read and decoded.
+		 *	A pending entry is inserted first, requests of the same file meanwhile get it and wait for the result when they use it.
+		 */
+		template <typename Type>
+		std::shared_ptr<LoadingResult<Type>> DoLoad(std::vector<FileSystem::path> const& paths, std::recursive_mutex& mutex,
 			std::unordered_map<std::string, std::shared_ptr<Type>>& objects, std::unordered_map<std::string, std::shared_ptr<LoadingResult<Type>>>& objectLoadingCache,
 			std::string const& fileName, std::function<std::shared_ptr<LoadingResult<Type>>(std::string const& fileName)> const& loadingFunction)
 		{
 			std::string fullPath;
-			if (!LocatePathString(paths, false, fileName, &fullPath))
+			std::shared_ptr<LoadingResultProxy<Type>> proxy;
 			{
-				return MakeSP<LoadingResultProxy<Type>>(); // not found
-			}
-			auto found = objects.find(fullPath);
-			if (found == objects.end())
-			{ // not in object cache
-				auto foundInToLoad = objectLoadingCache.find(fullPath);
-				if (foundInToLoad == objectLoadingCache.end())
-				{ // and not in object loading cache
-					std::shared_ptr<LoadingResult<Type>> result = loadingFunction(fullPath);
-					std::shared_ptr<LoadingResultProxy<Type>> proxy = MakeSP<LoadingResultProxy<Type>>(result);
-					objectLoadingCache.insert(std::make_pair(fullPath, proxy));
-
-					// callback to do caching
-					auto onLoadHandler = [&objects, &objectLoadingCache, fullPath] (std::shared_ptr<Type> const& object)
-					{
-						auto found = objectLoadingCache.find(fullPath);
-						if (found == objectLoadingCache.end())
-						{
-							assert(false);
-						}
-						objectLoadingCache.erase(found);
-						objects.insert(std::make_pair(fullPath, object));
-					};
-					proxy->SetOnLoad(std::move(onLoadHandler));
-
-					return proxy;
+				std::lock_guard<std::recursive_mutex> lock(mutex);
+				if (!LocatePathString(paths, false, fileName, &fullPath))
+				{
+					return MakeSP<LoadingResultProxy<Type>>(); // not found
 				}
-				else // loaded but not created
+				RemoveAbandonedLoading(objectLoadingCache, fullPath);
+				auto found = objects.find(fullPath);
+				if (found != objects.end()) // already created object
+				{
+					return MakeSP<LoadingResultProxy<Type>>(found->second);
+				}
+				auto foundInToLoad = objectLoadingCache.find(fullPath);
+				if (foundInToLoad != objectLoadingCache.end()) // loaded but not created, being loaded by another thread, or being loaded asynchronously
 				{
 					return foundInToLoad->second;
 				}
+				proxy = MakeSP<LoadingResultProxy<Type>>(typename LoadingResultProxy<Type>::Pending());
+				proxy->SetOnLoad(MakeCachingHandler(mutex, objects, objectLoadingCache, fullPath));
+				objectLoadingCache.insert(std::make_pair(fullPath, proxy));
 			}
-			else // already created object
+			proxy->Publish(loadingFunction(fullPath));
+			return proxy;
+		}
+
+		/*
+		 *	Baked texture container next to the image is used if it is not older than the image, see TextureLoader::BakeTexture2D.
+		 */
+		std::string SelectTextureFile(std::string const& fullPath)
+		{
+			FileSystem::path containerPath(TextureLoader::GetTextureContainerFileName(fullPath));
+			if (FileSystem::exists(containerPath) && FileSystem::LastWriteTime(containerPath) >= FileSystem::LastWriteTime(FileSystem::path(fullPath)))
 			{
-				std::shared_ptr<LoadingResultProxy<Type>> proxy = MakeSP<LoadingResultProxy<Type>>(found->second);
-				return proxy;
+				return containerPath.string();
 			}
+			return fullPath;
+		}
+
+		/*
+		 *	Cache is written by whichever thread imports the model, a failed write only costs the next load an import again.
+		 */
+		MeshLoadingResultSP LoadMeshWithCache(std::string const& fullPath, bool useCache, MeshLoader::TextureLoadingFunction const& loadTexture)
+		{
+			LocalResourceLoader& loader = XREXContext::GetInstance().GetResourceLoader();
+			if (!useCache)
+			{
+				return loader.LoadMesh(fullPath, loadTexture);
+			}
+			std::string cacheFileName = MeshLoader::GetMeshCacheFileName(fullPath);
+			FileSystem::path cachePath(cacheFileName);
+			if (FileSystem::exists(cachePath) && FileSystem::LastWriteTime(cachePath) >= FileSystem::LastWriteTime(FileSystem::path(fullPath)))
+			{
+				MeshLoadingResultSP cached = loader.LoadMeshCache(cacheFileName, loadTexture);
+				if (cached->Succeeded())
+				{
+					return cached;
+				}
+			}
+			MeshLoadingResultSP result = loader.LoadMesh(fullPath, loadTexture);
+			if (result->Succeeded())
+			{
+				loader.SaveMeshCache(result, cacheFileName);
+			}
+			return result;
+		}
+
+		template <typename Type>
+		std::shared_ptr<AsyncLoadingResult<Type>> DoLoadAsync(std::vector<FileSystem::path> const& paths, std::recursive_mutex& mutex, AsyncResourceLoader& loader,
+			std::unordered_map<std::string, std::shared_ptr<Type>>& objects, std::unordered_map<std::string, std::shared_ptr<LoadingResult<Type>>>& objectLoadingCache,
+			std::string const& fileName, int32 priority,
+			std::function<std::shared_ptr<LoadingResult<Type>>(std::string const& fileName, AsyncLoadingResultBase& result)> const& decodingFunction)
+		{
+			std::lock_guard<std::recursive_mutex> lock(mutex);
+			std::string fullPath;
+			if (!LocatePathString(paths, false, fileName, &fullPath))
+			{
+				return MakeSP<AsyncLoadingResult<Type>>(); // not found
+			}
+			RemoveAbandonedLoading(objectLoadingCache, fullPath);
+			auto found = objects.find(fullPath);
+			if (found != objects.end()) // already created object
+			{
+				return MakeSP<AsyncLoadingResult<Type>>(found->second);
+			}
+			auto foundInToLoad = objectLoadingCache.find(fullPath);
+			if (foundInToLoad != objectLoadingCache.end())
+			{
+				std::shared_ptr<AsyncLoadingResult<Type>> loading = std::dynamic_pointer_cast<AsyncLoadingResult<Type>>(foundInToLoad->second);
+				if (loading)
+				{
+					loading->RaisePriority(priority);
+					return loading;
+				}
+				// loaded synchronously but not created, let loader create it, the proxy caches the object.
+				std::shared_ptr<LoadingResult<Type>> loaded = foundInToLoad->second;
+				std::shared_ptr<AsyncLoadingResult<Type>> result = MakeSP<AsyncLoadingResult<Type>>([loaded] (AsyncLoadingResultBase&)
+				{
+					return loaded;
+				}, priority);
+				loader.Load(result);
+				return result;
+			}
+			std::shared_ptr<AsyncLoadingResult<Type>> result = MakeSP<AsyncLoadingResult<Type>>([decodingFunction, fullPath] (AsyncLoadingResultBase& self)
+			{
+				return decodingFunction(fullPath, self);
+			}, priority);
+			objectLoadingCache.insert(std::make_pair(fullPath, result));
+			result->SetOnCreate(MakeCachingHandler(mutex, objects, objectLoadingCache, fullPath));
+			loader.Load(result);
+			return result;
 		}
 	}
 
 	TextureLoadingResultSP ResourceManager::LoadTexture1D(std::string const& fileName)
 	{
-		return DoLoad<Texture>(hideFileSystemHeader_->paths, texture1Ds_, texture1DsToLoad_, fileName, [] (std::string const& fullPath)
+		return DoLoad<Texture>(hideFileSystemHeader_->paths, mutex_, texture1Ds_, texture1DsToLoad_, fileName, [] (std::string const& fullPath)
 		{
-			return XREXContext::GetInstance().GetResourceLoader().LoadTexture1D(fullPath, true);
+			return XREXContext::GetInstance().GetResourceLoader().LoadTexture1D(SelectTextureFile(fullPath), true);
 		});
 	}
 
 	TextureLoadingResultSP ResourceManager::LoadTexture2D(std::string const& fileName)
 	{
-		return DoLoad<Texture>(hideFileSystemHeader_->paths, texture2Ds_, texture2DsToLoad_, fileName, [] (std::string const& fullPath)
+		return DoLoad<Texture>(hideFileSystemHeader_->paths, mutex_, texture2Ds_, texture2DsToLoad_, fileName, [] (std::string const& fullPath)
 		{
-			return XREXContext::GetInstance().GetResourceLoader().LoadTexture2D(fullPath, true);
+			return XREXContext::GetInstance().GetResourceLoader().LoadTexture2D(SelectTextureFile(fullPath), true);
 		});
 	}
 
 	TextureLoadingResultSP ResourceManager::LoadTexture3D(std::string const& fileName)
 	{
-		return DoLoad<Texture>(hideFileSystemHeader_->paths, texture3Ds_, texture3DsToLoad_, fileName, [] (std::string const& fullPath)
+		return DoLoad<Texture>(hideFileSystemHeader_->paths, mutex_, texture3Ds_, texture3DsToLoad_, fileName, [] (std::string const& fullPath)
 		{
-			return XREXContext::GetInstance().GetResourceLoader().LoadTexture3D(fullPath, true);
+			return XREXContext::GetInstance().GetResourceLoader().LoadTexture3D(SelectTextureFile(fullPath), true);
 		});
 	}
 
 	MeshLoadingResultSP ResourceManager::LoadModel(std::string const& fileName)
 	{
-		return DoLoad<Mesh>(hideFileSystemHeader_->paths, meshes_, meshesToLoad_, fileName, [] (std::string const& fullPath)
+		return DoLoad<Mesh>(hideFileSystemHeader_->paths, mutex_, meshes_, meshesToLoad_, fileName, [this] (std::string const& fullPath)
+		{
+			return LoadMeshWithCache(fullPath, meshCacheEnabled_, [this] (std::string const& textureFileName)
+			{
+				return LoadTexture2D(textureFileName);
+			});
+		});
+	}
+
+	AsyncTextureLoadingResultSP ResourceManager::LoadTexture2DAsync(std::string const& fileName, int32 priority)
+	{
+		return DoLoadAsync<Texture>(hideFileSystemHeader_->paths, mutex_, *asyncLoader_, texture2Ds_, texture2DsToLoad_, fileName, priority,
+			[] (std::string const& fullPath, AsyncLoadingResultBase& result)
+		{
+			return XREXContext::GetInstance().GetResourceLoader().LoadTexture2D(SelectTextureFile(fullPath), true);
+		});
+	}
+
+	AsyncMeshLoadingResultSP ResourceManager::LoadModelAsync(std::string const& fileName, int32 priority)
+	{
+		return DoLoadAsync<Mesh>(hideFileSystemHeader_->paths, mutex_, *asyncLoader_, meshes_, meshesToLoad_, fileName, priority,
+			[this] (std::string const& fullPath, AsyncLoadingResultBase& result)
 		{
-			return XREXContext::GetInstance().GetResourceLoader().LoadMesh(fullPath);
+			return LoadMeshWithCache(fullPath, meshCacheEnabled_, [this, &result] (std::string const& textureFileName) -> TextureLoadingResultSP
+			{
+				AsyncTextureLoadingResultSP texture = LoadTexture2DAsync(textureFileName, result.GetPriority());
+				result.AddDependency(texture);
+				return texture;
+			});
 		});
 	}
 
+	AsyncResourceLoader::UploadStatistics ResourceManager::UploadLoadedResources(double timeBudget, uint64 byteBudget)
+	{
+		lastUploadStatistics_ = asyncLoader_->Upload(timeBudget, byteBudget);
+		return lastUploadStatistics_;
+	}
+
 	XREX::TechniqueLoadingResultSP ResourceManager::LoadTechnique(std::string const& fileName, std::vector<std::pair<std::string, std::string>> macros)
 	{
-		return DoLoad<RenderingTechnique>(hideFileSystemHeader_->paths, techniques_, techniquesToLoad_, fileName, [&macros] (std::string const& fullPath)
+		return DoLoad<RenderingTechnique>(hideFileSystemHeader_->paths, mutex_, techniques_, techniquesToLoad_, fileName, [&macros] (std::string const& fullPath)
 		{
 			return XREXContext::GetInstance().GetResourceLoader().LoadTechnique(fullPath, std::move(macros)); // TODO macros not participate cache, need to be considered same as path.
 		});
@@ -249,7 +435,7 @@ namespace XREX
 
 	XREX::FrameBufferLoadingResultSP ResourceManager::LoadFrameBuffer(std::string const& fileName)
 	{
-		return DoLoad<FrameBuffer>(hideFileSystemHeader_->paths, framebuffers_, framebuffersToLoad_, fileName, [] (std::string const& fullPath)
+		return DoLoad<FrameBuffer>(hideFileSystemHeader_->paths, mutex_, framebuffers_, framebuffersToLoad_, fileName, [] (std::string const& fullPath)
 		{
 			return XREXContext::GetInstance().GetResourceLoader().LoadFrameBuffer(fullPath);
 		});
@@ -2,9 +2,12 @@
 
 #include "Declare.hpp"
 #include "LoadingResult.hpp"
+#include "AsyncResourceLoader.hpp"
 
 #include <unordered_map>
 #include <string>
+#include <mutex>
+#include <atomic>
 
 namespace XREX
 {
@@ -13,7 +16,10 @@ namespace XREX
 		: Noncopyable
 	{
 	public:
-		ResourceManager(std::string const& rootPath);
+		/*
+		 *	@loadingThreadCount: threads of AsyncResourceLoader decoding asynchronously loaded resources.
+		 */
+		ResourceManager(std::string const& rootPath, uint32 loadingThreadCount = 2);
 		~ResourceManager();
 
 		/*
@@ -22,13 +28,58 @@ namespace XREX
 		bool AddResourceLocation(std::string const& path);
 		bool LocatePath(std::string const& relativePath, std::string* resultPath);
 
+		/*
+		 *	Baked texture container next to the image is loaded instead if it is not older, see TextureLoader::BakeTexture2D.
+		 */
 		TextureLoadingResultSP LoadTexture1D(std::string const& fileName);
 		TextureLoadingResultSP LoadTexture2D(std::string const& fileName);
 		TextureLoadingResultSP LoadTexture3D(std::string const& fileName);
 		TextureLoadingResultSP LoadTextureCube(std::string const& fileName);
 
+		/*
+		 *	Loads the mesh cache next to the model file if it is not older than the model and files it references are unchanged,
+		 *	see MeshLoader::GetMeshCacheFileName and MeshLoader::LoadMeshCache.
+		 *	Otherwise the model is imported and the cache is written for next time.
+		 */
 		MeshLoadingResultSP LoadModel(std::string const& fileName);
 
+		/*
+		 *	Return immediately, file is read and decoded by a loading thread, texture is created by UploadLoadedResources.
+		 *	Results share the cache of LoadTexture2D.
+		 *	@priority: larger ones are decoded and created earlier. Requesting a file being loaded raises its priority.
+		 */
+		AsyncTextureLoadingResultSP LoadTexture2DAsync(std::string const& fileName, int32 priority = 0);
+		/*
+		 *	Textures of the model are loaded asynchronously with the same priority, mesh is created after all of them.
+		 */
+		AsyncMeshLoadingResultSP LoadModelAsync(std::string const& fileName, int32 priority = 0);
+
+		/*
+		 *	Create decoded asynchronously loaded resources within the budget.
+		 *	Called on the context thread by XREXContext every frame, see Settings::resourceUploadTimeBudget.
+		 */
+		AsyncResourceLoader::UploadStatistics UploadLoadedResources(double timeBudget, uint64 byteBudget);
+		AsyncResourceLoader::UploadStatistics const& GetLastUploadStatistics() const
+		{
+			return lastUploadStatistics_;
+		}
+		AsyncResourceLoader& GetAsyncLoader() const
+		{
+			return *asyncLoader_;
+		}
+
+		/*
+		 *	Enabled by default. When disabled, models are always imported and no cache is written.
+		 */
+		void SetMeshCacheEnabled(bool enabled)
+		{
+			meshCacheEnabled_ = enabled;
+		}
+		bool IsMeshCacheEnabled() const
+		{
+			return meshCacheEnabled_;
+		}
+
 		TechniqueLoadingResultSP LoadTechnique(std::string const& fileName, std::vector<std::pair<std::string, std::string>> macros);
 		FrameBufferLoadingResultSP LoadFrameBuffer(std::string const& fileName);
 
@@ -49,6 +100,18 @@ namespace XREX
 
 		struct HideFileSystemHeader;
 		std::unique_ptr<HideFileSystemHeader> hideFileSystemHeader_;
+
+		/*
+		 *	Guards the caches, loading threads request textures of models being loaded asynchronously.
+		 *	Not held while files are read and decoded, a file being loaded by one thread is waited for by others requesting it.
+		 */
+		std::recursive_mutex mutex_;
+		std::atomic<bool> meshCacheEnabled_;
+		AsyncResourceLoader::UploadStatistics lastUploadStatistics_;
+		/*
+		 *	Declared last to stop loading threads first, they use the caches.
+		 */
+		std::unique_ptr<AsyncResourceLoader> asyncLoader_;
 	};
 
 }
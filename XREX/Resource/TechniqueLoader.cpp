@@ -8,11 +8,11 @@
 #include "Base/XREXContext.hpp"
 #include "Resource/LocalResourceLoader.hpp"
 #include "Base/Logger.hpp"
+#include "Base/FileSystem.hpp"
 
 #include <rapidxml/rapidxml.hpp>
 
 #include <sstream>
-#include <filesystem>
 
 #pragma warning(push)
 #pragma warning(disable: 4573) // a bug, static member function used in lambda caused the compiler to think this pointer is needed.
@@ -30,7 +30,7 @@ namespace XREX
 				: message_("Type: " + type + " do not have a Enumeration: " + value)
 			{
 			}
-			virtual char const* what() const override
+			virtual char const* what() const throw() override
 			{
 				return message_.c_str();
 			}
@@ -154,6 +154,11 @@ namespace XREX
 				temp["Depth32F"] = TexelFormat::Depth32F;
 				temp["Depth24Stencil8"] = TexelFormat::Depth24Stencil8;
 				temp["Stencil8"] = TexelFormat::Stencil8;
+				temp["BC1"] = TexelFormat::BC1;
+				temp["BC3"] = TexelFormat::BC3;
+				temp["BC4"] = TexelFormat::BC4;
+				temp["BC5"] = TexelFormat::BC5;
+				temp["BC7"] = TexelFormat::BC7;
 				return temp;
 			} ();
 			auto found = TexelFormats.find(name);
@@ -465,7 +470,7 @@ namespace XREX
 			FrameBufferDescriptionGenerator(LoadCache& cache, std::string const& fullPath)
 				: cache(cache), fullPath(fullPath)
 			{
-				std::tr2::sys::path fullTechniquePath(fullPath);
+				FileSystem::path fullTechniquePath(fullPath);
 				directoryPath = fullTechniquePath.parent_path().string() + "/";
 				fileName = fullTechniquePath.filename();
 
@@ -736,7 +741,7 @@ namespace XREX
 			TechniqueInformationGenerator(LoadCache& cache, std::string const& fullPath)
 				: cache(cache), fullPath(fullPath)
 			{
-				std::tr2::sys::path fullTechniquePath(fullPath);
+				FileSystem::path fullTechniquePath(fullPath);
 				directoryPath = fullTechniquePath.parent_path().string() + "/";
 				fileName = fullTechniquePath.filename();
 
@@ -955,7 +960,7 @@ namespace XREX
 						std::string noUse(attribute->value());
 						std::stringstream ss(noUse);
 						std::array<float, 4> value;
-						value.assign(0);
+						value.fill(0);
 						ss >> value[0] >> noUse >> value[1] >> noUse >> value[2] >> noUse >> value[3];
 						// XREXContext::GetInstance().GetLogger().BeginLine().Log("Color format error: \'").Log(colorString).Log("\", should be \"x,x,x,x\".").EndLine();
 						state.borderColor = Color(value[0], value[1], value[2], value[3]);
@@ -1390,7 +1395,7 @@ namespace XREX
 					bufferValid = false;
 				}
 
-				std::vector<VariableInformation const> variableInformations;
+				std::vector<VariableInformation> variableInformations;
 				std::unordered_set<std::string> nameDeclared;
 
 				for (rapidxml::xml_node<>* subNode = node->first_node(); subNode != nullptr; subNode = subNode->next_sibling())
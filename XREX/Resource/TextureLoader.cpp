@@ -3,13 +3,23 @@
 #include "TextureLoader.hpp"
 
 #include "Base/XREXContext.hpp"
+#include "Base/Logger.hpp"
 #include "Rendering/RenderingFactory.hpp"
 #include "Rendering/Texture.hpp"
+#include "Base/MappedFile.hpp"
+#include "Resource/BlockCompression.hpp"
 
+#ifndef XREX_WITHOUT_FREEIMAGE
 #include <FreeImage.h>
+#endif
 
 #include <unordered_map>
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
 
 namespace XREX
 {
@@ -36,11 +46,26 @@ namespace XREX
 		{
 			Texture::DataDescription<N> description;
 			std::vector<std::vector<uint8>> data;
+			/*
+			 *	Point to data of above vectors, or into the mapped texture container.
+			 */
+			std::vector<void const*> levels;
+			std::shared_ptr<MappedFile> mappedFile;
+			uint64 dataSize;
 			TextureSP loadedTexture;
 			bool generateMipmap;
 
 			DataDetail(Texture::DataDescription<N> const& theDescription, std::vector<std::vector<uint8>>&& theData, bool needGenerateMipmap)
-				: description(theDescription), data(std::move(theData)), generateMipmap(needGenerateMipmap)
+				: description(theDescription), data(std::move(theData)), dataSize(0), generateMipmap(needGenerateMipmap)
+			{
+				for (auto& level : data)
+				{
+					levels.push_back(level.data());
+					dataSize += level.size();
+				}
+			}
+			DataDetail(Texture::DataDescription<N> const& theDescription, std::vector<void const*>&& theLevels, uint64 theDataSize, std::shared_ptr<MappedFile> const& theMappedFile, bool needGenerateMipmap)
+				: description(theDescription), levels(std::move(theLevels)), mappedFile(theMappedFile), dataSize(theDataSize), generateMipmap(needGenerateMipmap)
 			{
 			}
 			~DataDetail()
@@ -51,6 +76,10 @@ namespace XREX
 				if (loadedTexture == nullptr)
 				{
 					loadedTexture = DoLoad(generateMipmap);
+					// data is in the texture now
+					std::vector<std::vector<uint8>>().swap(data);
+					std::vector<void const*>().swap(levels);
+					mappedFile.reset();
 				}
 				return loadedTexture;
 			}
@@ -67,6 +96,14 @@ namespace XREX
 		{
 			data_ = MakeUP<DataDetail>(theDescription, std::move(theData), generateMipmap);
 		}
+		/*
+		 *	Levels in the mapped texture container.
+		 */
+		TextureLoadingResultDetail(Texture::DataDescription<N> const& theDescription, std::vector<void const*>&& theLevels, uint64 theDataSize,
+			std::shared_ptr<MappedFile> const& theMappedFile, bool generateMipmap)
+		{
+			data_ = MakeUP<DataDetail>(theDescription, std::move(theLevels), theDataSize, theMappedFile, generateMipmap);
+		}
 
 		virtual bool Succeeded() const override
 		{
@@ -82,6 +119,50 @@ namespace XREX
 			return nullptr;
 		}
 
+		virtual uint64 GetDataSize() const override
+		{
+			return Succeeded() ? data_->dataSize : 0;
+		}
+
+		/*
+		 *	FNV-1a over 8 byte words of each level, the tail byte by byte.
+		 */
+		uint64 HashData() const
+		{
+			if (data_->levels.empty()) // already created, data is released
+			{
+				return 0;
+			}
+			uint64 hash = 14695981039346656037ULL;
+			for (uint32 i = 0; i < data_->levels.size(); ++i)
+			{
+				uint8 const* level = static_cast<uint8 const*>(data_->levels[i]);
+				uint32 size = data_->description.GetMipmapSizeInBytes(i);
+				uint32 wordCount = size / sizeof(uint64);
+				for (uint32 j = 0; j < wordCount; ++j)
+				{
+					uint64 word;
+					memcpy(&word, level + j * sizeof(uint64), sizeof(word));
+					hash = (hash ^ word) * 1099511628211ULL;
+				}
+				for (uint32 j = wordCount * sizeof(uint64); j < size; ++j)
+				{
+					hash = (hash ^ level[j]) * 1099511628211ULL;
+				}
+			}
+			return hash;
+		}
+
+		std::vector<uint8> CopyLevel(uint32 level) const
+		{
+			if (level >= data_->levels.size())
+			{
+				return std::vector<uint8>();
+			}
+			uint8 const* data = static_cast<uint8 const*>(data_->levels[level]);
+			return std::vector<uint8>(data, data + data_->description.GetMipmapSizeInBytes(level));
+		}
+
 
 		std::unique_ptr<DataDetail> data_;
 
@@ -90,17 +171,17 @@ namespace XREX
 	template <>
 	TextureSP TextureLoadingResultDetail<1>::DataDetail::DoLoad(bool generateMipmap)
 	{
-		return XREXContext::GetInstance().GetRenderingFactory().CreateTexture1D(description, data, generateMipmap);
+		return XREXContext::GetInstance().GetRenderingFactory().CreateTexture1D(description, levels, generateMipmap);
 	}
 	template <>
 	TextureSP TextureLoadingResultDetail<2>::DataDetail::DoLoad(bool generateMipmap)
 	{
-		return XREXContext::GetInstance().GetRenderingFactory().CreateTexture2D(description, data, generateMipmap);
+		return XREXContext::GetInstance().GetRenderingFactory().CreateTexture2D(description, levels, generateMipmap);
 	}
 	template <>
 	TextureSP TextureLoadingResultDetail<3>::DataDetail::DoLoad(bool generateMipmap)
 	{
-		return XREXContext::GetInstance().GetRenderingFactory().CreateTexture3D(description, data, generateMipmap);
+		return XREXContext::GetInstance().GetRenderingFactory().CreateTexture3D(description, levels, generateMipmap);
 	}
 
 
@@ -109,6 +190,48 @@ namespace XREX
 	namespace
 	{
 
+#ifdef XREX_WITHOUT_FREEIMAGE
+		/*
+		 *	Without FreeImage only uncompressed true color and grayscale TGA files are decoded, which covers the textures of Sponza.
+		 *	Rows are bottom-up and channels in BGR order, as FreeImage gives them.
+		 */
+		bool LoadTGA(std::string const& fileName, std::vector<uint8>* texels, uint32* width, uint32* height, TexelFormat* format)
+		{
+			std::ifstream file(fileName, std::ios::binary);
+			uint8 header[18];
+			if (!file.read(reinterpret_cast<char*>(header), sizeof(header)))
+			{
+				return false;
+			}
+			uint32 bpp = header[16];
+			bool colorMapped = header[1] != 0;
+			bool trueColor = header[2] == 2 && (bpp == 24 || bpp == 32);
+			bool grayscale = header[2] == 3 && bpp == 8;
+			if (colorMapped || !(trueColor || grayscale))
+			{
+				XREXContext::GetInstance().GetLogger().LogLine("XREX is built without FreeImage, cannot decode image: " + fileName);
+				return false;
+			}
+			*width = header[12] | header[13] << 8;
+			*height = header[14] | header[15] << 8;
+			file.seekg(header[0], std::ios::cur); // image id
+			uint32 rowSize = *width * bpp / 8;
+			texels->resize(rowSize * *height);
+			if (texels->empty() || !file.read(reinterpret_cast<char*>(texels->data()), texels->size()))
+			{
+				return false;
+			}
+			if ((header[17] & 0x20) != 0) // top-left origin
+			{
+				for (uint32 y = 0; y < *height / 2; ++y)
+				{
+					std::swap_ranges(texels->begin() + y * rowSize, texels->begin() + (y + 1) * rowSize, texels->begin() + (*height - 1 - y) * rowSize);
+				}
+			}
+			*format = bpp == 8 ? TexelFormat::R8 : bpp == 24 ? TexelFormat::BGR8 : TexelFormat::BGRA8;
+			return true;
+		}
+#else
 		TexelFormat TexelFormatFromFreeImageFormat(FREE_IMAGE_FORMAT freeImageFormat, FIBITMAP* bitmap)
 		{
 			FREE_IMAGE_TYPE imageType = FreeImage_GetImageType(bitmap);
@@ -164,6 +287,344 @@ namespace XREX
 
 
 
+		/*
+		 *	@return: null if file format is unknown or can not be read. Must be released by FreeImage_Unload.
+		 */
+		FIBITMAP* LoadFreeImageBitmap(std::string const& fileName, FREE_IMAGE_FORMAT* outImageFormat)
+		{
+			FREE_IMAGE_FORMAT imageFormat = FIF_UNKNOWN;
+
+			//check the file signature and deduce its format
+			imageFormat = FreeImage_GetFileType(fileName.c_str(), 0);
+			//if still unknown, try to guess the file format from the file extension
+			if(imageFormat == FIF_UNKNOWN)
+			{
+				imageFormat = FreeImage_GetFIFFromFilename(fileName.c_str());
+			}
+			//if still unknown, return failure
+			if(imageFormat == FIF_UNKNOWN)
+			{
+				return nullptr;
+			}
+
+			//pointer to the image, once loaded
+			FIBITMAP* bitmap = nullptr;
+
+			//check that the plugin has reading capabilities and load the file
+			if(FreeImage_FIFSupportsReading(imageFormat))
+			{
+				bitmap = FreeImage_Load(imageFormat, fileName.c_str());
+			}
+			*outImageFormat = imageFormat;
+			return bitmap;
+		}
+#endif // XREX_WITHOUT_FREEIMAGE
+
+
+
+		/*
+		 *	Texture container file, native byte order, all numbers are uint32:
+		 *	header: magic "XRTX", version, dimension, texel format, width, height, depth, mipmap count, layer count, offset of the data section, total file size.
+		 *	level table: offset relative to the data section and size of each level, layers of a level are adjacent.
+		 *	data section: tightly packed texels of each level as Texture::DataDescription::GetMipmapSizeInBytes, each starts 16 bytes aligned.
+		 *	Layer count is there for array and cube textures, only 1 is loaded for now.
+		 */
+		uint32 const TextureContainerMagic = 'X' | 'R' << 8 | 'T' << 16 | 'X' << 24;
+		uint32 const TextureContainerVersion = 1;
+		uint32 const TextureContainerHeaderSize = 11 * sizeof(uint32);
+		uint32 const TextureContainerDataAlignment = 16;
+		std::string const TextureContainerExtension = ".xrtx";
+
+		uint32 AlignTextureContainerOffset(uint32 offset)
+		{
+			return (offset + TextureContainerDataAlignment - 1) / TextureContainerDataAlignment * TextureContainerDataAlignment;
+		}
+
+		bool IsTextureContainerFileName(std::string const& fileName)
+		{
+			return fileName.size() >= TextureContainerExtension.size()
+				&& fileName.compare(fileName.size() - TextureContainerExtension.size(), TextureContainerExtension.size(), TextureContainerExtension) == 0;
+		}
+
+		/*
+		 *	@levels: one layer, from the largest level.
+		 */
+		bool WriteTextureContainer(std::string const& fileName, uint32 dimension, TexelFormat format, std::array<uint32, 3> const& size, std::vector<std::vector<uint8>> const& levels)
+		{
+			uint32 levelCount = levels.size();
+			uint32 dataOffset = AlignTextureContainerOffset(TextureContainerHeaderSize + levelCount * 2 * sizeof(uint32));
+			std::vector<uint32> header;
+			header.push_back(TextureContainerMagic);
+			header.push_back(TextureContainerVersion);
+			header.push_back(dimension);
+			header.push_back(static_cast<uint32>(format));
+			header.insert(header.end(), size.begin(), size.end());
+			header.push_back(levelCount);
+			header.push_back(1);
+			header.push_back(dataOffset);
+			header.push_back(0); // file size, filled below
+			uint32 dataSize = 0;
+			for (auto& level : levels)
+			{
+				header.push_back(dataSize);
+				header.push_back(level.size());
+				dataSize = AlignTextureContainerOffset(dataSize + level.size());
+			}
+			header[10] = dataOffset + dataSize;
+
+			std::vector<uint8> file(dataOffset + dataSize, 0);
+			memcpy(file.data(), header.data(), header.size() * sizeof(uint32));
+			for (uint32 i = 0; i < levelCount; ++i)
+			{
+				uint32 offset = header[TextureContainerHeaderSize / sizeof(uint32) + i * 2];
+				memcpy(&file[dataOffset + offset], levels[i].data(), levels[i].size());
+			}
+
+			std::ofstream stream(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!stream)
+			{
+				return false;
+			}
+			stream.write(reinterpret_cast<char const*>(file.data()), file.size());
+			return static_cast<bool>(stream);
+		}
+
+		/*
+		 *	Levels are not copied, they are uploaded from the mapped file.
+		 *	@generateMipmap: only used if the container has 1 level.
+		 *	@return: null if the file is not a valid container of current version or not of N dimension.
+		 */
+		template <uint32 N>
+		TextureLoadingResultSP ReadTextureContainer(std::string const& fileName, bool generateMipmap)
+		{
+			std::shared_ptr<MappedFile> mappedFile = MakeSP<MappedFile>(fileName);
+			if (!mappedFile->IsMapped() || mappedFile->GetSize() < TextureContainerHeaderSize)
+			{
+				return nullptr;
+			}
+			std::array<uint32, TextureContainerHeaderSize / sizeof(uint32)> header;
+			memcpy(header.data(), mappedFile->GetData(), TextureContainerHeaderSize);
+			uint32 format = header[3];
+			uint32 levelCount = header[7];
+			uint32 layerCount = header[8];
+			uint32 dataOffset = header[9];
+			uint32 fileSize = header[10];
+			if (header[0] != TextureContainerMagic || header[1] != TextureContainerVersion || fileSize != mappedFile->GetSize()
+				|| header[2] != N || format >= static_cast<uint32>(TexelFormat::TexelFormatCount) || layerCount != 1 || levelCount == 0
+				|| dataOffset < TextureContainerHeaderSize + levelCount * 2 * sizeof(uint32) || dataOffset > fileSize)
+			{
+				return nullptr;
+			}
+			std::array<uint32, N> sizeData;
+			for (uint32 i = 0; i < 3; ++i)
+			{
+				if (i < N)
+				{
+					sizeData[i] = header[4 + i];
+				}
+				else if (header[4 + i] != 1)
+				{
+					return nullptr;
+				}
+			}
+			Texture::DataDescription<N> description(static_cast<TexelFormat>(format), Size<uint32, N>(sizeData));
+			if (levelCount > description.GetFullMipmapCount())
+			{
+				return nullptr;
+			}
+
+			uint8 const* levelTable = mappedFile->GetData() + TextureContainerHeaderSize;
+			uint8 const* data = mappedFile->GetData() + dataOffset;
+			uint32 dataSize = fileSize - dataOffset;
+			std::vector<void const*> levels;
+			uint64 totalSize = 0;
+			for (uint32 i = 0; i < levelCount; ++i)
+			{
+				uint32 offsetAndSize[2];
+				memcpy(offsetAndSize, levelTable + i * sizeof(offsetAndSize), sizeof(offsetAndSize));
+				if (offsetAndSize[1] != description.GetMipmapSizeInBytes(i) || offsetAndSize[0] > dataSize || offsetAndSize[1] > dataSize - offsetAndSize[0])
+				{
+					return nullptr;
+				}
+				levels.push_back(data + offsetAndSize[0]);
+				totalSize += offsetAndSize[1];
+			}
+			bool needGenerateMipmap = generateMipmap && levelCount == 1 && !IsBlockCompressedTexelFormat(description.GetFormat());
+			return MakeSP<TextureLoadingResultDetail<N>>(description, std::move(levels), totalSize, mappedFile, needGenerateMipmap);
+		}
+
+
+
+		/*
+		 *	Taps of one destination texel when halving a dimension.
+		 *	An odd source size is filtered with 3 taps, so every source texel contributes equally to the smaller level.
+		 */
+		struct DownsampleTaps
+		{
+			uint32 first;
+			uint32 count;
+			std::array<float, 3> weights;
+		};
+
+		std::vector<DownsampleTaps> MakeDownsampleTaps(uint32 sourceSize)
+		{
+			uint32 size = std::max(sourceSize / 2, 1u);
+			std::vector<DownsampleTaps> allTaps(size);
+			for (uint32 i = 0; i < size; ++i)
+			{
+				DownsampleTaps& taps = allTaps[i];
+				if (sourceSize == 1)
+				{
+					taps.first = 0;
+					taps.count = 1;
+					taps.weights[0] = 1;
+				}
+				else if (sourceSize % 2 == 0)
+				{
+					taps.first = i * 2;
+					taps.count = 2;
+					taps.weights[0] = taps.weights[1] = 0.5f;
+				}
+				else
+				{
+					float denominator = static_cast<float>(size * 2 + 1);
+					taps.first = i * 2;
+					taps.count = 3;
+					taps.weights[0] = (size - i) / denominator;
+					taps.weights[1] = size / denominator;
+					taps.weights[2] = (i + 1) / denominator;
+				}
+			}
+			return allTaps;
+		}
+
+		/*
+		 *	Separable filter of a level stored as floats, horizontal then vertical.
+		 */
+		std::vector<float> DownsampleLevel(std::vector<float> const& source, uint32 width, uint32 height, uint32 channelCount)
+		{
+			std::vector<DownsampleTaps> horizontalTaps = MakeDownsampleTaps(width);
+			std::vector<DownsampleTaps> verticalTaps = MakeDownsampleTaps(height);
+			uint32 newWidth = horizontalTaps.size();
+			uint32 newHeight = verticalTaps.size();
+
+			std::vector<float> horizontal(newWidth * height * channelCount, 0.f);
+			for (uint32 y = 0; y < height; ++y)
+			{
+				for (uint32 x = 0; x < newWidth; ++x)
+				{
+					DownsampleTaps const& taps = horizontalTaps[x];
+					float* destination = &horizontal[(y * newWidth + x) * channelCount];
+					for (uint32 tap = 0; tap < taps.count; ++tap)
+					{
+						float const* texel = &source[(y * width + taps.first + tap) * channelCount];
+						for (uint32 c = 0; c < channelCount; ++c)
+						{
+							destination[c] += texel[c] * taps.weights[tap];
+						}
+					}
+				}
+			}
+
+			std::vector<float> result(newWidth * newHeight * channelCount, 0.f);
+			for (uint32 y = 0; y < newHeight; ++y)
+			{
+				DownsampleTaps const& taps = verticalTaps[y];
+				for (uint32 tap = 0; tap < taps.count; ++tap)
+				{
+					float const* row = &horizontal[(taps.first + tap) * newWidth * channelCount];
+					float* destination = &result[y * newWidth * channelCount];
+					for (uint32 i = 0; i < newWidth * channelCount; ++i)
+					{
+						destination[i] += row[i] * taps.weights[tap];
+					}
+				}
+			}
+			return result;
+		}
+
+		float SRGBToLinear(float value)
+		{
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+		float LinearToSRGB(float value)
+		{
+			return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1 / 2.4f) - 0.055f;
+		}
+
+		/*
+		 *	Full mipmap chain of 8 bits per channel image, level 0 is the image itself.
+		 *	@srgbColor: color channels are filtered in linear space, alpha is always linear.
+		 */
+		std::vector<std::vector<uint8>> GenerateMipmaps(std::vector<uint8>&& image, uint32 width, uint32 height, uint32 channelCount, bool srgbColor)
+		{
+			uint32 colorChannelCount = srgbColor ? std::min(channelCount, 3u) : 0;
+			std::array<float, 256> decoding;
+			for (uint32 i = 0; i < 256; ++i)
+			{
+				decoding[i] = i / 255.f;
+			}
+			std::array<float, 256> colorDecoding = decoding;
+			if (srgbColor)
+			{
+				std::transform(decoding.begin(), decoding.end(), colorDecoding.begin(), SRGBToLinear);
+			}
+
+			std::vector<float> level(image.size());
+			for (uint32 i = 0; i < image.size(); ++i)
+			{
+				level[i] = (i % channelCount < colorChannelCount ? colorDecoding : decoding)[image[i]];
+			}
+
+			Texture::DataDescription<2> description(TexelFormat::RGBA8, Size<uint32, 2>(width, height));
+			uint32 levelCount = description.GetFullMipmapCount();
+			std::vector<std::vector<uint8>> levels;
+			levels.reserve(levelCount);
+			levels.push_back(std::move(image));
+			for (uint32 i = 1; i < levelCount; ++i)
+			{
+				Size<uint32, 2> size = description.GetMipmapSize(i - 1);
+				level = DownsampleLevel(level, size.X(), size.Y(), channelCount);
+				std::vector<uint8> encoded(level.size());
+				for (uint32 j = 0; j < level.size(); ++j)
+				{
+					float value = j % channelCount < colorChannelCount ? LinearToSRGB(level[j]) : level[j];
+					encoded[j] = static_cast<uint8>(std::min(std::max(value, 0.f), 1.f) * 255 + 0.5f);
+				}
+				levels.push_back(std::move(encoded));
+			}
+			return levels;
+		}
+
+		/*
+		 *	Input of block compression. Gray is copied to red, green and blue.
+		 */
+		std::vector<uint8> ExpandToRGBA8(std::vector<uint8> const& texels, uint32 channelCount, bool bgr)
+		{
+			uint32 texelCount = texels.size() / channelCount;
+			std::vector<uint8> result(texelCount * 4, 255);
+			for (uint32 i = 0; i < texelCount; ++i)
+			{
+				uint8 const* source = &texels[i * channelCount];
+				uint8* destination = &result[i * 4];
+				if (channelCount == 1)
+				{
+					destination[0] = destination[1] = destination[2] = source[0];
+					continue;
+				}
+				destination[0] = source[bgr ? 2 : 0];
+				destination[1] = source[1];
+				destination[2] = source[bgr ? 0 : 2];
+				if (channelCount == 4)
+				{
+					destination[3] = source[3];
+				}
+			}
+			return result;
+		}
+
+
+
 		template <typename TextureType>
 		struct TextureHandler
 		{
@@ -183,29 +644,24 @@ namespace XREX
 
 			bool Load()
 			{
-				FREE_IMAGE_FORMAT imageFormat = FIF_UNKNOWN;
-
-				//check the file signature and deduce its format
-				imageFormat = FreeImage_GetFileType(fileName.c_str(), 0);
-				//if still unknown, try to guess the file format from the file extension
-				if(imageFormat == FIF_UNKNOWN)
-				{
-					imageFormat = FreeImage_GetFIFFromFilename(fileName.c_str());
-				}
-				//if still unknown, return failure
-				if(imageFormat == FIF_UNKNOWN)
+				if (IsTextureContainerFileName(fileName))
 				{
-					return false;
+					return LoadContainer();
 				}
 
-				//pointer to the image, once loaded
-				FIBITMAP* bitmap = nullptr;
-
-				//check that the plugin has reading capabilities and load the file
-				if(FreeImage_FIFSupportsReading(imageFormat))
+#ifdef XREX_WITHOUT_FREEIMAGE
+				std::vector<uint8> texels;
+				uint32 width = 0;
+				uint32 height = 0;
+				TexelFormat format = TexelFormat::TexelFormatCount;
+				if (!LoadTGA(fileName, &texels, &width, &height, &format))
 				{
-					bitmap = FreeImage_Load(imageFormat, fileName.c_str());
+					return false;
 				}
+				BuildResult(width, height, static_cast<uint32>(texels.size()), format, texels.data());
+#else
+				FREE_IMAGE_FORMAT imageFormat = FIF_UNKNOWN;
+				FIBITMAP* bitmap = LoadFreeImageBitmap(fileName, &imageFormat);
 				//if the image failed to load, return failure
 				if(!bitmap)
 				{
@@ -227,14 +683,55 @@ namespace XREX
 
 				uint32 bpp = FreeImage_GetBPP(bitmap);
 				BuildResult(width, height, bpp / 8 * height * width, TexelFormatFromFreeImageFormat(imageFormat, bitmap), bits);
+#endif // XREX_WITHOUT_FREEIMAGE
 
 
 				return true;
 			}
 
+			bool LoadContainer();
 			void BuildResult(uint32 width, uint32 height, uint32 size, TexelFormat format, uint8 const* data);
 		};
 
+		template <>
+		bool TextureHandler<Texture1D>::LoadContainer()
+		{
+			TextureLoadingResultSP loaded = ReadTextureContainer<1>(fileName, generateMipmap);
+			if (loaded == nullptr)
+			{
+				return false;
+			}
+			result = std::move(loaded);
+			return true;
+		}
+		template <>
+		bool TextureHandler<Texture2D>::LoadContainer()
+		{
+			TextureLoadingResultSP loaded = ReadTextureContainer<2>(fileName, generateMipmap);
+			if (loaded == nullptr)
+			{
+				return false;
+			}
+			result = std::move(loaded);
+			return true;
+		}
+		template <>
+		bool TextureHandler<Texture3D>::LoadContainer()
+		{
+			TextureLoadingResultSP loaded = ReadTextureContainer<3>(fileName, generateMipmap);
+			if (loaded == nullptr)
+			{
+				return false;
+			}
+			result = std::move(loaded);
+			return true;
+		}
+		template <>
+		bool TextureHandler<TextureCube>::LoadContainer()
+		{
+			return false; // TODO cube texture is not finished
+		}
+
 		template <>
 		void TextureHandler<Texture1D>::BuildResult(uint32 width, uint32 height, uint32 dataSize, TexelFormat format, uint8 const* data)
 		{
@@ -324,6 +821,140 @@ namespace XREX
 		return handler.ExtractResult();
 	}
 
+	uint64 TextureLoader::HashTextureData(TextureLoadingResultSP const& loadingResult)
+	{
+		if (loadingResult == nullptr || !loadingResult->Succeeded())
+		{
+			return 0;
+		}
+		if (auto detail = std::dynamic_pointer_cast<TextureLoadingResultDetail<2>>(loadingResult))
+		{
+			return detail->HashData();
+		}
+		if (auto detail = std::dynamic_pointer_cast<TextureLoadingResultDetail<1>>(loadingResult))
+		{
+			return detail->HashData();
+		}
+		if (auto detail = std::dynamic_pointer_cast<TextureLoadingResultDetail<3>>(loadingResult))
+		{
+			return detail->HashData();
+		}
+		return 0;
+	}
+
+	std::vector<uint8> TextureLoader::CopyTextureLevel(TextureLoadingResultSP const& loadingResult, uint32 level)
+	{
+		if (loadingResult == nullptr || !loadingResult->Succeeded())
+		{
+			return std::vector<uint8>();
+		}
+		if (auto detail = std::dynamic_pointer_cast<TextureLoadingResultDetail<2>>(loadingResult))
+		{
+			return detail->CopyLevel(level);
+		}
+		if (auto detail = std::dynamic_pointer_cast<TextureLoadingResultDetail<1>>(loadingResult))
+		{
+			return detail->CopyLevel(level);
+		}
+		if (auto detail = std::dynamic_pointer_cast<TextureLoadingResultDetail<3>>(loadingResult))
+		{
+			return detail->CopyLevel(level);
+		}
+		return std::vector<uint8>();
+	}
+
+	std::string TextureLoader::GetTextureContainerFileName(std::string const& fileName)
+	{
+		return fileName + TextureContainerExtension;
+	}
+
+	bool TextureLoader::BakeTexture2D(std::string const& imageFileName, std::string const& containerFileName, bool srgbColor, TexelFormat compression, TaskScheduler* scheduler)
+	{
+		if (compression != TexelFormat::TexelFormatCount && !IsBlockCompressionSupported(compression))
+		{
+			return false;
+		}
+#ifdef XREX_WITHOUT_FREEIMAGE
+		std::vector<uint8> image;
+		uint32 width = 0;
+		uint32 height = 0;
+		TexelFormat format = TexelFormat::TexelFormatCount;
+		if (!LoadTGA(imageFileName, &image, &width, &height, &format))
+		{
+			return false;
+		}
+		bool bgr = format != TexelFormat::R8;
+		uint32 channelCount = format == TexelFormat::R8 ? 1 : format == TexelFormat::BGR8 ? 3 : 4;
+#else
+		FREE_IMAGE_FORMAT imageFormat = FIF_UNKNOWN;
+		FIBITMAP* bitmap = LoadFreeImageBitmap(imageFileName, &imageFormat);
+		if (!bitmap)
+		{
+			return false;
+		}
+		uint32 bpp = FreeImage_GetBPP(bitmap);
+		bool supported = FreeImage_GetImageType(bitmap) == FIT_BITMAP
+			&& ((bpp == 8 && FreeImage_GetColorType(bitmap) == FIC_MINISBLACK) || bpp == 24 || bpp == 32);
+		if (!supported) // palette, 16 bits or other types
+		{
+			FIBITMAP* converted = FreeImage_ConvertTo32Bits(bitmap);
+			FreeImage_Unload(bitmap);
+			bitmap = converted;
+			if (!bitmap)
+			{
+				return false;
+			}
+			bpp = 32;
+		}
+
+		uint32 width = FreeImage_GetWidth(bitmap);
+		uint32 height = FreeImage_GetHeight(bitmap);
+		bool bgr = FreeImage_GetBlueMask(bitmap) < FreeImage_GetRedMask(bitmap);
+		TexelFormat format = bpp == 8 ? TexelFormat::R8 : bpp == 24 ? (bgr ? TexelFormat::BGR8 : TexelFormat::RGB8) : (bgr ? TexelFormat::BGRA8 : TexelFormat::RGBA8);
+		uint32 channelCount = bpp / 8;
+
+		// rows of FreeImage are padded, texture levels are tightly packed
+		uint32 rowSize = width * channelCount;
+		std::vector<uint8> image(rowSize * height);
+		for (uint32 y = 0; y < height; ++y)
+		{
+			memcpy(&image[y * rowSize], FreeImage_GetScanLine(bitmap, y), rowSize);
+		}
+		FreeImage_Unload(bitmap);
+#endif // XREX_WITHOUT_FREEIMAGE
+		if (image.empty())
+		{
+			return false;
+		}
+		if (compression == TexelFormat::BC1 && channelCount == 4) // BC1 stores no alpha, would make translucent texels opaque
+		{
+			for (uint32 i = 3; i < image.size(); i += 4)
+			{
+				if (image[i] != 255)
+				{
+					return false;
+				}
+			}
+		}
+
+		std::vector<std::vector<uint8>> levels = GenerateMipmaps(std::move(image), width, height, channelCount, srgbColor);
+		if (compression != TexelFormat::TexelFormatCount)
+		{
+			Texture::DataDescription<2> description(format, Size<uint32, 2>(width, height));
+			for (uint32 i = 0; i < levels.size(); ++i)
+			{
+				Size<uint32, 2> size = description.GetMipmapSize(i);
+				std::vector<uint8> rgbaTexels = ExpandToRGBA8(levels[i], channelCount, bgr);
+				levels[i] = scheduler
+					? ParallelCompressTexels(*scheduler, compression, rgbaTexels.data(), size.X(), size.Y())
+					: CompressTexels(compression, rgbaTexels.data(), size.X(), size.Y());
+			}
+			format = compression;
+		}
+		std::array<uint32, 3> size = { width, height, 1 };
+		return WriteTextureContainer(containerFileName, 2, format, size, levels);
+	}
+
 
 
 }
@@ -3,7 +3,11 @@
 #include "Declare.hpp"
 #include "LoadingResult.hpp"
 
+#include "Rendering/GraphicsType.hpp"
+
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace XREX
 {
@@ -32,6 +36,35 @@ namespace XREX
 		 */
 		TextureLoadingResultSP LoadTextureCube(std::string const& fileName, bool generateMipmap = true);
 
+		/*
+		 *	Reads every byte of the levels of a result returned by LoadTexture1D/2D/3D, as creating the texture does.
+		 *	@return: hash of the data. 0 if the result has no data or the texture is created.
+		 */
+		static uint64 HashTextureData(TextureLoadingResultSP const& loadingResult);
+		/*
+		 *	@level: mipmap level, a result of an image only has level 0 if mipmaps are generated at upload.
+		 *	@return: texels of the level as uploaded, empty if the result has no such level or the texture is created.
+		 */
+		static std::vector<uint8> CopyTextureLevel(TextureLoadingResultSP const& loadingResult, uint32 level);
+
+		/*
+		 *	Texture container stores all mipmap levels in the texel layout Texture expects,
+		 *	LoadTexture1D/2D/3D map it and upload the levels as they are, nothing is decoded or generated.
+		 *	@return: fileName with container extension appended, where ResourceManager looks for the baked texture of an image.
+		 */
+		static std::string GetTextureContainerFileName(std::string const& fileName);
+		/*
+		 *	Decode an image and write it with full mipmap chain as a texture container. Run offline, mipmaps are filtered on CPU.
+		 *	@srgbColor: color channels are sRGB encoded and filtered in linear space. False for normal, height and other data maps.
+		 *	@compression: block compressed format levels are encoded to, see IsBlockCompressionSupported. TexelFormatCount to store texels as they are.
+		 *		BC4 takes red, BC5 red and green, of gray images both are the gray value. BC1 drops alpha, use BC3 for images not opaque.
+		 *	@scheduler: compress in parallel if not null.
+		 *	@return: false if image can not be loaded or converted to 8 bits per channel, compression is not supported,
+		 *		compression is BC1 and the image has alpha other than 255, or file can not be written.
+		 */
+		bool BakeTexture2D(std::string const& imageFileName, std::string const& containerFileName, bool srgbColor = true,
+			TexelFormat compression = TexelFormat::TexelFormatCount, TaskScheduler* scheduler = nullptr);
+
 	};
 
 }
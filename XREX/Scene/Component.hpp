@@ -24,29 +24,12 @@ namespace XREX
 		{
 			static ComponentType const Type = ComponentType::ComponentTypeCount;
 		};
-		template <>
-		struct TypeToComponentType<Transformation>
-		{
-			static ComponentType const Type = ComponentType::TransformationType;
-		};
-		template <>
-		struct TypeToComponentType<Renderable>
-		{
-			static ComponentType const Type = ComponentType::RenderableType;
-		};
-		template <>
-		struct TypeToComponentType<Camera>
-		{
-			static ComponentType const Type = ComponentType::CameraType;
-		};
 
 	public:
 		Component()
 		{
 		}
-		virtual ~Component() = 0
-		{
-		}
+		virtual ~Component() = 0;
 
 		virtual ComponentType GetComponentType() const = 0;
 
@@ -68,14 +51,38 @@ namespace XREX
 		std::weak_ptr<SceneObject> sceneObject_;
 	};
 
+	/*
+	 *	Member templates can only be specialized at namespace scope.
+	 */
+	template <>
+	struct Component::TypeToComponentType<Transformation>
+	{
+		static ComponentType const Type = ComponentType::TransformationType;
+	};
+	template <>
+	struct Component::TypeToComponentType<Renderable>
+	{
+		static ComponentType const Type = ComponentType::RenderableType;
+	};
+	template <>
+	struct Component::TypeToComponentType<Camera>
+	{
+		static ComponentType const Type = ComponentType::CameraType;
+	};
+
+	/*
+	 *	Pure virtual destructors still need a body, defined out of class since "= 0 { }" is an MSVC extension.
+	 */
+	inline Component::~Component()
+	{
+	}
+
 	template <typename T>
 	class TemplateComponent
 		: public Component
 	{
 	public:
-		virtual ~TemplateComponent() override = 0
-		{
-		}
+		virtual ~TemplateComponent() override = 0;
 	private:
 		virtual ComponentType GetComponentType() const override
 		{
@@ -84,5 +91,9 @@ namespace XREX
 		}
 	};
 
-}
+	template <typename T>
+	TemplateComponent<T>::~TemplateComponent()
+	{
+	}
 
+}
@@ -44,9 +44,29 @@ namespace XREX
 
 		virtual void ClearAllObject() = 0;
 
-		virtual std::vector<SceneObjectSP> GetRenderableQueue(SceneObjectSP const& camera) = 0;
+		/*
+		 *	@camera: nullptr to get all visible renderable objects without culling.
+		 *	@queue: cleared then filled, memory of it is reused, so a buffer kept between frames allocates nothing.
+		 */
+		virtual void GetRenderableQueue(SceneObjectSP const& camera, std::vector<SceneObjectSP>& queue) = 0;
+		std::vector<SceneObjectSP> GetRenderableQueue(SceneObjectSP const& camera)
+		{
+			std::vector<SceneObjectSP> queue;
+			GetRenderableQueue(camera, queue);
+			return queue;
+		}
 
-		virtual std::vector<SceneObjectSP> GetCameras() = 0;
+		/*
+		 *	Active cameras.
+		 *	@cameras: cleared then filled, memory of it is reused.
+		 */
+		virtual void GetCameras(std::vector<SceneObjectSP>& cameras) = 0;
+		std::vector<SceneObjectSP> GetCameras()
+		{
+			std::vector<SceneObjectSP> cameras;
+			GetCameras(cameras);
+			return cameras;
+		}
 	};
 
 }
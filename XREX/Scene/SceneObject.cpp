@@ -3,6 +3,7 @@
 #include "SceneObject.hpp"
 
 #include "Scene/Transformation.hpp"
+#include "Rendering/Renderable.hpp"
 
 namespace XREX
 {
@@ -11,7 +12,8 @@ namespace XREX
 
 
 	SceneObject::SceneObject(std::string const& name)
-		: name_(name), components_(static_cast<uint32>(Component::ComponentType::ComponentTypeCount))
+		: name_(name), components_(static_cast<uint32>(Component::ComponentType::ComponentTypeCount)),
+		boundingVolumeRenderable_(nullptr), boundingVolumeRenderableVersion_(0), boundingVolumeTransformationVersion_(0)
 	{
 		components_[0] = MakeSP<Transformation>();
 	}
@@ -33,6 +35,33 @@ namespace XREX
 
 		components_[static_cast<uint32>(component->GetComponentType())] = component;
 		component->SetOwnerSceneObject(shared_from_this());
+		boundingVolumeRenderable_ = nullptr;
+	}
+
+	void SceneObject::UpdateWorldBoundingVolume() const
+	{
+		Renderable const* renderable = static_cast<Renderable const*>(components_[static_cast<uint32>(Component::ComponentType::RenderableType)].get());
+		Transformation const* transformation = static_cast<Transformation const*>(components_[static_cast<uint32>(Component::ComponentType::TransformationType)].get());
+		if (renderable == nullptr)
+		{
+			worldBoundingBox_ = AxisAlignedBox();
+			worldBoundingSphere_ = Sphere();
+			boundingVolumeRenderable_ = nullptr;
+			return;
+		}
+
+		uint32 transformationVersion = transformation->GetWorldMatrixVersion();
+		if (renderable == boundingVolumeRenderable_ && renderable->GetBoundingVolumeVersion() == boundingVolumeRenderableVersion_
+			&& transformationVersion == boundingVolumeTransformationVersion_)
+		{
+			return;
+		}
+		floatM44 const& worldMatrix = transformation->GetWorldMatrix();
+		worldBoundingBox_ = Transform(worldMatrix, renderable->GetBoundingBox());
+		worldBoundingSphere_ = Transform(worldMatrix, renderable->GetBoundingSphere());
+		boundingVolumeRenderable_ = renderable;
+		boundingVolumeRenderableVersion_ = renderable->GetBoundingVolumeVersion();
+		boundingVolumeTransformationVersion_ = transformationVersion;
 	}
 
 }
@@ -39,6 +39,7 @@ namespace XREX
 		{
 			ComponentSP component = components_[static_cast<uint32>(type)];
 			components_[static_cast<uint32>(type)] = nullptr;
+			boundingVolumeRenderable_ = nullptr;
 			return component;
 		}
 
@@ -47,6 +48,7 @@ namespace XREX
 		{
 			ComponentSP component = components_[static_cast<uint32>(Component::TypeToComponentType<T>::Type)];
 			components_[static_cast<uint32>(Component::TypeToComponentType<T>::Type)] = nullptr;
+			boundingVolumeRenderable_ = nullptr;
 			return CheckedSPCast<T>(component);
 		}
 
@@ -67,9 +69,37 @@ namespace XREX
 			return CheckedSPCast<T>(component); // shared_ptr_cast create a new shared_ptr object.
 		}
 
+		/*
+		 *	Bounding volumes of the Renderable in world space.
+		 *	Cached, only recalculated when Transformation or bounding volumes of the Renderable changed.
+		 *	Empty if there is no Renderable or the Renderable has no bounding volume.
+		 */
+		AxisAlignedBox const& GetWorldBoundingBox() const
+		{
+			UpdateWorldBoundingVolume();
+			return worldBoundingBox_;
+		}
+		Sphere const& GetWorldBoundingSphere() const
+		{
+			UpdateWorldBoundingVolume();
+			return worldBoundingSphere_;
+		}
+
+	private:
+		void UpdateWorldBoundingVolume() const;
+
 	private:
 		std::vector<ComponentSP> components_;
 		std::string name_;
+
+		AxisAlignedBox mutable worldBoundingBox_;
+		Sphere mutable worldBoundingSphere_;
+		/*
+		 *	Sources of cached bounding volumes.
+		 */
+		Renderable const mutable* boundingVolumeRenderable_;
+		uint32 mutable boundingVolumeRenderableVersion_;
+		uint32 mutable boundingVolumeTransformationVersion_;
 	};
 
 }
@@ -3,13 +3,17 @@
 #include "Declare.hpp"
 
 #include "Scene/Component.hpp"
+#include "Scene/TransformationHierarchy.hpp"
 
 namespace XREX
 {
 
 	/*
 	 *	The result of this representation is scaling first, then rotation, translation last.
-	 *
+	 *	Data is stored in TransformationHierarchy of XREXContext, this is a handle to it.
+	 *	World matrices are updated by TransformationHierarchy::Update, once per frame,
+	 *	or on demand by getters requiring them if anything changed since last update.
+	 *	Those getters stay const, the hierarchy is shared state reached through a reference, not part of this handle.
 	 */
 	class XREX_API Transformation
 		: public TemplateComponent<Transformation>
@@ -21,19 +25,27 @@ namespace XREX
 		/*
 		 *	@return: model matrix contains only this transformation.
 		 */
-		floatM44 const& GetModelMatrix() const
+		floatM44 GetModelMatrix() const
 		{
-			Update();
-			return modelMatrix_;
+			hierarchy_.Update();
+			return hierarchy_.modelMatrices_[GetSlot()];
 		}
 
 		/*
 		 *	@return: model matrix includes all parent transformation.
 		 */
-		floatM44 const& GetWorldMatrix() const
+		floatM44 GetWorldMatrix() const
 		{
-			Update();
-			return worldMatrix_;
+			hierarchy_.Update();
+			return hierarchy_.worldMatrices_[GetSlot()];
+		}
+		/*
+		 *	Increased every time world matrix changes, used to check whether data depends on world matrix need update.
+		 */
+		uint32 GetWorldMatrixVersion() const
+		{
+			hierarchy_.Update();
+			return hierarchy_.worldMatrixVersions_[GetSlot()];
 		}
 
 		void SetParent(TransformationSP const& parent);
@@ -45,107 +57,107 @@ namespace XREX
 		void SetPosition(float x, float y, float z)
 		{
 			SetPosition(floatV3(x, y, z));
-			dirty_ = true;
 		}
 		void SetPosition(floatV3 const& position)
 		{
-			position_ = position;
-			dirty_ = true;
+			uint32 slot = GetSlot();
+			hierarchy_.positions_[slot] = position;
+			hierarchy_.MarkDirty(slot);
 		}
-		floatV3 const& GetPosition() const
+		floatV3 GetPosition() const
 		{
-			return position_;
+			return hierarchy_.positions_[GetSlot()];
 		}
 
-		floatV3 const& GetWorldPosition() const
+		floatV3 GetWorldPosition() const
 		{
-			Update();
-			return globalPosition_;
+			hierarchy_.Update();
+			floatM44 const& worldMatrix = hierarchy_.worldMatrices_[GetSlot()];
+			return floatV3(worldMatrix(0, 3), worldMatrix(1, 3), worldMatrix(2, 3));
 		}
 
 		void SetOrientation(floatQ const& orientation)
 		{
-			orientation_ = orientation;
-			dirty_ = true;
+			uint32 slot = GetSlot();
+			hierarchy_.orientations_[slot] = orientation;
+			hierarchy_.MarkDirty(slot);
 		}
-		floatQ const& GetOrientation() const
+		floatQ GetOrientation() const
 		{
-			return orientation_;
+			return hierarchy_.orientations_[GetSlot()];
 		}
 
 		void SetScaling(float s)
 		{
 			assert(s > 0);
 			SetScaling(floatV3(s, s, s));
-			dirty_ = true;
 		}
 		void SetScaling(float sx, float sy, float sz)
 		{
 			assert(sx > 0 && sy > 0 && sz > 0);
 			SetScaling(floatV3(sx, sy, sz));
-			dirty_ = true;
 		}
 		void SetScaling(floatV3 const& scaling)
 		{
 			assert(scaling.X() > 0 && scaling.Y() > 0 && scaling.Z() > 0);
-			scaling_ = scaling;
-			dirty_ = true;
+			uint32 slot = GetSlot();
+			hierarchy_.scalings_[slot] = scaling;
+			hierarchy_.MarkDirty(slot);
 		}
-		floatV3 const& GetScaling() const
+		floatV3 GetScaling() const
 		{
-			return scaling_;
+			return hierarchy_.scalings_[GetSlot()];
 		}
 
 		bool IsUniformlyScaled() const
 		{
-			return scaling_.X() == scaling_.Y() && scaling_.X() == scaling_.Z();
+			floatV3 const& scaling = hierarchy_.scalings_[GetSlot()];
+			return scaling.X() == scaling.Y() && scaling.X() == scaling.Z();
 		}
 
 		void Translate(float x, float y, float z)
 		{
 			Translate(floatV3(x, y, z));
-			dirty_ = true;
 		}
 		void Translate(floatV3 const& displacement)
 		{
-			position_ = position_ + displacement;
-			dirty_ = true;
+			uint32 slot = GetSlot();
+			hierarchy_.positions_[slot] = hierarchy_.positions_[slot] + displacement;
+			hierarchy_.MarkDirty(slot);
 		}
 
 		void Scale(float s)
 		{
 			assert(s > 0);
 			Scale(floatV3(s, s, s));
-			dirty_ = true;
 		}
 		void Scale(float sx, float sy, float sz)
 		{
 			assert(sx > 0 && sy > 0 && sz > 0);
 			Scale(floatV3(sx, sy, sz));
-			dirty_ = true;
 		}
 		void Scale(floatV3 const& s)
 		{
 			assert(s.X() > 0 && s.Y() > 0 && s.Z() > 0);
-			scaling_ = scaling_ * s;
-			dirty_ = true;
+			uint32 slot = GetSlot();
+			hierarchy_.scalings_[slot] = hierarchy_.scalings_[slot] * s;
+			hierarchy_.MarkDirty(slot);
 		}
 
 
 		void Rotate(float angle, float x, float y, float z)
 		{
-			orientation_ = RotationQuaternion(angle, x, y, z) * orientation_;
-			dirty_ = true;
+			Rotate(RotationQuaternion(angle, x, y, z));
 		}
 		void Rotate(float angle, floatV3 const& axis)
 		{
-			orientation_ = RotationQuaternion(angle, axis) * orientation_;
-			dirty_ = true;
+			Rotate(RotationQuaternion(angle, axis));
 		}
 		void Rotate(floatQ const& rotation)
 		{
-			orientation_ = rotation * orientation_;
-			dirty_ = true;
+			uint32 slot = GetSlot();
+			hierarchy_.orientations_[slot] = rotation * hierarchy_.orientations_[slot];
+			hierarchy_.MarkDirty(slot);
 		}
 
 		floatV3 const& GetModelFrontDirection() const
@@ -159,7 +171,6 @@ namespace XREX
 		void SetModelFrontDirection(floatV3 const& front)
 		{
 			front_ = front;
-			dirty_ = true;
 		}
 
 		floatV3 const& GetModelUpDirection() const
@@ -173,7 +184,6 @@ namespace XREX
 		void SetModelUpDirection(floatV3 const& up)
 		{
 			up_ = up;
-			dirty_ = true;
 		}
 		/*
 		 *	Face to a direction, using front and up as reference.
@@ -182,8 +192,7 @@ namespace XREX
 		 */
 		void FaceToDirection(floatV3 const& to, floatV3 const& up)
 		{
-			orientation_ = FaceToQuaternion(to, up, front_, up_);
-			dirty_ = true;
+			SetOrientation(FaceToQuaternion(to, up, front_, up_));
 		}
 		/*
 		 *	Face to a position, using front and up as reference.
@@ -192,31 +201,23 @@ namespace XREX
 		 */
 		void FaceToPosition(floatV3 const& to, floatV3 const& up)
 		{
-			orientation_ = FaceToQuaternion(to - position_, up, front_, up_);
-			dirty_ = true;
+			SetOrientation(FaceToQuaternion(to - GetPosition(), up, front_, up_));
 		}
 
 	private:
-		void Update() const;
+		uint32 GetSlot() const
+		{
+			return hierarchy_.GetSlot(handle_);
+		}
 
 	private:
-		std::weak_ptr<Transformation> parent_;
-
-		floatV3 position_;
-		floatQ orientation_;
-		floatV3 scaling_;
+		TransformationHierarchy& hierarchy_;
+		uint32 handle_;
 
-		floatV3 mutable globalPosition_;
+		std::weak_ptr<Transformation> parent_;
 
 		floatV3 front_;
 		floatV3 up_;
-
-		floatM44 mutable modelMatrix_;
-		floatM44 mutable worldMatrix_;
-
-		floatM44 mutable parentWorldMatrix_;
-
-		bool mutable dirty_;
 	};
 
 }
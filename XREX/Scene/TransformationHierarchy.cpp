@@ -0,0 +1,213 @@
+#include "XREX.hpp"
+
+#include "TransformationHierarchy.hpp"
+
+using std::vector;
+
+namespace XREX
+{
+
+	namespace
+	{
+		/*
+		 *	result[i] = source[order[i]]
+		 */
+		template <typename T>
+		void Permute(vector<T>& source, vector<uint32> const& order)
+		{
+			vector<T> result;
+			result.reserve(order.size());
+			for (uint32 slot : order)
+			{
+				result.push_back(source[slot]);
+			}
+			source.swap(result);
+		}
+	}
+
+
+	TransformationHierarchy::TransformationHierarchy()
+		: anyDirty_(false), orderDirty_(false)
+	{
+	}
+
+
+	TransformationHierarchy::~TransformationHierarchy()
+	{
+	}
+
+	uint32 TransformationHierarchy::CreateNode()
+	{
+		// new node is a root, appending it keeps the order.
+		uint32 slot = slotToHandle_.size();
+		positions_.push_back(floatV3::Zero);
+		orientations_.push_back(floatQ::Identity);
+		scalings_.push_back(floatV3(1, 1, 1));
+		modelMatrices_.push_back(floatM44::Identity);
+		worldMatrices_.push_back(floatM44::Identity);
+		worldMatrixVersions_.push_back(0);
+		parents_.push_back(int32(NullSlot));
+		dirty_.push_back(0);
+		worldChanged_.push_back(0);
+
+		uint32 handle;
+		if (freeHandles_.empty())
+		{
+			handle = handleToSlot_.size();
+			handleToSlot_.push_back(slot);
+		}
+		else
+		{
+			handle = freeHandles_.back();
+			freeHandles_.pop_back();
+			handleToSlot_[handle] = slot;
+		}
+		slotToHandle_.push_back(handle);
+
+		MarkDirty(slot);
+		return handle;
+	}
+
+	void TransformationHierarchy::DestroyNode(uint32 handle)
+	{
+		uint32 slot = handleToSlot_[handle];
+		slotToHandle_[slot] = NullHandle;
+		handleToSlot_[handle] = NullHandle;
+		freeHandles_.push_back(handle);
+		// slot is reclaimed by Reorder, children become roots there.
+		orderDirty_ = true;
+	}
+
+	void TransformationHierarchy::SetParent(uint32 handle, uint32 parentHandle)
+	{
+		uint32 slot = handleToSlot_[handle];
+		if (parentHandle == NullHandle)
+		{
+			parents_[slot] = NullSlot;
+		}
+		else
+		{
+			uint32 parentSlot = handleToSlot_[parentHandle];
+			parents_[slot] = parentSlot;
+			if (parentSlot > slot)
+			{
+				orderDirty_ = true;
+			}
+		}
+		MarkDirty(slot);
+	}
+
+	void TransformationHierarchy::Reorder()
+	{
+		uint32 slotCount = slotToHandle_.size();
+
+		// children lists, in slot order
+		vector<int32> firstChild(slotCount, int32(NullSlot));
+		vector<int32> lastChild(slotCount, int32(NullSlot));
+		vector<int32> nextSibling(slotCount, int32(NullSlot));
+		vector<uint32> order;
+		order.reserve(slotCount);
+		for (uint32 slot = 0; slot < slotCount; ++slot)
+		{
+			if (slotToHandle_[slot] == NullHandle)
+			{
+				continue;
+			}
+			int32 parent = parents_[slot];
+			if (parent != NullSlot && slotToHandle_[parent] == NullHandle) // parent destroyed
+			{
+				parents_[slot] = NullSlot;
+				parent = NullSlot;
+				MarkDirty(slot);
+			}
+			if (parent == NullSlot)
+			{
+				order.push_back(slot);
+			}
+			else
+			{
+				if (lastChild[parent] == NullSlot)
+				{
+					firstChild[parent] = slot;
+				}
+				else
+				{
+					nextSibling[lastChild[parent]] = slot;
+				}
+				lastChild[parent] = slot;
+			}
+		}
+		// breadth first from all roots, parent always comes before child.
+		for (uint32 i = 0; i < order.size(); ++i)
+		{
+			for (int32 child = firstChild[order[i]]; child != NullSlot; child = nextSibling[child])
+			{
+				order.push_back(child);
+			}
+		}
+		assert(order.size() == GetNodeCount()); // or there is a cycle
+
+		vector<int32> oldToNew(slotCount, int32(NullSlot));
+		for (uint32 i = 0; i < order.size(); ++i)
+		{
+			oldToNew[order[i]] = i;
+		}
+
+		Permute(positions_, order);
+		Permute(orientations_, order);
+		Permute(scalings_, order);
+		Permute(modelMatrices_, order);
+		Permute(worldMatrices_, order);
+		Permute(worldMatrixVersions_, order);
+		Permute(parents_, order);
+		Permute(dirty_, order);
+		Permute(worldChanged_, order);
+		Permute(slotToHandle_, order);
+
+		for (uint32 i = 0; i < order.size(); ++i)
+		{
+			if (parents_[i] != NullSlot)
+			{
+				parents_[i] = oldToNew[parents_[i]];
+			}
+			handleToSlot_[slotToHandle_[i]] = i;
+		}
+		orderDirty_ = false;
+	}
+
+	void TransformationHierarchy::UpdateMatrices()
+	{
+		assert(!orderDirty_);
+		uint32 slotCount = slotToHandle_.size();
+		for (uint32 slot = 0; slot < slotCount; ++slot)
+		{
+			bool changed = false;
+			if (dirty_[slot])
+			{
+				modelMatrices_[slot] = TransformationMatrix(positions_[slot], orientations_[slot], scalings_[slot]);
+				dirty_[slot] = 0;
+				changed = true;
+			}
+			int32 parent = parents_[slot];
+			if (parent == NullSlot)
+			{
+				if (changed)
+				{
+					worldMatrices_[slot] = modelMatrices_[slot];
+				}
+			}
+			else if (changed || worldChanged_[parent])
+			{
+				worldMatrices_[slot] = worldMatrices_[parent] * modelMatrices_[slot];
+				changed = true;
+			}
+			if (changed)
+			{
+				++worldMatrixVersions_[slot];
+			}
+			worldChanged_[slot] = changed;
+		}
+		anyDirty_ = false;
+	}
+
+}
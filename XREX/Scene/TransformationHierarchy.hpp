@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Declare.hpp"
+
+#include <vector>
+
+namespace XREX
+{
+
+	/*
+	 *	Storage of all Transformation data, in contiguous arrays sorted in parent-before-child order.
+	 *	World matrices are recalculated in a single linear pass, dirty flags propagate from parent to child along the way.
+	 *	Transformation is a handle into this, handles are stable while slots in arrays move when hierarchy changes.
+	 */
+	class XREX_API TransformationHierarchy
+		: Noncopyable
+	{
+		friend class Transformation;
+
+	public:
+		TransformationHierarchy();
+		~TransformationHierarchy();
+
+		/*
+		 *	Recalculate all changed world matrices. Called every frame by XREXContext,
+		 *	also called by Transformation when matrices are required and something has changed since last update.
+		 */
+		void Update()
+		{
+			if (orderDirty_)
+			{
+				Reorder();
+			}
+			if (anyDirty_)
+			{
+				UpdateMatrices();
+			}
+		}
+
+		uint32 GetNodeCount() const
+		{
+			return handleToSlot_.size() - freeHandles_.size();
+		}
+
+	private:
+		static uint32 const NullHandle = ~0u;
+		static int32 const NullSlot = -1;
+
+		/*
+		 *	@return: handle of the new node.
+		 */
+		uint32 CreateNode();
+		void DestroyNode(uint32 handle);
+		/*
+		 *	@parentHandle: NullHandle to make the node a root.
+		 */
+		void SetParent(uint32 handle, uint32 parentHandle);
+
+		uint32 GetSlot(uint32 handle) const
+		{
+			return handleToSlot_[handle];
+		}
+		void MarkDirty(uint32 slot)
+		{
+			dirty_[slot] = 1;
+			anyDirty_ = true;
+		}
+
+		/*
+		 *	Remove destroyed nodes and restore parent-before-child order.
+		 */
+		void Reorder();
+		void UpdateMatrices();
+
+	private:
+		std::vector<floatV3> positions_;
+		std::vector<floatQ> orientations_;
+		std::vector<floatV3> scalings_;
+		std::vector<floatM44> modelMatrices_;
+		std::vector<floatM44> worldMatrices_;
+		std::vector<uint32> worldMatrixVersions_;
+		/*
+		 *	Slot of parent, always smaller than the slot of child after Reorder. NullSlot for root.
+		 */
+		std::vector<int32> parents_;
+		/*
+		 *	Local transformation changed.
+		 */
+		std::vector<uint8> dirty_;
+		/*
+		 *	World matrix changed in current UpdateMatrices pass, used to propagate to children.
+		 */
+		std::vector<uint8> worldChanged_;
+		/*
+		 *	NullHandle for destroyed node waiting for Reorder.
+		 */
+		std::vector<uint32> slotToHandle_;
+
+		std::vector<uint32> handleToSlot_;
+		std::vector<uint32> freeHandles_;
+
+		bool anyDirty_;
+		bool orderDirty_;
+	};
+
+}
@@ -1,6 +1,16 @@
 #pragma once
 
-#ifndef STATIC_BUILD
+/*
+ *	Without a window system, XREX renders into an offscreen default frame buffer of a headless context (EGL, or OSMesa with XREX_USE_OSMESA).
+ *	Define XREX_HEADLESS to use it on Windows too.
+ *	Off Windows XREX is built by CMakeLists.txt with GCC, which generates glload from its headers,
+ *	and builds without assimp or FreeImage when they are missing, see there.
+ */
+#if !defined(_WIN32) && !defined(XREX_HEADLESS)
+#define XREX_HEADLESS
+#endif
+
+#if !defined(STATIC_BUILD) && defined(_WIN32)
 #ifdef XREX_SOURCE
 #define XREX_API __declspec(dllexport)
 #else
@@ -10,7 +20,9 @@
 #define XREX_API
 #endif
 
+#ifdef _MSC_VER
 #pragma warning(disable: 4251) // have members do not dllexport-ed
+#endif
 
 #if defined(DEBUG) || defined(_DEBUG)
 #define XREX_DEBUG
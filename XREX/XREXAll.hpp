@@ -11,13 +11,18 @@
 #include "Base/XREXContext.hpp"
 #include "Base/Timer.hpp"
 #include "Base/Logger.hpp"
+#include "Base/TaskScheduler.hpp"
+#include "Base/FramePipeline.hpp"
 
 #include "Base/Window.hpp"
 
 #include "Resource/LocalResourceLoader.hpp"
 #include "Resource/MeshLoader.hpp"
+#include "Resource/MeshOptimizer.hpp"
 #include "Resource/TextureLoader.hpp"
+#include "Resource/BlockCompression.hpp"
 #include "Resource/ResourceManager.hpp"
+#include "Resource/AsyncResourceLoader.hpp"
 
 #include "Input/InputCenter.hpp"
 #include "Input/InputHandler.hpp"
@@ -40,6 +45,7 @@
 #include "Rendering/GraphicsContext.hpp"
 #include "Rendering/RenderingEngine.hpp"
 #include "Rendering/RenderingProcess.hpp"
+#include "Rendering/FrameSnapshot.hpp"
 #include "Rendering/DefinedShaderName.hpp"
 #include "Rendering/GraphicsType.hpp"
 #include "Rendering/SystemTechnique.hpp"
@@ -11,9 +11,11 @@ out vec3 textureCoordinate;
 
 void main()
 {
+	// clones of the cube are drawn as instances of one draw.
+	vec4 worldPosition = XREX_InstanceTransformation.WorldFromModel[gl_InstanceID] * vec4(position, 1);
 	textureCoordinate = position;
-	gl_Position = XREX_TransformToClip(XREX_ModelTransformation.ClipFromModel, position);
-	color = vec4(((XREX_ModelTransformation.WorldFromModel * vec4(position, 1)).xyz) / length(centerPosition) / 2, 0.5);
+	gl_Position = XREX_CameraTransformation.ClipFromWorld * worldPosition;
+	color = vec4(worldPosition.xyz / length(centerPosition) / 2, 0.5);
 }
 
 #endif
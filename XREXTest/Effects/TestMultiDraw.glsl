@@ -0,0 +1,32 @@
+
+
+#ifdef VS
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+in vec3 position;
+out vec3 color;
+
+void main()
+{
+	mat4 worldFromModel = XREX_DrawParameters.WorldFromModel[XREX_DrawID];
+	gl_Position = projectionMatrix * viewMatrix * worldFromModel * vec4(position, 1);
+	color = position + 0.5;
+}
+
+#endif
+
+
+#ifdef FS
+
+layout(location = 0) out vec4 XREX_DefaultFrameBufferOutput;
+
+in vec3 color;
+
+void main()
+{
+	XREX_DefaultFrameBufferOutput = vec4(color, 1);
+}
+
+#endif
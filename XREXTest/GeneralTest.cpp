@@ -1,6 +1,8 @@
 #include "XREXAll.hpp"
 #include "GeneralTest.h"
 
+#include "Rendering/FrameStatistics.hpp"
+
 #include <fstream>
 #include <vector>
 #include <iostream>
@@ -50,6 +52,7 @@ struct TempScene
 
 	void InitializeScene()
 	{
+		frameCount_ = 0;
 		vector<floatV3> vertexData;
 		vector<uint16> indexData;
 
@@ -138,10 +141,10 @@ struct TempScene
 		testTechnique->AddInclude(TransformationTechniqueFactory().GetTechniqueInformationToInclude());
 		testTechnique->AddInclude(CameraTechniqueFactory().GetTechniqueInformationToInclude());
 
-		testCubeTechnique->AddInclude(TransformationTechniqueFactory().GetTechniqueInformationToInclude());
+		testCubeTechnique->AddInclude(InstanceTransformationTechniqueFactory().GetTechniqueInformationToInclude());
 		testCubeTechnique->AddInclude(CameraTechniqueFactory().GetTechniqueInformationToInclude());
 
-		vector<VariableInformation const> variables;
+		vector<VariableInformation> variables;
 		testTechnique->AddUniformBufferInformation(BufferInformation("Material", "", BufferView::BufferType::Uniform, move(variables)));
 		testTechnique->AddUniformBufferInformation(BufferInformation("Info", "", BufferView::BufferType::Uniform, move(variables)));
 
@@ -186,7 +189,7 @@ struct TempScene
 
 		testCubeTechnique->SetRasterizerState(resterizerState);
 		testCubeTechnique->SetDepthStencilState(depthStencilState);
-		testCubeTechnique->SetBlendState(blendState);
+		testCubeTechnique->SetBlendState(BlendState()); // opaque, so cubes are sorted by state and drawn together instead of by depth
 
 
 		RenderingTechniqueSP effect = TechniqueBuilder(testTechnique).GetRenderingTechnique();
@@ -338,9 +341,25 @@ struct TempScene
 	SceneObjectSP obj1;
 	SceneObjectSP obj2;
 
+	/*
+	 *	Checks once that clones of the cube are drawn as instances, after the scene has been rendered a few frames.
+	 */
+	void CheckInstancing()
+	{
+		FrameStatistics const& statistics = XREXContext::GetInstance().GetRenderingEngine().GetLastFrameStatistics();
+		// only the cube technique includes InstanceTransformation, other draws have one instance each.
+		bool instanced = statistics.instanceCount > statistics.drawCount;
+		cout << "frame of " << statistics.drawCount << " draws, " << statistics.instanceCount << " instances, cube clones instanced: " << (instanced ? "ok" : "failed") << endl;
+	}
+	uint32 frameCount_;
+
 	void Logic(double currentTime, double deltaTime)
 	{
-		auto& transformation = camera_->GetComponent<Transformation>();
+		if (++frameCount_ == 10)
+		{
+			CheckInstancing();
+		}
+		auto transformation = camera_->GetComponent<Transformation>();
 		floatV3 const& position = transformation->GetWorldPosition();
 		floatV3 to = TransformDirection(transformation->GetWorldMatrix(), transformation->GetModelFrontDirection());
 		floatV3 up = TransformDirection(transformation->GetWorldMatrix(), transformation->GetModelUpDirection());
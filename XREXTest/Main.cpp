@@ -8,13 +8,74 @@
 #include "TestFile.hpp"
 #include "GeneralTest.h"
 #include "RenderToTextureTest.h"
+#include "SponzaBenchmark.h"
+#include "MultiDrawTest.h"
 
 #include <iostream>
+#include <string>
 using namespace std;
 
+namespace
+{
+	/*
+	 *	Tests of TestFile checking their results, run by XREXTest test <name>.
+	 */
+	struct
+	{
+		char const* name;
+		bool (TestFile::*test)();
+	} const CheckedTests[] =
+	{
+		{ "SceneCullingSpeedTest", &TestFile::SceneCullingSpeedTest },
+		{ "TaskSchedulerStressTest", &TestFile::TaskSchedulerStressTest },
+		{ "BufferArenaAllocatorTest", &TestFile::BufferArenaAllocatorTest },
+		{ "CommandBufferSpeedTest", &TestFile::CommandBufferSpeedTest },
+		{ "RenderablePackCollectionTest", &TestFile::RenderablePackCollectionTest },
+		{ "ProfilerSpeedTest", &TestFile::ProfilerSpeedTest },
+		{ "FrameStatisticsHistoryTest", &TestFile::FrameStatisticsHistoryTest },
+		{ "MathSIMDTest", &TestFile::MathSIMDTest },
+		{ "FrustumCullingTest", &TestFile::FrustumCullingTest },
+		{ "FrustumCullingSpeedTest", &TestFile::FrustumCullingSpeedTest },
+		{ "MeshCacheSpeedTest", &TestFile::MeshCacheSpeedTest },
+		{ "TextureContainerSpeedTest", &TestFile::TextureContainerSpeedTest },
+		{ "BlockCompressionTest", &TestFile::BlockCompressionTest },
+		{ "MeshOptimizationTest", &TestFile::MeshOptimizationTest },
+	};
+}
 
-int main()
+
+int main(int argc, char** argv)
 {
+	// XREXTest test <name>, exits with 1 if the test failed.
+	if (argc > 2 && string(argv[1]) == "test")
+	{
+		for (auto& checkedTest : CheckedTests)
+		{
+			if (string(argv[2]) == checkedTest.name)
+			{
+				TestFile t;
+				return (t.*checkedTest.test)() ? 0 : 1;
+			}
+		}
+		cerr << "no checked test " << argv[2] << endl;
+		return 1;
+	}
+	// XREXTest sponza-benchmark [result file], runs without a window when built with XREX_HEADLESS, exits with 1 if it did not complete.
+	if (argc > 1 && string(argv[1]) == "sponza-benchmark")
+	{
+		SponzaBenchmark sponzaBenchmark(argc > 2 ? argv[2] : "SponzaBenchmark.json");
+		return sponzaBenchmark.IsCompleted() ? 0 : 1;
+	}
+	if (argc > 1 && string(argv[1]) == "sponza-async-loading")
+	{
+		SponzaAsyncLoadingTest sponzaAsyncLoadingTest;
+		return 0;
+	}
+	if (argc > 1 && string(argv[1]) == "multi-draw")
+	{
+		MultiDrawTest multiDrawTest;
+		return 0;
+	}
 
 	switch (2)
 	{
@@ -27,6 +88,22 @@ int main()
 		{
 			RenderToTextureTest renderToTextureTest;
 		}
+		break;
+	case 3:
+		{
+			SponzaBenchmark sponzaBenchmark("SponzaBenchmark.json");
+		}
+		break;
+	case 4:
+		{
+			SponzaAsyncLoadingTest sponzaAsyncLoadingTest;
+		}
+		break;
+	case 5:
+		{
+			MultiDrawTest multiDrawTest;
+		}
+		break;
 	default:
 		break;
 	}
@@ -38,11 +115,33 @@ int main()
 	//return 0;
 	//TestFile t;
 	//t.TestTransformation();
+	//t.SceneCullingSpeedTest();
+	//t.TransformationHierarchySpeedTest();
+	//t.TaskSchedulerStressTest();
+	//t.TaskSchedulerSpeedTest();
+	//t.FramePipelineSpeedTest();
+	//t.RenderSortSpeedTest();
+	//t.ParameterLookupSpeedTest();
+	//t.BufferArenaAllocatorTest();
+	//t.CommandBufferSpeedTest();
+	//t.RenderablePackCollectionTest();
+	//t.ProfilerSpeedTest();
+	//t.FrameStatisticsHistoryTest();
+	//t.MathSIMDTest();
+	//t.MathSIMDSpeedTest();
+	//t.FrustumCullingTest();
+	//t.FrustumCullingSpeedTest();
+	//t.MeshCacheSpeedTest();
+	//t.TextureContainerSpeedTest();
+	//t.BlockCompressionTest();
+	//t.MeshOptimizationTest();
 
 	return 0;
 }
 
+#ifdef _MSC_VER
 #define MEMORY_LEAK_CHECK
+#endif
 #ifdef MEMORY_LEAK_CHECK
 #define _CRTDBG_MAP_ALLOC
 #include <stdlib.h>
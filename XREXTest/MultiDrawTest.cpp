@@ -0,0 +1,221 @@
+#include "XREXAll.hpp"
+#include "MultiDrawTest.h"
+
+#include "Rendering/FrameStatistics.hpp"
+#include "HelperFacility/DefaultRenderingProcess.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+#undef LoadString
+
+using namespace std;
+using namespace XREX;
+
+namespace
+{
+	/*
+	 *	Cubes in a CubeEdgeCount x CubeEdgeCount grid, all in view.
+	 */
+	uint32 const CubeEdgeCount = 8;
+	float const CubeInterval = 2.f;
+	/*
+	 *	Frames rendered in each mode before reading statistics, so the mode change has reached rendering thread.
+	 */
+	uint32 const FramesPerMode = 10;
+
+	/*
+	 *	A cube of its own buffers, created by RenderingFactory so they are ranges of the buffer arena when it is enabled.
+	 */
+	RenderingLayoutSP MakeCubeLayout()
+	{
+		vector<floatV3> vertexData;
+		vertexData.push_back(floatV3(0.5, 0.5, 0.5));
+		vertexData.push_back(floatV3(0.5, -0.5, 0.5));
+		vertexData.push_back(floatV3(-0.5, -0.5, 0.5));
+		vertexData.push_back(floatV3(-0.5, 0.5, 0.5));
+		vertexData.push_back(floatV3(0.5, 0.5, -0.5));
+		vertexData.push_back(floatV3(0.5, -0.5, -0.5));
+		vertexData.push_back(floatV3(-0.5, -0.5, -0.5));
+		vertexData.push_back(floatV3(-0.5, 0.5, -0.5));
+
+		uint16 const indices[] =
+		{
+			0, 3, 2, 0, 2, 1,
+			4, 0, 1, 4, 1, 5,
+			7, 4, 5, 7, 5, 6,
+			3, 7, 6, 3, 6, 2,
+			0, 4, 7, 0, 7, 3,
+			6, 5, 1, 6, 1, 2,
+		};
+		vector<uint16> indexData(indices, indices + sizeof(indices) / sizeof(indices[0]));
+
+		RenderingFactory& factory = XREXContext::GetInstance().GetRenderingFactory();
+		VertexBufferSP vertices = factory.CreateVertexBuffer(GraphicsBuffer::Usage::StaticDraw, vertexData, "position");
+		IndexBufferSP indexBuffer = factory.CreateIndexBuffer(GraphicsBuffer::Usage::StaticDraw, indexData, IndexBuffer::TopologicalType::Triangles);
+		return factory.CreateRenderingLayout(vector<VertexBufferSP>(1, vertices), indexBuffer);
+	}
+
+	/*
+	 *	Positions and colors of a triangle in arenas of different formats, so their ranges start at different vertices after the cubes.
+	 *	@return: whether the layout got buffers of one base vertex.
+	 */
+	bool CheckLayoutOfDifferentArenas()
+	{
+		vector<floatV3> positionData(3, floatV3(0, 0, 0));
+		vector<floatV4> colorData(3, floatV4(1, 1, 1, 1));
+		vector<uint16> indexData;
+		indexData.push_back(0);
+		indexData.push_back(1);
+		indexData.push_back(2);
+
+		RenderingFactory& factory = XREXContext::GetInstance().GetRenderingFactory();
+		vector<VertexBufferSP> buffers;
+		buffers.push_back(factory.CreateVertexBuffer(GraphicsBuffer::Usage::StaticDraw, positionData, "position"));
+		buffers.push_back(factory.CreateVertexBuffer(GraphicsBuffer::Usage::StaticDraw, colorData, "color"));
+		IndexBufferSP indexBuffer = factory.CreateIndexBuffer(GraphicsBuffer::Usage::StaticDraw, indexData, IndexBuffer::TopologicalType::Triangles);
+		bool differentBefore = !RenderingLayout::HaveSameBaseVertex(buffers);
+		RenderingLayoutSP layout = factory.CreateRenderingLayout(buffers, indexBuffer);
+		bool sameAfter = RenderingLayout::HaveSameBaseVertex(layout->GetVertexBuffers()) && layout->GetBaseVertex() == 0;
+		cout << "layout of different arenas: base vertices " << (differentBefore ? "differ" : "do not differ") << " before, "
+			<< (sameAfter ? "are the same" : "still differ") << " in the layout." << endl;
+		return differentBefore && sameAfter;
+	}
+
+	RenderingTechniqueSP MakeMultiDrawTechnique()
+	{
+		string shaderFile = "../../XREXTest/Effects/TestMultiDraw.glsl";
+		shared_ptr<string> shaderString = XREXContext::GetInstance().GetResourceLoader().LoadString(shaderFile);
+		if (!shaderString)
+		{
+			cerr << "file not found. file: " << shaderFile << endl;
+			return nullptr;
+		}
+
+		TechniqueBuildingInformationSP technique = MakeSP<TechniqueBuildingInformation>("multi draw test technique");
+		technique->AddCommonCode(shaderString);
+		technique->AddStageCode(ShaderObject::ShaderType::VertexShader, MakeSP<string>());
+		technique->AddStageCode(ShaderObject::ShaderType::FragmentShader, MakeSP<string>());
+		technique->AddInclude(DrawParametersTechniqueFactory().GetTechniqueInformationToInclude());
+		technique->AddAttributeInputInformation(AttributeInputInformation("position", ElementType::FloatV3));
+		technique->SetFrameBufferDescription(XREXContext::GetInstance().GetRenderingEngine().GetDefaultFrameBuffer()->GetLayoutDescription());
+		technique->SetRasterizerState(RasterizerState());
+		technique->SetDepthStencilState(DepthStencilState());
+		technique->SetBlendState(BlendState());
+
+		RenderingTechniqueSP effect = TechniqueBuilder(technique).GetRenderingTechnique();
+		effect->ConnectFrameBuffer(XREXContext::GetInstance().GetRenderingEngine().GetDefaultFrameBuffer());
+		return effect;
+	}
+}
+
+
+
+MultiDrawTest::MultiDrawTest()
+{
+	Settings settings("../../");
+	settings.windowTitle = L"Multi draw test";
+	settings.renderingSettings.sampleCount = 1;
+	settings.renderingSettings.width = 800;
+	settings.renderingSettings.height = 600;
+	settings.framesInFlight = 0; // statistics read in logic function are of the frame rendered with the mode just set
+
+	XREXContext::GetInstance().Initialize(settings);
+	RenderingEngine& engine = XREXContext::GetInstance().GetRenderingEngine();
+	shared_ptr<DefaultRenderingProcess> process = CheckedSPCast<DefaultRenderingProcess>(engine.GetRenderingProcess());
+
+	RenderingTechniqueSP effect = MakeMultiDrawTechnique();
+	if (effect == nullptr)
+	{
+		return;
+	}
+
+	RenderingFactory& factory = XREXContext::GetInstance().GetRenderingFactory();
+	factory.SetBufferArenaEnabled(true);
+	SceneSP scene = XREXContext::GetInstance().GetScene();
+	vector<SceneObjectSP> cubes;
+	float center = static_cast<float>(CubeEdgeCount - 1) / 2;
+	for (uint32 i = 0; i < CubeEdgeCount; ++i)
+	{
+		for (uint32 j = 0; j < CubeEdgeCount; ++j)
+		{
+			stringstream nameStream;
+			nameStream << "cube" << i << "_" << j;
+			MeshSP mesh = MakeSP<Mesh>(nameStream.str());
+			mesh->CreateSubMesh(nameStream.str(), MakeCubeLayout(), nullptr, effect);
+			SceneObjectSP cube = MakeSP<SceneObject>(nameStream.str());
+			cube->SetComponent(mesh);
+			cube->GetComponent<Transformation>()->SetPosition(floatV3((i - center) * CubeInterval, (j - center) * CubeInterval, 0));
+			scene->AddObject(cube);
+			cubes.push_back(cube);
+		}
+	}
+	bool differentArenasPassed = CheckLayoutOfDifferentArenas();
+	factory.SetBufferArenaEnabled(false);
+
+	SceneObjectSP cameraObject = MakeSP<SceneObject>("multi draw camera");
+	cameraObject->SetComponent(MakeSP<PerspectiveCamera>(PI / 3, static_cast<float>(settings.renderingSettings.width) / settings.renderingSettings.height, 1.f, 1000.f));
+	cameraObject->GetComponent<Transformation>()->SetPosition(floatV3(0, 0, -30));
+	cameraObject->GetComponent<Transformation>()->FaceToPosition(floatV3(0, 0, 0), floatV3(0, 1, 0));
+	scene->AddObject(cameraObject);
+
+	DefaultRenderingProcess::DrawStatistics multiDrawStatistics;
+	DefaultRenderingProcess::DrawStatistics perDrawStatistics;
+	uint32 multiDrawFrameDrawCount = 0;
+	uint32 perDrawFrameDrawCount = 0;
+	uint32 frame = 0;
+	process->SetIndirectDrawingEnabled(true);
+	XREXContext::GetInstance().SetLogicFunction([&] (double current, double delta)
+	{
+		++frame;
+		if (frame == FramesPerMode)
+		{
+			multiDrawStatistics = process->GetLastDrawStatistics();
+			multiDrawFrameDrawCount = engine.GetLastFrameStatistics().drawCount;
+			process->SetIndirectDrawingEnabled(false);
+		}
+		else if (frame == FramesPerMode * 2)
+		{
+			perDrawStatistics = process->GetLastDrawStatistics();
+			perDrawFrameDrawCount = engine.GetLastFrameStatistics().drawCount;
+			return false;
+		}
+		return true;
+	});
+
+	XREXContext::GetInstance().Start();
+
+	uint32 cubeCount = CubeEdgeCount * CubeEdgeCount;
+	cout << "multi draw: " << multiDrawStatistics.drawCount << " draw calls for " << multiDrawStatistics.packCount << " packs, "
+		<< multiDrawFrameDrawCount << " draws." << endl;
+	cout << "a multi draw for each pack: " << perDrawStatistics.drawCount << " draw calls for " << perDrawStatistics.packCount << " packs, "
+		<< perDrawFrameDrawCount << " draws." << endl;
+	// all cubes share one arena page and the technique, so they are one bucket.
+	bool passed = multiDrawStatistics.packCount == cubeCount && perDrawStatistics.packCount == cubeCount
+		&& perDrawStatistics.drawCount == cubeCount && multiDrawStatistics.drawCount == 1
+		&& multiDrawFrameDrawCount == perDrawFrameDrawCount;
+	cout << (passed ? "passed" : "failed") << endl;
+
+	process->SetIndirectDrawingEnabled(true);
+	XREXContext::GetInstance().SetLogicFunction(function<bool(double, double)>());
+	scene->RemoveObject(cameraObject);
+	for (auto& cube : cubes)
+	{
+		scene->RemoveObject(cube);
+	}
+
+	// pages of the cubes are released with their layouts.
+	uint32 pageCountInUse = factory.GetBufferArenaPageCount();
+	cubes.clear();
+	factory.ReleaseUnusedConnectors();
+	uint32 pageCountReleased = factory.GetBufferArenaPageCount();
+	cout << "arena pages: " << pageCountInUse << " in use, " << pageCountReleased << " after releasing the cubes." << endl;
+	bool arenaPassed = differentArenasPassed && pageCountInUse != 0 && pageCountReleased == 0;
+	cout << "buffer arena " << (arenaPassed ? "passed" : "failed") << endl;
+}
+
+
+MultiDrawTest::~MultiDrawTest()
+{
+}
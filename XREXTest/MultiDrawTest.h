@@ -0,0 +1,15 @@
+#pragma once
+
+/*
+ *	Renders cubes with their own layouts in the buffer arena by a technique including DrawParameters system technique,
+ *	with indirect drawing of DefaultRenderingProcess enabled and then disabled,
+ *	then checks that multi draws draw the same packs by fewer draw calls than a multi draw for each pack.
+ *	Also checks that a layout of ranges starting at different vertices gets buffers of its own,
+ *	and that arena pages are released with the cubes.
+ */
+class MultiDrawTest
+{
+public:
+	MultiDrawTest();
+	~MultiDrawTest();
+};
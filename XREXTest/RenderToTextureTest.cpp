@@ -290,6 +290,11 @@ namespace
 
 		uint32 glQuery;
 
+		/*
+		 *	Required by RenderablePackCollector, only small packs are collected, which do not use it.
+		 */
+		FrameArena collectorArena_;
+
 		void InitializeShadowTextureAndFrameBuffer()
 		{
 			string framebufferFile = "XREXTest/Effects/ShadowMapBuffer.framebuffer";
@@ -525,7 +530,7 @@ namespace
 			std::vector<SceneObjectSP> sceneObjects = scene->GetRenderableQueue(nullptr);
 
 
-			RenderablePackCollector collector;
+			RenderablePackCollector collector(collectorArena_);
 			for (SceneObjectSP sceneObject : sceneObjects)
 			{
 				RenderableSP renderable = sceneObject->GetComponent<Renderable>();
@@ -585,7 +590,7 @@ namespace
 			std::vector<SceneObjectSP> sceneObjects = scene->GetRenderableQueue(nullptr);
 
 
-			RenderablePackCollector collector;
+			RenderablePackCollector collector(collectorArena_);
 			for (SceneObjectSP sceneObject : sceneObjects)
 			{
 				RenderableSP renderable = sceneObject->GetComponent<Renderable>();
@@ -637,7 +642,7 @@ namespace
 			//XREXContext::GetInstance().GetRenderingEngine().GetDefaultFrameBuffer()->Clear(FrameBuffer::ClearMask::All, Color(0, 0, 0, 1), 1, 0);
 			tempBuffer_->Clear(FrameBuffer::ClearMask::All, Color(0, 0, 0, 1), 1, 0);
 
-			RenderablePackCollector collector;
+			RenderablePackCollector collector(collectorArena_);
 
 			RenderableSP renderable = light.lightObject_->GetComponent<Renderable>();
 			assert(renderable != nullptr);
@@ -835,7 +840,7 @@ RenderToTextureTest::RenderToTextureTest()
 	function<bool(double current, double delta)> l = [&theProcess] (double current, double delta)
 	{
 		auto process = CheckedSPCast<RenderToTextureProcess>(theProcess);
-		auto& transformation = process->viewCamera_.theCameraObject_->GetComponent<Transformation>();
+		auto transformation = process->viewCamera_.theCameraObject_->GetComponent<Transformation>();
 		floatV3 const& position = transformation->GetWorldPosition();
 		floatV3 to = TransformDirection(transformation->GetWorldMatrix(), transformation->GetModelFrontDirection());
 		floatV3 up = TransformDirection(transformation->GetWorldMatrix(), transformation->GetModelUpDirection());
@@ -0,0 +1,482 @@
+#include "XREXAll.hpp"
+#include "SponzaBenchmark.h"
+
+#include "Rendering/FrameStatistics.hpp"
+
+#include <CoreGL.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <cmath>
+
+#undef LoadString
+
+using namespace std;
+using namespace XREX;
+
+namespace
+{
+	/*
+	 *	Frames rendered before measuring, so shader compilation and first uploads are not measured.
+	 */
+	uint32 const WarmupFrameCount = 30;
+	uint32 const MeasuredFrameCount = 600;
+	/*
+	 *	Camera moves by frame index instead of elapsed time, so every run renders the same frames.
+	 */
+	float const TimeStep = 1.f / 60;
+	float const LoopTime = 10; // seconds of a camera loop
+
+	/*
+	 *	Closed camera loop through the atrium, eye height first then the gallery.
+	 */
+	floatV3 const CameraPath[] =
+	{
+		floatV3(-1200, 180, -40),
+		floatV3(-500, 160, 380),
+		floatV3(500, 160, 380),
+		floatV3(1150, 200, 0),
+		floatV3(500, 620, -420),
+		floatV3(-500, 620, -420),
+	};
+	uint32 const CameraPathPointCount = sizeof(CameraPath) / sizeof(CameraPath[0]);
+
+	/*
+	 *	Centripetal parameterization is not needed for evenly spaced points, uniform Catmull-Rom.
+	 *	@time: in [0, 1) for a loop.
+	 */
+	floatV3 CameraPathPosition(float time)
+	{
+		float segmentTime = (time - std::floor(time)) * CameraPathPointCount;
+		uint32 segment = static_cast<uint32>(segmentTime) % CameraPathPointCount;
+		float t = segmentTime - std::floor(segmentTime);
+		floatV3 const& p0 = CameraPath[(segment + CameraPathPointCount - 1) % CameraPathPointCount];
+		floatV3 const& p1 = CameraPath[segment];
+		floatV3 const& p2 = CameraPath[(segment + 1) % CameraPathPointCount];
+		floatV3 const& p3 = CameraPath[(segment + 2) % CameraPathPointCount];
+		float t2 = t * t;
+		float t3 = t2 * t;
+		return (p1 * 2 + (p2 - p0) * t + (p0 * 2 - p1 * 5 + p2 * 4 - p3) * t2 + (p1 * 3 - p0 - p2 * 3 + p3) * t3) * 0.5f;
+	}
+
+	/*
+	 *	GL_TIME_ELAPSED of each frame from OnBeforeRendering to OnAfterRendering.
+	 *	Results are read FrameLatency frames later, so measuring does not wait for the GPU.
+	 */
+	struct GPUFrameTimer
+	{
+		static uint32 const FrameLatency = 3;
+
+		GPUFrameTimer()
+			: frameCount_(0)
+		{
+			gl::GenQueries(FrameLatency, queries_);
+		}
+		~GPUFrameTimer()
+		{
+			gl::DeleteQueries(FrameLatency, queries_);
+		}
+
+		void BeginFrame()
+		{
+			uint32 slot = frameCount_ % FrameLatency;
+			if (frameCount_ >= FrameLatency)
+			{
+				ReadResult(frameCount_ - FrameLatency);
+			}
+			gl::BeginQuery(gl::GL_TIME_ELAPSED, queries_[slot]);
+		}
+		void EndFrame()
+		{
+			gl::EndQuery(gl::GL_TIME_ELAPSED);
+			++frameCount_;
+		}
+		/*
+		 *	Read results of frames not read yet.
+		 */
+		void Finish()
+		{
+			for (uint32 frame = frameCount_ > FrameLatency ? frameCount_ - FrameLatency : 0; frame < frameCount_; ++frame)
+			{
+				ReadResult(frame);
+			}
+		}
+
+		/*
+		 *	In seconds, indexed by frame.
+		 */
+		vector<double> const& GetFrameTimes() const
+		{
+			return frameTimes_;
+		}
+
+	private:
+		void ReadResult(uint32 frame)
+		{
+			GLuint64 elapsed = 0;
+			gl::GetQueryObjectui64v(queries_[frame % FrameLatency], gl::GL_QUERY_RESULT, &elapsed);
+			if (frameTimes_.size() <= frame)
+			{
+				frameTimes_.resize(frame + 1, 0);
+			}
+			frameTimes_[frame] = elapsed * 1e-9;
+		}
+
+	private:
+		uint32 queries_[FrameLatency];
+		uint32 frameCount_;
+		vector<double> frameTimes_;
+	};
+
+	/*
+	 *	Nearest rank, same as FrameStatisticsHistory::GetPercentileFrameTime.
+	 */
+	double Percentile(vector<double> values, float percentile)
+	{
+		if (values.empty())
+		{
+			return 0;
+		}
+		uint32 count = values.size();
+		uint32 rank = std::min(static_cast<uint32>(std::ceil(percentile * count)), count);
+		uint32 index = rank == 0 ? 0 : rank - 1;
+		std::nth_element(values.begin(), values.begin() + index, values.end());
+		return values[index];
+	}
+
+	void WriteSummary(ostream& stream, char const* name, vector<double> const& values, double scale)
+	{
+		double sum = 0;
+		for (double value : values)
+		{
+			sum += value;
+		}
+		stream << "\t\"" << name << "\": { "
+			<< "\"p50\": " << Percentile(values, 0.5f) * scale
+			<< ", \"p95\": " << Percentile(values, 0.95f) * scale
+			<< ", \"p99\": " << Percentile(values, 0.99f) * scale
+			<< ", \"min\": " << (values.empty() ? 0 : *std::min_element(values.begin(), values.end())) * scale
+			<< ", \"max\": " << (values.empty() ? 0 : *std::max_element(values.begin(), values.end())) * scale
+			<< ", \"average\": " << (values.empty() ? 0 : sum / values.size()) * scale << " }";
+	}
+
+	RenderingTechniqueSP MakeSponzaTechnique()
+	{
+		string shaderFile = "../../XREXTest/Effects/Test.glsl";
+		shared_ptr<string> shaderString = XREXContext::GetInstance().GetResourceLoader().LoadString(shaderFile);
+		if (!shaderString)
+		{
+			cerr << "file not found. file: " << shaderFile << endl;
+			return nullptr;
+		}
+
+		TechniqueBuildingInformationSP technique = MakeSP<TechniqueBuildingInformation>("sponza benchmark technique");
+		technique->AddCommonCode(shaderString);
+		technique->AddStageCode(ShaderObject::ShaderType::VertexShader, MakeSP<string>());
+		technique->AddStageCode(ShaderObject::ShaderType::FragmentShader, MakeSP<string>());
+		technique->AddInclude(TransformationTechniqueFactory().GetTechniqueInformationToInclude());
+		technique->AddInclude(CameraTechniqueFactory().GetTechniqueInformationToInclude());
+
+		vector<VariableInformation> variables;
+		technique->AddUniformBufferInformation(BufferInformation("Material", "", BufferView::BufferType::Uniform, move(variables)));
+		technique->AddUniformBufferInformation(BufferInformation("Info", "", BufferView::BufferType::Uniform, move(variables)));
+
+		string defaultSamplerName = "defaultSampler";
+		technique->AddSamplerState(defaultSamplerName, SamplerState());
+		technique->AddTextureInformation(TextureInformation("diffuseMap", Texture::TextureType::Texture2D, Texture::TexelType::FloatV4, defaultSamplerName));
+		technique->AddTextureInformation(TextureInformation("specularMap", Texture::TextureType::Texture2D, Texture::TexelType::FloatV4, defaultSamplerName));
+		technique->AddTextureInformation(TextureInformation("normalMap", Texture::TextureType::Texture2D, Texture::TexelType::FloatV4, defaultSamplerName));
+		technique->AddTextureInformation(TextureInformation("shininessMap", Texture::TextureType::Texture2D, Texture::TexelType::FloatV4, defaultSamplerName));
+		technique->AddTextureInformation(TextureInformation("opacityMap", Texture::TextureType::Texture2D, Texture::TexelType::FloatV4, defaultSamplerName));
+
+		technique->AddAttributeInputInformation(AttributeInputInformation("position", ElementType::FloatV3));
+		technique->AddAttributeInputInformation(AttributeInputInformation("normal", ElementType::FloatV3));
+		technique->AddAttributeInputInformation(AttributeInputInformation("textureCoordinate0", ElementType::FloatV3));
+
+		technique->SetFrameBufferDescription(XREXContext::GetInstance().GetRenderingEngine().GetDefaultFrameBuffer()->GetLayoutDescription());
+		technique->SetRasterizerState(RasterizerState());
+		technique->SetDepthStencilState(DepthStencilState());
+		technique->SetBlendState(BlendState()); // opaque, so sorting is by state only
+
+		RenderingTechniqueSP effect = TechniqueBuilder(technique).GetRenderingTechnique();
+		effect->ConnectFrameBuffer(XREXContext::GetInstance().GetRenderingEngine().GetDefaultFrameBuffer());
+		return effect;
+	}
+}
+
+
+
+SponzaBenchmark::SponzaBenchmark(string const& resultFile)
+	: completed_(false)
+{
+	Settings settings("../../");
+	settings.windowTitle = L"Sponza benchmark";
+	settings.renderingSettings.sampleCount = 1;
+	settings.renderingSettings.width = 1280;
+	settings.renderingSettings.height = 720;
+	settings.framesInFlight = 0; // logic and rendering in lock step, frame i always renders camera position i
+
+	XREXContext::GetInstance().Initialize(settings);
+	RenderingEngine& engine = XREXContext::GetInstance().GetRenderingEngine();
+
+	// the cache written by the first run would be loaded by later ones, import every time so load times compare.
+	ResourceManager& resourceManager = XREXContext::GetInstance().GetResourceManager();
+	bool meshCacheEnabled = resourceManager.IsMeshCacheEnabled();
+	resourceManager.SetMeshCacheEnabled(false);
+	Timer loadTimer;
+	resourceManager.AddResourceLocation("Data/");
+	MeshLoadingResultSP loadingResult = resourceManager.LoadModel("crytek-sponza/sponza.obj");
+	MeshSP model = loadingResult != nullptr ? loadingResult->Create() : nullptr;
+	double loadTime = loadTimer.Elapsed();
+	resourceManager.SetMeshCacheEnabled(meshCacheEnabled);
+	if (model == nullptr)
+	{
+		cerr << "crytek-sponza/sponza.obj not loaded." << endl;
+		return;
+	}
+
+	RenderingTechniqueSP effect = MakeSponzaTechnique();
+	if (effect == nullptr)
+	{
+		return;
+	}
+	TechniqueParameterSP const& centerPosition = effect->GetParameterByName("centerPosition");
+	if (centerPosition)
+	{
+		centerPosition->As<floatV3>().SetValue(floatV3(0, 0, 0));
+	}
+	for (auto& subMesh : model->GetAllSubMeshes())
+	{
+		subMesh->SetTechnique(effect);
+	}
+
+	SceneSP scene = XREXContext::GetInstance().GetScene();
+	SceneObjectSP modelObject = MakeSP<SceneObject>("sponza");
+	modelObject->SetComponent(model);
+	scene->AddObject(modelObject);
+
+	SceneObjectSP cameraObject = MakeSP<SceneObject>("benchmark camera");
+	cameraObject->SetComponent(MakeSP<PerspectiveCamera>(PI / 3, static_cast<float>(settings.renderingSettings.width) / settings.renderingSettings.height, 1.f, 10000.f));
+	scene->AddObject(cameraObject);
+
+	GPUFrameTimer gpuTimer;
+	engine.OnBeforeRendering([&gpuTimer] (double current, double delta)
+	{
+		gpuTimer.BeginFrame();
+	});
+	engine.OnAfterRendering([&gpuTimer] (double current, double delta)
+	{
+		gpuTimer.EndFrame();
+	});
+
+	vector<double> frameTimes;
+	vector<double> renderTimes;
+	vector<double> drawCounts;
+	vector<double> triangleCounts;
+	uint32 frame = 0;
+	XREXContext::GetInstance().SetLogicFunction([&] (double current, double delta)
+	{
+		// statistics of the last frame are complete when the logic of the next one runs.
+		if (frame > WarmupFrameCount)
+		{
+			FrameStatistics const& statistics = engine.GetLastFrameStatistics();
+			frameTimes.push_back(statistics.frameTime);
+			renderTimes.push_back(statistics.renderTime);
+			drawCounts.push_back(statistics.drawCount);
+			triangleCounts.push_back(static_cast<double>(statistics.triangleCount));
+		}
+		if (frame == WarmupFrameCount + MeasuredFrameCount)
+		{
+			return false;
+		}
+
+		float time = frame * TimeStep / LoopTime;
+		floatV3 position = CameraPathPosition(time);
+		floatV3 target = CameraPathPosition(time + 0.02f);
+		TransformationSP transformation = cameraObject->GetComponent<Transformation>();
+		transformation->SetPosition(position);
+		transformation->FaceToPosition(target, floatV3(0, 1, 0));
+		++frame;
+		return true;
+	});
+
+	XREXContext::GetInstance().Start();
+	gpuTimer.Finish();
+
+	vector<double> gpuTimes;
+	vector<double> const& allGPUTimes = gpuTimer.GetFrameTimes();
+	for (uint32 i = WarmupFrameCount; i < std::min<uint32>(WarmupFrameCount + MeasuredFrameCount, allGPUTimes.size()); ++i)
+	{
+		gpuTimes.push_back(allGPUTimes[i]);
+	}
+
+	ostringstream json;
+	json.setf(ios::fixed);
+	json.precision(3);
+	json << "{" << endl;
+	json << "\t\"benchmark\": \"sponza\"," << endl;
+	json << "\t\"renderer\": \"" << reinterpret_cast<char const*>(gl::GetString(gl::GL_RENDERER)) << "\"," << endl;
+	json << "\t\"width\": " << settings.renderingSettings.width << ", \"height\": " << settings.renderingSettings.height << "," << endl;
+	json << "\t\"warmupFrames\": " << WarmupFrameCount << ", \"frames\": " << frameTimes.size() << ", \"timeStep\": " << TimeStep << "," << endl;
+	json << "\t\"loadTimeMs\": " << loadTime * 1000 << ", \"meshLoadPath\": \"import\"," << endl;
+	WriteSummary(json, "frameTimeMs", frameTimes, 1000);
+	json << "," << endl;
+	WriteSummary(json, "cpuRenderTimeMs", renderTimes, 1000);
+	json << "," << endl;
+	WriteSummary(json, "gpuTimeMs", gpuTimes, 1000);
+	json << "," << endl;
+	WriteSummary(json, "drawCalls", drawCounts, 1);
+	json << "," << endl;
+	WriteSummary(json, "triangles", triangleCounts, 1);
+	json << endl << "}" << endl;
+
+	cout << json.str();
+	ofstream file(resultFile);
+	file << json.str();
+	completed_ = true;
+
+	engine.OnBeforeRendering(function<void(double, double)>());
+	engine.OnAfterRendering(function<void(double, double)>());
+	XREXContext::GetInstance().SetLogicFunction(function<bool(double, double)>());
+	scene->RemoveObject(cameraObject);
+	scene->RemoveObject(modelObject);
+}
+
+
+SponzaBenchmark::~SponzaBenchmark()
+{
+}
+
+
+
+namespace
+{
+	/*
+	 *	Frame time allowed while loading asynchronously, rendering plus upload budget of Settings with plenty of margin.
+	 */
+	double const MaxLoadingFrameTime = 0.05;
+	uint32 const FramesAfterLoading = 120;
+}
+
+SponzaAsyncLoadingTest::SponzaAsyncLoadingTest()
+{
+	Settings settings("../../");
+	settings.windowTitle = L"Sponza asynchronous loading";
+	settings.renderingSettings.sampleCount = 1;
+	settings.renderingSettings.width = 1280;
+	settings.renderingSettings.height = 720;
+	settings.framesInFlight = 0; // uploads of a frame are done before its logic, statistics of them are complete in logic function
+
+	XREXContext::GetInstance().Initialize(settings);
+	ResourceManager& resourceManager = XREXContext::GetInstance().GetResourceManager();
+	resourceManager.AddResourceLocation("Data/");
+
+	RenderingTechniqueSP effect = MakeSponzaTechnique();
+	if (effect == nullptr)
+	{
+		return;
+	}
+	TechniqueParameterSP const& centerPosition = effect->GetParameterByName("centerPosition");
+	if (centerPosition)
+	{
+		centerPosition->As<floatV3>().SetValue(floatV3(0, 0, 0));
+	}
+
+	SceneSP scene = XREXContext::GetInstance().GetScene();
+	SceneObjectSP cameraObject = MakeSP<SceneObject>("loading camera");
+	cameraObject->SetComponent(MakeSP<PerspectiveCamera>(PI / 3, static_cast<float>(settings.renderingSettings.width) / settings.renderingSettings.height, 1.f, 10000.f));
+	cameraObject->GetComponent<Transformation>()->SetPosition(CameraPath[0]);
+	cameraObject->GetComponent<Transformation>()->FaceToPosition(floatV3(0, 200, 0), floatV3(0, 1, 0));
+	scene->AddObject(cameraObject);
+
+	Timer loadTimer;
+	AsyncMeshLoadingResultSP loadingResult = resourceManager.LoadModelAsync("crytek-sponza/sponza.obj");
+	double requestTime = loadTimer.Elapsed();
+	if (!loadingResult->Succeeded())
+	{
+		cerr << "crytek-sponza/sponza.obj not found." << endl;
+		return;
+	}
+
+	SceneObjectSP modelObject;
+	vector<double> loadingFrameTimes;
+	double loadTime = 0;
+	double maxUploadTime = 0;
+	uint64 uploadedBytes = 0;
+	uint32 uploadedCount = 0;
+	uint32 framesAfterLoading = 0;
+	bool failed = false;
+	Timer frameTimer;
+	XREXContext::GetInstance().SetLogicFunction([&] (double current, double delta)
+	{
+		double frameTime = frameTimer.Elapsed();
+		frameTimer.Restart();
+		if (modelObject)
+		{
+			return ++framesAfterLoading < FramesAfterLoading;
+		}
+
+		AsyncResourceLoader::UploadStatistics const& upload = resourceManager.GetLastUploadStatistics();
+		loadingFrameTimes.push_back(frameTime);
+		maxUploadTime = std::max(maxUploadTime, upload.time);
+		uploadedBytes += upload.createdBytes;
+		uploadedCount += upload.createdCount;
+
+		MeshSP const& model = loadingResult->GetCreated();
+		if (model)
+		{
+			loadTime = loadTimer.Elapsed();
+			for (auto& subMesh : model->GetAllSubMeshes())
+			{
+				subMesh->SetTechnique(effect);
+			}
+			modelObject = MakeSP<SceneObject>("sponza");
+			modelObject->SetComponent(model);
+			scene->AddObject(modelObject);
+		}
+		else if (!loadingResult->Succeeded())
+		{
+			failed = true;
+			return false;
+		}
+		return true;
+	});
+
+	XREXContext::GetInstance().Start();
+
+	if (failed || !modelObject)
+	{
+		cerr << "crytek-sponza/sponza.obj not loaded." << endl;
+	}
+	else
+	{
+		if (!loadingFrameTimes.empty())
+		{
+			loadingFrameTimes.erase(loadingFrameTimes.begin()); // first frame includes time before Start
+		}
+		double maxFrameTime = loadingFrameTimes.empty() ? 0 : *std::max_element(loadingFrameTimes.begin(), loadingFrameTimes.end());
+		cout.setf(ios::fixed);
+		cout.precision(3);
+		cout << "asynchronous loading of sponza:" << endl;
+		cout << "request returned in " << requestTime * 1000 << "ms, loaded in " << loadTime * 1000 << "ms, " << loadingFrameTimes.size() << " frames rendered meanwhile." << endl;
+		cout << uploadedCount << " resources created, " << uploadedBytes / (1024.0 * 1024.0) << "MB, max upload time in a frame: " << maxUploadTime * 1000
+			<< "ms, budget: " << settings.resourceUploadTimeBudget * 1000 << "ms " << settings.resourceUploadByteBudget / (1024.0 * 1024.0) << "MB." << endl;
+		cout << "frame time while loading p50: " << Percentile(loadingFrameTimes, 0.5f) * 1000 << "ms, p99: " << Percentile(loadingFrameTimes, 0.99f) * 1000
+			<< "ms, max: " << maxFrameTime * 1000 << "ms." << endl;
+		cout << (maxFrameTime <= MaxLoadingFrameTime ? "passed" : "failed") << ", frame time limit: " << MaxLoadingFrameTime * 1000 << "ms." << endl;
+	}
+
+	XREXContext::GetInstance().SetLogicFunction(function<bool(double, double)>());
+	scene->RemoveObject(cameraObject);
+	if (modelObject)
+	{
+		scene->RemoveObject(modelObject);
+	}
+}
+
+
+SponzaAsyncLoadingTest::~SponzaAsyncLoadingTest()
+{
+}
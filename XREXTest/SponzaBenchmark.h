@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+/*
+ *	Renders crytek-sponza with DefaultRenderingProcess along a scripted camera path for a fixed number of frames,
+ *	then writes frame time, GPU time, draw call and load time statistics as JSON to resultFile and cout.
+ *	The mesh cache is disabled while loading, so the load time of every run is of importing the model, which needs assimp.
+ *	Runs without a window with the XREX_HEADLESS backend, see XREX.hpp.
+ */
+class SponzaBenchmark
+{
+public:
+	explicit SponzaBenchmark(std::string const& resultFile);
+	~SponzaBenchmark();
+
+	/*
+	 *	@return: false if the benchmark did not run to the end, no result is written then.
+	 */
+	bool IsCompleted() const
+	{
+		return completed_;
+	}
+
+private:
+	bool completed_;
+};
+
+/*
+ *	Loads crytek-sponza with ResourceManager::LoadModelAsync while frames keep rendering,
+ *	then prints loading time and frame times while loading, checked against a frame time limit.
+ */
+class SponzaAsyncLoadingTest
+{
+public:
+	SponzaAsyncLoadingTest();
+	~SponzaAsyncLoadingTest();
+};
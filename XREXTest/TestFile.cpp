@@ -2,7 +2,39 @@
 
 #include "TestFile.hpp"
 
+#include "HelperFacility/NaiveManagedScene.hpp"
+#include "HelperFacility/BVHManagedScene.hpp"
+#include "Scene/TransformationHierarchy.hpp"
+#include "HelperFacility/RenderSortKey.hpp"
+#include "Rendering/BufferArena.hpp"
+#include "Rendering/CommandBuffer.hpp"
+#include "Rendering/FrameSnapshot.hpp"
+#include "Base/FrameArena.hpp"
+#include "Base/Profiler.hpp"
+#include "Rendering/FrameStatistics.hpp"
+#include "Base/MathHelper.hpp"
+#include "Base/FrustumCulling.hpp"
+#include "HelperFacility/DefaultRenderingProcess.hpp"
+
 #include <iostream>
+#include <random>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <set>
+#include <array>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+#include <crtdbg.h>
+#endif
 
 
 
@@ -199,6 +231,2111 @@ void TestFile::TestTransformation()
 	floatM44 cm1 = child->GetWorldMatrix();
 }
 
+bool TestFile::SceneCullingSpeedTest()
+{
+	uint32 const FrameCount = 20;
+	float const WorldSize = 1000.0f;
+	uint32 const ObjectCounts[] = {1000, 10000, 100000};
+
+	// cameras take the default viewport of the context
+	Settings settings("../../");
+	settings.windowTitle = L"Scene culling speed test";
+	settings.renderingSettings.width = 64;
+	settings.renderingSettings.height = 64;
+	XREXContext::GetInstance().Initialize(settings);
+	SceneObjectSP cameraObject = MakeSP<SceneObject>("camera");
+	cameraObject->SetComponent(MakeSP<PerspectiveCamera>(PI / 3, 4.0f / 3.0f, 1.0f, WorldSize * 0.5f));
+
+	struct SceneResult
+	{
+		double buildTime;
+		double staticTime;
+		double movingTime;
+		std::vector<std::vector<SceneObject*>> visibleObjects; // of each frame, sorted
+	};
+	// both scenes start from the same positions and move objects the same way, so they should see the same objects every frame.
+	auto runScene = [&] (SceneSP const& scene, std::vector<SceneObjectSP> const& objects, std::vector<floatV3> const& positions)
+	{
+		std::mt19937 moveRandom(0);
+		std::uniform_real_distribution<float> moveDistribution(-1, 1);
+		cameraObject->GetComponent<Transformation>()->SetOrientation(floatQ::Identity);
+		for (uint32 i = 0; i < objects.size(); ++i)
+		{
+			objects[i]->GetComponent<Transformation>()->SetPosition(positions[i]);
+		}
+
+		SceneResult result;
+		std::vector<SceneObjectSP> queue;
+		auto recordVisibleObjects = [&result, &queue] ()
+		{
+			std::vector<SceneObject*> visibleObjects;
+			for (auto& object : queue)
+			{
+				visibleObjects.push_back(object.get());
+			}
+			std::sort(visibleObjects.begin(), visibleObjects.end());
+			result.visibleObjects.push_back(std::move(visibleObjects));
+		};
+
+		Timer t;
+		scene->AddObject(cameraObject);
+		for (auto& object : objects)
+		{
+			scene->AddObject(object);
+		}
+		result.buildTime = t.Elapsed();
+
+		result.staticTime = 0;
+		for (uint32 frame = 0; frame < FrameCount; ++frame)
+		{
+			t.Restart();
+			cameraObject->GetComponent<Transformation>()->Rotate(PI * 2 / FrameCount, 0, 1, 0);
+			scene->GetRenderableQueue(cameraObject, queue);
+			result.staticTime += t.Elapsed() / FrameCount;
+			recordVisibleObjects();
+		}
+
+		result.movingTime = 0;
+		for (uint32 frame = 0; frame < FrameCount; ++frame)
+		{
+			t.Restart();
+			for (uint32 i = 0; i < objects.size(); i += 10) // 10% objects moving
+			{
+				objects[i]->GetComponent<Transformation>()->Translate(moveDistribution(moveRandom), moveDistribution(moveRandom), moveDistribution(moveRandom));
+			}
+			scene->GetRenderableQueue(cameraObject, queue);
+			result.movingTime += t.Elapsed() / FrameCount;
+			recordVisibleObjects();
+		}
+		scene->ClearAllObject();
+		return result;
+	};
+
+	bool passed = true;
+	for (uint32 objectCount : ObjectCounts)
+	{
+		std::mt19937 random(objectCount);
+		std::uniform_real_distribution<float> positionDistribution(-WorldSize * 0.5f, WorldSize * 0.5f);
+		std::vector<SceneObjectSP> objects;
+		std::vector<floatV3> positions;
+		for (uint32 i = 0; i < objectCount; ++i)
+		{
+			MeshSP mesh = MakeSP<Mesh>("cube");
+			mesh->SetBoundingVolume(AxisAlignedBox(floatV3(-1, -1, -1), floatV3(1, 1, 1)), Sphere(floatV3::Zero, std::sqrt(3.0f)));
+			SceneObjectSP object = MakeSP<SceneObject>("object" + std::to_string(i));
+			object->SetComponent(mesh);
+			objects.push_back(object);
+			float x = positionDistribution(random);
+			float y = positionDistribution(random);
+			float z = positionDistribution(random);
+			positions.push_back(floatV3(x, y, z));
+		}
+
+		SceneResult naive = runScene(MakeSP<NaiveManagedScene>(), objects, positions);
+		SceneResult bvh = runScene(MakeSP<BVHManagedScene>(), objects, positions);
+
+		uint32 differentFrameCount = 0;
+		for (uint32 frame = 0; frame < naive.visibleObjects.size(); ++frame)
+		{
+			differentFrameCount += naive.visibleObjects[frame] != bvh.visibleObjects[frame];
+		}
+		cout << objectCount << " objects, " << naive.visibleObjects.back().size() << " visible in the last frame, ";
+		if (differentFrameCount != 0)
+		{
+			cout << "visible objects of BVHManagedScene differ in " << differentFrameCount << " of " << naive.visibleObjects.size() << " frames, failed" << endl;
+			passed = false;
+			continue;
+		}
+		cout << "same visible objects in all " << naive.visibleObjects.size() << " frames" << endl;
+		cout << "\tNaiveManagedScene: build " << naive.buildTime * 1000 << "ms, static frame " << naive.staticTime * 1000 << "ms, moving frame " << naive.movingTime * 1000 << "ms" << endl;
+		cout << "\tBVHManagedScene: build " << bvh.buildTime * 1000 << "ms, static frame " << bvh.staticTime * 1000 << "ms, moving frame " << bvh.movingTime * 1000 << "ms" << endl;
+		cout << "\tspeedup of BVHManagedScene: static " << naive.staticTime / bvh.staticTime << "x, moving " << naive.movingTime / bvh.movingTime << "x" << endl;
+	}
+	cout << "SceneCullingSpeedTest " << (passed ? "passed" : "failed") << endl;
+	return passed;
+}
+
+namespace
+{
+	/*
+	 *	The lazy transformation update used before TransformationHierarchy, kept for comparison.
+	 *	Every query walks up to the root comparing parent matrices.
+	 */
+	struct LazyTransformation
+	{
+		std::weak_ptr<LazyTransformation> parent;
+		floatV3 position;
+		floatQ orientation;
+		floatV3 scaling;
+		floatM44 mutable modelMatrix;
+		floatM44 mutable worldMatrix;
+		floatM44 mutable parentWorldMatrix;
+		bool mutable dirty;
+
+		LazyTransformation()
+			: position(floatV3::Zero), orientation(floatQ::Identity), scaling(1, 1, 1), parentWorldMatrix(floatM44::Identity), dirty(true)
+		{
+		}
+
+		floatM44 const& GetWorldMatrix() const
+		{
+			if (dirty)
+			{
+				modelMatrix = TranslationMatrix(position) * MatrixFromQuaternion(orientation) * ScalingMatrix(scaling);
+			}
+			if (!parent.expired())
+			{
+				floatM44 const& parentMatrix = parent.lock()->GetWorldMatrix();
+				if (parentWorldMatrix != parentMatrix)
+				{
+					worldMatrix = parentMatrix * modelMatrix;
+					parentWorldMatrix = parentMatrix;
+				}
+				else if (dirty)
+				{
+					worldMatrix = parentMatrix * modelMatrix;
+				}
+			}
+			else if (dirty)
+			{
+				worldMatrix = modelMatrix;
+			}
+			dirty = false;
+			return worldMatrix;
+		}
+	};
+}
+
+void TestFile::TransformationHierarchySpeedTest()
+{
+	uint32 const NodeCount = 100000;
+	uint32 const RootCount = 1000;
+	uint32 const FrameCount = 20;
+
+	// random forest, node i has a parent before it. nodes are created in shuffled order so the hierarchy has to reorder them.
+	std::mt19937 random(0);
+	std::vector<int32> parents(NodeCount, -1);
+	for (uint32 i = RootCount; i < NodeCount; ++i)
+	{
+		parents[i] = std::uniform_int_distribution<int32>(std::max<int32>(0, i - 2000), i - 1)(random);
+	}
+	std::vector<uint32> creationOrder(NodeCount);
+	for (uint32 i = 0; i < NodeCount; ++i)
+	{
+		creationOrder[i] = i;
+	}
+	std::shuffle(creationOrder.begin(), creationOrder.end(), random);
+	std::uniform_real_distribution<float> moveDistribution(-1, 1);
+
+	std::vector<std::shared_ptr<LazyTransformation>> lazyNodes(NodeCount);
+	std::vector<TransformationSP> nodes(NodeCount);
+	Timer t;
+	for (uint32 i : creationOrder)
+	{
+		lazyNodes[i] = MakeSP<LazyTransformation>();
+	}
+	for (uint32 i = 0; i < NodeCount; ++i)
+	{
+		lazyNodes[i]->position = floatV3(1, 0, 0);
+		lazyNodes[i]->orientation = RotationQuaternion(0.1f, floatV3(0, 1, 0));
+		if (parents[i] != -1)
+		{
+			lazyNodes[i]->parent = lazyNodes[parents[i]];
+		}
+	}
+	double lazyBuildTime = t.Elapsed();
+
+	TransformationHierarchy& hierarchy = XREXContext::GetInstance().GetTransformationHierarchy();
+	t.Restart();
+	for (uint32 i : creationOrder)
+	{
+		nodes[i] = MakeSP<Transformation>();
+	}
+	for (uint32 i = 0; i < NodeCount; ++i)
+	{
+		nodes[i]->SetPosition(1, 0, 0);
+		nodes[i]->SetOrientation(RotationQuaternion(0.1f, floatV3(0, 1, 0)));
+		if (parents[i] != -1)
+		{
+			nodes[i]->SetParent(nodes[parents[i]]);
+		}
+	}
+	hierarchy.Update();
+	double buildTime = t.Elapsed();
+
+	auto runFrames = [&] (std::function<void(uint32 index, floatV3 const& displacement)> const& move, std::function<float()> const& queryAll)
+	{
+		std::mt19937 moveRandom(1);
+		float checksum = 0;
+		Timer frameTimer;
+		for (uint32 frame = 0; frame < FrameCount; ++frame)
+		{
+			for (uint32 i = 0; i < NodeCount / 10; ++i) // 10% nodes moving
+			{
+				uint32 index = std::uniform_int_distribution<uint32>(0, NodeCount - 1)(moveRandom);
+				move(index, floatV3(moveDistribution(moveRandom), moveDistribution(moveRandom), moveDistribution(moveRandom)));
+			}
+			checksum += queryAll();
+		}
+		cout << "checksum " << checksum << ", ";
+		return frameTimer.Elapsed() / FrameCount;
+	};
+
+	double lazyFrameTime = runFrames([&] (uint32 index, floatV3 const& displacement)
+	{
+		lazyNodes[index]->position = lazyNodes[index]->position + displacement;
+		lazyNodes[index]->dirty = true;
+	}, [&] ()
+	{
+		float sum = 0;
+		for (auto& node : lazyNodes)
+		{
+			sum += node->GetWorldMatrix()(0, 3);
+		}
+		return sum;
+	});
+	cout << "lazy: build " << lazyBuildTime * 1000 << "ms, frame " << lazyFrameTime * 1000 << "ms" << endl;
+
+	double frameTime = runFrames([&] (uint32 index, floatV3 const& displacement)
+	{
+		nodes[index]->Translate(displacement);
+	}, [&] ()
+	{
+		hierarchy.Update(); // what XREXContext does every frame
+		float sum = 0;
+		for (auto& node : nodes)
+		{
+			sum += node->GetWorldMatrix()(0, 3);
+		}
+		return sum;
+	});
+	cout << "hierarchy: build " << buildTime * 1000 << "ms, frame " << frameTime * 1000 << "ms, speedup " << lazyFrameTime / frameTime << endl;
+
+	float maxError = 0;
+	for (uint32 i = 0; i < NodeCount; ++i)
+	{
+		floatM44 const& lazyMatrix = lazyNodes[i]->GetWorldMatrix();
+		floatM44 matrix = nodes[i]->GetWorldMatrix();
+		for (uint32 j = 0; j < 16; ++j)
+		{
+			maxError = std::max(maxError, std::abs(lazyMatrix[j] - matrix[j]));
+		}
+	}
+	cout << "max difference " << maxError << endl;
+}
+
+bool TestFile::TaskSchedulerStressTest()
+{
+	uint32 const RoundCount = 20;
+	bool passed = true;
+	auto check = [&passed] (bool condition, char const* name)
+	{
+		if (!condition)
+		{
+			cout << "failed: " << name << endl;
+			passed = false;
+		}
+	};
+
+	for (uint32 round = 0; round < RoundCount; ++round)
+	{
+		TaskScheduler scheduler(round % 2 == 0 ? 0 : round % 8 + 1); // also create and destroy schedulers repeatedly
+
+		// many tiny tasks
+		{
+			uint32 const TaskCount = 100000;
+			std::atomic<uint32> counter(0);
+			TaskGroup group;
+			for (uint32 i = 0; i < TaskCount; ++i)
+			{
+				scheduler.Run(group, [&counter] ()
+				{
+					++counter;
+				});
+			}
+			scheduler.Wait(group);
+			check(counter == TaskCount, "tiny tasks");
+		}
+
+		// tasks spawning and waiting for tasks, recursively
+		{
+			std::function<uint32(uint32)> fibonacci = [&] (uint32 n) -> uint32
+			{
+				if (n < 2)
+				{
+					return n;
+				}
+				uint32 left = 0;
+				TaskGroup group;
+				scheduler.Run(group, [&] ()
+				{
+					left = fibonacci(n - 1);
+				});
+				uint32 right = fibonacci(n - 2);
+				scheduler.Wait(group);
+				return left + right;
+			};
+			check(fibonacci(20) == 6765, "nested tasks");
+		}
+
+		// continuations run after all tasks of the dependency, in chain
+		{
+			uint32 const StageCount = 8;
+			uint32 const TasksPerStage = 64;
+			std::vector<std::unique_ptr<TaskGroup>> stages;
+			std::array<std::atomic<uint32>, StageCount> finished;
+			std::atomic<bool> ordered(true);
+			for (uint32 stage = 0; stage < StageCount; ++stage)
+			{
+				finished[stage] = 0;
+				stages.push_back(MakeUP<TaskGroup>());
+				for (uint32 i = 0; i < TasksPerStage; ++i)
+				{
+					auto task = [&, stage] ()
+					{
+						if (stage > 0 && finished[stage - 1] != TasksPerStage)
+						{
+							ordered = false;
+						}
+						++finished[stage];
+					};
+					if (stage == 0)
+					{
+						scheduler.Run(*stages[stage], task);
+					}
+					else
+					{
+						scheduler.RunAfter(*stages[stage - 1], *stages[stage], task);
+					}
+				}
+			}
+			scheduler.Wait(*stages.back());
+			for (auto& stage : stages)
+			{
+				scheduler.Wait(*stage);
+			}
+			check(ordered && finished.back() == TasksPerStage, "continuations");
+		}
+
+		// continuation of an already finished group runs at once
+		{
+			TaskGroup finishedGroup;
+			TaskGroup group;
+			bool executed = false;
+			scheduler.RunAfter(finishedGroup, group, [&executed] ()
+			{
+				executed = true;
+			});
+			scheduler.Wait(group);
+			check(executed, "continuation of finished group");
+		}
+
+		// parallel for covers every index exactly once, also nested
+		{
+			uint32 const Count = 1000003;
+			std::vector<uint8> visited(Count, 0);
+			scheduler.ParallelFor(0, Count, 4096, [&] (uint32 begin, uint32 end)
+			{
+				scheduler.ParallelFor(begin, end, 512, [&] (uint32 innerBegin, uint32 innerEnd)
+				{
+					for (uint32 i = innerBegin; i < innerEnd; ++i)
+					{
+						++visited[i];
+					}
+				});
+			});
+			check(std::all_of(visited.begin(), visited.end(), [] (uint8 v) { return v == 1; }), "parallel for");
+		}
+
+		// tasks submitted from a thread outside the scheduler
+		{
+			std::atomic<uint32> counter(0);
+			std::thread outside([&] ()
+			{
+				TaskGroup group;
+				for (uint32 i = 0; i < 1000; ++i)
+				{
+					scheduler.Run(group, [&counter] ()
+					{
+						++counter;
+					});
+				}
+				scheduler.Wait(group);
+			});
+			outside.join();
+			check(counter == 1000, "outside thread");
+		}
+	}
+	cout << "TaskSchedulerStressTest " << (passed ? "passed" : "failed") << endl;
+	return passed;
+}
+
+void TestFile::TaskSchedulerSpeedTest()
+{
+	uint32 const Count = 1 << 22;
+	uint32 const RepeatCount = 10;
+	std::vector<floatV4> source(Count);
+	std::vector<floatV4> result(Count);
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		source[i] = floatV4(float(i), float(i % 7), float(i % 13), 1);
+	}
+	floatM44 matrix = FrustumProjectionMatrix(PI / 3, 4.0f / 3.0f, 1.0f, 1000.0f) * TranslationMatrix(1.0f, 2.0f, 3.0f);
+
+	// CPU only work, transform vectors and do some math on them
+	auto work = [&] (uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+		{
+			floatV4 v = source[i];
+			for (uint32 j = 0; j < 4; ++j)
+			{
+				v = Transform(matrix, v);
+				v = v * ReciprocalSqrt(v.LengthSquared() + 1.0f);
+			}
+			result[i] = v;
+		}
+	};
+
+	uint32 hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	double singleThreadTime = 0;
+	for (uint32 threadCount = 1; threadCount <= hardwareThreadCount; ++threadCount)
+	{
+		TaskScheduler scheduler(threadCount);
+		Timer t;
+		for (uint32 i = 0; i < RepeatCount; ++i)
+		{
+			scheduler.ParallelFor(0, Count, 16384, work);
+		}
+		double time = t.Elapsed() / RepeatCount;
+		if (threadCount == 1)
+		{
+			singleThreadTime = time;
+		}
+		cout << threadCount << " threads: " << time * 1000 << "ms, speedup " << singleThreadTime / time << endl;
+	}
+
+	// overhead of empty tasks
+	TaskScheduler scheduler;
+	uint32 const TaskCount = 1000000;
+	TaskGroup group;
+	Timer t;
+	for (uint32 i = 0; i < TaskCount; ++i)
+	{
+		scheduler.Run(group, [] ()
+		{
+		});
+	}
+	scheduler.Wait(group);
+	cout << scheduler.GetThreadCount() << " threads: " << t.Elapsed() / TaskCount * 1e9 << "ns per empty task" << endl;
+}
+
+void TestFile::FramePipelineSpeedTest()
+{
+	uint32 const FrameCount = 200;
+	double const LogicTime = 0.004;
+	double const RenderTime = 0.003;
+
+	// CPU only, simulate logic and render frames by spinning.
+	auto spin = [] (double seconds)
+	{
+		Timer t;
+		while (t.Elapsed() < seconds)
+		{
+		}
+	};
+
+	Timer t;
+	for (uint32 i = 0; i < FrameCount; ++i)
+	{
+		spin(LogicTime);
+		spin(RenderTime);
+	}
+	double serialTime = t.Elapsed();
+	cout << "serial: " << FrameCount / serialTime << " fps, latency " << (LogicTime + RenderTime) * 1000 << "ms" << endl;
+
+	for (uint32 framesInFlight = 1; framesInFlight <= 3; ++framesInFlight)
+	{
+		FramePipeline pipeline(framesInFlight);
+		std::thread logicThread([&] ()
+		{
+			for (uint32 i = 0; i < FrameCount; ++i)
+			{
+				FrameSnapshot* snapshot = pipeline.BeginLogicFrame();
+				spin(LogicTime);
+				pipeline.EndLogicFrame(snapshot);
+			}
+		});
+		uint32 lastFrameIndex = 0;
+		bool inOrder = true;
+		for (uint32 i = 0; i < FrameCount; )
+		{
+			FrameSnapshot* snapshot = pipeline.BeginRenderFrame(0.005);
+			if (snapshot != nullptr)
+			{
+				inOrder = inOrder && (i == 0 || snapshot->frameIndex == lastFrameIndex + 1);
+				lastFrameIndex = snapshot->frameIndex;
+				spin(RenderTime);
+				pipeline.EndRenderFrame(snapshot);
+				++i;
+			}
+		}
+		logicThread.join();
+
+		FramePipeline::Statistics statistics = pipeline.GetStatistics();
+		cout << framesInFlight << " frames in flight: " << statistics.GetRenderedFramesPerSecond() << " fps, speedup " << serialTime / statistics.elapsedTime
+			<< ", latency average " << statistics.GetAverageLatency() * 1000 << "ms max " << statistics.maxLatency * 1000 << "ms"
+			<< ", logic wait " << statistics.totalLogicWaitTime * 1000 << "ms, render wait " << statistics.totalRenderWaitTime * 1000 << "ms"
+			<< (inOrder ? "" : ", out of order!") << endl;
+	}
+}
+
+void TestFile::RenderSortSpeedTest()
+{
+	uint32 const DrawCount = 100000;
+	uint32 const TechniqueCount = 16;
+	uint32 const MaterialCount = 256;
+	uint32 const LayoutCount = 1024;
+	uint32 const Repeat = 20;
+
+	struct Draw
+	{
+		int32 group;
+		bool transparent;
+		uint32 technique;
+		uint32 material;
+		uint32 layout;
+		float depth;
+	};
+	std::mt19937 engine;
+	std::uniform_int_distribution<uint32> random(0, 0xFFFFFFFF);
+	std::uniform_real_distribution<float> randomDepth(0, 1);
+	vector<Draw> draws(DrawCount);
+	for (auto& draw : draws)
+	{
+		draw.group = random(engine) % 4 == 0 ? 1 : 0;
+		draw.transparent = random(engine) % 8 == 0;
+		draw.technique = random(engine) % TechniqueCount;
+		draw.material = random(engine) % MaterialCount;
+		draw.layout = random(engine) % LayoutCount;
+		draw.depth = randomDepth(engine);
+	}
+
+	// state changes when drawing in the given order, opaque draws only, transparent order is decided by depth.
+	auto countStateChanges = [&draws] (vector<uint32> const& order)
+	{
+		uint32 changes = 0;
+		Draw const* last = nullptr;
+		for (uint32 index : order)
+		{
+			Draw const& draw = draws[index];
+			if (!draw.transparent)
+			{
+				changes += last == nullptr || last->technique != draw.technique ? 1 : 0;
+				changes += last == nullptr || last->material != draw.material ? 1 : 0;
+				changes += last == nullptr || last->layout != draw.layout ? 1 : 0;
+			}
+			last = &draw;
+		}
+		return changes;
+	};
+
+	// what DefaultRenderingProcess did before: only sorted by rendering group.
+	vector<uint32> groupOrder(DrawCount);
+	Timer t;
+	for (uint32 r = 0; r < Repeat; ++r)
+	{
+		for (uint32 i = 0; i < DrawCount; ++i)
+		{
+			groupOrder[i] = i;
+		}
+		std::stable_sort(groupOrder.begin(), groupOrder.end(), [&draws] (uint32 left, uint32 right)
+		{
+			return draws[left].group < draws[right].group;
+		});
+	}
+	double groupSortTime = t.Elapsed() / Repeat;
+
+	vector<RenderSortItem> keys(DrawCount);
+	for (uint32 i = 0; i < DrawCount; ++i)
+	{
+		Draw const& draw = draws[i];
+		keys[i] = RenderSortItem(RenderSortKey::Make(draw.group, draw.transparent, draw.technique, draw.material, draw.layout, draw.depth), i);
+	}
+
+	vector<RenderSortItem> items;
+	t.Restart();
+	for (uint32 r = 0; r < Repeat; ++r)
+	{
+		items = keys;
+		std::sort(items.begin(), items.end(), [] (RenderSortItem const& left, RenderSortItem const& right)
+		{
+			return left.key < right.key || (left.key == right.key && left.index < right.index);
+		});
+	}
+	double stdSortTime = t.Elapsed() / Repeat;
+	vector<RenderSortItem> stdSorted = items;
+
+	vector<RenderSortItem> buffer;
+	t.Restart();
+	for (uint32 r = 0; r < Repeat; ++r)
+	{
+		items = keys;
+		RadixSort(items, buffer);
+	}
+	double radixSortTime = t.Elapsed() / Repeat;
+
+	bool same = true;
+	vector<uint32> keyOrder(DrawCount);
+	for (uint32 i = 0; i < DrawCount; ++i)
+	{
+		same = same && items[i].index == stdSorted[i].index;
+		keyOrder[i] = items[i].index;
+	}
+	bool orderCorrect = true;
+	for (uint32 i = 1; i < DrawCount; ++i)
+	{
+		Draw const& previous = draws[keyOrder[i - 1]];
+		Draw const& current = draws[keyOrder[i]];
+		orderCorrect = orderCorrect && previous.group <= current.group;
+		if (previous.group == current.group)
+		{
+			orderCorrect = orderCorrect && (!previous.transparent || current.transparent);
+			if (previous.transparent && current.transparent)
+			{
+				// back to front, up to quantization
+				orderCorrect = orderCorrect && previous.depth + 1.f / RenderSortKey::MaxDepth >= current.depth;
+			}
+		}
+	}
+
+	cout << "group sort: " << groupSortTime * 1000 << "ms, std::sort keys: " << stdSortTime * 1000 << "ms, radix sort keys: " << radixSortTime * 1000 << "ms" << endl;
+	cout << "state changes, group sorted: " << countStateChanges(groupOrder) << ", key sorted: " << countStateChanges(keyOrder) << endl;
+	cout << (same ? "" : "radix sort differs from std::sort! ") << (orderCorrect ? "" : "draw order incorrect!") << endl;
+}
+
+void TestFile::ParameterLookupSpeedTest()
+{
+	// parameters of a typical technique, per draw parameters at the end, as uniforms are added after buffers and textures.
+	char const* names[] =
+	{
+		"XREX_Uniform_CameraTransformation", "lightBuffer", "diffuseMap", "specularMap", "normalMap", "shadowMap",
+		"diffuseColor", "specularColor", "emissiveColor", "opacity", "shininess", "specularLevel", "lightCount", "time",
+		"modelMatrix", "normalMatrix", "viewMatrix", "projectionMatrix", "cameraPosition",
+	};
+	vector<TechniqueParameterSP> parameters;
+	for (auto name : names)
+	{
+		parameters.push_back(MakeSP<ConcreteTechniqueParameter<floatM44>>(name));
+	}
+	DefinedUniform const perDrawUniforms[] =
+	{
+		DefinedUniform::ModelMatrix, DefinedUniform::NormalMatrix, DefinedUniform::ViewMatrix, DefinedUniform::ProjectionMatrix, DefinedUniform::CameraPosition,
+	};
+
+	uint32 const DrawCount = 1000000;
+	floatM44 matrix = floatM44::Identity;
+
+	// what RenderingTechnique::GetParameterByName does
+	Timer t;
+	for (uint32 i = 0; i < DrawCount; ++i)
+	{
+		for (auto uniform : perDrawUniforms)
+		{
+			std::string const& name = GetUniformString(uniform);
+			auto found = find_if(parameters.begin(), parameters.end(), [&name] (TechniqueParameterSP const& parameter)
+			{
+				return parameter->GetName() == name;
+			});
+			if (found != parameters.end())
+			{
+				(*found)->As<floatM44>().SetValue(matrix);
+			}
+		}
+	}
+	double byNameTime = t.Elapsed();
+
+	// what RenderingTechnique::GetParameter(ParameterHandle) does with handles resolved at technique creation
+	vector<uint32> handles;
+	for (auto uniform : perDrawUniforms)
+	{
+		std::string const& name = GetUniformString(uniform);
+		handles.push_back(find_if(parameters.begin(), parameters.end(), [&name] (TechniqueParameterSP const& parameter)
+		{
+			return parameter->GetName() == name;
+		}) - parameters.begin());
+	}
+	t.Restart();
+	for (uint32 i = 0; i < DrawCount; ++i)
+	{
+		for (uint32 handle : handles)
+		{
+			TechniqueParameterSP const& parameter = handle < parameters.size() ? parameters[handle] : TechniqueParameter::NullTechniqueParameter;
+			if (parameter)
+			{
+				parameter->As<floatM44>().SetValue(matrix);
+			}
+		}
+	}
+	double byHandleTime = t.Elapsed();
+
+	cout << "per draw, by name: " << byNameTime / DrawCount * 1000000000 << "ns, by handle: " << byHandleTime / DrawCount * 1000000000 << "ns" << endl;
+}
+
+bool TestFile::BufferArenaAllocatorTest()
+{
+	// a page of BufferArena, sub meshes of a scene with interleaved position, normal, texcoord and tangent.
+	uint32 const PageSize = BufferArena::DefaultPageSizeInBytes;
+	uint32 const VertexSize = 3 * 4 + 3 * 4 + 3 * 4 + 4 * 4;
+	uint32 const RoundCount = 1000;
+	RangeAllocator allocator(PageSize);
+	default_random_engine randomEngine;
+	uniform_int_distribution<uint32> vertexCountDistribution(4, 4096);
+
+	vector<pair<uint32, uint32>> ranges;
+	bool ok = true;
+	uint32 allocationCount = 0;
+	Timer t;
+	for (uint32 round = 0; round < RoundCount; ++round)
+	{
+		// fill the page, then free a random half
+		while (true)
+		{
+			uint32 size = vertexCountDistribution(randomEngine) * VertexSize;
+			pair<bool, uint32> offset = allocator.Allocate(size, VertexSize);
+			if (!offset.first)
+			{
+				break;
+			}
+			ok = ok && offset.second % VertexSize == 0 && offset.second + size <= PageSize;
+			ranges.push_back(make_pair(offset.second, size));
+			++allocationCount;
+		}
+		shuffle(ranges.begin(), ranges.end(), randomEngine);
+		uint32 keepCount = ranges.size() / 2;
+		for (uint32 i = keepCount; i < ranges.size(); ++i)
+		{
+			allocator.Free(ranges[i].first, ranges[i].second);
+		}
+		ranges.resize(keepCount);
+	}
+	double time = t.Elapsed();
+
+	sort(ranges.begin(), ranges.end());
+	for (uint32 i = 1; i < ranges.size(); ++i)
+	{
+		ok = ok && ranges[i - 1].first + ranges[i - 1].second <= ranges[i].first;
+	}
+	for (auto& range : ranges)
+	{
+		allocator.Free(range.first, range.second);
+	}
+	ok = ok && allocator.GetAllocatedSize() == 0 && allocator.GetFreeRangeCount() == 1;
+
+	cout << "allocations: " << allocationCount << ", per allocation: " << time / allocationCount * 1000000000 << "ns, " << (ok ? "ok" : "failed") << endl;
+	return ok;
+}
+
+bool TestFile::CommandBufferSpeedTest()
+{
+	// what DefaultRenderingProcess records for a draw: 5 parameters, material and layout every few draws. No GL involved.
+	uint32 const DrawCount = 100000;
+	uint32 const RepeatCount = 10;
+	uint32 const TechniqueCount = 16;
+	uint32 const MaterialCount = 256;
+	uint32 const LayoutCount = 1024;
+
+	vector<RenderingTechnique*> techniques(TechniqueCount, nullptr); // only recorded, never used
+	vector<TechniqueParameterSP> parameters;
+	for (uint32 i = 0; i < 4; ++i)
+	{
+		parameters.push_back(MakeSP<ConcreteTechniqueParameter<floatM44>>("matrix" + std::to_string(static_cast<uint64>(i))));
+	}
+	TechniqueParameterSP position = MakeSP<ConcreteTechniqueParameter<floatV3>>("position");
+	vector<MaterialSP> materials;
+	for (uint32 i = 0; i < MaterialCount; ++i)
+	{
+		materials.push_back(MakeSP<Material>("material"));
+	}
+	vector<RenderingLayoutSP> layouts;
+	for (uint32 i = 0; i < LayoutCount; ++i)
+	{
+		IndexBufferSP indices = MakeSP<IndexBuffer>(IndexBuffer::TopologicalType::Triangles, ElementType::Uint16, 3 * (i + 1));
+		layouts.push_back(MakeSP<RenderingLayout>(vector<VertexBufferSP>(), indices));
+	}
+	vector<floatM44> worldMatrices(DrawCount);
+	for (uint32 i = 0; i < DrawCount; ++i)
+	{
+		worldMatrices[i] = TranslationMatrix(float(i), 0.0f, 0.0f);
+	}
+	floatM44 viewMatrix = floatM44::Identity;
+	floatV3 cameraPosition(0, 0, 0);
+
+	auto record = [&] (CommandBuffer& commands, uint32 begin, uint32 end)
+	{
+		commands.Reset();
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (i == begin || i % 1024 == 0)
+			{
+				commands.BindTechnique(techniques[i / 1024 % TechniqueCount]);
+			}
+			commands.SetParameter(*parameters[0], worldMatrices[i]);
+			commands.SetParameter(*parameters[1], worldMatrices[i]);
+			commands.SetParameter(*parameters[2], viewMatrix);
+			commands.SetParameter(*parameters[3], viewMatrix);
+			commands.SetParameter(*position, cameraPosition);
+			if (i == begin || i % 8 == 0)
+			{
+				commands.BindMaterial(*materials[i / 8 % MaterialCount]);
+			}
+			if (i == begin || i % 2 == 0)
+			{
+				commands.BindLayout(nullptr, layouts[i / 2 % LayoutCount].get());
+			}
+			commands.Draw(1);
+		}
+	};
+
+	struct CountingExecutor
+		: ICommandExecutor
+	{
+		uint32 drawCount;
+		uint32 indexCount;
+		uint32 parameterCount;
+
+		CountingExecutor()
+			: drawCount(0), indexCount(0), parameterCount(0)
+		{
+		}
+		virtual void BindTechnique(RenderingTechnique* technique) override
+		{
+		}
+		virtual void BindLayout(LayoutAndProgramConnector* connector, RenderingLayout* layout) override
+		{
+		}
+		virtual void SetParameter(TechniqueParameter& parameter, ElementType type, void const* value) override
+		{
+			++parameterCount;
+		}
+		virtual void SetBufferData(ShaderResourceBuffer& buffer, void const* data, uint32 sizeInBytes) override
+		{
+		}
+		virtual void BindMaterial(Material& material) override
+		{
+		}
+		virtual void Draw(uint32 indexCount, uint32 firstIndex, int32 baseVertex, uint32 instanceCount) override
+		{
+			++drawCount;
+			this->indexCount += indexCount;
+		}
+		virtual void MultiDraw(IndirectDrawer::DrawElementsIndirectCommand const* commands, floatM44 const* drawParameters, uint32 drawCount) override
+		{
+			++this->drawCount;
+			for (uint32 i = 0; i < drawCount; ++i)
+			{
+				indexCount += commands[i].count;
+			}
+		}
+		virtual void Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ) override
+		{
+		}
+		virtual void SetViewport(Viewport const& viewport) override
+		{
+		}
+		virtual void Clear(FrameBuffer& frameBuffer, FrameBuffer::ClearMask clearMask, Color const& clearColor, float clearDepth, uint16 clearStencil) override
+		{
+		}
+		virtual void BeginProfileRange(char const* name, int32 argument, bool hasArgument) override
+		{
+		}
+		virtual void EndProfileRange() override
+		{
+		}
+	};
+
+	// record by one thread
+	CommandBuffer single;
+	record(single, 0, DrawCount); // warm up, memory is kept
+	Timer t;
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		record(single, 0, DrawCount);
+	}
+	double singleTime = t.Elapsed() / RepeatCount;
+
+	// record slices by all threads
+	TaskScheduler scheduler;
+	uint32 sliceCount = scheduler.GetThreadCount();
+	uint32 sliceSize = (DrawCount + sliceCount - 1) / sliceCount;
+	vector<std::unique_ptr<CommandBuffer>> slices;
+	for (uint32 i = 0; i < sliceCount; ++i)
+	{
+		slices.push_back(MakeUP<CommandBuffer>());
+	}
+	auto recordSlices = [&] (uint32 rangeBegin, uint32 rangeEnd)
+	{
+		for (uint32 slice = rangeBegin; slice < rangeEnd; ++slice)
+		{
+			uint32 begin = std::min(slice * sliceSize, DrawCount);
+			record(*slices[slice], begin, std::min(begin + sliceSize, DrawCount));
+			slices[slice]->SetSortKey(slice);
+		}
+	};
+	scheduler.ParallelFor(0, sliceCount, 1, recordSlices);
+	t.Restart();
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		scheduler.ParallelFor(0, sliceCount, 1, recordSlices);
+	}
+	double parallelTime = t.Elapsed() / RepeatCount;
+
+	// replay without GL, only decoding cost
+	vector<CommandBuffer*> order;
+	for (auto& slice : slices)
+	{
+		order.push_back(slice.get());
+	}
+	std::reverse(order.begin(), order.end());
+	CountingExecutor executor;
+	t.Restart();
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		CommandBuffer::ExecuteInOrder(order, executor);
+	}
+	double replayTime = t.Elapsed() / RepeatCount;
+
+	uint32 expectedIndexCount = 0;
+	for (uint32 i = 0; i < DrawCount; ++i)
+	{
+		expectedIndexCount += layouts[i / 2 % LayoutCount]->GetElementCount();
+	}
+	bool ok = executor.drawCount == DrawCount * RepeatCount && executor.parameterCount == DrawCount * 5 * RepeatCount
+		&& executor.indexCount == expectedIndexCount * RepeatCount;
+
+	cout << "draws: " << DrawCount << ", bytes per draw: " << single.GetSizeInBytes() / DrawCount << endl;
+	cout << "record, 1 thread: " << singleTime * 1000 << "ms, " << sliceCount << " threads: " << parallelTime * 1000 << "ms" << endl;
+	cout << "replay: " << replayTime * 1000 << "ms, " << (ok ? "ok" : "failed") << endl;
+	return ok;
+}
+
+namespace
+{
+	/*
+	 *	Emits packs of CPU only resources, they are collected but never drawn.
+	 */
+	class PackEmitter
+		: public Renderable
+	{
+	public:
+		PackEmitter(vector<RenderingLayoutSP> const& layouts, vector<MaterialSP> const& materials, RenderingTechniqueSP const& technique)
+			: layouts_(layouts), materials_(materials), technique_(technique)
+		{
+		}
+
+		virtual void GetRenderablePack(RenderablePackCollector& collector, SceneObjectSP const& camera) override
+		{
+			for (uint32 i = 0; i < layouts_.size(); ++i)
+			{
+				collector.AddRenderablePack(RenderablePack(*this, layouts_[i].get(), materials_[i].get(), nullptr, technique_.get()));
+			}
+		}
+		virtual void GetSmallRenderablePack(RenderablePackCollector& collector, SceneObjectSP const& camera) override
+		{
+		}
+		virtual RenderableSP ShallowClone() const override
+		{
+			return nullptr;
+		}
+
+	private:
+		vector<RenderingLayoutSP> layouts_;
+		vector<MaterialSP> materials_;
+		RenderingTechniqueSP technique_;
+	};
+
+	/*
+	 *	Sorting packs reads blend state of their technique, packs of PackEmitter are never drawn by it.
+	 */
+	RenderingTechniqueSP MakeCollectionTestTechnique()
+	{
+		TechniqueBuildingInformationSP technique = MakeSP<TechniqueBuildingInformation>("collection test technique");
+		technique->AddCommonCode(MakeSP<string>(
+			"#ifdef VS\n"
+			"in vec3 position;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_Position = vec4(position, 1);\n"
+			"}\n"
+			"#endif\n"
+			"#ifdef FS\n"
+			"layout(location = 0) out vec4 XREX_DefaultFrameBufferOutput;\n"
+			"void main()\n"
+			"{\n"
+			"	XREX_DefaultFrameBufferOutput = vec4(1);\n"
+			"}\n"
+			"#endif\n"));
+		technique->AddStageCode(ShaderObject::ShaderType::VertexShader, MakeSP<string>());
+		technique->AddStageCode(ShaderObject::ShaderType::FragmentShader, MakeSP<string>());
+		technique->AddAttributeInputInformation(AttributeInputInformation("position", ElementType::FloatV3));
+		technique->SetFrameBufferDescription(XREXContext::GetInstance().GetRenderingEngine().GetDefaultFrameBuffer()->GetLayoutDescription());
+		technique->SetRasterizerState(RasterizerState());
+		technique->SetDepthStencilState(DepthStencilState());
+		technique->SetBlendState(BlendState());
+		return TechniqueBuilder(technique).GetRenderingTechnique();
+	}
+
+	/*
+	 *	Heap allocations of threads counting them, including allocations of XREX.
+	 *	Counted by the debug CRT on Visual Studio, by the global operator new below elsewhere.
+	 */
+	uint32 heapAllocationCount = 0;
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+	int CountHeapAllocation(int allocationType, void* userData, size_t size, int blockType, long requestNumber, unsigned char const* fileName, int lineNumber)
+	{
+		if (allocationType == _HOOK_ALLOC || allocationType == _HOOK_REALLOC)
+		{
+			++heapAllocationCount;
+		}
+		return TRUE;
+	}
+#elif !defined(_MSC_VER)
+	/*
+	 *	Only the thread running the test counts, worker threads of XREXContext allocate on their own.
+	 */
+	thread_local bool countingHeapAllocations = false;
+#endif
+}
+
+#if !defined(_MSC_VER)
+void* operator new(size_t size)
+{
+	if (countingHeapAllocations)
+	{
+		++heapAllocationCount;
+	}
+	void* memory = std::malloc(size != 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+void operator delete(void* memory, size_t size) noexcept
+{
+	std::free(memory);
+}
+void operator delete[](void* memory, size_t size) noexcept
+{
+	std::free(memory);
+}
+#endif
+
+bool TestFile::RenderablePackCollectionTest()
+{
+	uint32 const ObjectCount = 10000;
+	uint32 const PacksPerObject = 4;
+	uint32 const FrameCount = 100;
+
+	Settings settings("../../");
+	settings.windowTitle = L"Renderable pack collection test";
+	settings.renderingSettings.width = 64;
+	settings.renderingSettings.height = 64;
+	XREXContext::GetInstance().Initialize(settings);
+	RenderingTechniqueSP technique = MakeCollectionTestTechnique();
+	if (technique == nullptr)
+	{
+		cout << "failed to build technique." << endl;
+		return false;
+	}
+
+	vector<RenderingLayoutSP> layouts;
+	vector<MaterialSP> materials;
+	for (uint32 i = 0; i < PacksPerObject; ++i)
+	{
+		IndexBufferSP indices = MakeSP<IndexBuffer>(IndexBuffer::TopologicalType::Triangles, ElementType::Uint16, 3);
+		layouts.push_back(MakeSP<RenderingLayout>(vector<VertexBufferSP>(), indices));
+		materials.push_back(MakeSP<Material>("material"));
+	}
+	SceneSP scene = MakeSP<NaiveManagedScene>();
+	SceneObjectSP cameraObject = MakeSP<SceneObject>("camera");
+	cameraObject->SetComponent(MakeSP<PerspectiveCamera>(PI / 3, 1.f, 1.f, 1000.f));
+	scene->AddObject(cameraObject);
+	for (uint32 i = 0; i < ObjectCount; ++i)
+	{
+		// no bounding volume, never culled
+		SceneObjectSP object = MakeSP<SceneObject>("object" + std::to_string(static_cast<uint64>(i)));
+		object->SetComponent(MakeSP<PackEmitter>(layouts, materials, technique));
+		object->GetComponent<Transformation>()->SetPosition(float(i), 0, 0);
+		scene->AddObject(object);
+	}
+
+	// what DefaultRenderingProcess::RenderScene does, without rendering
+	DefaultRenderingProcess process;
+	FrameSnapshot snapshot;
+	auto captureFrame = [&] ()
+	{
+		snapshot.Clear();
+		snapshot.ReleaseSceneObjects();
+		process.CaptureSnapshot(scene, snapshot);
+	};
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+	_CRT_ALLOC_HOOK lastHook = _CrtSetAllocHook(CountHeapAllocation);
+#elif !defined(_MSC_VER)
+	countingHeapAllocations = true;
+#endif
+	// first frame grows buffers and the arena, second one merges chunks of the arena
+	heapAllocationCount = 0;
+	captureFrame();
+	uint32 firstFrameAllocationCount = heapAllocationCount;
+	captureFrame();
+
+	heapAllocationCount = 0;
+	uint32 arenaAllocationCount = snapshot.arena.GetHeapAllocationCount();
+	Timer t;
+	for (uint32 frame = 0; frame < FrameCount; ++frame)
+	{
+		captureFrame();
+	}
+	double frameTime = t.Elapsed() / FrameCount;
+	uint32 steadyAllocationCount = heapAllocationCount;
+	arenaAllocationCount = snapshot.arena.GetHeapAllocationCount() - arenaAllocationCount;
+#if defined(_MSC_VER) && defined(_DEBUG)
+	_CrtSetAllocHook(lastHook);
+#elif !defined(_MSC_VER)
+	countingHeapAllocations = false;
+#else
+	cout << "heap allocations are only counted by debug CRT, only arena allocations are checked." << endl;
+#endif
+
+	// materials are copied, packs of the same material share a copy
+	FrameSnapshot::CameraView const& view = *snapshot.cameraViews[0];
+	bool ok = snapshot.cameraViews.size() == 1 && view.packs.GetSize() == ObjectCount * PacksPerObject && view.owners.size() == ObjectCount
+		&& view.visibleObjectCount == ObjectCount && view.drawOrder.GetSize() == view.packs.GetSize()
+		&& view.packs[1].material != materials[1].get() && view.packs[PacksPerObject + 1].material == view.packs[1].material
+		&& view.packs[1].material != view.packs[0].material && view.packs[PacksPerObject].renderable != view.packs[0].renderable
+		&& snapshot.materialCopyCount == PacksPerObject && steadyAllocationCount == 0 && arenaAllocationCount == 0;
+
+	cout << "packs: " << view.packs.GetSize() << ", arena: " << snapshot.arena.GetCapacity() / 1024 << "KB" << endl;
+	cout << "first frame heap allocations: " << firstFrameAllocationCount << ", steady state heap allocations per frame: "
+		<< static_cast<double>(steadyAllocationCount) / FrameCount << endl;
+	cout << "capture: " << frameTime * 1000 << "ms, " << (ok ? "ok" : "failed") << endl;
+	snapshot.Clear();
+	snapshot.ReleaseSceneObjects();
+	scene->ClearAllObject();
+	return ok;
+}
+
+bool TestFile::ProfilerSpeedTest()
+{
+	uint32 const TaskCount = 64;
+	uint32 const ScopeCountPerTask = 1000;
+
+	Profiler profiler(TaskCount * ScopeCountPerTask * 2);
+	TaskScheduler scheduler;
+	auto work = [&] (uint32 begin, uint32 end)
+	{
+		for (uint32 task = begin; task < end; ++task)
+		{
+			ProfileScope taskScope(profiler, "Task", static_cast<int32>(task));
+			for (uint32 i = 0; i < ScopeCountPerTask - 1; ++i)
+			{
+				ProfileScope scope(profiler, "Scope");
+			}
+		}
+	};
+
+	// not capturing, scopes only check a flag
+	Timer t;
+	scheduler.ParallelFor(0, TaskCount, 1, work);
+	double idleTime = t.Elapsed();
+
+	profiler.StartCapture();
+	t.Restart();
+	scheduler.ParallelFor(0, TaskCount, 1, work);
+	double captureTime = t.Elapsed();
+	profiler.StopCapture();
+
+	t.Restart();
+	std::string trace = profiler.ExportChromeTrace();
+	double exportTime = t.Elapsed();
+
+	uint32 eventCount = 0;
+	for (size_t position = trace.find("\"ph\":\"X\""); position != std::string::npos; position = trace.find("\"ph\":\"X\"", position + 1))
+	{
+		++eventCount;
+	}
+	bool ok = eventCount == TaskCount * ScopeCountPerTask && trace.find("\"name\":\"Task\"") != std::string::npos;
+
+	uint32 scopeCount = TaskCount * ScopeCountPerTask;
+	cout << "threads: " << scheduler.GetThreadCount() << ", scopes: " << scopeCount << endl;
+	cout << "per scope, not capturing: " << idleTime / scopeCount * 1e9 << "ns, capturing: " << captureTime / scopeCount * 1e9 << "ns" << endl;
+	cout << "export: " << exportTime * 1000 << "ms, " << trace.size() / 1024 << "KB, " << (ok ? "ok" : "failed") << endl;
+	return ok;
+}
+
+bool TestFile::FrameStatisticsHistoryTest()
+{
+	uint32 const FrameCount = 1000;
+
+	FrameStatisticsHistory history;
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> distribution(0.010, 0.020);
+	vector<double> frameTimes;
+	for (uint32 i = 0; i < FrameCount; ++i)
+	{
+		FrameStatistics statistics;
+		statistics.frameTime = i % 100 == 99 ? 0.050 : distribution(generator); // a hitch every 100 frames
+		statistics.drawCount = i;
+		history.Add(statistics);
+		frameTimes.push_back(statistics.frameTime);
+	}
+
+	// only the latest frames are kept, compare with them sorted
+	uint32 count = history.GetCount();
+	vector<double> expected(frameTimes.end() - count, frameTimes.end());
+	double sum = 0;
+	for (double time : expected)
+	{
+		sum += time;
+	}
+	std::sort(expected.begin(), expected.end());
+	uint32 p99Index = static_cast<uint32>(std::ceil(0.99 * count)) - 1;
+
+	bool ok = count == std::min(FrameCount, history.GetCapacity())
+		&& history.GetFrame(0).drawCount == FrameCount - count && history.GetFrame(count - 1).drawCount == FrameCount - 1
+		&& history.GetMinFrameTime() == expected.front() && history.GetMaxFrameTime() == expected.back()
+		&& std::abs(history.GetAverageFrameTime() - sum / count) < 1e-12
+		&& history.GetPercentileFrameTime(0.99f) == expected[p99Index] && history.GetPercentileFrameTime(1) == expected.back();
+
+	uint32 const QueryCount = 10000;
+	double p99 = 0;
+	Timer t;
+	for (uint32 i = 0; i < QueryCount; ++i)
+	{
+		p99 += history.GetPercentileFrameTime(0.99f);
+	}
+	double queryTime = t.Elapsed();
+
+	cout << "frames: " << count << ", min: " << history.GetMinFrameTime() * 1000 << "ms, avg: " << history.GetAverageFrameTime() * 1000
+		<< "ms, p99: " << p99 / QueryCount * 1000 << "ms, " << (ok ? "ok" : "failed") << endl;
+	cout << "per p99 query: " << queryTime / QueryCount * 1e6 << "us" << endl;
+	return ok;
+}
+
+namespace
+{
+	char const* MathSIMDName()
+	{
+#if defined(XREX_SIMD_AVX)
+		return "AVX";
+#elif defined(XREX_SIMD_SSE)
+		return "SSE";
+#else
+		return "scalar only";
+#endif
+	}
+
+	bool BitEqual(float const* left, float const* right, uint32 count)
+	{
+		return std::memcmp(left, right, count * sizeof(float)) == 0;
+	}
+
+	void RandomQuaternion(float quaternion[4], std::mt19937& generator)
+	{
+		std::uniform_real_distribution<float> distribution(-1, 1);
+		floatV4 q(distribution(generator), distribution(generator), distribution(generator), distribution(generator));
+		q = q.Normalize();
+		std::memcpy(quaternion, &q[0], sizeof(float) * 4);
+	}
+}
+
+bool TestFile::MathSIMDTest()
+{
+	using namespace MathHelper;
+
+	uint32 const CaseCount = 100000;
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<float> distribution(-10, 10);
+
+	enum Operation
+	{
+		Multiply,
+		Inverse,
+		Transpose,
+		TransformV4,
+		TransformV3,
+		TransformDirectionV4,
+		VectorArithmetic,
+		QuaternionToMatrix,
+		ComposeTransformation,
+		OperationCount,
+	};
+	char const* names[OperationCount] = { "multiply", "inverse", "transpose", "transform v4", "transform v3", "transform direction v4", "vector arithmetic", "quaternion to matrix", "compose TRS" };
+	uint32 failures[OperationCount] = { 0 };
+
+	for (uint32 i = 0; i < CaseCount; ++i)
+	{
+		float a[16];
+		float b[16];
+		for (uint32 j = 0; j < 16; ++j)
+		{
+			a[j] = distribution(generator);
+			b[j] = distribution(generator);
+		}
+		float expected[16];
+		float result[16];
+
+		ScalarMatrixHepler<float>::DoMultiply(expected, a, b);
+		MatrixHepler<float>::DoMultiply(result, a, b);
+		failures[Multiply] += !BitEqual(expected, result, 16);
+
+		bool expectedInvertible = ScalarMatrixHepler<float>::DoInverse(expected, a);
+		bool invertible = MatrixHepler<float>::DoInverse(result, a);
+		failures[Inverse] += expectedInvertible != invertible || (invertible && !BitEqual(expected, result, 16));
+
+		ScalarMatrixHepler<float>::DoTranspose(expected, a);
+		MatrixHepler<float>::DoTranspose(result, a);
+		failures[Transpose] += !BitEqual(expected, result, 16);
+
+		ScalarTransformHelper<float, 4>::DoTransform(expected, a, b, 1);
+		TransformHelper<float, 4>::DoTransform(result, a, b, 1);
+		failures[TransformV4] += !BitEqual(expected, result, 4);
+
+		ScalarTransformHelper<float, 3>::DoTransform(expected, a, b, b[3]);
+		TransformHelper<float, 3>::DoTransform(result, a, b, b[3]);
+		failures[TransformV3] += !BitEqual(expected, result, 3);
+
+		ScalarTransformHelper<float, 4>::DoTransformDirection(expected, a, b);
+		TransformHelper<float, 4>::DoTransformDirection(result, a, b);
+		failures[TransformDirectionV4] += !BitEqual(expected, result, 4);
+
+		ScalarVectorHelper<float, 4>::DoAdd(expected, a, b);
+		VectorHelper<float, 4>::DoAdd(result, a, b);
+		ScalarVectorHelper<float, 4>::DoSubtract(expected + 4, a, b);
+		VectorHelper<float, 4>::DoSubtract(result + 4, a, b);
+		ScalarVectorHelper<float, 4>::DoScale(expected + 8, a, b[0]);
+		VectorHelper<float, 4>::DoScale(result + 8, a, b[0]);
+		ScalarVectorHelper<float, 4>::DoDivide(expected + 12, a, b);
+		VectorHelper<float, 4>::DoDivide(result + 12, a, b);
+		failures[VectorArithmetic] += !BitEqual(expected, result, 16);
+
+		float quaternion[4];
+		RandomQuaternion(quaternion, generator);
+		ScalarQuaternionHelper<float>::DoToMatrix(expected, quaternion);
+		QuaternionHelper<float>::DoToMatrix(result, quaternion);
+		failures[QuaternionToMatrix] += !BitEqual(expected, result, 16);
+
+		ScalarQuaternionHelper<float>::DoComposeTransformation(expected, a, quaternion, b);
+		QuaternionHelper<float>::DoComposeTransformation(result, a, quaternion, b);
+		failures[ComposeTransformation] += !BitEqual(expected, result, 16);
+	}
+
+	// the composed matrix should be the product it replaces.
+	floatV3 translation(1, -2, 3);
+	floatQ orientation = RotationQuaternion(0.7f, floatV3(1, 2, 3));
+	floatV3 scaling(2, 0.5f, -1);
+	floatM44 product = TranslationMatrix(translation) * MatrixFromQuaternion(orientation) * ScalingMatrix(scaling);
+	floatM44 composed = TransformationMatrix(translation, orientation, scaling);
+	bool composeOk = true;
+	for (uint32 i = 0; i < 16; ++i)
+	{
+		composeOk = composeOk && std::abs(product[i] - composed[i]) < 1e-6f;
+	}
+
+	cout << MathSIMDName() << ", " << CaseCount << " cases" << endl;
+	for (uint32 i = 0; i < OperationCount; ++i)
+	{
+		cout << names[i] << ": " << (failures[i] == 0 ? "bit identical" : std::to_string(static_cast<uint64>(failures[i])) + " different") << endl;
+	}
+	cout << "compose equals product: " << (composeOk ? "ok" : "failed") << endl;
+
+	bool passed = composeOk;
+	for (uint32 i = 0; i < OperationCount; ++i)
+	{
+		passed = passed && failures[i] == 0;
+	}
+	return passed;
+}
+
+void TestFile::MathSIMDSpeedTest()
+{
+	using namespace MathHelper;
+
+	uint32 const MatrixCount = 4096;
+	uint32 const RoundCount = 1000;
+	std::mt19937 generator(13);
+	std::uniform_real_distribution<float> distribution(-10, 10);
+	vector<float> matrices(MatrixCount * 16);
+	vector<float> quaternions(MatrixCount * 4);
+	for (float& value : matrices)
+	{
+		value = distribution(generator);
+	}
+	for (uint32 i = 0; i < MatrixCount; ++i)
+	{
+		RandomQuaternion(&quaternions[i * 4], generator);
+	}
+	vector<float> results(MatrixCount * 16);
+	float checksum = 0;
+
+	// each operation over all matrices, RoundCount times. scalar and SIMD helpers are the same when SIMD is not available.
+#define MATH_SPEED_TEST(name, body)	\
+	{	\
+		Timer timer;	\
+		for (uint32 round = 0; round < RoundCount; ++round)	\
+		{	\
+			for (uint32 i = 0; i < MatrixCount; ++i)	\
+			{	\
+				float const* m = &matrices[i * 16];	\
+				float const* n = &matrices[((i + 1) % MatrixCount) * 16];	\
+				float* out = &results[i * 16];	\
+				body;	\
+			}	\
+			checksum += results[round % results.size()];	\
+		}	\
+		cout << name << ": " << timer.Elapsed() / (static_cast<double>(RoundCount) * MatrixCount) * 1e9 << "ns" << endl;	\
+	}
+
+	cout << MathSIMDName() << ", per operation:" << endl;
+	MATH_SPEED_TEST("scalar multiply", ScalarMatrixHepler<float>::DoMultiply(out, m, n));
+	MATH_SPEED_TEST("SIMD multiply", MatrixHepler<float>::DoMultiply(out, m, n));
+	MATH_SPEED_TEST("scalar inverse", ScalarMatrixHepler<float>::DoInverse(out, m));
+	MATH_SPEED_TEST("SIMD inverse", MatrixHepler<float>::DoInverse(out, m));
+	MATH_SPEED_TEST("scalar transpose", ScalarMatrixHepler<float>::DoTranspose(out, m));
+	MATH_SPEED_TEST("SIMD transpose", MatrixHepler<float>::DoTranspose(out, m));
+	MATH_SPEED_TEST("scalar transform v4", (ScalarTransformHelper<float, 4>::DoTransform(out, m, n, 1)));
+	MATH_SPEED_TEST("SIMD transform v4", (TransformHelper<float, 4>::DoTransform(out, m, n, 1)));
+	MATH_SPEED_TEST("scalar transform v3", (ScalarTransformHelper<float, 3>::DoTransform(out, m, n, 1)));
+	MATH_SPEED_TEST("SIMD transform v3", (TransformHelper<float, 3>::DoTransform(out, m, n, 1)));
+	MATH_SPEED_TEST("scalar quaternion to matrix", ScalarQuaternionHelper<float>::DoToMatrix(out, &quaternions[i * 4]));
+	MATH_SPEED_TEST("SIMD quaternion to matrix", QuaternionHelper<float>::DoToMatrix(out, &quaternions[i * 4]));
+	MATH_SPEED_TEST("scalar compose TRS", ScalarQuaternionHelper<float>::DoComposeTransformation(out, m, &quaternions[i * 4], n));
+	MATH_SPEED_TEST("SIMD compose TRS", QuaternionHelper<float>::DoComposeTransformation(out, m, &quaternions[i * 4], n));
+#undef MATH_SPEED_TEST
+
+	cout << "checksum: " << checksum << endl;
+}
+
+namespace
+{
+	Frustum MakeCullingTestFrustum()
+	{
+		floatM44 view = LookToViewMatrix(floatV3(10, 20, -30), floatV3(0.3f, -0.1f, 1), floatV3(0, 1, 0));
+		return Frustum(FrustumProjectionMatrix(PI / 3, 16.f / 9.f, 1.f, 1000.f) * view);
+	}
+
+	void MakeCullingTestBounds(uint32 count, uint32 seed, BoundingBoxArrays& boxes, BoundingSphereArrays& spheres, vector<AxisAlignedBox>& boxList, vector<Sphere>& sphereList)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> position(-1200, 1200);
+		std::uniform_real_distribution<float> size(0.1f, 30);
+		boxes.Reserve(count);
+		spheres.Reserve(count);
+		for (uint32 i = 0; i < count; ++i)
+		{
+			floatV3 center(position(generator), position(generator), position(generator));
+			floatV3 extent(size(generator), size(generator), size(generator));
+			boxList.push_back(AxisAlignedBox(center - extent, center + extent));
+			sphereList.push_back(Sphere(center, size(generator)));
+			boxes.Add(boxList.back());
+			spheres.Add(sphereList.back());
+		}
+	}
+}
+
+bool TestFile::FrustumCullingTest()
+{
+	// odd count to test the tail which is not a full batch
+	uint32 const Count = 100003;
+	Frustum frustum = MakeCullingTestFrustum();
+	BoundingBoxArrays boxes;
+	BoundingSphereArrays spheres;
+	vector<AxisAlignedBox> boxList;
+	vector<Sphere> sphereList;
+	MakeCullingTestBounds(Count, 17, boxes, spheres, boxList, sphereList);
+
+	vector<uint32> boxMask(GetVisibilityMaskSize(Count));
+	vector<uint32> sphereMask(GetVisibilityMaskSize(Count));
+	vector<uint32> parallelBoxMask(GetVisibilityMaskSize(Count));
+	vector<uint32> parallelSphereMask(GetVisibilityMaskSize(Count));
+	CullBoxes(frustum, boxes, boxMask.data());
+	CullSpheres(frustum, spheres, sphereMask.data());
+	TaskScheduler scheduler;
+	ParallelCullBoxes(scheduler, frustum, boxes, parallelBoxMask.data(), 1000);
+	ParallelCullSpheres(scheduler, frustum, spheres, parallelSphereMask.data(), 1000);
+
+	uint32 boxDifferences = 0;
+	uint32 sphereDifferences = 0;
+	uint32 visibleBoxCount = 0;
+	uint32 visibleSphereCount = 0;
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		bool boxVisible = Intersect(frustum, boxList[i]) != IntersectionResult::Outside;
+		bool sphereVisible = Intersect(frustum, sphereList[i]) != IntersectionResult::Outside;
+		boxDifferences += boxVisible != IsVisible(boxMask.data(), i);
+		sphereDifferences += sphereVisible != IsVisible(sphereMask.data(), i);
+		visibleBoxCount += boxVisible;
+		visibleSphereCount += sphereVisible;
+	}
+	bool parallelSame = boxMask == parallelBoxMask && sphereMask == parallelSphereMask;
+	bool ok = boxDifferences == 0 && sphereDifferences == 0 && parallelSame;
+
+	cout << Count << " bounds, visible boxes: " << visibleBoxCount << ", visible spheres: " << visibleSphereCount << endl;
+	cout << "box differences: " << boxDifferences << ", sphere differences: " << sphereDifferences << ", parallel "
+		<< (parallelSame ? "same" : "different") << ", " << (ok ? "ok" : "failed") << endl;
+	return ok;
+}
+
+bool TestFile::FrustumCullingSpeedTest()
+{
+	uint32 const Count = 1000000;
+	uint32 const RepeatCount = 20;
+	Frustum frustum = MakeCullingTestFrustum();
+	BoundingBoxArrays boxes;
+	BoundingSphereArrays spheres;
+	vector<AxisAlignedBox> boxList;
+	vector<Sphere> sphereList;
+	MakeCullingTestBounds(Count, 19, boxes, spheres, boxList, sphereList);
+	vector<uint32> mask(GetVisibilityMaskSize(Count));
+	TaskScheduler scheduler;
+	uint32 visibleCount = 0;
+
+	// the mask of the last repeat is compared with scalar Intersect outside the timed loops, it is filled first to catch bits not written
+	uint32 boxDifferences = 0;
+	uint32 sphereDifferences = 0;
+	auto countBoxDifferences = [&] ()
+	{
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			boxDifferences += (Intersect(frustum, boxList[i]) != IntersectionResult::Outside) != IsVisible(mask.data(), i);
+		}
+	};
+	auto countSphereDifferences = [&] ()
+	{
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			sphereDifferences += (Intersect(frustum, sphereList[i]) != IntersectionResult::Outside) != IsVisible(mask.data(), i);
+		}
+	};
+
+	Timer t;
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			visibleCount += Intersect(frustum, boxList[i]) != IntersectionResult::Outside;
+		}
+	}
+	cout << "scalar Intersect boxes: " << t.Elapsed() / RepeatCount * 1000 << "ms" << endl;
+
+	fill(mask.begin(), mask.end(), ~0u);
+	t.Restart();
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		CullBoxes(frustum, boxes, mask.data());
+		visibleCount += mask[repeat];
+	}
+	cout << "CullBoxes: " << t.Elapsed() / RepeatCount * 1000 << "ms" << endl;
+	countBoxDifferences();
+
+	fill(mask.begin(), mask.end(), ~0u);
+	t.Restart();
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		ParallelCullBoxes(scheduler, frustum, boxes, mask.data());
+		visibleCount += mask[repeat];
+	}
+	cout << "ParallelCullBoxes, " << scheduler.GetThreadCount() << " threads: " << t.Elapsed() / RepeatCount * 1000 << "ms" << endl;
+	countBoxDifferences();
+
+	t.Restart();
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			visibleCount += Intersect(frustum, sphereList[i]) != IntersectionResult::Outside;
+		}
+	}
+	cout << "scalar Intersect spheres: " << t.Elapsed() / RepeatCount * 1000 << "ms" << endl;
+
+	fill(mask.begin(), mask.end(), ~0u);
+	t.Restart();
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		CullSpheres(frustum, spheres, mask.data());
+		visibleCount += mask[repeat];
+	}
+	cout << "CullSpheres: " << t.Elapsed() / RepeatCount * 1000 << "ms" << endl;
+	countSphereDifferences();
+
+	fill(mask.begin(), mask.end(), ~0u);
+	t.Restart();
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		ParallelCullSpheres(scheduler, frustum, spheres, mask.data());
+		visibleCount += mask[repeat];
+	}
+	cout << "ParallelCullSpheres: " << t.Elapsed() / RepeatCount * 1000 << "ms" << endl;
+	countSphereDifferences();
+
+	bool ok = boxDifferences == 0 && sphereDifferences == 0;
+	cout << "checksum: " << visibleCount << endl;
+	cout << "differences from scalar Intersect, boxes: " << boxDifferences << ", spheres: " << sphereDifferences << ", " << (ok ? "ok" : "failed") << endl;
+	return ok;
+}
+
+namespace
+{
+	string ReadWholeFile(string const& fileName)
+	{
+		ifstream file(fileName, ios::in | ios::binary);
+		return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	}
+
+	void WriteWholeFile(string const& fileName, string const& content)
+	{
+		ofstream file(fileName, ios::out | ios::binary | ios::trunc);
+		file << content;
+	}
+
+	/*
+	 *	Uncompressed 32 bits TGA, rows from the bottom as textures.
+	 *	@texels: BGRA, tightly packed.
+	 */
+	void WriteTGA(string const& fileName, uint32 width, uint32 height, vector<uint8> const& texels)
+	{
+		uint8 header[18] = { 0, 0, 2 }; // true color
+		header[12] = static_cast<uint8>(width);
+		header[13] = static_cast<uint8>(width >> 8);
+		header[14] = static_cast<uint8>(height);
+		header[15] = static_cast<uint8>(height >> 8);
+		header[16] = 32;
+		header[17] = 8; // alpha bits, origin at bottom left
+		WriteWholeFile(fileName, string(reinterpret_cast<char const*>(header), sizeof(header)) + string(texels.begin(), texels.end()));
+	}
+}
+
+bool TestFile::MeshCacheSpeedTest()
+{
+	string const ModelFile = "../../Data/crytek-sponza/sponza.obj";
+	string const CacheFile = "MeshCacheSpeedTest.xrmc";
+	string const ResavedCacheFile = "MeshCacheSpeedTest2.xrmc";
+	uint32 const RepeatCount = 5;
+	MeshLoader loader;
+	MeshLoader::TextureLoadingFunction noTexture = [] (string const&)
+	{
+		return MakeSP<AsyncTextureLoadingResult>(); // failed, only mesh data is measured
+	};
+
+	// data of a cache is mapped and read from disk when first accessed, both paths read all data as creating the mesh does.
+	Timer t;
+	MeshLoadingResultSP imported;
+	uint64 importedHash = 0;
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		imported = loader.LoadMesh(ModelFile, noTexture);
+		importedHash = MeshLoader::HashMeshData(imported);
+	}
+	double importTime = t.Elapsed() / RepeatCount;
+	if (!imported->Succeeded())
+	{
+		cerr << ModelFile << " not loaded." << endl;
+		return false;
+	}
+
+	t.Restart();
+	bool saved = loader.SaveMeshCache(imported, CacheFile);
+	double saveTime = t.Elapsed();
+
+	t.Restart();
+	MeshLoadingResultSP cached;
+	uint64 cachedHash = 0;
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		cached = loader.LoadMeshCache(CacheFile, noTexture);
+		cachedHash = MeshLoader::HashMeshData(cached);
+	}
+	double cacheTime = t.Elapsed() / RepeatCount;
+
+	cout << "assimp import and read data: " << importTime * 1000 << "ms" << endl;
+	cout << "save cache: " << saveTime * 1000 << "ms" << (saved ? "" : ", failed") << endl;
+	cout << "load cache and read data: " << cacheTime * 1000 << "ms, " << importTime / cacheTime << "x" << endl;
+
+	// cache loaded data must be the same as imported data
+	bool same = cached->Succeeded() && cached->GetDataSize() == imported->GetDataSize() && cachedHash == importedHash && importedHash != 0
+		&& loader.SaveMeshCache(cached, ResavedCacheFile) && ReadWholeFile(CacheFile) == ReadWholeFile(ResavedCacheFile);
+	cout << "data size: " << imported->GetDataSize() << " bytes, round trip " << (same ? "identical" : "FAILED") << endl;
+	cached = nullptr; // unmap before removing
+	remove(CacheFile.c_str());
+	remove(ResavedCacheFile.c_str());
+
+	// a cache is stale once a file referenced by the model changes, not only the model file.
+	string const StaleModelFile = "MeshCacheStaleTest.obj";
+	string const StaleMaterialFile = "MeshCacheStaleTest.mtl";
+	string const StaleCacheFile = MeshLoader::GetMeshCacheFileName(StaleModelFile);
+	WriteWholeFile(StaleModelFile, "mtllib MeshCacheStaleTest.mtl\nusemtl red\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+	WriteWholeFile(StaleMaterialFile, "newmtl red\nKd 1 0 0\n");
+	bool staleSaved = loader.SaveMeshCache(loader.LoadMesh(StaleModelFile, noTexture), StaleCacheFile);
+	bool freshLoaded = loader.LoadMeshCache(StaleCacheFile, noTexture)->Succeeded();
+	this_thread::sleep_for(chrono::milliseconds(1100)); // write times may only have a resolution of seconds
+	WriteWholeFile(StaleMaterialFile, "newmtl red\nKd 0 1 0\n");
+	bool staleRejected = !loader.LoadMeshCache(StaleCacheFile, noTexture)->Succeeded();
+	cout << "cache of changed material library " << (staleSaved && freshLoaded && staleRejected ? "rejected" : "FAILED") << endl;
+	remove(StaleModelFile.c_str());
+	remove(StaleMaterialFile.c_str());
+	remove(StaleCacheFile.c_str());
+	return same && staleSaved && freshLoaded && staleRejected;
+}
+
+bool TestFile::TextureContainerSpeedTest()
+{
+	string const TextureDirectory = "../../Data/crytek-sponza/textures/";
+	char const* const TextureNames[] =
+	{
+		"background.tga", "lion.tga", "sponza_arch_diff.tga", "sponza_column_a_diff.tga", "sponza_floor_a_diff.tga", "sponza_arch_bump.png", "vase_round_bump.png",
+	};
+	TextureLoader loader;
+	double bakeTime = 0;
+	double imageTime = 0;
+	double containerTime = 0;
+	uint64 imageSize = 0;
+	uint64 containerSize = 0;
+	uint32 failedCount = 0;
+	Timer t;
+	for (uint32 i = 0; i < sizeof(TextureNames) / sizeof(TextureNames[0]); ++i)
+	{
+#ifdef XREX_WITHOUT_FREEIMAGE
+		if (string(TextureNames[i]).find(".png") != string::npos)
+		{
+			cout << TextureNames[i] << " skipped, built without FreeImage" << endl;
+			continue;
+		}
+#endif
+		string imageFile = TextureDirectory + TextureNames[i];
+		string containerFile = "TextureContainerSpeedTest" + to_string(i) + ".xrtx";
+		bool srgbColor = string(TextureNames[i]).find("_bump") == string::npos;
+
+		t.Restart();
+		bool baked = loader.BakeTexture2D(imageFile, containerFile, srgbColor);
+		bakeTime += t.Elapsed();
+
+		// both read every byte to be uploaded, mapping alone does not read the container.
+		t.Restart();
+		TextureLoadingResultSP image = loader.LoadTexture2D(imageFile, true);
+		uint64 imageHash = TextureLoader::HashTextureData(image);
+		imageTime += t.Elapsed();
+
+		t.Restart();
+		TextureLoadingResultSP container = loader.LoadTexture2D(containerFile, true);
+		uint64 containerHash = TextureLoader::HashTextureData(container);
+		containerTime += t.Elapsed();
+
+		// a full mipmap chain is 4/3 of the top level less a third of the 1x1 level, a few bytes more for odd sizes
+		if (!baked || !image->Succeeded() || !container->Succeeded() || container->GetDataSize() + 4 < image->GetDataSize() * 4 / 3
+			|| imageHash == 0 || containerHash == 0 || TextureLoader::CopyTextureLevel(container, 0) != TextureLoader::CopyTextureLevel(image, 0))
+		{
+			cerr << TextureNames[i] << " failed." << endl;
+			++failedCount;
+		}
+		imageSize += image->GetDataSize();
+		containerSize += container->GetDataSize();
+		container = nullptr; // unmap before removing
+		remove(containerFile.c_str());
+	}
+	cout << "bake with mipmaps: " << bakeTime * 1000 << "ms" << endl;
+	cout << "decode and read images: " << imageTime * 1000 << "ms, " << imageSize << " bytes, mipmaps generated at upload" << endl;
+	cout << "map and read containers: " << containerTime * 1000 << "ms, " << containerSize << " bytes including mipmaps" << endl;
+	cout << "failed: " << failedCount << endl;
+
+	// 3x3 black image with a white corner, odd sizes take 3 taps, so level 1 is the average of all 9 texels.
+	// averaged in linear space it is much brighter than averaged in sRGB, a 2 taps filter misses the corner.
+	uint32 const SyntheticSize = 3;
+	string const SyntheticImageFile = "TextureContainerContentTest.tga";
+	string const SyntheticContainerFile = "TextureContainerContentTest.xrtx";
+	vector<uint8> texels(SyntheticSize * SyntheticSize * 4, 0);
+	for (uint32 i = 0; i < SyntheticSize * SyntheticSize; ++i)
+	{
+		texels[i * 4 + 3] = 255;
+	}
+	fill(texels.end() - 4, texels.end(), static_cast<uint8>(255));
+	WriteTGA(SyntheticImageFile, SyntheticSize, SyntheticSize, texels);
+
+	bool passed = failedCount == 0;
+	float const average = 1.f / (SyntheticSize * SyntheticSize);
+	float const srgbAverage = 1.055f * pow(average, 1 / 2.4f) - 0.055f;
+	struct
+	{
+		bool srgbColor;
+		uint8 expectedColor;
+	} const Cases[] =
+	{
+		{ true, static_cast<uint8>(srgbAverage * 255 + 0.5f) },
+		{ false, static_cast<uint8>(average * 255 + 0.5f) },
+	};
+	TextureLoadingResultSP decoded = loader.LoadTexture2D(SyntheticImageFile, false);
+	bool decodedPassed = TextureLoader::CopyTextureLevel(decoded, 0) == texels;
+	passed = passed && decodedPassed;
+	cout << "synthetic image decoded " << (decodedPassed ? "ok" : "FAILED") << endl;
+	for (auto& testCase : Cases)
+	{
+		bool baked = loader.BakeTexture2D(SyntheticImageFile, SyntheticContainerFile, testCase.srgbColor);
+		TextureLoadingResultSP container = loader.LoadTexture2D(SyntheticContainerFile, false);
+		vector<uint8> level0 = TextureLoader::CopyTextureLevel(container, 0);
+		vector<uint8> level1 = TextureLoader::CopyTextureLevel(container, 1);
+		bool casePassed = baked && decodedPassed && level0 == texels && level1.size() == 4 && TextureLoader::CopyTextureLevel(container, 2).empty();
+		for (uint32 c = 0; casePassed && c < 4; ++c)
+		{
+			int32 expected = c == 3 ? 255 : testCase.expectedColor;
+			casePassed = abs(static_cast<int32>(level1[c]) - expected) <= 1;
+		}
+		cout << (testCase.srgbColor ? "sRGB" : "linear") << " mipmaps of synthetic image, level 1 expected " << static_cast<uint32>(testCase.expectedColor)
+			<< ", got " << (level1.empty() ? 0 : static_cast<uint32>(level1[0])) << ", " << (casePassed ? "ok" : "FAILED") << endl;
+		passed = passed && casePassed;
+		container = nullptr; // unmap before removing
+		remove(SyntheticContainerFile.c_str());
+	}
+
+	// BC1 has no alpha, baking a translucent image to it is refused.
+	bool opaqueBC1Baked = loader.BakeTexture2D(SyntheticImageFile, SyntheticContainerFile, true, TexelFormat::BC1);
+	texels[3] = 128;
+	WriteTGA(SyntheticImageFile, SyntheticSize, SyntheticSize, texels);
+	bool translucentBC1Refused = !loader.BakeTexture2D(SyntheticImageFile, SyntheticContainerFile, true, TexelFormat::BC1);
+	bool translucentBC3Baked = loader.BakeTexture2D(SyntheticImageFile, SyntheticContainerFile, true, TexelFormat::BC3);
+	passed = passed && opaqueBC1Baked && translucentBC1Refused && translucentBC3Baked;
+	cout << "BC1 of translucent image " << (opaqueBC1Baked && translucentBC1Refused && translucentBC3Baked ? "refused" : "FAILED") << endl;
+	remove(SyntheticContainerFile.c_str());
+	remove(SyntheticImageFile.c_str());
+	return passed;
+}
+
+bool TestFile::BlockCompressionTest()
+{
+	// smooth color gradients with noise, a normal map like pattern and alpha ramps, sizes not multiple of 4 to cover edge blocks
+	uint32 const Width = 1021;
+	uint32 const Height = 1023;
+	vector<uint8> image(Width * Height * 4);
+	mt19937 engine;
+	uniform_int_distribution<int32> noise(-6, 6);
+	for (uint32 y = 0; y < Height; ++y)
+	{
+		for (uint32 x = 0; x < Width; ++x)
+		{
+			uint8* texel = &image[(y * Width + x) * 4];
+			float normalX = sin(x * 0.05f) * 0.5f;
+			float normalY = cos(y * 0.03f) * 0.5f;
+			texel[0] = static_cast<uint8>(min(max(static_cast<int32>((normalX + 0.5f) * 255) + noise(engine), 0), 255));
+			texel[1] = static_cast<uint8>(min(max(static_cast<int32>((normalY + 0.5f) * 255) + noise(engine), 0), 255));
+			texel[2] = static_cast<uint8>(x * 255 / Width / 2 + y * 255 / Height / 2);
+			texel[3] = static_cast<uint8>((x + y) / 8 % 256);
+		}
+	}
+
+	struct
+	{
+		TexelFormat format;
+		char const* name;
+		uint32 channelCount; // channels compared, from red
+		double minimumPSNR;
+	} const Cases[] =
+	{
+		{ TexelFormat::BC1, "BC1", 3, 32 },
+		{ TexelFormat::BC3, "BC3", 4, 32 },
+		{ TexelFormat::BC4, "BC4", 1, 38 },
+		{ TexelFormat::BC5, "BC5", 2, 38 },
+	};
+	TaskScheduler scheduler;
+	bool passed = true;
+	Timer t;
+	for (auto& testCase : Cases)
+	{
+		t.Restart();
+		vector<uint8> blocks = CompressTexels(testCase.format, image.data(), Width, Height);
+		double singleTime = t.Elapsed();
+		t.Restart();
+		vector<uint8> parallelBlocks = ParallelCompressTexels(scheduler, testCase.format, image.data(), Width, Height);
+		double parallelTime = t.Elapsed();
+
+		vector<uint8> decoded = DecompressTexels(testCase.format, blocks.data(), Width, Height);
+		double squaredError = 0;
+		for (uint32 i = 0; i < Width * Height; ++i)
+		{
+			for (uint32 c = 0; c < testCase.channelCount; ++c)
+			{
+				double difference = static_cast<double>(image[i * 4 + c]) - decoded[i * 4 + c];
+				squaredError += difference * difference;
+			}
+		}
+		double meanSquaredError = squaredError / (Width * Height * testCase.channelCount);
+		double psnr = meanSquaredError == 0 ? numeric_limits<double>::infinity() : 10 * log10(255 * 255 / meanSquaredError);
+		bool casePassed = blocks.size() == GetTexelDataSizeInBytes(testCase.format, Width, Height, 1) && blocks == parallelBlocks && psnr >= testCase.minimumPSNR;
+		passed = passed && casePassed;
+		cout << testCase.name << ": PSNR " << psnr << "dB, " << singleTime * 1000 << "ms single thread, "
+			<< parallelTime * 1000 << "ms with " << scheduler.GetThreadCount() << " threads" << (casePassed ? "" : ", failed") << endl;
+	}
+
+	// baked containers keep all levels compressed, smaller than the top level of the 24 bits image
+	TextureLoader loader;
+	string const imageFile = "../../Data/crytek-sponza/textures/sponza_arch_diff.tga";
+	string const containerFile = "BlockCompressionTest.xrtx";
+	TextureLoadingResultSP original = loader.LoadTexture2D(imageFile, false);
+	for (auto& testCase : Cases)
+	{
+		bool baked = loader.BakeTexture2D(imageFile, containerFile, testCase.format != TexelFormat::BC5, testCase.format, &scheduler);
+		TextureLoadingResultSP container = loader.LoadTexture2D(containerFile, true);
+		if (!baked || !original->Succeeded() || !container->Succeeded() || container->GetDataSize() >= original->GetDataSize())
+		{
+			cerr << testCase.name << " container failed." << endl;
+			passed = false;
+		}
+		container = nullptr; // unmap before removing
+		remove(containerFile.c_str());
+	}
+	cout << "BlockCompressionTest " << (passed ? "passed" : "failed") << endl;
+	return passed;
+}
+
+bool TestFile::MeshOptimizationTest()
+{
+	// a shuffled grid: triangles must be kept with their winding, ACMR must get close to the ideal 0.5
+	uint32 const GridSize = 256;
+	uint32 const VertexCount = (GridSize + 1) * (GridSize + 1);
+	vector<floatV3> positions;
+	for (uint32 y = 0; y <= GridSize; ++y)
+	{
+		for (uint32 x = 0; x <= GridSize; ++x)
+		{
+			float u = x * 2 * PI / GridSize;
+			float v = y * PI / GridSize;
+			positions.push_back(floatV3(sin(v) * cos(u), sin(v) * sin(u), cos(v)));
+		}
+	}
+	vector<array<uint32, 3>> triangles;
+	for (uint32 y = 0; y < GridSize; ++y)
+	{
+		for (uint32 x = 0; x < GridSize; ++x)
+		{
+			uint32 corner = y * (GridSize + 1) + x;
+			triangles.push_back(array<uint32, 3>{ { corner, corner + GridSize + 1, corner + 1 } });
+			triangles.push_back(array<uint32, 3>{ { corner + 1, corner + GridSize + 1, corner + GridSize + 2 } });
+		}
+	}
+	shuffle(triangles.begin(), triangles.end(), mt19937());
+	vector<uint32> indices;
+	for (auto& triangle : triangles)
+	{
+		indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+	// vertices carry their original index, to compare triangles after vertices are reordered
+	struct Vertex
+	{
+		floatV3 position;
+		uint32 originalIndex;
+	};
+	vector<Vertex> vertices(VertexCount);
+	for (uint32 i = 0; i < VertexCount; ++i)
+	{
+		vertices[i].position = positions[i];
+		vertices[i].originalIndex = i;
+	}
+	auto getTriangleSet = [&indices, &vertices] ()
+	{
+		multiset<array<uint32, 3>> result;
+		for (uint32 i = 0; i < indices.size(); i += 3)
+		{
+			array<uint32, 3> triangle = { { vertices[indices[i]].originalIndex, vertices[indices[i + 1]].originalIndex, vertices[indices[i + 2]].originalIndex } };
+			rotate(triangle.begin(), min_element(triangle.begin(), triangle.end()), triangle.end()); // keeps winding
+			result.insert(triangle);
+		}
+		return result;
+	};
+	multiset<array<uint32, 3>> originalTriangles = getTriangleSet();
+
+	Timer t;
+	VertexCacheStatistics shuffled = AnalyzeVertexCache(indices.data(), indices.size(), VertexCount);
+	vector<uint32> clusters = OptimizeVertexCache(indices.data(), indices.size(), VertexCount);
+	VertexCacheStatistics vertexCacheOptimized = AnalyzeVertexCache(indices.data(), indices.size(), VertexCount);
+	OptimizeOverdraw(indices.data(), indices.size(), reinterpret_cast<uint8 const*>(vertices.data()), sizeof(Vertex), VertexCount, clusters);
+	VertexCacheStatistics overdrawOptimized = AnalyzeVertexCache(indices.data(), indices.size(), VertexCount);
+	OptimizeVertexFetch(reinterpret_cast<uint8*>(vertices.data()), sizeof(Vertex), VertexCount, indices.data(), indices.size());
+	double time = t.Elapsed();
+	bool passed = getTriangleSet() == originalTriangles && vertexCacheOptimized.acmr < 0.7f && overdrawOptimized.acmr < 0.75f;
+	cout << "grid of " << triangles.size() << " triangles, " << time * 1000 << "ms, ACMR shuffled " << shuffled.acmr << ", vertex cache " << vertexCacheOptimized.acmr
+		<< ", " << clusters.size() << " clusters, overdraw " << overdrawOptimized.acmr << (passed ? "" : ", failed") << endl;
+
+	// shipped models, statistics of each layout
+#ifdef XREX_WITHOUT_ASSIMP
+	cout << "built without assimp, models skipped" << endl;
+#else
+	char const* const ModelFiles[] =
+	{
+		"../../Data/crytek-sponza/sponza.obj", "../../Data/crytek-sponza/banner.obj", "../../Data/teapot/teapot.obj",
+	};
+	MeshLoader loader;
+	MeshLoader::TextureLoadingFunction noTexture = [] (string const&)
+	{
+		return MakeSP<AsyncTextureLoadingResult>(); // failed, only mesh data is processed
+	};
+	for (auto modelFile : ModelFiles)
+	{
+		if (!ifstream(modelFile))
+		{
+			cout << modelFile << " not found, skipped" << endl; // sponza.obj is not in every copy of Data
+			continue;
+		}
+		loader.SetOptimizationEnabled(false);
+		t.Restart();
+		MeshLoadingResultSP imported = loader.LoadMesh(modelFile, noTexture);
+		double importTime = t.Elapsed();
+		loader.SetOptimizationEnabled(true);
+		t.Restart();
+		vector<MeshLoader::OptimizationStatistics> optimizationStatistics;
+		MeshLoadingResultSP optimized = loader.LoadMesh(modelFile, noTexture, &optimizationStatistics);
+		double optimizedImportTime = t.Elapsed();
+		if (!imported->Succeeded() || !optimized->Succeeded() || imported->GetDataSize() != optimized->GetDataSize())
+		{
+			cerr << modelFile << " not loaded." << endl;
+			passed = false;
+			continue;
+		}
+
+		cout << modelFile << ": import " << importTime * 1000 << "ms, with optimization " << optimizedImportTime * 1000 << "ms" << endl;
+		uint64 triangleCount = 0;
+		double missesBefore = 0;
+		double missesAfter = 0;
+		for (auto& statistics : optimizationStatistics)
+		{
+			cout << "\t" << statistics.name << ": " << statistics.triangleCount << " triangles, ACMR " << statistics.before.acmr << " -> " << statistics.after.acmr
+				<< ", ATVR " << statistics.before.atvr << " -> " << statistics.after.atvr << endl;
+			triangleCount += statistics.triangleCount;
+			missesBefore += statistics.before.acmr * statistics.triangleCount;
+			missesAfter += statistics.after.acmr * statistics.triangleCount;
+		}
+		if (triangleCount > 0)
+		{
+			passed = passed && missesAfter < missesBefore;
+			cout << "\ttotal: " << triangleCount << " triangles, ACMR " << missesBefore / triangleCount << " -> " << missesAfter / triangleCount << endl;
+		}
+	}
+#endif
+	cout << "MeshOptimizationTest " << (passed ? "passed" : "failed") << endl;
+	return passed;
+}
+
 template <uint32 N>
 struct MyStruct
 {
@@ -231,8 +2368,8 @@ MyStruct<3>::MyStruct(int& a)
 
 }
 
-template MyStruct<1>;
-template MyStruct<2>;
+template struct MyStruct<1>;
+template struct MyStruct<2>;
 
 void Temp()
 {
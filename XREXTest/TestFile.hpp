@@ -1,5 +1,8 @@
 #pragma once
 
+/*
+ *	Tests returning bool check their results, false if any check failed. XREXTest test <name> runs one of them.
+ */
 class TestFile
 {
 public:
@@ -7,5 +10,25 @@ public:
 	void TestMath();
 	//void FileSystemTest();
 	void TestTransformation();
+	bool SceneCullingSpeedTest();
+	void TransformationHierarchySpeedTest();
+	bool TaskSchedulerStressTest();
+	void TaskSchedulerSpeedTest();
+	void FramePipelineSpeedTest();
+	void RenderSortSpeedTest();
+	void ParameterLookupSpeedTest();
+	bool BufferArenaAllocatorTest();
+	bool CommandBufferSpeedTest();
+	bool RenderablePackCollectionTest();
+	bool ProfilerSpeedTest();
+	bool FrameStatisticsHistoryTest();
+	bool MathSIMDTest();
+	void MathSIMDSpeedTest();
+	bool FrustumCullingTest();
+	bool FrustumCullingSpeedTest();
+	bool MeshCacheSpeedTest();
+	bool TextureContainerSpeedTest();
+	bool BlockCompressionTest();
+	bool MeshOptimizationTest();
 };
 